@@ -0,0 +1,61 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMCOLLISION_H_INCLUDED
+#define BMCOLLISION_H_INCLUDED
+
+#include <string>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+
+class BMCollision : public Bench::Case
+{
+public:
+    BMCollision( const char* name )
+        : Bench::Case( name )
+        {}
+
+    // box[1] を box[0] の上に置いて rbCollision::Detect を計測する
+    static void MeasureDetect( Bench::Reporter& reporter, const std::string& name,
+                               const rbMtx3& orientation0, const rbMtx3& orientation1, const rbVec3& position1 )
+        {
+            if ( !reporter.Enabled(name) )
+                return;
+
+            rbShapeLibrary library;
+            rbRigidBody box[2];
+            for ( rbRigidBody& b : box )
+                b.SetShapeParameter( library, 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+            box[0].SetOrientation( orientation0 );
+            box[1].SetOrientation( orientation1 );
+            box[1].SetPosition( position1 );
+
+            rbContact contacts[rbCollision::MaxContactsPerPair];
+            Bench::Result result = reporter.Measure( name, [&]() {
+                    rbs32 count = rbCollision::Detect( &box[0], &box[1], contacts, rbCollision::MaxContactsPerPair );
+                    Bench::DoNotOptimize( count );
+                } );
+            result.pairs_per_s = 1.0e9 / result.ns_per_op;
+            reporter.Add( result );
+        }
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            rbMtx3 identity, rotate_z, rotate_x;
+            identity.SetIdentity();
+            rotate_z.SetFromAxisAngle( rbVec3(0, 0, 1), rbToRad(45) );
+            rotate_x.SetFromAxisAngle( rbVec3(1, 0, 0), rbToRad(45) );
+
+            // 分離 : 少し傾けて離す (分離軸が見つかった時点で打ち切り)
+            MeasureDetect( reporter, "collision/Detect/separated", identity, rotate_z, rbVec3(0, 1.3f, 0) );
+
+            // 面と面 : 積み重ねた箱
+            MeasureDetect( reporter, "collision/Detect/face", identity, identity, rbVec3(0.1f, 0.99f, 0.05f) );
+
+            // 辺と辺 : 直交する二つの辺が交差
+            MeasureDetect( reporter, "collision/Detect/edge", rotate_z, rotate_x, rbVec3(0, 1.4f, 0) );
+
+            // 深いめり込み
+            MeasureDetect( reporter, "collision/Detect/deep", identity, rotate_z, rbVec3(0, 0.3f, 0) );
+        }
+};
+
+#endif
@@ -0,0 +1,254 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMENV_H_INCLUDED
+#define BMENV_H_INCLUDED
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+#include <PerfCounters.h>
+
+// 生成したシーンで rbEnvironment::Update 全体を計測する
+class BMEnv : public Bench::Case
+{
+public:
+    BMEnv( const char* name )
+        : Bench::Case( name )
+        {}
+
+    enum SceneType
+    {
+        Scene_BoxRain,
+        Scene_Pyramid,
+        Scene_DominoLine,
+        Scene_Wall,
+    };
+
+    // 再現性のため std::rand ではなく固定の線形合同法を使う
+    static rbReal Random( rbu32& seed )
+        {
+            seed = seed * 1664525U + 1013904223U;
+            return rbReal(seed >> 8) / rbReal(1 << 24);
+        }
+
+    // body_count 個の箱と床 (bodies.back()) を配置する。形状は shapes に追加する
+    static void BuildScene( rbShapeLibrary& shapes, SceneType type, rbu32 body_count, std::vector<rbRigidBody>& bodies )
+        {
+            rbu32 seed = 12345;
+            rbReal floor_extent = 10;
+
+            for ( rbu32 i = 0; i < body_count; ++i )
+            {
+                rbRigidBody& b = bodies[i];
+                b.EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+
+                switch ( type )
+                {
+                case Scene_BoxRain:
+                {
+                    // 立方体状の格子から少しずつ回転させて落とす
+                    const rbu32 side = static_cast<rbu32>( std::ceil(std::cbrt(double(body_count))) );
+                    b.SetShapeParameter( shapes, 1, 0.5f, 0.5f, 0.5f, 0.2f, 0.5f );
+                    b.SetPosition( rbReal(i % side) * 1.5f, 2 + rbReal(i / (side * side)) * 1.5f, rbReal((i / side) % side) * 1.5f );
+                    b.SetOrientation( Random(seed), Random(seed), Random(seed) );
+                    floor_extent = rbMax( floor_extent, side * 1.5f + 5 );
+                    break;
+                }
+                case Scene_Pyramid:
+                {
+                    // 底辺の段から順に、一段ごとに一つ少なく積む
+                    rbu32 base = 1;
+                    while ( base * (base + 1) / 2 < body_count )
+                        ++base;
+                    rbu32 row = 0, index = i, width = base;
+                    while ( index >= width )
+                    {
+                        index -= width;
+                        --width;
+                        ++row;
+                    }
+                    b.SetShapeParameter( shapes, 1, 0.5f, 0.5f, 0.5f, 0.0f, 0.6f );
+                    b.SetPosition( rbReal(index) * 1.01f + rbReal(row) * 0.505f, 0.5f + rbReal(row), 0 );
+                    floor_extent = rbMax( floor_extent, base * 1.01f + 5 );
+                    break;
+                }
+                case Scene_DominoLine:
+                {
+                    // 先頭の一枚だけを傾けておく
+                    b.SetShapeParameter( shapes, 1, 0.1f, 1.0f, 0.5f, 0.0f, 0.6f );
+                    b.SetPosition( rbReal(i) * 1.2f, 1.0f, 0 );
+                    if ( i == 0 )
+                        b.SetOrientation( 0, 0, rbToRad(-20) );
+                    floor_extent = rbMax( floor_extent, body_count * 0.6f + 5 );
+                    break;
+                }
+                case Scene_Wall:
+                {
+                    // 一段おきに半分ずらしたレンガの壁
+                    const rbu32 width = static_cast<rbu32>( std::ceil(std::sqrt(double(body_count))) );
+                    const rbu32 row = i / width;
+                    b.SetShapeParameter( shapes, 1, 0.5f, 0.25f, 0.25f, 0.0f, 0.6f );
+                    b.SetPosition( rbReal(i % width) * 1.0f + ((row & 1) ? 0.5f : 0.0f), 0.25f + rbReal(row) * 0.5f, 0 );
+                    floor_extent = rbMax( floor_extent, width * 0.5f + 5 );
+                    break;
+                }
+                }
+            }
+
+            rbRigidBody& floor = bodies[body_count];
+            floor.SetShapeParameter( shapes, 10000, floor_extent, 1, floor_extent, 0.2f, 0.6f );
+            floor.SetPosition( floor_extent * 0.5f, -1, 0 );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+        }
+
+    // rbProfiler のコールバックで、Update の処理段階ごとにハードウェアカウンターを集計する
+    struct PhaseCounters
+    {
+        Bench::PerfCounters* counters;
+        Bench::PerfCounters::Values begin[rbFrameStats::PhaseCount];
+        Bench::PerfCounters::Values total[rbFrameStats::PhaseCount];
+
+        static void Callback( rbu32 phase, bool begin, void* user_data )
+            {
+                PhaseCounters* self = static_cast<PhaseCounters*>( user_data );
+                if ( begin )
+                {
+                    self->counters->Read( self->begin[phase] );
+                    return;
+                }
+
+                Bench::PerfCounters::Values end;
+                self->counters->Read( end );
+                for ( int i = 0; i < Bench::PerfCounters::EventCount; ++i )
+                    self->total[phase].value[i] += end.value[i] - self->begin[phase].value[i];
+            }
+    };
+
+    // 計測と別のフレームでカウンターを読む (読み取りのシステムコールが時間の計測に混ざらないように)
+    static void CaptureCounters( Bench::Reporter& reporter, Bench::PerfCounters& counters, const std::string& name,
+                                 rbEnvironment& env, std::vector<rbRigidBody>& bodies, rbu32 body_count,
+                                 rbReal dt, rbs32 div, const rbVec3& G, rbu32 frames )
+        {
+            PhaseCounters phase_counters;
+            phase_counters.counters = &counters;
+
+            double pairs = 0;
+            env.Profiler().SetPhaseCallback( PhaseCounters::Callback, &phase_counters );
+            for ( rbu32 frame = 0; frame < frames; ++frame )
+            {
+                for ( rbu32 i = 0; i < body_count; ++i )
+                    bodies[i].SetForce( G );
+                env.Update( dt, div );
+                pairs += env.BroadPhasePairCount();
+            }
+            env.Profiler().SetPhaseCallback( nullptr );
+
+            typedef Bench::PerfCounters PC;
+            for ( rbu32 phase = 0; phase < rbFrameStats::PhaseCount; ++phase )
+            {
+                const PC::Values& total = phase_counters.total[phase];
+                if ( counters.Has(PC::Event_Cycles) && total.value[PC::Event_Cycles] == 0 )
+                    continue;
+
+                Bench::CounterResult result;
+                result.name = name + "/" + rbFrameStats::PhaseName( phase );
+                for ( int i = 0; i < PC::EventCount; ++i )
+                {
+                    if ( !counters.Has(i) )
+                        continue;
+                    result.values.push_back( std::make_pair(std::string(PC::EventName(i)) + "_per_frame", double(total.value[i]) / frames) );
+                }
+                if ( counters.Has(PC::Event_Cycles) && counters.Has(PC::Event_Instructions) )
+                    result.values.push_back( std::make_pair(std::string("ipc"), double(total.value[PC::Event_Instructions]) / double(total.value[PC::Event_Cycles])) );
+
+                // 剛体の組あたりのミス
+                const int misses[] = { PC::Event_L1DMisses, PC::Event_LLCMisses, PC::Event_BranchMisses };
+                for ( int event : misses )
+                {
+                    if ( counters.Has(event) && pairs > 0 )
+                        result.values.push_back( std::make_pair(std::string(PC::EventName(event)) + "_per_pair", double(total.value[event]) / pairs) );
+                }
+                reporter.AddCounters( result );
+            }
+        }
+
+    static void MeasureScene( Bench::Reporter& reporter, Bench::PerfCounters* counters, const char* scene_name, SceneType type, rbu32 body_count )
+        {
+            const std::string name = std::string("env/Update/") + scene_name + "/" + std::to_string(body_count);
+            if ( !reporter.Enabled(name) )
+                return;
+
+            const rbReal dt = rbReal(1.0 / 60.0);
+            const rbs32 div = 4;
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+            const rbu32 warmup_frames = 5;
+            const rbu32 frames = body_count >= 10000 ? 5 : (body_count >= 1000 ? 20 : 100);
+
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = body_count + 1;
+            config.ContactCapacty = 8 * body_count;
+            rbEnvironment env( config );
+
+            std::vector<rbRigidBody> bodies( body_count + 1 );
+            BuildScene( env.Shapes(), type, body_count, bodies );
+            for ( rbRigidBody& b : bodies )
+                env.Register( &b );
+
+            Bench::Result result;
+            result.name = name;
+
+            double elapsed = 0;
+            double pairs = 0;
+            for ( rbu32 frame = 0; frame < warmup_frames + frames; ++frame )
+            {
+                for ( rbu32 i = 0; i < body_count; ++i )
+                    bodies[i].SetForce( G );
+
+                Bench::Timer timer;
+                env.Update( dt, div );
+                if ( frame < warmup_frames )
+                    continue;
+                elapsed += timer.ElapsedNs();
+                pairs += env.BroadPhasePairCount();
+            }
+
+            result.iterations = frames;
+            result.ns_per_op = elapsed / frames;
+            result.pairs_per_s = pairs * 1.0e9 / elapsed;
+            result.bodies_per_s = double(body_count) * frames * 1.0e9 / elapsed;
+            reporter.Add( result );
+
+            if ( counters != nullptr && counters->Available() )
+                CaptureCounters( reporter, *counters, name, env, bodies, body_count, dt, div, G, frames );
+
+            for ( rbRigidBody& b : bodies )
+                env.Unregister( &b );
+        }
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            const rbu32 sizes[] = { 100, 1000, 10000 };
+            const size_t size_count = reporter.GetOptions().quick ? 2 : 3;
+
+            // カウンターが使えない環境では時間のみを計測する
+            Bench::PerfCounters perf_counters;
+            Bench::PerfCounters* counters = nullptr;
+            if ( reporter.GetOptions().counters )
+            {
+                std::cout << "# perf counters : " << perf_counters.Status() << std::endl;
+                if ( perf_counters.Available() )
+                    counters = &perf_counters;
+            }
+
+            for ( size_t i = 0; i < size_count; ++i )
+            {
+                MeasureScene( reporter, counters, "box_rain", Scene_BoxRain, sizes[i] );
+                MeasureScene( reporter, counters, "pyramid", Scene_Pyramid, sizes[i] );
+                MeasureScene( reporter, counters, "domino_line", Scene_DominoLine, sizes[i] );
+                MeasureScene( reporter, counters, "wall", Scene_Wall, sizes[i] );
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,40 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMLAYOUT_H_INCLUDED
+#define BMLAYOUT_H_INCLUDED
+
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+
+// サイズとキャッシュラインの使用量の報告 (データ配置の変更前後の比較用)
+class BMLayout : public Bench::Case
+{
+public:
+    BMLayout( const char* name )
+        : Bench::Case( name )
+        {}
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            const size_t line = RIGIDBOX_CACHE_LINE_SIZE;
+
+#if defined(RIGIDBOX_USE_SIMD)
+            reporter.AddProperty( "build.simd", 1 );
+#else
+            reporter.AddProperty( "build.simd", 0 );
+#endif
+            reporter.AddProperty( "build.sizeof_real", sizeof(rbReal) );
+            reporter.AddProperty( "layout.cache_line_size", line );
+            reporter.AddProperty( "layout.sizeof_vec3", sizeof(rbVec3) );
+            reporter.AddProperty( "layout.sizeof_mtx3", sizeof(rbMtx3) );
+            reporter.AddProperty( "layout.sizeof_body", sizeof(rbRigidBody) );
+            reporter.AddProperty( "layout.sizeof_body_state", sizeof(rbRigidBody::State) );
+            reporter.AddProperty( "layout.sizeof_shape", sizeof(rbRigidBody::Shape) );
+            reporter.AddProperty( "layout.sizeof_contact", sizeof(rbContact) );
+
+            // サブステップごとに必ず触れるキャッシュラインの数 (State と、その直後の warm ブロック)
+            reporter.AddProperty( "layout.body_cache_lines", (sizeof(rbRigidBody) + line - 1) / line );
+            reporter.AddProperty( "layout.hot_cache_lines", (sizeof(rbRigidBody::State) + line - 1) / line );
+        }
+};
+
+#endif
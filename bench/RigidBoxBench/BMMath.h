@@ -0,0 +1,69 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMMATH_H_INCLUDED
+#define BMMATH_H_INCLUDED
+
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+
+class BMMath : public Bench::Case
+{
+public:
+    BMMath( const char* name )
+        : Bench::Case( name )
+        {}
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            // 定数畳み込みを避けるため、あらかじめ用意した行列を順に使う
+            const size_t Count = 256;
+            std::vector<rbMtx3> matrices( Count );
+            std::vector<rbVec3> vectors( Count );
+            for ( size_t i = 0; i < Count; ++i )
+            {
+                rbVec3 axis( rbReal(1), rbReal(i % 7) * rbReal(0.1), rbReal(i % 5) * rbReal(0.2) );
+                matrices[i].SetFromAxisAngle( axis.Normalize(), rbReal(i) * rbReal(0.05) );
+                matrices[i] *= rbReal(1) + rbReal(i % 3) * rbReal(0.01);
+                vectors[i].Set( rbReal(i % 11), rbReal(1), rbReal(i % 13) * rbReal(0.5) );
+            }
+
+            size_t i = 0;
+            if ( reporter.Enabled("math/Mtx3Multiply") )
+                reporter.Add( reporter.Measure( "math/Mtx3Multiply", [&]() {
+                            rbMtx3 m = matrices[i % Count] * matrices[(i + 1) % Count];
+                            Bench::DoNotOptimize( m );
+                            ++i;
+                        } ) );
+
+            if ( reporter.Enabled("math/Mtx3MultiplyVec3") )
+                reporter.Add( reporter.Measure( "math/Mtx3MultiplyVec3", [&]() {
+                            rbVec3 v = matrices[i % Count] * vectors[(i + 1) % Count];
+                            Bench::DoNotOptimize( v );
+                            ++i;
+                        } ) );
+
+            if ( reporter.Enabled("math/Mtx3GetInverse") )
+                reporter.Add( reporter.Measure( "math/Mtx3GetInverse", [&]() {
+                            rbMtx3 m = matrices[i % Count].GetInverse();
+                            Bench::DoNotOptimize( m );
+                            ++i;
+                        } ) );
+
+            if ( reporter.Enabled("math/Mtx3Orthonormalize") )
+                reporter.Add( reporter.Measure( "math/Mtx3Orthonormalize", [&]() {
+                            rbMtx3 m = matrices[i % Count];
+                            m.Orthonormalize();
+                            Bench::DoNotOptimize( m );
+                            ++i;
+                        } ) );
+
+            if ( reporter.Enabled("math/Vec3Cross") )
+                reporter.Add( reporter.Measure( "math/Vec3Cross", [&]() {
+                            rbVec3 v = vectors[i % Count] % vectors[(i + 1) % Count];
+                            Bench::DoNotOptimize( v );
+                            ++i;
+                        } ) );
+        }
+};
+
+#endif
@@ -0,0 +1,117 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMQUERY_H_INCLUDED
+#define BMQUERY_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+#include "BMEnv.h"
+
+// Update の間に行うシーンへの問い合わせ (地面へのレイ、視線のレイ、直方体との重なり) を計測する。
+// Update ごとに最初の問い合わせで境界を計算し直すので、その費用も含まれる
+class BMQuery : public Bench::Case
+{
+public:
+    BMQuery( const char* name )
+        : Bench::Case( name )
+        {}
+
+    static const rbu32 RayCount = 1024;
+    static const rbu32 OverlapCount = 64;
+
+    static void MeasureScene( Bench::Reporter& reporter, rbu32 body_count )
+        {
+            const std::string name = "env/Query/box_rain/" + std::to_string(body_count);
+            if ( !reporter.Enabled(name + "/ground_rays") && !reporter.Enabled(name + "/sight_rays") &&
+                 !reporter.Enabled(name + "/overlap_box") )
+                return;
+
+            const rbReal dt = rbReal(1.0 / 60.0);
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+            const rbu32 frames = body_count >= 10000 ? 10 : 50;
+
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = body_count + 1;
+            config.ContactCapacty = 8 * body_count;
+            rbEnvironment env( config );
+
+            std::vector<rbRigidBody> bodies( body_count + 1 );
+            BMEnv::BuildScene( env.Shapes(), BMEnv::Scene_BoxRain, body_count, bodies );
+            for ( rbRigidBody& b : bodies )
+                env.Register( &b );
+
+            // 地面へのレイは格子状に並んだ鉛直なレイ、視線のレイは散らばった点から任意の向きへのレイ
+            const rbAABB& floor_bounds = bodies[body_count].WorldAABB();
+            const rbVec3 extent = floor_bounds.upper - floor_bounds.lower;
+            rbu32 seed = 4321;
+            std::vector<rbRay> ground_rays( RayCount ), sight_rays( RayCount );
+            for ( rbu32 i = 0; i < RayCount; ++i )
+            {
+                const rbReal x = floor_bounds.lower.x + extent.x * rbReal(i % 32) / rbReal(32);
+                const rbReal z = floor_bounds.lower.z + extent.z * rbReal(i / 32) / rbReal(RayCount / 32);
+                ground_rays[i] = rbRay( rbVec3(x, 50, z), rbVec3(0, -100, 0) );
+
+                const rbVec3 origin( floor_bounds.lower.x + extent.x * BMEnv::Random(seed), 1 + 10 * BMEnv::Random(seed),
+                                     floor_bounds.lower.z + extent.z * BMEnv::Random(seed) );
+                const rbVec3 direction( BMEnv::Random(seed) - rbReal(0.5), BMEnv::Random(seed) - rbReal(0.5), BMEnv::Random(seed) - rbReal(0.5) );
+                sight_rays[i] = rbRay( origin, 20 * direction );
+            }
+            std::vector<rbRayHit> hits( RayCount );
+            const rbMtx3 identity( 1, 0, 0, 0, 1, 0, 0, 0, 1 );
+
+            double ground_ns = 0, sight_ns = 0, overlap_ns = 0;
+            rbu32 hit_count = 0;
+            for ( rbu32 frame = 0; frame < frames; ++frame )
+            {
+                for ( rbu32 i = 0; i < body_count; ++i )
+                    bodies[i].SetForce( G );
+                env.Update( dt, 1 );
+
+                Bench::Timer ground_timer;
+                env.RayCast( ground_rays.data(), RayCount, hits.data() );
+                ground_ns += ground_timer.ElapsedNs();
+                hit_count += hits[RayCount / 2].Body != nullptr ? 1 : 0;
+
+                Bench::Timer sight_timer;
+                env.RayCast( sight_rays.data(), RayCount, hits.data() );
+                sight_ns += sight_timer.ElapsedNs();
+                hit_count += hits[RayCount / 2].Body != nullptr ? 1 : 0;
+
+                Bench::Timer overlap_timer;
+                for ( rbu32 i = 0; i < OverlapCount; ++i )
+                {
+                    rbRigidBody* found[8];
+                    const rbVec3 center = sight_rays[i].Origin;
+                    hit_count += env.OverlapBox( center, identity, rbVec3(1, 1, 1), found, 8 );
+                }
+                overlap_ns += overlap_timer.ElapsedNs();
+            }
+            Bench::DoNotOptimize( hit_count );
+
+            const double elapsed_ns[3] = { ground_ns, sight_ns, overlap_ns };
+            const char* suffixes[3] = { "/ground_rays", "/sight_rays", "/overlap_box" };
+            const rbu32 counts[3] = { RayCount, RayCount, OverlapCount };
+            for ( int i = 0; i < 3; ++i )
+            {
+                Bench::Result result;
+                result.name = name + suffixes[i];
+                result.iterations = frames * counts[i];
+                result.ns_per_op = elapsed_ns[i] / double(frames * counts[i]);
+                reporter.Add( result );
+            }
+
+            for ( rbRigidBody& b : bodies )
+                env.Unregister( &b );
+        }
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            MeasureScene( reporter, 1000 );
+            MeasureScene( reporter, 10000 );
+            if ( !reporter.GetOptions().quick )
+                MeasureScene( reporter, 100000 );
+        }
+};
+
+#endif
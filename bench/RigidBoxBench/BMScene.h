@@ -0,0 +1,107 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMSCENE_H_INCLUDED
+#define BMSCENE_H_INCLUDED
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+#include "BMEnv.h"
+
+// rbScene (シーンのファイルからの一括読み込み) と、剛体を1つずつ設定して登録する場合の比較
+class BMScene : public Bench::Case
+{
+public:
+    BMScene( const char* name )
+        : Bench::Case( name )
+        {}
+
+    static void AddOnce( Bench::Reporter& reporter, const std::string& name, double ns, rbu32 body_count )
+        {
+            Bench::Result result;
+            result.name = name;
+            result.iterations = 1;
+            result.ns_per_op = ns;
+            result.bodies_per_s = double(body_count) * 1.0e9 / ns;
+            reporter.Add( result );
+        }
+
+    // シーンへの最初の問い合わせ。ブロードフェーズの AABB と並び順が構築される
+    static void FirstQuery( rbEnvironment& env )
+        {
+            rbRigidBody* hit = nullptr;
+            const rbMtx3 identity( 1, 0, 0, 0, 1, 0, 0, 0, 1 );
+            env.OverlapBox( rbVec3(0, -100, 0), identity, rbVec3(rbReal(0.1), rbReal(0.1), rbReal(0.1)), &hit, 1 );
+            Bench::DoNotOptimize( hit );
+        }
+
+    // 箱の雨は登録順と x 方向の並びが一致しないので、ブロードフェーズの最初の並べ替えの費用も現れる。
+    // 起動時の処理 (build / load) と最初の問い合わせ (first_query) を別々に計測する
+    static void MeasureScene( Bench::Reporter& reporter, rbu32 body_count )
+        {
+            const std::string name = "env/Scene/box_rain/" + std::to_string(body_count);
+            if ( !reporter.Enabled(name) )
+                return;
+
+            const char* path = "BMScene.rbsc";
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = body_count + 1;
+            config.ContactCapacty = 8 * body_count;
+
+            // 剛体を1つずつ設定して登録する
+            {
+                rbEnvironment env( config );
+                Bench::Timer timer;
+                std::vector<rbRigidBody> bodies( body_count + 1 );
+                BMEnv::BuildScene( env.Shapes(), BMEnv::Scene_BoxRain, body_count, bodies );
+                for ( rbRigidBody& b : bodies )
+                    env.Register( &b );
+                AddOnce( reporter, name + "/build", timer.ElapsedNs(), body_count );
+
+                Bench::Timer query_timer;
+                FirstQuery( env );
+                AddOnce( reporter, name + "/build/first_query", query_timer.ElapsedNs(), body_count );
+
+                env.Unregister( bodies.data(), body_count + 1 );
+            }
+
+            // 同じシーンを保存し、読み込んで一括登録する
+            {
+                rbShapeLibrary shapes;
+                std::vector<rbRigidBody> bodies( body_count + 1 );
+                BMEnv::BuildScene( shapes, BMEnv::Scene_BoxRain, body_count, bodies );
+                std::vector<rbRigidBody*> pointers;
+                for ( rbRigidBody& b : bodies )
+                    pointers.push_back( &b );
+                if ( !rbScene::Save(path, pointers) )
+                    return;
+            }
+            {
+                rbEnvironment env( config );
+                rbScene scene;
+                Bench::Timer timer;
+                const bool loaded = scene.Load( path ) && scene.Register( env );
+                const double load_ns = timer.ElapsedNs();
+                std::remove( path );
+                if ( !loaded )
+                    return;
+                AddOnce( reporter, name + "/load", load_ns, body_count );
+
+                Bench::Timer query_timer;
+                FirstQuery( env );
+                AddOnce( reporter, name + "/load/first_query", query_timer.ElapsedNs(), body_count );
+
+                scene.Unregister( env );
+            }
+        }
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            MeasureScene( reporter, 10000 );
+            if ( !reporter.GetOptions().quick )
+                MeasureScene( reporter, 100000 );
+        }
+};
+
+#endif
@@ -0,0 +1,153 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMSNAPSHOT_H_INCLUDED
+#define BMSNAPSHOT_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+#include "BMEnv.h"
+
+// rbEnvironment::SaveSnapshot / RestoreSnapshot と Rollback (ロールバック・リプレイ用の保存と復元)
+class BMSnapshot : public Bench::Case
+{
+public:
+    BMSnapshot( const char* name )
+        : Bench::Case( name )
+        {}
+
+    static void MeasureScene( Bench::Reporter& reporter, rbu32 body_count )
+        {
+            const std::string name = "env/Snapshot/pyramid/" + std::to_string(body_count);
+            if ( !reporter.Enabled(name + "/save") && !reporter.Enabled(name + "/restore") )
+                return;
+
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = body_count + 1;
+            config.ContactCapacty = 8 * body_count;
+            rbEnvironment env( config );
+
+            std::vector<rbRigidBody> bodies( body_count + 1 );
+            BMEnv::BuildScene( env.Shapes(), BMEnv::Scene_Pyramid, body_count, bodies );
+            for ( rbRigidBody& b : bodies )
+                env.Register( &b );
+
+            // 衝突点が揃うまで進めておく
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+            for ( rbu32 frame = 0; frame < 5; ++frame )
+            {
+                for ( rbu32 i = 0; i < body_count; ++i )
+                    bodies[i].SetForce( G );
+                env.Update( rbReal(1.0 / 60.0), 4 );
+            }
+
+            rbSnapshot snapshot;
+            env.SaveSnapshot( snapshot );
+            reporter.AddProperty( name + "/bytes", snapshot.Size() );
+
+            Bench::Result save = reporter.Measure( name + "/save", [&]() {
+                    env.SaveSnapshot( snapshot );
+                    Bench::DoNotOptimize( snapshot.Data() );
+                } );
+            save.bodies_per_s = double(body_count) * 1.0e9 / save.ns_per_op;
+            if ( reporter.Enabled(save.name) )
+                reporter.Add( save );
+
+            Bench::Result restore = reporter.Measure( name + "/restore", [&]() {
+                    env.RestoreSnapshot( snapshot );
+                } );
+            restore.bodies_per_s = double(body_count) * 1.0e9 / restore.ns_per_op;
+            if ( reporter.Enabled(restore.name) )
+                reporter.Add( restore );
+
+            for ( rbRigidBody& b : bodies )
+                env.Unregister( &b );
+        }
+
+    // Update を1回取り消して同じ入力で再計算する、を繰り返す。起きている剛体の割合を
+    // 100% / 10% / 1% と変え、Rollback の時間が世界の大きさではなく動いている剛体の数に比例することを確かめる
+    static void MeasureRollback( Bench::Reporter& reporter, rbu32 body_count )
+        {
+            const std::string name = "env/Rollback/pyramid/" + std::to_string(body_count);
+            if ( !reporter.Enabled(name) )
+                return;
+
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = body_count + 1;
+            config.ContactCapacty = 8 * body_count;
+            config.RollbackCapacity = 8;
+            rbEnvironment env( config );
+
+            std::vector<rbRigidBody> bodies( body_count + 1 );
+            BMEnv::BuildScene( env.Shapes(), BMEnv::Scene_Pyramid, body_count, bodies );
+            for ( rbRigidBody& b : bodies )
+                env.Register( &b );
+
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+            auto update = [&]() {
+                for ( rbu32 i = 0; i < body_count; ++i )
+                    bodies[i].SetForce( G );
+                env.Update( rbReal(1.0 / 60.0), 4 );
+            };
+            for ( rbu32 frame = 0; frame < 120; ++frame )
+                update();
+
+            // 眠らせた剛体は接触で起きないようにする (起きている剛体の割合を一定に保つため)
+            rbRigidBody::SleepThresholds frozen;
+            frozen.WakeUpThresholdLV = rbReal(1.0e10);
+            frozen.WakeUpThresholdAV = rbReal(1.0e10);
+
+            const rbu32 awake_every[] = { 1, 10, 100 };
+            for ( rbu32 every : awake_every )
+            {
+                for ( rbu32 i = 0; i < body_count; ++i )
+                {
+                    if ( i % every == 0 )
+                    {
+                        bodies[i].SetSleepThresholds( rbRigidBody::DefaultSleepThresholds() );
+                        bodies[i].SetSleepOff();
+                    }
+                    else
+                    {
+                        bodies[i].SetSleepThresholds( &frozen );
+                        bodies[i].SetSleepOn();
+                    }
+                }
+                for ( rbu32 frame = 0; frame < 2; ++frame )
+                    update();
+
+                const rbu32 frames = 20;
+                double rollback_ns = 0;
+                for ( rbu32 i = 0; i < frames; ++i )
+                {
+                    Bench::Timer timer;
+                    env.Rollback( 1 );
+                    rollback_ns += timer.ElapsedNs();
+                    update();
+                }
+
+                Bench::Result result;
+                result.name = name + "/awake" + std::to_string(100 / every) + "%";
+                result.iterations = frames;
+                result.ns_per_op = rollback_ns / frames;
+                reporter.Add( result );
+                reporter.AddProperty( result.name + "/asleep", env.FrameStats().BodiesAsleep );
+            }
+
+            for ( rbRigidBody& b : bodies )
+                env.Unregister( &b );
+        }
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            MeasureScene( reporter, 1000 );
+            MeasureRollback( reporter, 1000 );
+            if ( !reporter.GetOptions().quick )
+            {
+                MeasureScene( reporter, 10000 );
+                MeasureRollback( reporter, 10000 );
+            }
+        }
+};
+
+#endif
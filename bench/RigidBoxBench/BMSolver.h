@@ -0,0 +1,47 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMSOLVER_H_INCLUDED
+#define BMSOLVER_H_INCLUDED
+
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+
+class BMSolver : public Bench::Case
+{
+public:
+    BMSolver( const char* name )
+        : Bench::Case( name )
+        {}
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            if ( !reporter.Enabled("solver/ApplyImpulse") )
+                return;
+
+            // 床に載って落下中の箱の衝突点 (4点) に力積を適用し続ける
+            rbShapeLibrary library;
+            rbRigidBody box[2];
+            box[0].SetShapeParameter( library, 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+            box[1].SetShapeParameter( library, 100, 5.0f, 0.5f, 5.0f, 0.5f, 0.5f );
+            box[1].EnableAttribute( rbRigidBody::Attribute_Fixed );
+            box[0].SetPosition( 0, 0.99f, 0 );
+            box[0].SetLinearVelocity( 0.5f, -1.0f, 0 );
+            for ( rbRigidBody& b : box )
+                b.UpdateInvInertiaWorld();
+
+            std::vector<rbContact> contacts;
+            rbCollision::Detect( &box[0], &box[1], contacts );
+
+            rbSolver solver;
+            const rbReal dt = rbReal(1.0 / 240.0);
+            size_t i = 0;
+            Bench::Result result = reporter.Measure( "solver/ApplyImpulse", [&]() {
+                    rbReal impulse = solver.ApplyImpulse( &contacts[i % contacts.size()], dt );
+                    Bench::DoNotOptimize( impulse );
+                    ++i;
+                } );
+            reporter.Add( result );
+        }
+};
+
+#endif
@@ -0,0 +1,126 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BMTRAJECTORY_H_INCLUDED
+#define BMTRAJECTORY_H_INCLUDED
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+#include "BMEnv.h"
+
+// rbTrajectoryRecorder (Update ごとの姿勢の記録) と rbTrajectoryPlayer (任意フレームの読み出し)
+class BMTrajectory : public Bench::Case
+{
+public:
+    BMTrajectory( const char* name )
+        : Bench::Case( name )
+        {}
+
+    // 記録なし (off) と記録あり (on) の Update の時間を比べる。書き込みは別スレッドなので、
+    // 差は Capture による姿勢のコピーと、書き込みが追いつかなかった場合の待ち (stalls) だけになるはず
+    // (コアが1つしかない環境では書き込み用のスレッドの時間も含まれる)
+    static void MeasureScene( Bench::Reporter& reporter, rbu32 body_count )
+        {
+            const std::string name = "env/Trajectory/pyramid/" + std::to_string(body_count);
+            if ( !reporter.Enabled(name) )
+                return;
+
+            const char* path = "BMTrajectory.rbtr";
+            const rbReal dt = rbReal(1.0 / 60.0);
+            const rbs32 div = 4;
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+            const rbu32 frames = body_count >= 10000 ? 64 : 256;
+
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = body_count + 1;
+            config.ContactCapacty = 8 * body_count;
+            rbEnvironment env( config );
+
+            std::vector<rbRigidBody> bodies( body_count + 1 );
+            BMEnv::BuildScene( env.Shapes(), BMEnv::Scene_Pyramid, body_count, bodies );
+            for ( rbRigidBody& b : bodies )
+                env.Register( &b );
+
+            auto run = [&]( const char* suffix ) {
+                double elapsed = 0;
+                for ( rbu32 frame = 0; frame < frames; ++frame )
+                {
+                    for ( rbu32 i = 0; i < body_count; ++i )
+                        bodies[i].SetForce( G );
+                    Bench::Timer timer;
+                    env.Update( dt, div );
+                    elapsed += timer.ElapsedNs();
+                }
+                Bench::Result result;
+                result.name = name + suffix;
+                result.iterations = frames;
+                result.ns_per_op = elapsed / frames;
+                result.bodies_per_s = double(body_count) * frames * 1.0e9 / elapsed;
+                reporter.Add( result );
+            };
+
+            // 同じフレームを比べるため、記録ありの計測は記録なしの開始時点から始める
+            rbSnapshot start;
+            env.SaveSnapshot( start );
+            run( "/off" );
+            env.RestoreSnapshot( start );
+
+            rbTrajectoryRecorder recorder;
+            if ( !recorder.Open(path, body_count + 1) )
+            {
+                for ( rbRigidBody& b : bodies )
+                    env.Unregister( &b );
+                return;
+            }
+            env.SetTrajectoryRecorder( &recorder );
+            run( "/on" );
+            env.SetTrajectoryRecorder( nullptr );
+            reporter.AddProperty( name + "/stalls", recorder.StallCount() );
+            recorder.Close();
+
+            // 全フレームを逆順に読み出す (チャンクをまたいだランダムアクセス)
+            rbTrajectoryPlayer player;
+            if ( player.Open(path) )
+            {
+                std::FILE* file = std::fopen( path, "rb" );
+                if ( file != nullptr )
+                {
+                    std::fseek( file, 0, SEEK_END );
+                    reporter.AddProperty( name + "/bytes_per_frame", size_t(std::ftell(file)) / frames );
+                    std::fclose( file );
+                }
+
+                std::vector<rbVec3> positions( player.BodyCount() );
+                std::vector<rbMtx3> orientations( player.BodyCount() );
+                Bench::Timer timer;
+                for ( rbu32 frame = player.FrameCount(); frame-- > 0; )
+                {
+                    player.ReadFrame( frame, positions.data(), orientations.data() );
+                    Bench::DoNotOptimize( positions.data() );
+                }
+                const double elapsed = timer.ElapsedNs();
+
+                Bench::Result result;
+                result.name = name + "/read_frame";
+                result.iterations = player.FrameCount();
+                result.ns_per_op = elapsed / player.FrameCount();
+                result.bodies_per_s = double(body_count + 1) * player.FrameCount() * 1.0e9 / elapsed;
+                reporter.Add( result );
+                player.Close();
+            }
+            std::remove( path );
+
+            for ( rbRigidBody& b : bodies )
+                env.Unregister( &b );
+        }
+
+    virtual void Run( Bench::Reporter& reporter )
+        {
+            MeasureScene( reporter, 1000 );
+            if ( !reporter.GetOptions().quick )
+                MeasureScene( reporter, 10000 );
+        }
+};
+
+#endif
@@ -0,0 +1,56 @@
+// -*- mode: C++; coding: utf-8 -*-
+#include <iostream>
+#include <BenchFramework.h>
+
+#include "BMLayout.h"
+#include "BMMath.h"
+#include "BMCollision.h"
+#include "BMSolver.h"
+#include "BMEnv.h"
+#include "BMSnapshot.h"
+#include "BMTrajectory.h"
+#include "BMScene.h"
+#include "BMQuery.h"
+
+int
+main( int argc, char** argv )
+{
+    Bench::Options options;
+    if ( !options.Parse(argc, argv) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [--quick] [--filter <substring>] [--json <path>] [--no-counters]" << std::endl;
+        return 1;
+    }
+
+    Bench::Reporter reporter( options );
+
+    Bench::Case* bc[] = {
+        new BMLayout( "Layout" ),
+        new BMMath( "Math" ),
+        new BMCollision( "Collision" ),
+        new BMSolver( "Solver" ),
+        new BMEnv( "Env" ),
+        new BMSnapshot( "Snapshot" ),
+        new BMTrajectory( "Trajectory" ),
+        new BMScene( "Scene" ),
+        new BMQuery( "Query" ),
+    };
+
+    for ( size_t i = 0; i < sizeof(bc)/sizeof(bc[0]); ++i )
+    {
+        std::cout << "* Case \"" << bc[i]->Name() << "\" start." << std::endl;
+        bc[i]->Run( reporter );
+    }
+
+    int status = 0;
+    if ( !reporter.WriteJSON() )
+    {
+        std::cerr << "Failed to write " << options.json_path << std::endl;
+        status = 1;
+    }
+
+    for ( size_t i = 0; i < sizeof(bc)/sizeof(bc[0]); ++i )
+        delete bc[i];
+
+    return status;
+}
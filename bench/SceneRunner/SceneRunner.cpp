@@ -0,0 +1,161 @@
+// -*- mode: C++; coding: utf-8 -*-
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <BenchFramework.h>
+
+#include <StackScene.h>
+#include <DominoScene.h>
+#include <CollisionScene.h>
+
+// デモのシーンを画面なしで実行し、時間と最終状態のチェックサムを報告する
+
+struct RunnerOptions
+{
+    std::string scene;
+    // 0 はシーンの既定値
+    rbs32 bodies;
+    rbs32 steps;
+    float dt;
+    rbs32 div;
+    rbs32 threads;
+
+    RunnerOptions()
+        : scene( "all" )
+        , bodies( 0 )
+        , steps( 600 )
+        , dt( 1.0f / 60.0f )
+        , div( 0 )
+        , threads( 1 )
+        {}
+
+    bool Parse( int argc, char** argv )
+        {
+            for ( int i = 1; i < argc; ++i )
+            {
+                if ( i + 1 >= argc )
+                    return false;
+                const char* value = argv[i + 1];
+                if ( std::strcmp(argv[i], "--scene") == 0 )
+                    scene = value;
+                else if ( std::strcmp(argv[i], "--bodies") == 0 )
+                    bodies = std::atoi( value );
+                else if ( std::strcmp(argv[i], "--steps") == 0 )
+                    steps = std::atoi( value );
+                else if ( std::strcmp(argv[i], "--dt") == 0 )
+                    dt = float( std::atof(value) );
+                else if ( std::strcmp(argv[i], "--div") == 0 )
+                    div = std::atoi( value );
+                else if ( std::strcmp(argv[i], "--threads") == 0 )
+                    threads = std::atoi( value );
+                else
+                    return false;
+                ++i;
+            }
+            return bodies >= 0 && steps > 0 && dt > 0 && div >= 0 && threads > 0;
+        }
+};
+
+static bool KnownScene( const std::string& name )
+{
+    return name == "stack" || name == "domino" || name == "collision";
+}
+
+static Scene* CreateScene( const std::string& name, rbs32 bodies, rbs32 div )
+{
+    if ( name == "stack" )
+        return new StackScene( bodies ? bodies : 10, div ? div : 4 );
+    if ( name == "domino" )
+        return new DominoScene( bodies ? bodies : 5, div ? div : 1 );
+    if ( name == "collision" )
+        return new CollisionScene( bodies ? bodies : 2, div ? div : 3 );
+    return nullptr;
+}
+
+struct Instance
+{
+    Scene* scene;
+    double elapsed_ns;
+    unsigned long long checksum;
+};
+
+static void Simulate( Instance* instance, rbs32 steps, float dt )
+{
+    Bench::Timer timer;
+    for ( rbs32 i = 0; i < steps; ++i )
+        instance->scene->Update( dt );
+    instance->elapsed_ns = timer.ElapsedNs();
+    instance->checksum = instance->scene->Environment()->StateHash();
+}
+
+// 同じシーンを threads 個同時に実行する。すべての複製のチェックサムが一致すれば true
+static bool RunScene( const std::string& name, const RunnerOptions& options )
+{
+    std::vector<Instance> instances( options.threads );
+    for ( Instance& instance : instances )
+    {
+        instance.scene = CreateScene( name, options.bodies, options.div );
+        instance.scene->Initialize();
+        instance.scene->Reset();
+    }
+
+    Bench::Timer wall;
+    std::vector<std::thread> workers;
+    for ( size_t i = 1; i < instances.size(); ++i )
+        workers.push_back( std::thread(Simulate, &instances[i], options.steps, options.dt) );
+    Simulate( &instances[0], options.steps, options.dt );
+    for ( std::thread& worker : workers )
+        worker.join();
+    const double wall_ns = wall.ElapsedNs();
+
+    bool consistent = true;
+    double step_ns = 0;
+    for ( const Instance& instance : instances )
+    {
+        consistent = consistent && instance.checksum == instances[0].checksum;
+        step_ns += instance.elapsed_ns / options.steps;
+    }
+    step_ns /= instances.size();
+
+    rbEnvironment* env = instances[0].scene->Environment();
+    char line[256];
+    std::snprintf( line, sizeof(line), "%-10s bodies=%-6u steps=%-6d threads=%-3d %12.1f us/step %12.1f steps/s  checksum=%016llx%s",
+                   name.c_str(), unsigned(env->RigidBodyCount()), options.steps, options.threads,
+                   step_ns * 1.0e-3, double(options.steps) * instances.size() * 1.0e9 / wall_ns,
+                   instances[0].checksum, consistent ? "" : "  MISMATCH" );
+    std::cout << line << std::endl;
+
+    for ( Instance& instance : instances )
+    {
+        instance.scene->Finalize();
+        delete instance.scene;
+    }
+    return consistent;
+}
+
+int
+main( int argc, char** argv )
+{
+    RunnerOptions options;
+    if ( !options.Parse(argc, argv) || (options.scene != "all" && !KnownScene(options.scene)) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [--scene stack|domino|collision|all] [--bodies <count>] [--steps <count>]"
+                  << " [--dt <seconds>] [--div <count>] [--threads <count>]" << std::endl;
+        return 1;
+    }
+
+    const char* scenes[] = { "stack", "domino", "collision" };
+    bool consistent = true;
+    for ( const char* name : scenes )
+    {
+        if ( options.scene == "all" || options.scene == name )
+            consistent = RunScene( name, options ) && consistent;
+    }
+
+    return consistent ? 0 : 1;
+}
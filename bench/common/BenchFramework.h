@@ -0,0 +1,282 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef BENCHFRAMEWORK_H_INCLUDED
+#define BENCHFRAMEWORK_H_INCLUDED
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    //
+    // Bench::DoNotOptimize
+    //
+    // Keeps the compiler from discarding a result that is otherwise unused.
+    //
+    template <typename T>
+    inline void DoNotOptimize( const T& value )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile( "" : : "r,m"(value) : "memory" );
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+
+    //
+    // Bench::Timer
+    //
+    class Timer
+    {
+    public:
+        Timer() : start( std::chrono::steady_clock::now() ) {}
+
+        void Restart() { start = std::chrono::steady_clock::now(); }
+
+        double ElapsedNs() const
+            {
+                return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+            }
+
+    private:
+        std::chrono::steady_clock::time_point start;
+    };
+
+
+    //
+    // Bench::Result
+    //
+    // Rates are left at 0 when they do not apply to the benchmark.
+    //
+    struct Result
+    {
+        std::string name;
+        unsigned long long iterations;
+        double ns_per_op;
+        double pairs_per_s;
+        double bodies_per_s;
+
+        Result()
+            : name()
+            , iterations(0)
+            , ns_per_op(0)
+            , pairs_per_s(0)
+            , bodies_per_s(0)
+            {}
+    };
+
+
+    //
+    // Bench::CounterResult
+    //
+    // Named values derived from hardware counters (see PerfCounters.h), e.g. IPC of one Update phase.
+    //
+    struct CounterResult
+    {
+        std::string name;
+        std::vector< std::pair<std::string, double> > values;
+    };
+
+
+    //
+    // Bench::Options
+    //
+    struct Options
+    {
+        // Minimum measuring time of each benchmark
+        double min_time_ns;
+        // Skip the largest scenes
+        bool quick;
+        // Only run benchmarks whose name contains this string (all if empty)
+        std::string filter;
+        // Write the results to this file as JSON (nothing if empty)
+        std::string json_path;
+        // Capture hardware performance counters where the benchmark supports them
+        bool counters;
+
+        Options()
+            : min_time_ns(2.0e8)
+            , quick(false)
+            , filter()
+            , json_path()
+            , counters(true)
+            {}
+
+        // Returns false on an unknown argument
+        bool Parse( int argc, char** argv )
+            {
+                for ( int i = 1; i < argc; ++i )
+                {
+                    if ( std::strcmp(argv[i], "--quick") == 0 )
+                    {
+                        quick = true;
+                        min_time_ns = 2.0e7;
+                    }
+                    else if ( std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc )
+                        filter = argv[++i];
+                    else if ( std::strcmp(argv[i], "--json") == 0 && i + 1 < argc )
+                        json_path = argv[++i];
+                    else if ( std::strcmp(argv[i], "--no-counters") == 0 )
+                        counters = false;
+                    else
+                        return false;
+                }
+                return true;
+            }
+    };
+
+
+    //
+    // Bench::Reporter
+    //
+    class Reporter
+    {
+    public:
+        Reporter( const Options& options_ )
+            : options( options_ )
+            , results()
+            , counter_results()
+            , properties()
+            {}
+
+        const Options& GetOptions() const { return options; }
+
+        bool Enabled( const std::string& name ) const
+            {
+                return options.filter.empty() || name.find( options.filter ) != std::string::npos;
+            }
+
+        // Calls op() repeatedly (in doubling batches) until Options::min_time_ns has elapsed
+        template <typename Op>
+        Result Measure( const std::string& name, Op&& op )
+            {
+                Result result;
+                result.name = name;
+
+                unsigned long long batch = 1;
+                double elapsed = 0;
+                while ( elapsed < options.min_time_ns )
+                {
+                    Timer timer;
+                    for ( unsigned long long i = 0; i < batch; ++i )
+                        op();
+                    elapsed += timer.ElapsedNs();
+                    result.iterations += batch;
+                    batch *= 2;
+                }
+                result.ns_per_op = elapsed / double(result.iterations);
+                return result;
+            }
+
+        void Add( const Result& result )
+            {
+                results.push_back( result );
+
+                char line[256];
+                std::snprintf( line, sizeof(line), "%-40s %12llu %14.1f ns/op", result.name.c_str(), result.iterations, result.ns_per_op );
+                std::cout << line;
+                if ( result.pairs_per_s > 0 )
+                {
+                    std::snprintf( line, sizeof(line), " %12.3e pairs/s", result.pairs_per_s );
+                    std::cout << line;
+                }
+                if ( result.bodies_per_s > 0 )
+                {
+                    std::snprintf( line, sizeof(line), " %12.3e bodies/s", result.bodies_per_s );
+                    std::cout << line;
+                }
+                std::cout << std::endl;
+            }
+
+        void AddCounters( const CounterResult& result )
+            {
+                counter_results.push_back( result );
+
+                char line[256];
+                std::snprintf( line, sizeof(line), "  %-38s", result.name.c_str() );
+                std::cout << line;
+                for ( size_t i = 0; i < result.values.size(); ++i )
+                {
+                    std::snprintf( line, sizeof(line), " %s=%.4g", result.values[i].first.c_str(), result.values[i].second );
+                    std::cout << line;
+                }
+                std::cout << std::endl;
+            }
+
+        // Records a build/layout property (e.g. sizeof a structure) reported along with the results
+        void AddProperty( const std::string& name, double value )
+            {
+                properties.push_back( std::make_pair(name, value) );
+                std::cout << "# " << name << " = " << value << std::endl;
+            }
+
+        bool WriteJSON() const
+            {
+                if ( options.json_path.empty() )
+                    return true;
+
+                std::ofstream out( options.json_path.c_str() );
+                if ( !out )
+                    return false;
+
+                out << "{\n  \"properties\": {";
+                for ( size_t i = 0; i < properties.size(); ++i )
+                    out << (i ? ",\n" : "\n") << "    \"" << properties[i].first << "\": " << properties[i].second;
+                out << "\n  },\n  \"benchmarks\": [";
+                for ( size_t i = 0; i < results.size(); ++i )
+                {
+                    const Result& r = results[i];
+                    out << (i ? ",\n" : "\n")
+                        << "    { \"name\": \"" << r.name << "\""
+                        << ", \"iterations\": " << r.iterations
+                        << ", \"ns_per_op\": " << r.ns_per_op
+                        << ", \"pairs_per_s\": " << r.pairs_per_s
+                        << ", \"bodies_per_s\": " << r.bodies_per_s << " }";
+                }
+                out << "\n  ],\n  \"counters\": [";
+                for ( size_t i = 0; i < counter_results.size(); ++i )
+                {
+                    const CounterResult& r = counter_results[i];
+                    out << (i ? ",\n" : "\n") << "    { \"name\": \"" << r.name << "\"";
+                    for ( size_t k = 0; k < r.values.size(); ++k )
+                        out << ", \"" << r.values[k].first << "\": " << r.values[k].second;
+                    out << " }";
+                }
+                out << "\n  ]\n}\n";
+                return bool(out);
+            }
+
+    private:
+        const Options& options;
+        std::vector<Result> results;
+        std::vector<CounterResult> counter_results;
+        std::vector< std::pair<std::string, double> > properties;
+    };
+
+
+    //
+    // Bench::Case
+    //
+    class Case
+    {
+    public:
+        Case( const char* name_ ) : name( name_ ) {}
+        virtual ~Case() {}
+
+        const char* Name() { return name; }
+
+        virtual void Run( Reporter& reporter ) = 0;
+
+    private:
+        const char* name;
+    };
+}
+
+#endif
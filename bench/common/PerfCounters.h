@@ -0,0 +1,174 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef PERFCOUNTERS_H_INCLUDED
+#define PERFCOUNTERS_H_INCLUDED
+
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Bench
+{
+    //
+    // Bench::PerfCounters
+    //
+    // Hardware performance counters of the calling thread (user space only), read as one perf_event_open group.
+    // Events the CPU/kernel does not provide are skipped; if none can be opened (non-Linux systems, containers
+    // without perf access, perf_event_paranoid > 2, ...) Available() returns false and Status() tells why.
+    //
+    class PerfCounters
+    {
+    public:
+        enum Event
+        {
+            Event_Cycles,
+            Event_Instructions,
+            Event_L1DMisses,
+            Event_LLCMisses,
+            Event_BranchMisses,
+            EventCount
+        };
+
+        struct Values
+        {
+            unsigned long long value[EventCount];
+
+            Values() { Clear(); }
+
+            void Clear()
+                {
+                    for ( int i = 0; i < EventCount; ++i )
+                        value[i] = 0;
+                }
+        };
+
+        static const char* EventName( int event )
+            {
+                static const char* names[EventCount] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+                return names[event];
+            }
+
+        PerfCounters()
+            : leader( -1 )
+            , opened_count( 0 )
+            , status()
+            {
+                for ( int i = 0; i < EventCount; ++i )
+                {
+                    fd[i] = -1;
+                    slot[i] = -1;
+                }
+                Open();
+            }
+
+        ~PerfCounters()
+            {
+#if defined(__linux__)
+                for ( int i = 0; i < EventCount; ++i )
+                    if ( fd[i] >= 0 )
+                        close( fd[i] );
+#endif
+            }
+
+        PerfCounters( const PerfCounters& ) = delete;
+        PerfCounters& operator =( const PerfCounters& ) = delete;
+
+        bool Available() const { return opened_count > 0; }
+
+        bool Has( int event ) const { return slot[event] >= 0; }
+
+        const std::string& Status() const { return status; }
+
+        // Current (free-running) counts. Events that are not available read as 0.
+        bool Read( Values& values ) const
+            {
+                values.Clear();
+#if defined(__linux__)
+                if ( !Available() )
+                    return false;
+
+                // PERF_FORMAT_GROUP : { nr, value[nr] } in the order the events were opened
+                unsigned long long buffer[1 + EventCount];
+                const ssize_t size = read( leader, buffer, sizeof(buffer) );
+                if ( size < ssize_t(sizeof(unsigned long long)) )
+                    return false;
+                for ( int i = 0; i < EventCount; ++i )
+                    if ( slot[i] >= 0 && unsigned(slot[i]) < buffer[0] )
+                        values.value[i] = buffer[1 + slot[i]];
+                return true;
+#else
+                return false;
+#endif
+            }
+
+    private:
+
+        void Open()
+            {
+#if defined(__linux__)
+                const unsigned long long l1d_read_miss =
+                    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                const struct { unsigned type; unsigned long long config; } events[EventCount] = {
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+                    { PERF_TYPE_HW_CACHE, l1d_read_miss },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+                };
+
+                int first_error = 0;
+                for ( int i = 0; i < EventCount; ++i )
+                {
+                    perf_event_attr attr;
+                    std::memset( &attr, 0, sizeof(attr) );
+                    attr.size = sizeof(attr);
+                    attr.type = events[i].type;
+                    attr.config = events[i].config;
+                    attr.read_format = PERF_FORMAT_GROUP;
+                    attr.disabled = leader < 0 ? 1 : 0;
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv = 1;
+
+                    fd[i] = static_cast<int>( syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0) );
+                    if ( fd[i] < 0 )
+                    {
+                        if ( first_error == 0 )
+                            first_error = errno;
+                        continue;
+                    }
+                    if ( leader < 0 )
+                        leader = fd[i];
+                    slot[i] = opened_count++;
+                }
+
+                if ( Available() )
+                {
+                    ioctl( leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+                    ioctl( leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+                    status = opened_count == EventCount ? "ok" : "partial (some events are not supported)";
+                }
+                else
+                {
+                    status = std::string("unavailable (perf_event_open: ") + std::strerror(first_error) + ")";
+                }
+#else
+                status = "unavailable (perf_event_open is Linux only)";
+#endif
+            }
+
+        int fd[EventCount];
+        // Position of each event in the group read, -1 if it could not be opened
+        int slot[EventCount];
+        int leader;
+        int opened_count;
+        std::string status;
+    };
+}
+
+#endif
@@ -1,9 +1,9 @@
-// -*- mode: C++; coding: utf-8 -*-
-#ifndef DEMOVIEWER_H_INCLUDED
-#define DEMOVIEWER_H_INCLUDED
-
-#include "Application.h"
-#include "Renderer.h"
-#include "Scene.h"
-
-#endif
+// -*- mode: C++; coding: utf-8 -*-
+#ifndef DEMOVIEWER_H_INCLUDED
+#define DEMOVIEWER_H_INCLUDED
+
+#include "Application.h"
+#include "Renderer.h"
+#include "Scene.h"
+
+#endif
@@ -1,20 +1,26 @@
-// -*- mode: C++; coding: utf-8 -*-
-#ifndef DEMOVIEWER_SCENE_H_INCLUDED
-#define DEMOVIEWER_SCENE_H_INCLUDED
-
-class Renderer;
-
-class Scene
-{
-public:
-    Scene() {}
-    virtual ~Scene() {}
-
-    virtual void Initialize() {}
-    virtual void Update( float dt ) =0;
-    virtual void Reset() =0;
-    virtual void Render( Renderer* renderer ) =0;
-    virtual void Finalize() {}
-};
-
-#endif
+// -*- mode: C++; coding: utf-8 -*-
+#ifndef DEMOVIEWER_SCENE_H_INCLUDED
+#define DEMOVIEWER_SCENE_H_INCLUDED
+
+class Renderer;
+class rbEnvironment;
+
+// [LANG en] Scenes only simulate; drawing is left to Render, so that the same scene also runs headless
+// [LANG en] (see bench/SceneRunner).
+// [LANG ja] シーンはシミュレーションのみを行い、描画は Render に任せます。同じシーンを画面なしでも実行できます
+// [LANG ja] (bench/SceneRunner を参照)。
+class Scene
+{
+public:
+    Scene() {}
+    virtual ~Scene() {}
+
+    virtual void Initialize() {}
+    virtual void Update( float dt ) =0;
+    virtual void Reset() =0;
+    virtual rbEnvironment* Environment() =0;
+    virtual void Render( Renderer* renderer ) {}
+    virtual void Finalize() {}
+};
+
+#endif
@@ -0,0 +1,93 @@
+// -*- mode: C++; coding: utf-8 -*-
+#ifndef SCENES_COLLISIONSCENE_H_INCLUDED
+#define SCENES_COLLISIONSCENE_H_INCLUDED
+
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <Scene.h>
+
+// [LANG en] Pairs of boxes thrown at each other, side by side along the z axis (one pair by default)
+// [LANG ja] 互いに投げつける箱の組を z 軸方向に並べたもの (既定では1組)
+class CollisionScene : public Scene
+{
+    rbEnvironment env;
+    std::vector<rbRigidBody> box;
+    rbRigidBody floor;
+    rbs32 div;
+
+public:
+
+    CollisionScene( rbs32 box_count = 2, rbs32 div = 3 )
+        : env()
+        , box( box_count )
+        , floor()
+        , div( div )
+        {
+            for ( rbRigidBody& b : box )
+            {
+                b.SetShapeParameter( env.Shapes(), 10.0f,
+                                     1.0f, 1.0f, 1.0f,
+                                     0.0f, 0.5f );
+                b.EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                env.Register( &b );
+            }
+
+            const rbReal floor_extent = rbMax( rbReal(10), rbReal(3) * rbReal(box.size() / 2) + 2 );
+            floor.SetShapeParameter( env.Shapes(), 10000.0f,
+                                     10.0f, 10.0f, floor_extent,
+                                     0.1f, 0.3f );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+            env.Register( &floor );
+        }
+
+    virtual ~CollisionScene()
+        {
+            env.Unregister( &floor );
+            for ( rbRigidBody& b : box )
+                env.Unregister( &b );
+        }
+
+    virtual rbEnvironment* Environment()
+        {
+            return &env;
+        }
+
+    virtual void Update( float dt )
+        {
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+            for ( rbRigidBody& b : box )
+                b.SetForce( G );
+            env.Update( dt, div );
+        }
+
+    virtual void Reset()
+        {
+            env.ClearContacts();
+            for ( size_t i = 0; i < box.size(); ++i )
+            {
+                const rbReal z = rbReal(3) * rbReal(i / 2) - rbReal(1.5) * rbReal((box.size() - 1) / 2);
+
+                box[i].ResetStatuses();
+                box[i].SetAngularMomentum(0,0,0);
+                if ( i % 2 == 0 )
+                {
+                    box[i].SetPosition( rbReal(-10), rbSqrt(2), z );
+                    box[i].SetOrientation( rbToRad(45), rbToRad(45), 0 );
+                    box[i].SetLinearVelocity( rbReal(10), rbReal(10), 0 );
+                }
+                else
+                {
+                    box[i].SetPosition( rbReal(10), rbReal(1), z );
+                    box[i].SetOrientation( 0, 0, 0 );
+                    box[i].SetLinearVelocity( rbReal(-10), rbReal(10), 0 );
+                }
+            }
+
+            floor.ResetStatuses();
+            floor.SetAngularMomentum( 0, 0, 0 );
+            floor.SetPosition( 0, rbReal(-10), 0 );
+            floor.SetOrientation( 0, 0, 0 );
+        }
+};
+
+#endif
@@ -0,0 +1,108 @@
+// -*- mode: C++; coding: utf-8 -*-
+#ifndef SCENES_DOMINOSCENE_H_INCLUDED
+#define SCENES_DOMINOSCENE_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <Scene.h>
+
+// [LANG en] A spinning box thrown at a row of growing dominoes (the last size is repeated beyond the fourth one)
+// [LANG ja] 回転する箱を、だんだん大きくなるドミノの列に投げつける (5枚目以降は4枚目と同じ大きさ)
+class DominoScene : public Scene
+{
+    rbEnvironment env;
+    std::vector<rbRigidBody> box;
+    rbRigidBody floor;
+    rbs32 div;
+
+    // [LANG en] Size of the i-th domino (box[i + 1])
+    // [LANG ja] i 枚目のドミノ (box[i + 1]) の大きさ
+    static rbReal DominoHalfWidth( rbs32 i )  { return rbReal(0.25) + rbReal(0.05) * std::min( i, 3 ); }
+    static rbReal DominoHalfHeight( rbs32 i ) { return rbReal(1.5) + rbReal(0.5) * std::min( i, 3 ); }
+    static rbReal DominoMass( rbs32 i )       { return rbReal(100) + rbReal(25) * std::min( i, 2 ); }
+
+public:
+
+    DominoScene( rbs32 box_count = 5, rbs32 div = 1 )
+        : env()
+        , box( std::max(box_count, 2) )
+        , floor()
+        , div( div )
+    {
+        box[0].SetShapeParameter(
+            env.Shapes(),
+            10.0f,
+            0.5f, 0.5f, 0.5f,
+            0.5f, 0.5f);
+
+        for (rbs32 i = 1; i < rbs32(box.size()); ++i) {
+            box[i].SetShapeParameter(env.Shapes(),
+                DominoMass(i - 1),
+                DominoHalfWidth(i - 1), DominoHalfHeight(i - 1), 1.0f,
+                0.0f, 0.5f);
+        }
+
+        for (auto& b : box) {
+            b.EnableAttribute(rbRigidBody::Attribute_AutoSleep);
+            env.Register(&b);
+        }
+
+        const rbReal floor_extent = rbMax(rbReal(10), rbReal(3) * rbReal(box.size() - 2) + 1);
+        floor.SetShapeParameter(
+            env.Shapes(),
+            10000.0f,
+            floor_extent, 10.0f, 10.0f,
+            0.0f, 0.8f);
+        floor.EnableAttribute(rbRigidBody::Attribute_Fixed);
+        env.Register(&floor);
+    }
+
+    virtual ~DominoScene()
+    {
+        env.Unregister(&floor);
+        for (auto& b : box) {
+            env.Unregister(&b);
+        }
+    }
+
+    virtual rbEnvironment* Environment()
+    {
+        return &env;
+    }
+
+    virtual void Update( float dt )
+        {
+            const rbVec3 G( 0, 10*rbReal(-9.8), 0 );
+            for (auto& b : box) {
+                b.SetForce(G);
+            }
+            env.Update( dt, div );
+        }
+
+    virtual void Reset()
+    {
+        env.ClearContacts();
+        for (auto& b : box) {
+            b.ResetStatuses();
+            b.SetAngularMomentum(0, 0, 0);
+        }
+
+        box[0].SetPosition(rbReal(-10), rbSqrt(2), 0);
+        box[0].SetOrientation(rbToRad(45), rbToRad(45), 0);
+        box[0].SetLinearVelocity(rbReal(50), rbReal(2.5), 0);
+
+        for (rbs32 i = 1; i < rbs32(box.size()); ++i) {
+            box[i].SetPosition(rbReal(3) * rbReal(i - 1), DominoHalfHeight(i - 1), 0);
+            box[i].SetOrientation(0, 0, 0);
+            box[i].SetLinearVelocity(rbReal(0), rbReal(0), 0);
+        }
+
+        floor.ResetStatuses();
+        floor.SetAngularMomentum(0, 0, 0);
+        floor.SetPosition(0, rbReal(-10), 0);
+        floor.SetOrientation(0, 0, 0);
+    }
+};
+
+#endif
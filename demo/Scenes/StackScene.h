@@ -0,0 +1,123 @@
+// -*- mode: C++; coding: utf-8 -*-
+#ifndef SCENES_STACKSCENE_H_INCLUDED
+#define SCENES_STACKSCENE_H_INCLUDED
+
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <Scene.h>
+
+// [LANG en] Boxes dropped onto the floor in columns of ten (one column by default)
+// [LANG ja] 10個ずつの列に積んで床に落とす箱 (既定では1列)
+class StackScene : public Scene
+{
+    static const rbs32 ColumnHeight = 10;
+
+    rbEnvironment* env;
+    std::vector<rbRigidBody> box;
+    rbRigidBody floor;
+    rbs32 div;
+    rbu32 seed;
+
+    // [LANG en] Fixed linear congruential generator, so that every Reset places the boxes the same way
+    // [LANG ja] Reset のたびに同じ配置になるよう、固定の線形合同法を使う
+    rbReal frand()
+        {
+            seed = seed * 1664525U + 1013904223U;
+            return rbReal(seed >> 8) / rbReal(1 << 24);
+        }
+
+    rbs32 ColumnsPerRow() const
+        {
+            rbs32 columns = 1;
+            while ( columns * columns * ColumnHeight < rbs32(box.size()) )
+                ++columns;
+            return columns;
+        }
+
+public:
+
+    // [LANG en] Increasing 'div' generates too much contact points for one Update() in the 'env', and causes explosion. 3 or 4 is a reasonable choise for this scene.
+    // [LANG ja] 'dev' を増やすと、1回のUpdate()で扱うには多すぎる衝突点が 'env' 内部に生成され、結果として爆発するかのような見た目が効果を生んでしまいます。3または4がこのシーンには適切です。
+    StackScene( rbs32 box_count = 10, rbs32 div = 4 )
+        : env( nullptr )
+        , box( box_count )
+        , floor()
+        , div( div )
+        , seed( 0 )
+        {
+            rbEnvironment::Config config;
+            config.RigidBodyCapacity = box_count + 10;
+            config.ContactCapacty = 10 * box_count;
+            env = new rbEnvironment( config );
+
+            for ( rbRigidBody& b : box )
+            {
+                b.SetShapeParameter( env->Shapes(), 10.0f,
+                                     1.0f, 1.0f, 1.0f,
+                                     0.0f, 0.5f );
+                b.EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                env->Register( &b );
+            }
+
+            const rbReal floor_extent = rbMax( rbReal(10), rbReal(ColumnsPerRow()) * 2 + 2 );
+            floor.SetShapeParameter( env->Shapes(), 10000.0f,
+                                     floor_extent, 10.0f, floor_extent,
+                                     0.1f, 0.3f );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+            env->Register( &floor );
+        }
+
+    virtual ~StackScene()
+        {
+            env->Unregister( &floor );
+
+            for ( rbRigidBody& b : box )
+                env->Unregister( &b );
+
+            delete env;
+        }
+
+    virtual rbEnvironment* Environment()
+        {
+            return env;
+        }
+
+    virtual void Update( float dt )
+        {
+            const rbVec3 G( 0, rbReal(-9.8), 0 );
+
+            for ( rbRigidBody& b : box )
+                b.SetForce( G );
+
+            env->Update( dt, div );
+        }
+
+    virtual void Reset()
+        {
+            env->ClearContacts();
+            seed = 1;
+
+            const rbs32 columns = ColumnsPerRow();
+            for ( rbs32 i = 0; i < rbs32(box.size()); ++i )
+            {
+                const rbs32 column = i / ColumnHeight;
+                const rbs32 level = i % ColumnHeight;
+                const rbReal x = rbReal(column % columns - columns / 2) * 4;
+                const rbReal z = rbReal(column / columns - columns / 2) * 4;
+
+                box[i].ResetStatuses();
+                box[i].SetAngularMomentum(0,0,0);
+
+                box[i].SetPosition( x + frand()-rbReal(0.5), rbReal(2.5) + level * rbReal(4), z + frand()-rbReal(0.5) );
+                box[i].SetOrientation( 0, rbToRad(rbReal(10*level)), 0 );
+                box[i].SetLinearVelocity( 0, 0, 0 );
+            }
+
+            floor.ResetStatuses();
+            floor.SetAngularMomentum( 0, 0, 0 );
+            floor.SetPosition( 0, rbReal(-10), 0 );
+            floor.SetOrientation( 0, 0, 0 );
+        }
+};
+
+#endif
@@ -1 +1 @@
-%HOME%\Programs\cmake\bin\cmake -G "Visual Studio 10" ..
+%HOME%\Programs\cmake\bin\cmake -G "Visual Studio 10" ..
@@ -1,31 +1,44 @@
-// -*- mode: C++; coding: utf-8; -*-
-#pragma once
-
-#include "rbCollision.h"
-#include "rbEnvironment.h"
-#include "rbMath.h"
-#include "rbRigidBody.h"
-#include "rbSolver.h"
-#include "rbTypes.h"
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include "rbBroadPhase.h"
+#include "rbCollision.h"
+#include "rbCompound.h"
+#include "rbContactEvent.h"
+#include "rbConvexHull.h"
+#include "rbDeterministicMath.h"
+#include "rbEnvironment.h"
+#include "rbHeightField.h"
+#include "rbMappedFile.h"
+#include "rbMath.h"
+#include "rbProfiler.h"
+#include "rbRigidBody.h"
+#include "rbScene.h"
+#include "rbShapeLibrary.h"
+#include "rbSnapshot.h"
+#include "rbSolver.h"
+#include "rbTrajectory.h"
+#include "rbTriangleMesh.h"
+#include "rbTypes.h"
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
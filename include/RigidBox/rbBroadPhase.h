@@ -0,0 +1,167 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "rbTypes.h"
+#include "rbMath.h"
+
+// Sweep-and-prune broadphase.
+//
+// [LANG en] Bodies are kept sorted by the lower x-bound of their world AABBs. The order is reused across updates,
+// [LANG en] so the insertion sort only has to fix up the few bodies that passed each other since the last call.
+// [LANG ja] 剛体をワールド座標の AABB の x 方向の下限でソートしておきます。並び順は次回の更新でも再利用されるため、
+// [LANG ja] 挿入ソートは前回から追い越しの起きた少数の剛体を並べ替えるだけで済みます。
+class rbBroadPhase
+{
+public:
+
+    struct Pair
+    {
+        // [LANG en] Indices into the body list, Index[0] < Index[1]
+        // [LANG ja] 剛体リスト内の番号 (Index[0] < Index[1])
+        rbu32 Index[2];
+
+        // [LANG en] Number of contacts found by the narrowphase (filled by rbEnvironment)
+        // [LANG ja] ナローフェーズで見つかった衝突点の数 (rbEnvironment が設定)
+        rbs32 ContactCount;
+    };
+
+    using PairContainer = std::vector<Pair>;
+
+    // [LANG en] Returns false to drop the pair. Called only for pairs that passed the AABB and group/mask tests.
+    // [LANG ja] false を返すとその組を除外します。AABB とグループ/マスクの判定を通過した組に対してのみ呼ばれます。
+    using PairFilter = bool (*)( rbRigidBody* body0, rbRigidBody* body1, void* user_data );
+
+    rbBroadPhase();
+
+    // [LANG en] Recomputes the world AABBs and collects the overlapping pairs, sorted by body index.
+    // [LANG en] Bodies with Attribute_CCD (or every body if +sweep_all+) are swept along their motion over +dt+.
+    // [LANG en] Pairs of fixed/kinematic bodies, pairs rejected by the group/mask test and pairs dropped by the PairFilter are not reported.
+    // [LANG ja] ワールド座標の AABB を計算し直し、重なっている組を剛体の番号順に集めます。
+    // [LANG ja] Attribute_CCD を持つ剛体 (+sweep_all+ の場合は全ての剛体) の AABB は +dt+ 間の移動で掃引します。
+    // [LANG ja] 固定物体/キネマティックな剛体同士の組、グループ/マスクの合わない組、PairFilter が除外した組は報告しません。
+    void Update( const std::vector<rbRigidBody*>& bodies, rbReal dt, bool sweep_all = false );
+
+    // [LANG en] Recomputes the bounds used by Query (unswept world AABBs, see rbRigidBody::ComputeWorldAABB) and their
+    // [LANG en] sorted order, unless they are still up to date. Neither the bodies nor the bounds and order of Update
+    // [LANG en] are touched, so queries never change the simulation.
+    // [LANG ja] Query が使う境界 (掃引しないワールド座標の AABB。rbRigidBody::ComputeWorldAABB を参照) とその並び順を、
+    // [LANG ja] 最新でなければ計算し直します。剛体にも Update の境界と並び順にも触れないので、問い合わせがシミュレーションを
+    // [LANG ja] 変えることはありません。
+    void RefitQueryBounds( const std::vector<rbRigidBody*>& bodies );
+
+    // [LANG en] Marks the query bounds out of date (the bodies moved or the body list changed)
+    // [LANG ja] 問い合わせ用の境界を古いものとします (剛体が動いた、または剛体のリストが変わった)
+    void InvalidateQueryBounds()
+        { query_bounds_valid = false; }
+
+    // [LANG en] Replaces the sorted order with +body_order+, a permutation of the indices of +body_count+ bodies sorted
+    // [LANG en] by the lower x-bound of their world AABBs (e.g. baked into an rbScene file). A stale order is only slower :
+    // [LANG en] the next Update fixes it up.
+    // [LANG ja] 並び順を +body_order+ (+body_count+ 個の剛体の番号をワールド座標の AABB の x 方向の下限でソートした順列。
+    // [LANG ja] rbScene のファイルに保存したもの等) で置き換えます。並び順が古くても遅くなるだけです (次の Update で修正されます)。
+    void SetOrder( const rbu32* body_order, rbu32 body_count );
+
+    void SetPairFilter( PairFilter filter, void* user_data )
+        {
+            pair_filter = filter;
+            pair_filter_user_data = user_data;
+        }
+
+    const rbAABB& Bounds( rbu32 body_index ) const
+        { return bounds[body_index]; }
+
+    const rbAABB& QueryBounds( rbu32 body_index ) const
+        { return query_bounds[body_index]; }
+
+    // [LANG en] Largest x-width among the bodies of the sorted scan (see Query)
+    // [LANG ja] ソート済みの走査の対象となる剛体の x 方向の幅の最大値 (Query を参照)
+    rbReal QueryReach() const
+        { return query_reach; }
+
+    // [LANG en] Calls visitor(body_index) for every body whose query bounds (see RefitQueryBounds) overlap +aabb+.
+    // [LANG en] Bodies much wider than the rest (floors, terrain) are visited first. The others are sorted by their lower
+    // [LANG en] x-bound and none is wider than query_reach, so a binary search finds the first one that can reach
+    // [LANG en] aabb.lower.x and the scan stops at the first one starting beyond aabb.upper.x.
+    // [LANG ja] 問い合わせ用の境界 (RefitQueryBounds を参照) が +aabb+ と重なる剛体ごとに visitor(body_index) を呼びます。
+    // [LANG ja] 他よりはるかに大きい剛体 (床や地形) を先に訪れます。それ以外は x 方向の下限でソートされ、幅が query_reach を
+    // [LANG ja] 超えないので、aabb.lower.x に届きうる最初の剛体を二分探索で求め、下限が aabb.upper.x を超える剛体に
+    // [LANG ja] 達した時点で走査を打ち切ります。
+    template <typename Visitor>
+    void Query( const rbAABB& aabb, Visitor&& visitor ) const
+        {
+            for ( rbu32 index : query_wide )
+            {
+                if ( aabb.Overlaps(query_bounds[index]) )
+                    visitor( index );
+            }
+
+            const rbReal start_x = aabb.lower.x - query_reach;
+            const rbu32* first = std::lower_bound( query_order.data(), query_order.data() + query_order.size(), start_x,
+                [this](rbu32 index, rbReal x) { return query_bounds[index].lower.x < x; } );
+            const rbu32* last = query_order.data() + query_order.size();
+            for ( const rbu32* it = first; it != last && query_bounds[*it].lower.x <= aabb.upper.x; ++it )
+            {
+                const rbAABB& bounds = query_bounds[*it];
+                if ( bounds.upper.x - bounds.lower.x <= query_reach && aabb.Overlaps(bounds) )
+                    visitor( *it );
+            }
+        }
+
+    PairContainer& Pairs()
+        { return pairs; }
+
+private:
+
+    void ComputeBounds( const std::vector<rbRigidBody*>& bodies, rbReal dt, bool sweep_all );
+    static void SortByLowerX( const std::vector<rbAABB>& body_bounds, std::vector<rbu32>& body_order );
+
+    // [LANG en] Copied from the bodies in ComputeBounds, so the pair loop rejects pairs without touching rbRigidBody
+    // [LANG ja] ComputeBounds で剛体から写しておき、組の走査中に rbRigidBody へアクセスせずに除外できるようにする
+    struct FilterData
+    {
+        rbu32 group;
+        rbu32 mask;
+        rbu32 fixed;
+    };
+
+    std::vector<rbAABB> bounds;
+    std::vector<FilterData> filters;
+    std::vector<rbu32> order;
+    PairContainer pairs;
+    PairFilter pair_filter;
+    void* pair_filter_user_data;
+
+    // [LANG en] Kept apart from the bounds and order of Update, which are swept and only valid during the step.
+    // [LANG en] query_order holds every body, query_wide the ones wider than query_reach along x.
+    // [LANG ja] Update の境界と並び順 (掃引され、ステップ中のみ有効) とは別に保持する。
+    // [LANG ja] query_order は全ての剛体を、query_wide は x 方向の幅が query_reach を超える剛体を保持する。
+    std::vector<rbAABB> query_bounds;
+    std::vector<rbu32> query_order;
+    std::vector<rbu32> query_wide;
+    rbReal query_reach;
+    bool query_bounds_valid;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
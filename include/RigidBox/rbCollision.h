@@ -1,77 +1,155 @@
-// -*- mode: C++; coding: utf-8; -*-
-#pragma once
-
-#include "rbTypes.h"
-#include "rbMath.h"
-#include <vector>
-
-struct rbContact
-{
-    rbVec3 Position;
-    rbVec3 RelativeBodyPosition[2];
-    rbRigidBody* Body[2];
-
-    // [LANG en] We will assume the direction of Normal is always from Body[1] to Body[0]. rbCollision::Detect implements this convention.
-    // [LANG ja] Normal の向きは常に Body[1] -> Body[0] であるものとします。このルールは rbCollision::Detect で実装されています。
-    rbVec3 Normal;
-
-    rbReal PenetrationDepth;
-
-    rbContact() = default;
-
-    rbContact(const rbContact& other)
-        : Position(other.Position)
-        , RelativeBodyPosition{ other.RelativeBodyPosition[0], other.RelativeBodyPosition[1] }
-        , Body{ other.Body[0], other.Body[1] }
-        , Normal(other.Normal)
-        , PenetrationDepth(other.PenetrationDepth)
-    {}
-
-    rbContact& operator =(const rbContact& other)
-    {
-        if (this != &other)
-        {
-            Position = other.Position;
-            RelativeBodyPosition[0] = other.RelativeBodyPosition[0];
-            RelativeBodyPosition[1] = other.RelativeBodyPosition[1];
-            Body[0] = other.Body[0];
-            Body[1] = other.Body[1];
-            Normal = other.Normal;
-            PenetrationDepth = other.PenetrationDepth;
-        }
-
-        return *this;
-    }
-};
-
-// Collision detection algorithm
-class rbCollision
-{
-public:
-
-    static rbs32 Detect( rbRigidBody* box0, rbRigidBody* box1, rbContact* contact_out );
-
-    static rbs32 Detect(rbRigidBody* box0, rbRigidBody* box1, std::vector<rbContact>& contacts_out);
-};
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include "rbTypes.h"
+#include "rbMath.h"
+#include <vector>
+
+struct rbContact
+{
+    rbVec3 Position;
+    rbVec3 RelativeBodyPosition[2];
+    rbRigidBody* Body[2];
+
+    // [LANG en] We will assume the direction of Normal is always from Body[1] to Body[0]. rbCollision::Detect implements this convention.
+    // [LANG ja] Normal の向きは常に Body[1] -> Body[0] であるものとします。このルールは rbCollision::Detect で実装されています。
+    rbVec3 Normal;
+
+    // [LANG en] Negative for speculative contacts (minus the gap between the bodies, see rbCollision::DetectSpeculative).
+    // [LANG ja] 予測的な衝突点では負の値 (剛体間の隙間の符号を反転した値。rbCollision::DetectSpeculative を参照)。
+    rbReal PenetrationDepth;
+
+    rbContact() = default;
+
+    rbContact(const rbContact& other)
+        : Position(other.Position)
+        , RelativeBodyPosition{ other.RelativeBodyPosition[0], other.RelativeBodyPosition[1] }
+        , Body{ other.Body[0], other.Body[1] }
+        , Normal(other.Normal)
+        , PenetrationDepth(other.PenetrationDepth)
+    {}
+
+    rbContact& operator =(const rbContact& other)
+    {
+        if (this != &other)
+        {
+            Position = other.Position;
+            RelativeBodyPosition[0] = other.RelativeBodyPosition[0];
+            RelativeBodyPosition[1] = other.RelativeBodyPosition[1];
+            Body[0] = other.Body[0];
+            Body[1] = other.Body[1];
+            Normal = other.Normal;
+            PenetrationDepth = other.PenetrationDepth;
+        }
+
+        return *this;
+    }
+};
+
+// [LANG en] Line segment from Origin to Origin + Direction. Hits are reported as a fraction of Direction.
+// [LANG ja] Origin から Origin + Direction までの線分。交差位置は Direction に対する比率で表します。
+struct rbRay
+{
+    rbVec3 Origin;
+    rbVec3 Direction;
+
+    rbRay() = default;
+
+    rbRay( const rbVec3& origin, const rbVec3& direction )
+        : Origin(origin)
+        , Direction(direction)
+    {}
+};
+
+struct rbRayHit
+{
+    // [LANG en] nullptr if nothing was hit
+    // [LANG ja] 何にも当たらなかった場合は nullptr
+    rbRigidBody* Body;
+
+    rbReal Fraction;
+    rbVec3 Position;
+
+    // [LANG en] Surface normal at Position, facing against the ray (or the cast shape)
+    // [LANG ja] Position における表面の法線 (レイまたは移動させた形状に向かう向き)
+    rbVec3 Normal;
+};
+
+// Collision detection algorithm
+class rbCollision
+{
+public:
+
+    // [LANG en] Upper bound of contacts generated for one pair (mesh pairs may produce several).
+    // [LANG ja] 1組の剛体から生成される衝突点の上限 (メッシュとの組は複数の衝突点を生成しうる)
+    static const rbs32 MaxContactsPerPair = 4;
+
+    // [LANG en] Writes at most +contact_capacity+ contacts into +contact_out+ and returns the count.
+    // [LANG en] With +update_support_cache+ == false, convex hulls start their support searches from a copy of
+    // [LANG en] rbRigidBody::SupportVertexCache and the bodies are left untouched (used by the queries of rbEnvironment).
+    // [LANG ja] 最大 +contact_capacity+ 個の衝突点を +contact_out+ に書き込み、その個数を返します。
+    // [LANG ja] +update_support_cache+ が false の場合、凸包のサポート点探索は rbRigidBody::SupportVertexCache のコピーから
+    // [LANG ja] 始め、剛体には書き込みません (rbEnvironment の問い合わせが使用)。
+    static rbs32 Detect( rbRigidBody* box0, rbRigidBody* box1, rbContact* contact_out, rbs32 contact_capacity = 1,
+                         bool update_support_cache = true );
+
+    static rbs32 Detect(rbRigidBody* box0, rbRigidBody* box1, std::vector<rbContact>& contacts_out);
+
+    // [LANG en] Boolean overlap test : stops at the first separating axis and builds no contact.
+    // [LANG ja] 重なりの有無のみの判定 : 最初に見つかった分離軸で打ち切り、衝突点は生成しません。
+    static bool Overlap( rbRigidBody* body0, rbRigidBody* body1 );
+
+    // [LANG en] Also reports pairs separated by a gap smaller than +margin+. Their contacts are speculative :
+    // [LANG en] PenetrationDepth holds minus the gap, and Normal/Position describe the closest features along the separating axis.
+    // [LANG ja] +margin+ 未満の隙間で離れている組も報告します。これらは予測的な衝突点です :
+    // [LANG ja] PenetrationDepth には隙間の符号を反転した値が入り、Normal/Position は分離軸に沿った最近接の特徴を表します。
+    static rbs32 DetectSpeculative( rbRigidBody* body0, rbRigidBody* body1, rbReal margin, rbContact* contacts_out, rbs32 contact_capacity = 1 );
+
+    // [LANG en] Closest hit of +ray+ against +body+ closer than +max_fraction+. Rays starting inside a convex part are ignored,
+    // [LANG en] and triangles of meshes/heightfields are hit from both sides.
+    // [LANG ja] +max_fraction+ より手前で +ray+ が +body+ と交差する最初の位置を求めます。凸形状の内部から出るレイは無視し、
+    // [LANG ja] メッシュ/高さ場の三角形は両面とも判定します。
+    static bool RayCast( rbRigidBody* body, const rbRay& ray, rbReal max_fraction, rbRayHit& hit_out );
+
+    // [LANG en] Moves +body+ along +displacement+ against the motionless +target+ (conservative advancement, see TimeOfImpact)
+    // [LANG en] and returns the fraction of +displacement+ at which it touches +target+ within +target_depth+.
+    // [LANG en] +body+ is posed along the way and put back; +target+ is never posed. +update_support_cache+ works as in Detect.
+    // [LANG ja] 静止した +target+ に向けて +body+ を +displacement+ だけ動かし (保守的前進法。TimeOfImpact を参照)、
+    // [LANG ja] +target_depth+ 以内で接触する時点を +displacement+ に対する比率で返します。
+    // [LANG ja] +body+ は途中の姿勢に動かしてから元に戻し、+target+ は動かしません。+update_support_cache+ は Detect と同様です。
+    static bool ShapeCast( rbRigidBody* body, const rbVec3& displacement, rbRigidBody* target, rbReal target_depth, rbReal& fraction_out,
+                           bool update_support_cache = true );
+
+    static const rbs32 MaxTOIIterations = 32;
+
+    // [LANG en] Conservative advancement along the current velocities. If the bodies collide within +dt+, returns true and
+    // [LANG en] the time of impact in +toi_out+; at that time they overlap by a depth in [target_depth / 4, target_depth / 2]
+    // [LANG en] (bodies overlapping from the start are reported once they sink that much further).
+    // [LANG en] The poses of the bodies are restored before returning.
+    // [LANG ja] 現在の速度に沿った保守的前進法。+dt+ 以内に衝突する場合は true を返し、衝突時刻を +toi_out+ に設定します。
+    // [LANG ja] その時刻には [target_depth / 4, target_depth / 2] の深さで重なっています (最初から重なっている場合は、
+    // [LANG ja] そこからさらにその深さだけめり込む時刻を返します)。剛体の姿勢は元に戻してから返ります。
+    static bool TimeOfImpact( rbRigidBody* body0, rbRigidBody* body1, rbReal dt, rbReal target_depth, rbReal& toi_out );
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
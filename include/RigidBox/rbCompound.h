@@ -0,0 +1,160 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbTypes.h"
+#include "rbMath.h"
+
+// Union of boxes shared by any number of rbRigidBody instances.
+//
+// [LANG en] Each child box has its own mass and a transform relative to the compound. Build() computes the combined
+// [LANG en] mass, center of mass and inertia, and moves the children so that they are relative to the center of mass
+// [LANG en] (the same convention as rbConvexHull). A small AABB tree over the children lets rbCollision test only
+// [LANG en] the children that overlap the other body.
+// [LANG ja] 子の直方体はそれぞれ質量と、複合形状に対する相対的な姿勢・位置を持ちます。Build() は全体の質量・重心・
+// [LANG ja] 慣性テンソルを計算し、子の位置を重心からの相対位置へ移します (rbConvexHull と同じ約束)。
+// [LANG ja] 子を囲む小さな AABB ツリーにより、rbCollision は相手の剛体と重なる子だけを判定します。
+class rbCompound
+{
+public:
+
+    struct Child
+    {
+        rbVec3 half_extent;
+        rbVec3 position;
+        rbMtx3 orientation;
+        rbReal mass;
+
+        Child()
+            : half_extent(rbReal(1), rbReal(1), rbReal(1))
+            , position(0, 0, 0)
+            , orientation(rbReal(1), 0, 0,
+                          0, rbReal(1), 0,
+                          0, 0, rbReal(1))
+            , mass(rbReal(1))
+            {}
+    };
+
+    // [LANG en] Nodes are stored in depth-first order (see rbTriangleMesh::QuantizedNode); bounds are not quantized
+    // [LANG en] since compounds have only a handful of children.
+    // [LANG ja] ノードは深さ優先順に並びます (rbTriangleMesh::QuantizedNode を参照)。子の数は少ないので境界は量子化しません。
+    struct Node
+    {
+        rbVec3 aabb_min;
+        rbVec3 aabb_max;
+
+        // [LANG en] leaf : child index (>= 0), internal : -(number of nodes in the subtree)
+        // [LANG ja] 葉 : 子の番号 (>= 0)、内部ノード : -(部分木のノード数)
+        rbs32 escape_index_or_child_index;
+
+        bool IsLeaf() const
+            { return escape_index_or_child_index >= 0; }
+    };
+
+    rbCompound();
+
+    // [LANG en] Returns false if there is no child, or if any child has a non-positive mass or half-extent.
+    // [LANG ja] 子がない場合、または質量・half-extent が正でない子がある場合は false を返します。
+    bool Build( const Child* children, rbu32 child_count );
+
+    void Clear();
+
+    bool Valid() const
+        { return !children.empty(); }
+
+    rbu32 ChildCount() const
+        { return static_cast<rbu32>(children.size()); }
+
+    // [LANG en] Position is relative to the center of mass.
+    // [LANG ja] 位置は重心からの相対位置です。
+    const Child& GetChild( rbu32 index ) const
+        { return children[index]; }
+
+    rbu32 NodeCount() const
+        { return static_cast<rbu32>(nodes.size()); }
+
+    const Node& GetNode( rbu32 index ) const
+        { return nodes[index]; }
+
+    rbReal Mass() const
+        { return mass; }
+
+    rbVec3 CenterOfMass() const
+        { return center_of_mass; }
+
+    // [LANG en] Inertia tensor about the center of mass.
+    // [LANG ja] 重心まわりの慣性テンソル。
+    rbMtx3 Inertia() const
+        { return inertia; }
+
+    // [LANG en] Symmetric half-extent around the center of mass that bounds every child.
+    // [LANG ja] 重心を中心として全ての子を包む half-extent。
+    rbVec3 HalfExtent() const
+        { return half_extent; }
+
+    // [LANG en] Calls visitor(child_index) for every child whose bounds overlap [aabb_min, aabb_max] (compound-local).
+    // [LANG ja] [aabb_min, aabb_max] (複合形状のローカル座標) と境界が重なる子ごとに visitor(child_index) を呼びます。
+    template <typename Visitor>
+    void Query( const rbVec3& aabb_min, const rbVec3& aabb_max, Visitor&& visitor ) const
+        {
+            const rbs32 node_count = static_cast<rbs32>(nodes.size());
+            rbs32 i = 0;
+            while ( i < node_count )
+            {
+                const Node& node = nodes[i];
+                bool overlap =
+                    (aabb_min.x <= node.aabb_max.x) & (aabb_max.x >= node.aabb_min.x) &
+                    (aabb_min.y <= node.aabb_max.y) & (aabb_max.y >= node.aabb_min.y) &
+                    (aabb_min.z <= node.aabb_max.z) & (aabb_max.z >= node.aabb_min.z);
+
+                if ( node.IsLeaf() )
+                {
+                    if ( overlap )
+                        visitor( static_cast<rbu32>(node.escape_index_or_child_index) );
+                    ++i;
+                }
+                else
+                {
+                    i += overlap ? 1 : -node.escape_index_or_child_index;
+                }
+            }
+        }
+
+private:
+
+    rbs32 BuildNode( std::vector<rbu32>& order, rbu32 begin, rbu32 end );
+
+    std::vector<Child> children;
+    std::vector<Node> nodes;
+
+    // [LANG en] Half-extent of the axis-aligned box bounding each child (compound-local)
+    // [LANG ja] 各子を包む軸平行な直方体の half-extent (複合形状のローカル座標)
+    std::vector<rbVec3> child_bounds;
+
+    rbReal mass;
+    rbVec3 center_of_mass;
+    rbVec3 half_extent;
+    rbMtx3 inertia;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,97 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbTypes.h"
+#include "rbMath.h"
+
+// [LANG en] A pair of bodies started, kept or stopped touching during an rbEnvironment::Update.
+// [LANG ja] rbEnvironment::Update の間に2つの剛体の接触が開始・継続・終了したことを表します。
+struct rbContactEvent
+{
+    static const rbu32 Type_Begin   = 0;
+    static const rbu32 Type_Persist = 1;
+    static const rbu32 Type_End     = 2;
+
+    rbu32 Type;
+
+    // [LANG en] Handle of the touching pair : assigned at Type_Begin and kept until Type_End
+    // [LANG ja] 接触している組のハンドル : Type_Begin で割り当てられ、Type_End まで変わりません
+    rbu32 PairId;
+
+    rbRigidBody* Body[2];
+
+    // [LANG en] Largest normal impulse applied to the pair's contacts during the Update (0 for Type_End)
+    // [LANG ja] Update の間にこの組の衝突点に加えられた法線方向の力積の最大値 (Type_End では 0)
+    rbReal MaxImpulse;
+
+    // [LANG en] Average contact normal, from Body[1] to Body[0] (the last known one for Type_End)
+    // [LANG ja] 衝突点の法線の平均 (Body[1] -> Body[0]。Type_End では最後に得られた値)
+    rbVec3 Normal;
+};
+
+// Fixed-capacity ring buffer of rbContactEvent.
+//
+// [LANG en] The environment pushes events as plain data and the application drains them in bulk once per frame;
+// [LANG en] events pushed while the buffer is full are dropped and counted.
+// [LANG ja] 環境はイベントを単純なデータとして書き込み、アプリケーションはフレームごとに一括で読み出します。
+// [LANG ja] バッファが一杯のときに書き込まれたイベントは破棄し、その数を数えておきます。
+class rbContactEventQueue
+{
+public:
+
+    rbContactEventQueue();
+
+    // [LANG en] Discards pending events. The capacity is rounded up to a power of two; 0 disables the queue.
+    // [LANG ja] 未読のイベントを破棄します。容量は2のべき乗に切り上げます。0 の場合はキューを無効にします。
+    void Reserve( rbu32 capacity );
+
+    rbu32 Capacity() const
+        { return static_cast<rbu32>(events.size()); }
+
+    rbu32 Count() const
+        { return write_count - read_count; }
+
+    rbu32 OverflowCount() const
+        { return overflow_count; }
+
+    // [LANG en] Returns false (and counts an overflow) if the queue is full.
+    // [LANG ja] キューが一杯の場合は false を返します (溢れた数として数えます)。
+    bool Push( const rbContactEvent& event );
+
+    // [LANG en] Moves at most +max_count+ events, oldest first, into +events_out+ and returns the count.
+    // [LANG ja] 古いものから最大 +max_count+ 個のイベントを +events_out+ へ移し、その個数を返します。
+    rbu32 Drain( rbContactEvent* events_out, rbu32 max_count );
+
+private:
+
+    std::vector<rbContactEvent> events;
+
+    // [LANG en] Free-running counters; the slot is counter & (capacity - 1)
+    // [LANG ja] 単調増加するカウンター。格納位置は counter & (capacity - 1)
+    rbu32 read_count;
+    rbu32 write_count;
+    rbu32 overflow_count;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,120 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbTypes.h"
+#include "rbMath.h"
+
+// Convex polyhedron shared by any number of rbRigidBody instances.
+//
+// [LANG en] The vertices are stored relative to the center of mass, so that rbRigidBody::Position() keeps its
+// [LANG en] 'center-of-mass position' meaning. The offset subtracted from the input points is kept in CenterOfMass().
+// [LANG ja] 頂点は重心からの相対位置として保持します (rbRigidBody::Position() が重心位置を表すという約束を守るため)。
+// [LANG ja] 入力点から差し引いたオフセットは CenterOfMass() で取得できます。
+class rbConvexHull
+{
+public:
+
+    rbConvexHull();
+
+    // [LANG en] Builds the hull of the given point cloud. Returns false if the points are degenerate (coplanar, etc.).
+    // [LANG ja] 与えられた点群の凸包を構築します。点群が縮退している(同一平面上にある等)場合は false を返します。
+    bool Build( const rbVec3* points, rbu32 point_count );
+
+    void Clear();
+
+    bool Valid() const
+        { return !vertices.empty(); }
+
+    rbu32 VertexCount() const
+        { return static_cast<rbu32>(vertices.size()); }
+
+    const rbVec3& Vertex( rbu32 index ) const
+        { return vertices[index]; }
+
+    rbu32 FaceCount() const
+        { return static_cast<rbu32>(face_normals.size()); }
+
+    const rbVec3& FaceNormal( rbu32 index ) const
+        { return face_normals[index]; }
+
+    rbu32 EdgeDirectionCount() const
+        { return static_cast<rbu32>(edge_directions.size()); }
+
+    const rbVec3& EdgeDirection( rbu32 index ) const
+        { return edge_directions[index]; }
+
+    rbu32 NeighborCount( rbu32 vertex ) const
+        { return adjacency_offset[vertex + 1] - adjacency_offset[vertex]; }
+
+    rbVec3 CenterOfMass() const
+        { return center_of_mass; }
+
+    rbReal Volume() const
+        { return volume; }
+
+    // [LANG en] Symmetric half-extent around the center of mass that bounds every vertex.
+    // [LANG ja] 重心を中心として全頂点を包む half-extent。
+    rbVec3 HalfExtent() const
+        { return half_extent; }
+
+    // [LANG en] Inertia tensor (about the center of mass) for the given mass, assuming uniform density.
+    // [LANG ja] 密度一様と仮定した場合の、重心まわりの慣性テンソル。
+    rbMtx3 Inertia( rbReal mass ) const
+        { return unit_inertia * mass; }
+
+    // [LANG en] Hill-climbing support mapping. +start+ is the vertex index returned by the previous query
+    // [LANG en] (any valid index works); coherent queries typically finish after a step or two.
+    // [LANG ja] 山登り法によるサポート写像。+start+ には前回の問い合わせ結果の頂点番号を渡します
+    // [LANG ja] (任意の有効な番号でも可)。方向の変化が小さければ 1, 2 ステップで収束します。
+    // [LANG en] A hull that is not Valid() has no vertex : SupportIndex returns 0 and Support the origin.
+    // [LANG ja] Valid() でない凸包には頂点がないため、SupportIndex は 0 を、Support は原点を返します。
+    rbu32 SupportIndex( const rbVec3& direction, rbu32 start ) const;
+
+    rbVec3 Support( const rbVec3& direction, rbu32& start ) const
+        {
+            start = SupportIndex( direction, start );
+            return vertices.empty() ? rbVec3( 0, 0, 0 ) : vertices[start];
+        }
+
+private:
+
+    std::vector<rbVec3> vertices;
+
+    // [LANG en] Vertex adjacency in CSR layout : neighbors of vertex i are adjacency[adjacency_offset[i] .. adjacency_offset[i+1]).
+    // [LANG ja] CSR 形式の頂点隣接情報 : 頂点 i の隣接頂点は adjacency[adjacency_offset[i] .. adjacency_offset[i+1]) 。
+    std::vector<rbu32> adjacency_offset;
+    std::vector<rbu32> adjacency;
+
+    // [LANG en] Candidate axes for the separating-axis test (parallel duplicates are removed).
+    // [LANG ja] 分離軸テストの候補軸 (平行なものは除去済み)。
+    std::vector<rbVec3> face_normals;
+    std::vector<rbVec3> edge_directions;
+
+    rbVec3 center_of_mass;
+    rbVec3 half_extent;
+    rbReal volume;
+    rbMtx3 unit_inertia;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
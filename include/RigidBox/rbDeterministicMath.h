@@ -0,0 +1,187 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <cmath>
+
+// Portable implementations of the transcendental functions (see RIGIDBOX_DETERMINISTIC in rbTypes.h).
+//
+// [LANG en] Built only from +, -, *, /, sqrt and floor, whose results IEEE 754 defines exactly, so they return the same
+// [LANG en] bits on every conforming platform as long as the compiler does not contract a*b+c into FMA instructions.
+// [LANG en] Evaluated in double precision (a few ulps of double) and rounded once to the caller's type.
+// [LANG en] The range reduction of sin/cos/tan loses accuracy (but not reproducibility) for |x| > 1e6.
+// [LANG ja] IEEE 754 が結果を厳密に定める +, -, *, /, sqrt, floor のみで構成しているので、コンパイラが a*b+c を FMA 命令に
+// [LANG ja] まとめない限り、規格に従う全ての環境で同じビット列を返します。
+// [LANG ja] 倍精度で計算し (誤差は倍精度で数 ulp)、呼び出し側の型へ1回だけ丸めます。
+// [LANG ja] sin/cos/tan の引数の範囲縮小は |x| > 1e6 で精度が落ちます (再現性は保たれます)。
+
+// [LANG en] Taylor series of sin/cos on [-pi/4, pi/4] (truncation error below 1e-18)
+// [LANG ja] [-pi/4, pi/4] における sin/cos のテイラー級数 (打ち切り誤差は 1e-18 未満)
+inline double rbDeterministicSinKernel( double r )
+{
+    const double r2 = r * r;
+    double p = 1.0 / 355687428096000.0;      // 1/17!
+    p = p * r2 - 1.0 / 1307674368000.0;      // 1/15!
+    p = p * r2 + 1.0 / 6227020800.0;         // 1/13!
+    p = p * r2 - 1.0 / 39916800.0;           // 1/11!
+    p = p * r2 + 1.0 / 362880.0;             // 1/9!
+    p = p * r2 - 1.0 / 5040.0;               // 1/7!
+    p = p * r2 + 1.0 / 120.0;                // 1/5!
+    p = p * r2 - 1.0 / 6.0;                  // 1/3!
+    return r + r * r2 * p;
+}
+
+inline double rbDeterministicCosKernel( double r )
+{
+    const double r2 = r * r;
+    double p = -1.0 / 6402373705728000.0;    // 1/18!
+    p = p * r2 + 1.0 / 20922789888000.0;     // 1/16!
+    p = p * r2 - 1.0 / 87178291200.0;        // 1/14!
+    p = p * r2 + 1.0 / 479001600.0;          // 1/12!
+    p = p * r2 - 1.0 / 3628800.0;            // 1/10!
+    p = p * r2 + 1.0 / 40320.0;              // 1/8!
+    p = p * r2 - 1.0 / 720.0;                // 1/6!
+    p = p * r2 + 1.0 / 24.0;                 // 1/4!
+    return 1.0 - 0.5 * r2 + r2 * r2 * p;
+}
+
+// [LANG en] x = k * pi/2 + r with |r| <= pi/4 (Cody-Waite : pi/2 is split in three parts whose products with k are exact).
+// [LANG en] Returns r and writes k mod 4 to +quadrant+.
+// [LANG ja] x = k * pi/2 + r (|r| <= pi/4) と分解します (Cody-Waite 法 : pi/2 を k との積が厳密になる3つの部分に分割)。
+// [LANG ja] r を返し、k mod 4 を +quadrant+ に書き込みます。
+inline double rbDeterministicReduce( double x, int& quadrant )
+{
+    const double pio2_1 = 1.57079632673412561417e+00;
+    const double pio2_2 = 6.07710050630396597660e-11;
+    const double pio2_3 = 2.02226624871116645580e-21;
+    const double k = std::floor( x * 0.63661977236758134308 + 0.5 );
+    quadrant = static_cast<int>( static_cast<long long>(k) & 3 );
+    return ((x - k * pio2_1) - k * pio2_2) - k * pio2_3;
+}
+
+inline double rbDeterministicSin( double x )
+{
+    if ( !(x - x == 0) )
+        return x - x; // NaN for NaN and infinities
+
+    int quadrant;
+    const double r = rbDeterministicReduce( x, quadrant );
+    switch ( quadrant )
+    {
+    case 0: return  rbDeterministicSinKernel( r );
+    case 1: return  rbDeterministicCosKernel( r );
+    case 2: return -rbDeterministicSinKernel( r );
+    default: return -rbDeterministicCosKernel( r );
+    }
+}
+
+inline double rbDeterministicCos( double x )
+{
+    if ( !(x - x == 0) )
+        return x - x;
+
+    int quadrant;
+    const double r = rbDeterministicReduce( x, quadrant );
+    switch ( quadrant )
+    {
+    case 0: return  rbDeterministicCosKernel( r );
+    case 1: return -rbDeterministicSinKernel( r );
+    case 2: return -rbDeterministicCosKernel( r );
+    default: return  rbDeterministicSinKernel( r );
+    }
+}
+
+inline double rbDeterministicTan( double x )
+{
+    if ( !(x - x == 0) )
+        return x - x;
+
+    int quadrant;
+    const double r = rbDeterministicReduce( x, quadrant );
+    const double s = rbDeterministicSinKernel( r );
+    const double c = rbDeterministicCosKernel( r );
+    return (quadrant & 1) ? -c / s : s / c;
+}
+
+inline double rbDeterministicAtan( double x )
+{
+    if ( x != x || x == 0 )
+        return x;
+
+    const double pio2 = 1.57079632679489661923;
+    const bool negative = x < 0;
+    double a = negative ? -x : x;
+    const bool inverted = a > 1;
+    if ( inverted )
+        a = 1 / a;
+
+    // [LANG en] atan(a) = 2 atan(a / (1 + sqrt(1 + a^2))) twice : |a| <= tan(pi/16), where 12 terms of the series suffice
+    // [LANG ja] atan(a) = 2 atan(a / (1 + sqrt(1 + a^2))) を2回適用 : |a| <= tan(pi/16) となり、級数は12項で足りる
+    a = a / (1 + std::sqrt(1 + a * a));
+    a = a / (1 + std::sqrt(1 + a * a));
+    const double a2 = a * a;
+    double p = 0;
+    for ( int n = 11; n >= 0; --n )
+        p = p * a2 + ((n & 1) ? -1.0 : 1.0) / (2 * n + 1);
+    double result = 4 * a * p;
+
+    if ( inverted )
+        result = pio2 - result;
+    return negative ? -result : result;
+}
+
+inline double rbDeterministicAtan2( double y, double x )
+{
+    const double pi = 3.14159265358979323846;
+    const double pio2 = 1.57079632679489661923;
+    if ( x != x || y != y )
+        return x + y;
+
+    if ( x == 0 )
+    {
+        if ( y == 0 )
+            return std::signbit(x) ? (std::signbit(y) ? -pi : pi) : y;
+        return y > 0 ? pio2 : -pio2;
+    }
+    if ( std::isinf(x) && std::isinf(y) )
+    {
+        const double angle = x > 0 ? 0.25 * pi : 0.75 * pi;
+        return y > 0 ? angle : -angle;
+    }
+
+    const double angle = rbDeterministicAtan( y / x );
+    if ( x > 0 )
+        return angle;
+    return std::signbit(y) ? angle - pi : angle + pi;
+}
+
+inline double rbDeterministicAsin( double x )
+{
+    return rbDeterministicAtan2( x, std::sqrt((1 - x) * (1 + x)) );
+}
+
+inline double rbDeterministicAcos( double x )
+{
+    return rbDeterministicAtan2( std::sqrt((1 - x) * (1 + x)), x );
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
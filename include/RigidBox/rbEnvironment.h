@@ -1,88 +1,426 @@
-// -*- mode: C++; coding: utf-8; -*-
-#pragma once
-
-#include <vector>
-#include "rbSolver.h"
-#include "rbTypes.h"
-
-class rbEnvironment
-{
-public:
-
-    using BodyPtrContainer = std::vector<rbRigidBody*>;
-    using ContactContainer = std::vector<rbContact>;
-
-    struct Config
-    {
-        rbs32 RigidBodyCapacity = 10;
-        rbs32 ContactCapacty = 20;
-        rbReal NearThreshold = rbReal(0.02);
-    };
-
-    rbEnvironment();
-    rbEnvironment( const Config& config );
-    ~rbEnvironment();
-
-
-    BodyPtrContainer RigidBodies()
-        { return bodies; }
-
-    rbRigidBody* RigidBody( rbu32 index )
-        { return bodies.at( index ); }
-
-    size_t RigidBodyCount()
-        { return bodies.size(); }
-
-    size_t RigidBodyCapacity()
-        { return bodies.capacity(); }
-
-
-    ContactContainer Contacts()
-        { return contacts; }
-
-    rbContact* Contact( rbu32 index )
-        { return &contacts.at( index ); }
-
-    size_t ContactCount()
-        { return contacts.size(); }
-
-    size_t ContactCapacity()
-        { return contacts.capacity(); }
-
-    void ClearContacts()
-        { contacts.clear(); }
-
-    bool Register( rbRigidBody* box );
-    bool Unregister( rbRigidBody* box );
-
-    void Update( rbReal dtime, int div );
-
-private:
-
-    BodyPtrContainer bodies;
-    ContactContainer contacts;
-    rbSolver solver;
-    Config config;
-};
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbBroadPhase.h"
+#include "rbCollision.h"
+#include "rbContactEvent.h"
+#include "rbProfiler.h"
+#include "rbShapeLibrary.h"
+#include "rbSnapshot.h"
+#include "rbSolver.h"
+#include "rbTypes.h"
+
+class rbEnvironment
+{
+public:
+
+    using BodyPtrContainer = std::vector<rbRigidBody*>;
+    using ContactContainer = std::vector<rbContact>;
+
+    // [LANG en] Overlap of a body with Attribute_Sensor began/ended during the last Update.
+    // [LANG ja] Attribute_Sensor を持つ剛体との重なりが直前の Update で開始/終了したことを表します。
+    struct SensorEvent
+    {
+        static const rbu32 Type_Begin = 0;
+        static const rbu32 Type_End   = 1;
+
+        rbu32 Type;
+        rbRigidBody* Sensor;
+
+        // [LANG en] May also be a sensor
+        // [LANG ja] センサーである場合もあります
+        rbRigidBody* Other;
+    };
+
+    using SensorEventContainer = std::vector<SensorEvent>;
+
+    struct Config
+    {
+        rbs32 RigidBodyCapacity = 10;
+        rbs32 ContactCapacty = 20;
+        rbReal NearThreshold = rbReal(0.02);
+
+        // [LANG en] Bodies with Attribute_CCD are stopped this deep inside what they hit (see rbCollision::TimeOfImpact)
+        // [LANG ja] Attribute_CCD を持つ剛体は衝突相手にこの深さだけめり込んだ位置で止めます (rbCollision::TimeOfImpact を参照)
+        rbReal CCDTargetDepth = rbReal(0.01);
+
+        // [LANG en] Pairs about to touch within a step get speculative contacts (see rbCollision::DetectSpeculative),
+        // [LANG en] which lets most scenes run with div == 1 without tunneling.
+        // [LANG ja] 1ステップ以内に接触しそうな組に予測的な衝突点を生成します (rbCollision::DetectSpeculative を参照)。
+        // [LANG ja] 多くのシーンで div == 1 でもすり抜けずに動作するようになります。
+        bool SpeculativeContacts = false;
+
+        // [LANG en] Capacity of the contact event queue (see DrainContactEvents). 0 disables contact events.
+        // [LANG ja] 接触イベントのキューの容量 (DrainContactEvents を参照)。0 の場合は接触イベントを生成しません。
+        rbu32 ContactEventCapacity = 0;
+
+        // [LANG en] Number of past Updates that can be undone with Rollback. 0 disables the rollback history.
+        // [LANG ja] Rollback で取り消せる Update の回数。0 の場合は巻き戻しの履歴を記録しません。
+        rbu32 RollbackCapacity = 0;
+    };
+
+    // [LANG en] Upper bound of time-of-impact substeps for one pair (see SolveTimeOfImpact)
+    // [LANG ja] 1組あたりの衝突時刻サブステップの上限 (SolveTimeOfImpact を参照)
+    static const rbs32 MaxCCDSubsteps = 8;
+
+    // [LANG en] Number of rays traced together by the batched RayCast (the lanes of an SSE register)
+    // [LANG ja] 一括版の RayCast でまとめて追跡するレイの本数 (SSE レジスタのレーン数)
+    static const rbu32 RayPacketSize = 4;
+
+    rbEnvironment();
+    rbEnvironment( const Config& config );
+    ~rbEnvironment();
+
+
+    BodyPtrContainer RigidBodies()
+        { return bodies; }
+
+    rbRigidBody* RigidBody( rbu32 index )
+        { return bodies.at( index ); }
+
+    size_t RigidBodyCount()
+        { return bodies.size(); }
+
+    size_t RigidBodyCapacity()
+        { return bodies.capacity(); }
+
+
+    ContactContainer Contacts()
+        { return contacts; }
+
+    rbContact* Contact( rbu32 index )
+        { return &contacts.at( index ); }
+
+    size_t ContactCount()
+        { return contacts.size(); }
+
+    size_t ContactCapacity()
+        { return contacts.capacity(); }
+
+    void ClearContacts()
+        { contacts.clear(); }
+
+    // [LANG en] Events of the last Update, in the order of the sensor pairs (begin events first).
+    // [LANG ja] 直前の Update で発生したイベント (組の順。開始イベントが先)。
+    const SensorEvent& GetSensorEvent( rbu32 index )
+        { return sensor_events.at( index ); }
+
+    size_t SensorEventCount()
+        { return sensor_events.size(); }
+
+    // [LANG en] Moves at most +capacity+ pending contact events (oldest first) into +events_out+ and returns the count.
+    // [LANG en] Every Update pushes Type_Begin/Type_Persist for the pairs touching in it and Type_End for those that stopped.
+    // [LANG ja] 未読の接触イベントを古いものから最大 +capacity+ 個 +events_out+ へ移し、その個数を返します。
+    // [LANG ja] Update ごとに、接触している組について Type_Begin/Type_Persist を、離れた組について Type_End を書き込みます。
+    rbu32 DrainContactEvents( rbContactEvent* events_out, rbu32 capacity )
+        { return contact_events.Drain( events_out, capacity ); }
+
+    // [LANG en] Number of events dropped because the queue was full
+    // [LANG ja] キューが一杯だったために破棄されたイベントの数
+    rbu32 ContactEventOverflowCount()
+        { return contact_events.OverflowCount(); }
+
+    // [LANG en] Shapes owned by this environment. Bodies may share them via rbRigidBody::SetShape( Shapes().GetShape(index) );
+    // [LANG en] they stay valid until the environment is destroyed. Pass it to rbRigidBody::SetShapeParameter to add the
+    // [LANG en] shapes of the bodies registered here. Like the rest of the environment, not safe to use from several threads.
+    // [LANG ja] この環境が所有する形状。rbRigidBody::SetShape( Shapes().GetShape(index) ) により剛体間で共有できます。
+    // [LANG ja] 環境が破棄されるまで有効です。ここに登録する剛体の形状は rbRigidBody::SetShapeParameter にこれを渡して追加します。
+    // [LANG ja] 環境の他の機能と同様、複数のスレッドから同時に使うことはできません。
+    rbShapeLibrary& Shapes()
+        { return shape_library; }
+
+    // [LANG en] Number of (body, substep) combinations of the last Update for which the body's derived data
+    // [LANG en] was still valid (see rbRigidBody::RefreshDerivedData)
+    // [LANG ja] 直前の Update において、剛体の派生データが有効なままだった (剛体, サブステップ) の組の数
+    // [LANG ja] (rbRigidBody::RefreshDerivedData を参照)
+    rbu32 SkippedBodyUpdateCount()
+        { return profiler.Stats().SkippedBodyUpdates; }
+
+    // [LANG en] Number of pairs reported by the broadphase during the last Update (summed over the substeps)
+    // [LANG ja] 直前の Update でブロードフェーズが報告した組の数 (サブステップの合計)
+    rbu32 BroadPhasePairCount()
+        { return profiler.Stats().BroadPhasePairs; }
+
+    // [LANG en] Counters and phase timings of the last Update (see rbFrameStats and RIGIDBOX_DISABLE_PROFILE)
+    // [LANG ja] 直前の Update のカウンターと処理段階ごとの時間 (rbFrameStats と RIGIDBOX_DISABLE_PROFILE を参照)
+    const rbFrameStats& FrameStats()
+        { return profiler.Stats(); }
+
+    // [LANG en] Use Profiler().SetTraceCapacity and Profiler().WriteChromeTrace to record a trace of the following Updates.
+    // [LANG ja] 以降の Update のトレースを記録するには Profiler().SetTraceCapacity と Profiler().WriteChromeTrace を使います。
+    rbProfiler& Profiler()
+        { return profiler; }
+
+    // [LANG en] +recorder+ captures the poses of the registered bodies at the end of every Update
+    // [LANG en] (see rbTrajectoryRecorder::Capture). It is not owned by the environment. nullptr (the default) removes it.
+    // [LANG ja] +recorder+ は Update の最後に毎回、登録された剛体の姿勢を記録します (rbTrajectoryRecorder::Capture を
+    // [LANG ja] 参照)。環境は +recorder+ を所有しません。nullptr (既定値) を渡すと解除します。
+    void SetTrajectoryRecorder( rbTrajectoryRecorder* recorder )
+        { trajectory_recorder = recorder; }
+
+    bool Register( rbRigidBody* box );
+    bool Unregister( rbRigidBody* box );
+
+    // [LANG en] Registers the +count+ bodies of an array (e.g. rbScene::Bodies()) in time linear in the number of bodies,
+    // [LANG en] instead of searching the registered bodies once per body. Returns false, registering none of them, if any
+    // [LANG en] is already registered. +sweep_order+, if given, is the broadphase order of the array (see rbBroadPhase::SetOrder);
+    // [LANG en] it is used only if no body was registered before. Unlike the bodies registered one by one, the array
+    // [LANG en] stays owned by the caller : the destructor does not delete its bodies.
+    // [LANG ja] 配列の +count+ 個の剛体 (rbScene::Bodies() 等) を、剛体ごとに登録済みの剛体を探すのではなく剛体の数に
+    // [LANG ja] 比例する時間で登録します。いずれかが登録済みの場合は1つも登録せずに false を返します。+sweep_order+ を
+    // [LANG ja] 渡した場合は配列のブロードフェーズの並び順 (rbBroadPhase::SetOrder を参照) として、まだ剛体が1つも
+    // [LANG ja] 登録されていなかった場合にのみ使います。1つずつ登録した剛体と異なり、配列は呼び出し側が所有したままで、
+    // [LANG ja] デストラクタはその剛体を delete しません。
+    bool Register( rbRigidBody* bodies, rbu32 count, const rbu32* sweep_order = nullptr );
+
+    // [LANG en] Unregisters the +count+ bodies of an array in linear time. Returns false, unregistering none of them,
+    // [LANG en] unless all of them are registered.
+    // [LANG ja] 配列の +count+ 個の剛体の登録を線形時間で解除します。全てが登録されていない場合は1つも解除せずに
+    // [LANG ja] false を返します。
+    bool Unregister( rbRigidBody* bodies, rbu32 count );
+
+    // [LANG en] Optional user callback deciding whether a pair may collide (see rbBroadPhase::PairFilter).
+    // [LANG ja] 組が衝突してよいかを判定する任意のコールバック (rbBroadPhase::PairFilter を参照)。
+    void SetPairFilter( rbBroadPhase::PairFilter filter, void* user_data = nullptr )
+        { broadphase.SetPairFilter( filter, user_data ); }
+
+    void Update( rbReal dtime, int div );
+
+    // [LANG en] Saves the state of the registered bodies, the contacts of the last Update and the touching/sensor pairs
+    // [LANG en] that contact/sensor events are derived from into +snapshot+ (see rbSnapshot). Pending events in the
+    // [LANG en] contact event queue and the profiler are not included.
+    // [LANG ja] 登録された剛体の状態、直前の Update の衝突点、接触/センサーイベントの元になる接触している組と
+    // [LANG ja] センサーの組を +snapshot+ に保存します (rbSnapshot を参照)。接触イベントのキューにある未読のイベントと
+    // [LANG ja] プロファイラーの情報は含みません。
+    void SaveSnapshot( rbSnapshot& snapshot );
+
+    // [LANG en] Overwrites the state in place (no allocation as long as the containers have enough capacity).
+    // [LANG en] Returns false, leaving the environment unchanged, if +snapshot+ is empty or was saved with a different
+    // [LANG en] number of registered bodies.
+    // [LANG ja] 状態をその場で上書きします (コンテナの容量が足りていればメモリ確保は起こりません)。
+    // [LANG ja] +snapshot+ が空の場合、または登録された剛体の数が異なる環境で保存された場合は、何もせずに false を返します。
+    bool RestoreSnapshot( const rbSnapshot& snapshot );
+
+    // [LANG en] Rollback history (see Config::RollbackCapacity). Every Update keeps the previous records (see
+    // [LANG en] rbRigidBody::SaveSnapshot) of the bodies it changed, i.e. of those awake before or after it and of the
+    // [LANG en] sleeping ones posed since the last Update (SetPosition, SetOrientation etc.), so both the recording and
+    // [LANG en] Rollback cost time proportional to the active bodies rather than to the world size.
+    // [LANG en] Register, Unregister and RestoreSnapshot discard the history, which starts again after the next Update.
+    // [LANG ja] 巻き戻しの履歴 (Config::RollbackCapacity を参照)。Update ごとに、その Update が変更した剛体 (前後で
+    // [LANG ja] スリープしていなかった剛体と、前回の Update 以降に姿勢を設定 (SetPosition, SetOrientation 等) したスリープ中の
+    // [LANG ja] 剛体) の変更前の記録 (rbRigidBody::SaveSnapshot を参照) を保持するため、記録と Rollback にかかる時間は
+    // [LANG ja] 世界の大きさではなく動いている剛体の数に比例します。
+    // [LANG ja] Register, Unregister, RestoreSnapshot は履歴を破棄し、次の Update の後から記録し直します。
+
+    // [LANG en] Number of Updates that can be undone now
+    // [LANG ja] 現在取り消すことのできる Update の回数
+    rbu32 RollbackFrameCount()
+        { return rollback_count; }
+
+    // [LANG en] Returns to the state before the last +frame_count+ Updates. The contacts are cleared (the next Update
+    // [LANG en] finds them again) and the contact event queue is left as is. Returns false, leaving the environment
+    // [LANG en] unchanged, if fewer Updates are recorded.
+    // [LANG ja] 直近 +frame_count+ 回の Update の前の状態に戻します。衝突点はクリアし (次の Update で再び検出されます)、
+    // [LANG ja] 接触イベントのキューはそのままにします。記録されている Update が足りない場合は何もせずに false を返します。
+    bool Rollback( rbu32 frame_count );
+
+    // [LANG en] 64-bit FNV-1a hash of the simulation state : the state records of the registered bodies (see
+    // [LANG en] rbRigidBody::SaveState) in registration order, the indices and ids of the touching pairs and the next pair
+    // [LANG en] id. Only scalar components are hashed, so the result does not depend on the padding of rbVec3
+    // [LANG en] (RIGIDBOX_USE_SIMD), and caches are left out, so queries between two Updates do not change it.
+    // [LANG en] Comparing it after every Update tells whether two runs are bit-identical (see RIGIDBOX_DETERMINISTIC).
+    // [LANG ja] シミュレーションの状態の 64 ビット FNV-1a ハッシュ : 登録順の剛体の状態の記録 (rbRigidBody::SaveState を
+    // [LANG ja] 参照)、接触している組の番号と識別子、次の組の番号から求めます。スカラーの成分のみを対象とするので、結果は
+    // [LANG ja] rbVec3 の padding (RIGIDBOX_USE_SIMD) に左右されません。キャッシュは含まないので、Update の間のクエリでも
+    // [LANG ja] 変わりません。Update ごとに比較すれば、2つの実行がビット単位で一致しているかが分かります
+    // [LANG ja] (RIGIDBOX_DETERMINISTIC を参照)。
+    rbu64 StateHash();
+
+    // [LANG en] Scene queries. They share the sweep-and-prune broadphase with Update but keep their own unswept bounds,
+    // [LANG en] refitted on the first query after an Update, Register, Unregister, Rollback or RestoreSnapshot, so that
+    // [LANG en] each query walks only the bodies near it. Bodies moved directly (SetPosition etc.) since then are seen by
+    // [LANG en] the broadphase after InvalidateQueryBounds. Queries never modify the bodies, including their caches
+    // [LANG en] (rbRigidBody::WorldAABB, rbRigidBody::SupportVertexCache) and dirty bits.
+    // [LANG ja] シーンへの問い合わせ。Update と共通の sweep-and-prune のブロードフェーズを使いますが、掃引しない専用の
+    // [LANG ja] 境界を保持し、Update・Register・Unregister・Rollback・RestoreSnapshot の後の最初の問い合わせで計算し直すので、
+    // [LANG ja] 各問い合わせは近くの剛体だけを走査します。それ以降に直接動かした (SetPosition など) 剛体は、
+    // [LANG ja] InvalidateQueryBounds の後にブロードフェーズに反映されます。問い合わせが剛体を変更することはなく、
+    // [LANG ja] キャッシュ (rbRigidBody::WorldAABB, rbRigidBody::SupportVertexCache) や Dirty ビットもそのままです。
+
+    // [LANG en] Makes the next query refit its bounds, after moving registered bodies directly between Updates.
+    // [LANG ja] Update の間に登録済みの剛体を直接動かした後に呼ぶと、次の問い合わせで境界を計算し直します。
+    void InvalidateQueryBounds()
+        { broadphase.InvalidateQueryBounds(); }
+
+    // [LANG en] Closest hit along +ray+. Returns false (and hit_out.Body == nullptr) if nothing is hit.
+    // [LANG ja] +ray+ に沿って最も近い交差を求めます。何にも当たらなければ false を返します (hit_out.Body == nullptr)。
+    bool RayCast( const rbRay& ray, rbRayHit& hit_out );
+
+    // [LANG en] Closest hits of +ray_count+ rays, written to +hits_out+ (Body == nullptr for misses). Rays are traced
+    // [LANG en] in packets of RayPacketSize : every candidate AABB is slab-tested against the segments of the whole packet
+    // [LANG en] at once (SSE with RIGIDBOX_USE_SIMD). Packets spread along x walk the broadphase ray by ray.
+    // [LANG ja] +ray_count+ 本のレイそれぞれの最も近い交差を +hits_out+ に書き込みます (当たらなければ Body == nullptr)。
+    // [LANG ja] レイは RayPacketSize 本ずつパケットとして追跡し、候補の AABB をパケット全体の線分とまとめてスラブ判定します
+    // [LANG ja] (RIGIDBOX_USE_SIMD では SSE)。x 方向に散らばったパケットはレイ1本ずつブロードフェーズを走査します。
+    void RayCast( const rbRay* rays, rbu32 ray_count, rbRayHit* hits_out );
+
+    // [LANG en] Bodies overlapping the given box. Writes at most +capacity+ of them and returns the total count.
+    // [LANG ja] 指定した直方体と重なる剛体を求めます。最大 +capacity+ 個を書き込み、重なる剛体の総数を返します。
+    rbu32 OverlapBox( const rbVec3& center, const rbMtx3& orientation, const rbVec3& half_extent,
+                      rbRigidBody** bodies_out, rbu32 capacity );
+
+    // [LANG en] Moves the given box along +displacement+ and reports the first body it touches
+    // [LANG en] (fraction 0 if it overlaps something already). Stops within Config::CCDTargetDepth like CCD does.
+    // [LANG ja] 指定した直方体を +displacement+ だけ動かし、最初に接触する剛体を求めます (最初から重なっていれば比率 0)。
+    // [LANG ja] CCD と同様に Config::CCDTargetDepth 以内のめり込みで止めます。
+    bool SweepBox( const rbVec3& center, const rbMtx3& orientation, const rbVec3& half_extent,
+                   const rbVec3& displacement, rbRayHit& hit_out );
+
+private:
+
+    void Step( rbReal dtime, int div );
+    void DetectCollision( rbReal dt );
+    void MergeContacts();
+    void SolveTimeOfImpact( rbReal dt );
+    void AddSensorOverlap( rbRigidBody* sensor, rbRigidBody* other );
+    void UpdateSensorEvents();
+    rbu32 AddTouchingPair( rbu32 index0, rbu32 index1, const rbContact* pair_contacts, rbs32 contact_count );
+    void UpdateContactEvents();
+    void ResetRollback();
+    void BeginRollbackFrame();
+    void EndRollbackFrame();
+
+    // [LANG en] Pair with at least one (non-speculative) contact
+    // [LANG ja] (予測的でない) 衝突点を1つ以上持つ組
+    struct TouchingPair
+    {
+        rbu32 Index[2];
+        rbRigidBody* Body[2];
+        rbu32 PairId;
+        rbReal MaxImpulse;
+        rbVec3 NormalSum;
+    };
+
+    static const rbu32 NoTouchingPair = ~rbu32(0);
+
+    struct SensorPair
+    {
+        rbRigidBody* Sensor;
+        rbRigidBody* Other;
+
+        bool operator ==( const SensorPair& other ) const
+            { return Sensor == other.Sensor && Other == other.Other; }
+    };
+
+    BodyPtrContainer bodies;
+
+    // [LANG en] Arrays registered with Register( bodies, count ) : the destructor skips their bodies
+    // [LANG ja] Register( bodies, count ) で登録した配列 : デストラクタはその剛体を飛ばす
+    struct BodyArray
+    {
+        rbRigidBody* Bodies;
+        rbu32 Count;
+    };
+    std::vector<BodyArray> body_arrays;
+
+    ContactContainer contacts;
+    rbBroadPhase broadphase;
+    rbSolver solver;
+    rbShapeLibrary shape_library;
+    Config config;
+
+    // [LANG en] Time already integrated by the CCD pass in the current substep (per body)
+    // [LANG ja] 現在のサブステップで CCD の処理によってすでに積分された時間 (剛体ごと)
+    std::vector<rbReal> ccd_advanced_time;
+
+    // [LANG en] Scratch of SolveTimeOfImpact (kept between calls to reuse the storage) : the pairs that collide within
+    // [LANG en] the substep, and whether each body has already been advanced by one of them
+    // [LANG ja] SolveTimeOfImpact の作業領域 (領域を使い回すため呼び出しの間も保持) : サブステップ内で衝突する組と、
+    // [LANG ja] 各剛体がすでにいずれかの組によって進められたか
+    struct CCDImpact
+    {
+        rbReal toi;
+        rbu32 index[2];
+    };
+    std::vector<CCDImpact> ccd_impacts;
+    std::vector<bool> ccd_advanced;
+
+    // [LANG en] Sensor pairs overlapping as of the last Update, and those found so far in the current one
+    // [LANG ja] 直前の Update の時点で重なっていたセンサーの組と、現在の Update でここまでに見つかった組
+    std::vector<SensorPair> sensor_pairs;
+    std::vector<SensorPair> sensor_pairs_current;
+    SensorEventContainer sensor_events;
+
+    // [LANG en] Touching pairs of the last Update, those found in the current one (one entry per substep),
+    // [LANG en] and the entry each element of +contacts+ belongs to
+    // [LANG ja] 直前の Update で接触していた組、現在の Update で見つかった組 (サブステップごとに1要素)、
+    // [LANG ja] および +contacts+ の各要素が属する組の番号
+    std::vector<TouchingPair> touching_pairs;
+    std::vector<TouchingPair> touching_pairs_current;
+    std::vector<rbu32> contact_owners;
+
+    // [LANG en] Scratch of UpdateContactEvents (kept between calls to reuse the storage) : the previous pairs sorted by
+    // [LANG en] body address, and whether each of them persisted
+    // [LANG ja] UpdateContactEvents の作業領域 (領域を使い回すため呼び出しの間も保持) : 剛体のアドレス順に並べた
+    // [LANG ja] 前回の組と、それぞれが継続したか
+    std::vector<rbu32> touching_pairs_previous;
+    std::vector<bool> touching_pairs_persisted;
+
+    // [LANG en] Contacts found by the narrow phase in the current substep (and their touching pairs), before deduplication
+    // [LANG ja] 現在のサブステップで詳細判定が見つけた重複除去前の衝突点 (および属する接触している組)
+    ContactContainer contact_candidates;
+    std::vector<rbu32> candidate_owners;
+    rbContactEventQueue contact_events;
+    rbu32 next_pair_id;
+    rbProfiler profiler;
+    rbTrajectoryRecorder* trajectory_recorder;
+
+    // [LANG en] What one Update changed : the previous records of the bodies (by index) and the previous pairs
+    // [LANG ja] 1回の Update による変更 : 剛体の変更前の記録 (番号つき) と変更前の組
+    struct RollbackFrame
+    {
+        std::vector<rbu32> BodyIndices;
+        std::vector<rbu8> BodyRecords;
+        std::vector<TouchingPair> TouchingPairs;
+        std::vector<SensorPair> SensorPairs;
+        rbu32 NextPairId;
+    };
+
+    // [LANG en] Ring of RollbackCapacity frames, the records of every body as of the last recorded Update
+    // [LANG en] (compared against to find the changed ones), whether each body was awake then, and the indices of the
+    // [LANG en] bodies the current Update may change (noted by Step)
+    // [LANG ja] RollbackCapacity 個のフレームのリング、最後に記録した Update の時点での全剛体の記録 (変更された
+    // [LANG ja] 剛体を見つけるための比較対象)、その時点で各剛体がスリープしていなかったか、現在の Update が変更しうる
+    // [LANG ja] 剛体の番号 (Step が書き留める)
+    std::vector<RollbackFrame> rollback_frames;
+    rbu32 rollback_next;
+    rbu32 rollback_count;
+    bool rollback_valid;
+    std::vector<rbu8> rollback_baseline;
+    std::vector<rbu8> rollback_awake;
+    std::vector<rbu8> rollback_scratch;
+    std::vector<rbu32> rollback_changed;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,131 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbTypes.h"
+#include "rbMath.h"
+
+// Static heightfield terrain collider.
+//
+// [LANG en] Samples are laid out on a regular grid in the local xz-plane, starting at the origin :
+// [LANG en] sample (i, j) is located at (i * cell_size_x, height, j * cell_size_z).
+// [LANG en] Heights are quantized into 16 bits (height = offset + scale * q), so a 4096 x 4096 terrain takes 32 MB.
+// [LANG en] Like rbTriangleMesh, a heightfield is shared read-only and bodies using it are always fixed.
+// [LANG ja] サンプルはローカル座標系の xz 平面上、原点から始まる等間隔の格子上に並びます :
+// [LANG ja] サンプル (i, j) の位置は (i * cell_size_x, 高さ, j * cell_size_z) です。
+// [LANG ja] 高さは 16 ビットに量子化されます (高さ = offset + scale * q)。4096 x 4096 の地形で 32 MB です。
+// [LANG ja] rbTriangleMesh と同様に読み取り専用で共有され、これを使う剛体は常に固定物体になります。
+class rbHeightField
+{
+public:
+
+    rbHeightField();
+
+    // [LANG en] +heights+ holds sample_count_x * sample_count_z values, row by row (x runs fastest).
+    // [LANG ja] +heights+ は sample_count_x * sample_count_z 個の値を行ごとに保持します (x が先に変化)。
+    bool Build( rbu32 sample_count_x, rbu32 sample_count_z, const rbReal* heights, rbReal cell_size_x, rbReal cell_size_z );
+
+    void Clear();
+
+    bool Valid() const
+        { return !samples.empty(); }
+
+    rbu32 SampleCountX() const
+        { return sample_count_x; }
+
+    rbu32 SampleCountZ() const
+        { return sample_count_z; }
+
+    rbReal HeightScale() const
+        { return height_scale; }
+
+    rbReal HeightOffset() const
+        { return height_offset; }
+
+    rbReal Height( rbu32 i, rbu32 j ) const
+        { return height_offset + height_scale * samples[j * sample_count_x + i]; }
+
+    rbVec3 Sample( rbu32 i, rbu32 j ) const
+        { return rbVec3( cell_size_x * i, Height(i, j), cell_size_z * j ); }
+
+    // [LANG en] Symmetric half-extent around the local origin that bounds every sample.
+    // [LANG ja] ローカル座標の原点を中心として全サンプルを包む half-extent。
+    rbVec3 HalfExtent() const;
+
+    // [LANG en] Calls visitor(const rbVec3 v[3]) for both triangles of every cell under the footprint of
+    // [LANG en] [aabb_min, aabb_max] (local coordinates). Cells lying entirely above or below the box are skipped.
+    // [LANG ja] [aabb_min, aabb_max] (ローカル座標) の真下にある各セルについて、2枚の三角形それぞれで
+    // [LANG ja] visitor(const rbVec3 v[3]) を呼びます。箱より完全に上または下にあるセルは読み飛ばします。
+    template <typename Visitor>
+    void Query( const rbVec3& aabb_min, const rbVec3& aabb_max, Visitor&& visitor ) const
+        {
+            if ( samples.empty() )
+                return;
+
+            // [LANG en] O(1) lookup of the cell range
+            // [LANG ja] セル範囲を O(1) で求める
+            const rbs32 last_x = static_cast<rbs32>(sample_count_x) - 2;
+            const rbs32 last_z = static_cast<rbs32>(sample_count_z) - 2;
+            rbs32 i0 = static_cast<rbs32>( std::floor(aabb_min.x / cell_size_x) );
+            rbs32 i1 = static_cast<rbs32>( std::floor(aabb_max.x / cell_size_x) );
+            rbs32 j0 = static_cast<rbs32>( std::floor(aabb_min.z / cell_size_z) );
+            rbs32 j1 = static_cast<rbs32>( std::floor(aabb_max.z / cell_size_z) );
+            if ( i1 < 0 || j1 < 0 || i0 > last_x || j0 > last_z )
+                return;
+            i0 = i0 < 0 ? 0 : i0;  i1 = i1 > last_x ? last_x : i1;
+            j0 = j0 < 0 ? 0 : j0;  j1 = j1 > last_z ? last_z : j1;
+
+            for ( rbs32 j = j0; j <= j1; ++j )
+            {
+                for ( rbs32 i = i0; i <= i1; ++i )
+                {
+                    const rbVec3 v00 = Sample( i, j ),     v10 = Sample( i + 1, j );
+                    const rbVec3 v01 = Sample( i, j + 1 ), v11 = Sample( i + 1, j + 1 );
+
+                    rbReal lo = rbMin( rbMin(v00.y, v10.y), rbMin(v01.y, v11.y) );
+                    rbReal hi = rbMax( rbMax(v00.y, v10.y), rbMax(v01.y, v11.y) );
+                    if ( lo > aabb_max.y || hi < aabb_min.y )
+                        continue;
+
+                    // [LANG en] Counter-clockwise seen from above (+y)
+                    // [LANG ja] 上 (+y) から見て反時計回り
+                    const rbVec3 t0[3] = { v00, v01, v10 };
+                    const rbVec3 t1[3] = { v10, v01, v11 };
+                    visitor( t0 );
+                    visitor( t1 );
+                }
+            }
+        }
+
+private:
+
+    std::vector<rbu16> samples;
+    rbu32 sample_count_x;
+    rbu32 sample_count_z;
+    rbReal cell_size_x;
+    rbReal cell_size_z;
+    rbReal height_scale;
+    rbReal height_offset;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,64 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <cstddef>
+#include "rbTypes.h"
+
+// Read-only memory mapping of a whole file (mmap, or a file mapping on Windows).
+//
+// [LANG en] Used by the file readers (rbTrajectoryPlayer, rbScene) so that only the touched pages are read from disk.
+// [LANG ja] ファイルの読み込み (rbTrajectoryPlayer, rbScene) で使い、参照したページだけがディスクから読まれるようにします。
+class rbMappedFile
+{
+public:
+
+    rbMappedFile();
+
+    ~rbMappedFile();
+
+    rbMappedFile( const rbMappedFile& ) = delete;
+    rbMappedFile& operator =( const rbMappedFile& ) = delete;
+
+    // [LANG en] Returns false if the file cannot be opened or mapped, or is empty.
+    // [LANG ja] ファイルを開けない、マップできない、または空の場合は false を返します。
+    bool Open( const char* path );
+
+    void Close();
+
+    bool IsOpen() const
+        { return data != nullptr; }
+
+    const rbu8* Data() const
+        { return data; }
+
+    size_t Size() const
+        { return size; }
+
+private:
+
+    const rbu8* data;
+    size_t size;
+    void* mapping;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -1,614 +1,886 @@
-// -*- mode: C++; coding: utf-8; -*-
-#pragma once
-
-#include "rbTypes.h"
-
-inline rbReal rbToRad( rbReal deg )
-{
-    // (/ float-pi 180.0) -> 0.017453292519943295
-    return rbReal(0.017453292519943295) * deg;
-}
-
-inline rbReal rbMin( rbReal a, rbReal b )
-{
-    return a >= b ? b : a;
-}
-
-inline rbReal rbMax( rbReal a, rbReal b )
-{
-    return a >= b ? a : b;
-}
-
-inline rbReal rbClamp( rbReal v, rbReal v_min, rbReal v_max )
-{
-    if ( v < v_min )
-        return v_min;
-    else if ( v > v_max )
-        return v_max;
-    else
-        return v;
-}
-
-inline rbReal rbSign( rbReal v )
-{
-    return v <= -RIGIDBOX_TOLERANCE ? rbReal(-1) : rbReal(1);
-}
-
-
-//
-// rbVec3 Declaration
-//
-
-struct rbVec3
-{
-    union
-    {
-        struct
-        {
-            rbReal x, y, z;
-        };
-        rbReal e[3];
-    };
-
-    rbVec3();
-    rbVec3( rbReal x_, rbReal y_, rbReal z_ );
-    rbVec3( rbReal* a );
-    rbVec3( const rbVec3& other );
-    rbVec3& operator =( const rbVec3& other );
-    void Set( rbReal x_, rbReal y_, rbReal z_ );
-    void SetZero();
-    void Add( rbReal x_, rbReal y_, rbReal z_ );
-    rbVec3 operator -() const;
-    rbVec3 operator +( const rbVec3& v ) const;
-    rbVec3& operator +=( const rbVec3& v );
-    rbVec3 operator -( const rbVec3& v ) const;
-    rbVec3& operator -=( const rbVec3& v );
-    rbVec3 operator *( rbReal f ) const;
-    rbVec3& operator *=( rbReal f );
-    rbVec3 operator /( rbReal f ) const;
-    rbVec3& operator /=( rbReal f );
-    rbReal operator *( const rbVec3& v ) const;
-    rbVec3 operator %( const rbVec3& v ) const;
-    rbReal Length() const;
-    rbReal LengthSq() const;
-    rbVec3 GetNormalized() const;
-    rbVec3& Normalize();
-
-}; // struct rbVec3
-
-
-//
-// rbMtx3 Declaration
-//
-
-struct rbMtx3
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    rbVec3 c[3];
-#else
-    rbVec3 r[3];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-
-    rbMtx3();
-    rbMtx3( rbReal e00, rbReal e01, rbReal e02,
-            rbReal e10, rbReal e11, rbReal e12,
-            rbReal e20, rbReal e21, rbReal e22 );
-    rbMtx3( const rbMtx3& other );
-    rbMtx3& operator =( const rbMtx3& other );
-    rbReal& Elem( rbs32 row, rbs32 col );
-    const rbReal& Elem( rbs32 row, rbs32 col ) const;
-    rbVec3 Row( rbs32 i ) const;
-    rbVec3 Column( rbs32 i ) const;
-    void Set( rbReal e00, rbReal e01, rbReal e02,
-              rbReal e10, rbReal e11, rbReal e12,
-              rbReal e20, rbReal e21, rbReal e22 );
-    void SetZero();
-    void SetIdentity();
-    rbMtx3& SetFromAxisAngle( const rbVec3& normalized_axis, rbReal radian );
-    void SetAsCrossProductMatrix( const rbVec3& v );
-    void Orthonormalize();
-    void Scale( rbReal f );
-    rbMtx3 GetTransposed() const;
-    rbMtx3& Transpose();
-    rbMtx3 GetInverse() const;
-    rbMtx3& Invert();
-    rbMtx3 operator +( const rbMtx3& m ) const;
-    rbMtx3& operator +=( const rbMtx3& m );
-    rbMtx3 operator -( const rbMtx3& m ) const;
-    rbMtx3& operator -=( const rbMtx3& m );
-    rbMtx3 operator *( rbReal f ) const;
-    rbMtx3& operator *=( rbReal f );
-    rbMtx3 operator *( const rbMtx3& m ) const;
-    rbMtx3& operator *=( const rbMtx3& m );
-    rbVec3 operator *( const rbVec3& v ) const;
-
-}; // struct rbMtx3
-
-
-//
-// rbVec3 Implementation
-//
-
-inline rbVec3::rbVec3()
-{}
-
-inline rbVec3::rbVec3( rbReal x_, rbReal y_, rbReal z_ )
-    : x(x_), y(y_), z(z_)
-{}
-
-inline rbVec3::rbVec3( rbReal* a )
-    : x(a[0]), y(a[1]), z(a[2])
-{}
-
-inline rbVec3::rbVec3( const rbVec3& other )
-    : x(other.x), y(other.y), z(other.z)
-{}
-
-inline rbVec3& rbVec3::operator =( const rbVec3& other )
-{
-    x = other.x;  y = other.y;  z = other.z;
-
-    return *this;
-}
-
-inline void rbVec3::Set( rbReal x_, rbReal y_, rbReal z_ )
-{
-    x = x_;  y = y_;  z = z_;
-}
-
-inline void rbVec3::SetZero()
-{
-    x = 0;  y = 0;  z = 0;
-}
-
-inline void rbVec3::Add( rbReal x_, rbReal y_, rbReal z_ )
-{
-    x += x_;  y += y_;  z += z_;
-}
-
-inline rbVec3 rbVec3::operator -() const
-{
-    return rbVec3( -x, -y, -z );
-}
-
-inline rbVec3 rbVec3::operator +( const rbVec3& v ) const
-{
-    return rbVec3( x+v.x, y+v.y, z+v.z );
-}
-
-inline rbVec3& rbVec3::operator +=( const rbVec3& v )
-{
-    x += v.x;  y += v.y;  z += v.z;
-    return *this;
-}
-
-inline rbVec3 rbVec3::operator -( const rbVec3& v ) const
-{
-    return rbVec3( x-v.x, y-v.y, z-v.z );
-}
-
-inline rbVec3& rbVec3::operator -=( const rbVec3& v )
-{
-    x -= v.x;  y -= v.y;  z -= v.z;
-    return *this;
-}
-
-inline rbVec3 rbVec3::operator *( rbReal f ) const
-{
-    return rbVec3( x*f, y*f, z*f );
-}
-
-inline rbVec3& rbVec3::operator *=( rbReal f )
-{
-    x *= f;  y *= f;  z *= f;
-    return *this;
-}
-
-inline rbVec3 rbVec3::operator /( rbReal f ) const
-{
-    return rbVec3( x/f, y/f, z/f );
-}
-
-inline rbVec3& rbVec3::operator /=( rbReal f )
-{
-    x /= f;  y /= f;  z /= f;
-    return *this;
-}
-
-inline rbReal rbVec3::operator *( const rbVec3& v ) const
-{
-    return x*v.x + y*v.y + z*v.z;
-}
-
-inline rbVec3 rbVec3::operator %( const rbVec3& v ) const
-{
-    return rbVec3( y*v.z - z*v.y,
-                   z*v.x - x*v.z,
-                   x*v.y - y*v.x );
-}
-
-inline rbReal rbVec3::Length() const
-{
-    return rbSqrt( x*x + y*y + z*z );
-}
-
-inline rbReal rbVec3::LengthSq() const
-{
-    return x*x + y*y + z*z;
-}
-
-inline rbVec3 rbVec3::GetNormalized() const
-{
-    rbReal l = Length();
-    l = rbReal(1) / l;
-    return rbVec3( l*x, l*y, l*z );
-}
-
-inline rbVec3& rbVec3::Normalize()
-{
-    rbReal l = Length();
-    l = rbReal(1) / l;
-
-    x *= l;
-    y *= l;
-    z *= l;
-
-    return *this;
-}
-
-
-//
-// rbMtx3 Implementation
-//
-
-inline rbMtx3::rbMtx3()
-{}
-
-inline rbMtx3::rbMtx3( rbReal e00, rbReal e01, rbReal e02,
-                       rbReal e10, rbReal e11, rbReal e12,
-                       rbReal e20, rbReal e21, rbReal e22 )
-{
-    Elem(0,0) = e00;  Elem(0,1) = e01;  Elem(0,2) = e02;
-    Elem(1,0) = e10;  Elem(1,1) = e11;  Elem(1,2) = e12;
-    Elem(2,0) = e20;  Elem(2,1) = e21;  Elem(2,2) = e22;
-}
-
-inline rbMtx3::rbMtx3( const rbMtx3& other )
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0] = other.c[0];
-    c[1] = other.c[1];
-    c[2] = other.c[2];
-#else
-    r[0] = other.r[0];
-    r[1] = other.r[1];
-    r[2] = other.r[2];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline rbMtx3& rbMtx3::operator =( const rbMtx3& other )
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0] = other.c[0];
-    c[1] = other.c[1];
-    c[2] = other.c[2];
-#else
-    r[0] = other.r[0];
-    r[1] = other.r[1];
-    r[2] = other.r[2];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    return *this;
-}
-
-inline rbReal& rbMtx3::Elem( rbs32 row, rbs32 col )
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    return c[col].e[row];
-#else
-    return r[row].e[col];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline const rbReal& rbMtx3::Elem( rbs32 row, rbs32 col ) const
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    return c[col].e[row];
-#else
-    return r[row].e[col];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline rbVec3 rbMtx3::Row( rbs32 i ) const
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    return rbVec3( Elem(i,0), Elem(i,1), Elem(i,2) );
-#else
-    return r[i];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline rbVec3 rbMtx3::Column( rbs32 i ) const
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    return c[i];
-#else
-    return rbVec3( Elem(0,i), Elem(1,i), Elem(2,i) );
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline void rbMtx3::Set( rbReal e00, rbReal e01, rbReal e02,
-                         rbReal e10, rbReal e11, rbReal e12,
-                         rbReal e20, rbReal e21, rbReal e22 )
-{
-    Elem(0,0) = e00;  Elem(0,1) = e01;  Elem(0,2) = e02;
-    Elem(1,0) = e10;  Elem(1,1) = e11;  Elem(1,2) = e12;
-    Elem(2,0) = e20;  Elem(2,1) = e21;  Elem(2,2) = e22;
-}
-
-inline void rbMtx3::SetZero()
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0].SetZero();
-    c[1].SetZero();
-    c[2].SetZero();
-#else
-    r[0].SetZero();
-    r[1].SetZero();
-    r[2].SetZero();
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline void rbMtx3::SetIdentity()
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0].Set( 1, 0, 0 );
-    c[1].Set( 0, 1, 0 );
-    c[2].Set( 0, 0, 1 );
-#else
-    r[0].Set( 1, 0, 0 );
-    r[1].Set( 0, 1, 0 );
-    r[2].Set( 0, 0, 1 );
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-inline rbMtx3& rbMtx3::SetFromAxisAngle( const rbVec3& axis, rbReal radian )
-{
-    rbReal s = rbSin( radian );
-    rbReal c = rbCos( radian );
-    rbReal C = rbReal(1) - c;
-    rbReal x = axis.x;
-    rbReal y = axis.y;
-    rbReal z = axis.z;
-
-    Elem(0,0) = x*x*C + c;
-    Elem(0,1) = x*y*C - z*s;
-    Elem(0,2) = z*x*C + y*s;
-    Elem(1,0) = x*y*C + z*s;
-    Elem(1,1) = y*y*C + c;
-    Elem(1,2) = y*z*C - x*s;
-    Elem(2,0) = z*x*C - y*s;
-    Elem(2,1) = y*z*C + x*s;
-    Elem(2,2) = z*z*C + c;
-
-    return *this;
-}
-
-inline void rbMtx3::SetAsCrossProductMatrix( const rbVec3& v )
-{
-    Set(    0, -v.z,  v.y,
-          v.z,    0, -v.x,
-         -v.y,  v.x,    0 );
-}
-
-//
-// [LANG en] Orhotnomalization algorithm. Should only be used for the orientation matrix of rigid body (rbRigidBody::State::R).
-// [LANG ja] 正規直交化(※注意：剛体の姿勢行列 rbRigidBody::State::R のみで利用すること)
-//
-// Ref.: Rigid Body Dynamics - Chris Hecker's Website
-//       See the physics article series for Game Developer Magazine.
-//       http://chrishecker.com/Rigid_Body_Dynamics
-//
-inline void rbMtx3::Orthonormalize()
-{
-    rbVec3 X( Column(0).Normalize() );
-    rbVec3 Y( Column(1) );
-    rbVec3 Z( (X % Y).Normalize() );
-    Y = (Z % X).Normalize();
-
-    Set( X.e[0], Y.e[0], Z.e[0],
-         X.e[1], Y.e[1], Z.e[1],
-         X.e[2], Y.e[2], Z.e[2] );
-}
-
-inline void rbMtx3::Scale( rbReal f )
-{
-    for ( rbs32 row = 0; row < 3; ++row )
-        for ( rbs32 col = 0; col < 3; ++col )
-            Elem(row, col) *= f;
-}
-
-inline rbMtx3 rbMtx3::GetTransposed() const
-{
-    return rbMtx3( Elem(0,0), Elem(1,0), Elem(2,0),
-                   Elem(0,1), Elem(1,1), Elem(2,1),
-                   Elem(0,2), Elem(1,2), Elem(2,2) );
-}
-
-inline rbMtx3& rbMtx3::Transpose()
-{
-    rbReal tmp;
-    tmp = Elem(0,1); Elem(0,1) = Elem(1,0); Elem(1,0) = tmp;
-    tmp = Elem(0,2); Elem(0,2) = Elem(2,0); Elem(2,0) = tmp;
-    tmp = Elem(1,2); Elem(1,2) = Elem(2,1); Elem(2,1) = tmp;
-
-    return *this;
-}
-
-inline rbMtx3 rbMtx3::GetInverse() const
-{
-#define E( row, col ) Elem((row), (col))
-#define R( row, col ) result.Elem((row), (col))
-#define DET( e00, e01, e10, e11 ) ((e00)*(e11)-(e01)*(e10))
-
-    rbMtx3 result;
-    R(0,0) =  DET( E(1,1),E(1,2), E(2,1),E(2,2) );
-    R(0,1) = -DET( E(0,1),E(0,2), E(2,1),E(2,2) );
-    R(0,2) =  DET( E(0,1),E(0,2), E(1,1),E(1,2) );
-
-    R(1,0) = -DET( E(1,0),E(1,2), E(2,0),E(2,2) );
-    R(1,1) =  DET( E(0,0),E(0,2), E(2,0),E(2,2) );
-    R(1,2) = -DET( E(0,0),E(0,2), E(1,0),E(1,2) );
-
-    R(2,0) =  DET( E(1,0),E(1,1), E(2,0),E(2,1) );
-    R(2,1) = -DET( E(0,0),E(0,1), E(2,0),E(2,1) );
-    R(2,2) =  DET( E(0,0),E(0,1), E(1,0),E(1,1) );
-
-    rbReal det = E(0,0) * R(0,0) + E(0,1) * R(1,0) + E(0,2) * R(2,0);
-    // assert( rmFabs(det) >= RIGIDBOX_TOLERANCE );
-
-    result.Scale( 1 / det );
-
-    return result;
-
-#undef E
-#undef R
-#undef DET
-}
-
-inline rbMtx3& rbMtx3::Invert()
-{
-    *this = GetInverse();
-
-    return *this;
-}
-
-inline rbMtx3 rbMtx3::operator +( const rbMtx3& m ) const
-{
-    return rbMtx3( Elem(0,0)+m.Elem(0,0), Elem(0,1)+m.Elem(0,1), Elem(0,2)+m.Elem(0,2),
-                   Elem(1,0)+m.Elem(1,0), Elem(1,1)+m.Elem(1,1), Elem(1,2)+m.Elem(1,2),
-                   Elem(2,0)+m.Elem(2,0), Elem(2,1)+m.Elem(2,1), Elem(2,2)+m.Elem(2,2) );
-}
-
-inline rbMtx3& rbMtx3::operator +=( const rbMtx3& m )
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0] += m.c[0];
-    c[1] += m.c[1];
-    c[2] += m.c[2];
-#else
-    r[0] += m.r[0];
-    r[1] += m.r[1];
-    r[2] += m.r[2];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-
-    return *this;
-}
-
-inline rbMtx3 rbMtx3::operator -( const rbMtx3& m ) const
-{
-    return rbMtx3( Elem(0,0)-m.Elem(0,0), Elem(0,1)-m.Elem(0,1), Elem(0,2)-m.Elem(0,2),
-                   Elem(1,0)-m.Elem(1,0), Elem(1,1)-m.Elem(1,1), Elem(1,2)-m.Elem(1,2),
-                   Elem(2,0)-m.Elem(2,0), Elem(2,1)-m.Elem(2,1), Elem(2,2)-m.Elem(2,2) );
-}
-
-inline rbMtx3& rbMtx3::operator -=( const rbMtx3& m )
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0] -= m.c[0];
-    c[1] -= m.c[1];
-    c[2] -= m.c[2];
-#else
-    r[0] -= m.r[0];
-    r[1] -= m.r[1];
-    r[2] -= m.r[2];
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-
-    return *this;
-}
-
-inline rbMtx3 rbMtx3::operator *( rbReal f ) const
-{
-    return rbMtx3( Elem(0,0)*f, Elem(0,1)*f, Elem(0,2)*f,
-                   Elem(1,0)*f, Elem(1,1)*f, Elem(1,2)*f,
-                   Elem(2,0)*f, Elem(2,1)*f, Elem(2,2)*f );
-}
-
-inline rbMtx3& rbMtx3::operator *=( rbReal f )
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    c[0] *= f;
-    c[1] *= f;
-    c[2] *= f;
-#else
-    r[0] *= f;
-    r[1] *= f;
-    r[2] *= f;
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-
-    return *this;
-}
-
-inline rbMtx3 rbMtx3::operator *( const rbMtx3& m ) const
-{
-    rbMtx3 result;
-    for ( rbs32 row = 0; row < 3; ++row )
-        for ( rbs32 col = 0; col < 3; ++col )
-            result.Elem(row, col) =
-                Elem(row, 0) * m.Elem(0, col) +
-                Elem(row, 1) * m.Elem(1, col) +
-                Elem(row, 2) * m.Elem(2, col) ;
-
-    return result;
-}
-
-inline rbMtx3& rbMtx3::operator *=( const rbMtx3& m )
-{
-    *this = *this * m;
-    return *this;
-}
-
-inline rbVec3 rbMtx3::operator *( const rbVec3& v ) const
-{
-#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-    return rbVec3( Row(0) * v, Row(1) * v, Row(2) * v );
-#else
-    return rbVec3( r[0] * v, r[1] * v, r[2] * v );
-#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
-}
-
-
-//
-// Binary operators
-//
-
-inline rbVec3 operator *( rbReal f, const rbVec3& v )
-{
-    return rbVec3( v.x*f, v.y*f, v.z*f );
-}
-
-inline rbMtx3 operator *( rbReal f, const rbMtx3& m )
-{
-    return m * f;
-}
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include "rbTypes.h"
+
+#if defined(RIGIDBOX_USE_SIMD)
+# include <emmintrin.h>
+# if defined(__SSE4_1__) || defined(__AVX__)
+#  include <smmintrin.h>
+#  define RIGIDBOX_SIMD_DOT_PRODUCT
+# endif
+#endif
+
+inline rbReal rbToRad( rbReal deg )
+{
+    // (/ float-pi 180.0) -> 0.017453292519943295
+    return rbReal(0.017453292519943295) * deg;
+}
+
+inline rbReal rbMin( rbReal a, rbReal b )
+{
+    return a >= b ? b : a;
+}
+
+inline rbReal rbMax( rbReal a, rbReal b )
+{
+    return a >= b ? a : b;
+}
+
+inline rbReal rbClamp( rbReal v, rbReal v_min, rbReal v_max )
+{
+    if ( v < v_min )
+        return v_min;
+    else if ( v > v_max )
+        return v_max;
+    else
+        return v;
+}
+
+inline rbReal rbSign( rbReal v )
+{
+    return v <= -RIGIDBOX_TOLERANCE ? rbReal(-1) : rbReal(1);
+}
+
+
+//
+// rbVec3 Declaration
+//
+
+#if defined(RIGIDBOX_USE_SIMD)
+struct alignas(16) rbVec3
+{
+    // [LANG en] +padding+ never affects x, y and z : every operator ignores (or just carries) it.
+    // [LANG en] Every constructor sets it to zero and the operators keep it zero, so copies of equal vectors
+    // [LANG en] (and of rbMtx3 built from them) are equal byte for byte.
+    // [LANG ja] +padding+ が x, y, z に影響することはありません (どの演算も無視するか、そのまま運ぶだけです)。
+    // [LANG ja] どのコンストラクタも 0 にし、演算も 0 のまま保つので、等しいベクトル (とそれからなる rbMtx3) は
+    // [LANG ja] バイト列としても等しくなります。
+    union
+    {
+        struct
+        {
+            rbReal x, y, z, padding;
+        };
+        rbReal e[4];
+        __m128 m;
+    };
+
+    explicit rbVec3( __m128 m_ );
+#else
+struct rbVec3
+{
+    union
+    {
+        struct
+        {
+            rbReal x, y, z;
+        };
+        rbReal e[3];
+    };
+#endif // defined(RIGIDBOX_USE_SIMD)
+
+    rbVec3();
+    rbVec3( rbReal x_, rbReal y_, rbReal z_ );
+    rbVec3( rbReal* a );
+    rbVec3( const rbVec3& other );
+    rbVec3& operator =( const rbVec3& other );
+    void Set( rbReal x_, rbReal y_, rbReal z_ );
+    void SetZero();
+    void Add( rbReal x_, rbReal y_, rbReal z_ );
+    rbVec3 operator -() const;
+    rbVec3 operator +( const rbVec3& v ) const;
+    rbVec3& operator +=( const rbVec3& v );
+    rbVec3 operator -( const rbVec3& v ) const;
+    rbVec3& operator -=( const rbVec3& v );
+    rbVec3 operator *( rbReal f ) const;
+    rbVec3& operator *=( rbReal f );
+    rbVec3 operator /( rbReal f ) const;
+    rbVec3& operator /=( rbReal f );
+    rbReal operator *( const rbVec3& v ) const;
+    rbVec3 operator %( const rbVec3& v ) const;
+    rbReal Length() const;
+    rbReal LengthSq() const;
+    rbVec3 GetNormalized() const;
+    rbVec3& Normalize();
+
+}; // struct rbVec3
+
+
+//
+// rbMtx3 Declaration
+//
+
+struct rbMtx3
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    rbVec3 c[3];
+#else
+    rbVec3 r[3];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+
+    rbMtx3();
+    rbMtx3( rbReal e00, rbReal e01, rbReal e02,
+            rbReal e10, rbReal e11, rbReal e12,
+            rbReal e20, rbReal e21, rbReal e22 );
+    rbMtx3( const rbMtx3& other );
+    rbMtx3& operator =( const rbMtx3& other );
+    rbReal& Elem( rbs32 row, rbs32 col );
+    const rbReal& Elem( rbs32 row, rbs32 col ) const;
+    rbVec3 Row( rbs32 i ) const;
+    rbVec3 Column( rbs32 i ) const;
+    void Set( rbReal e00, rbReal e01, rbReal e02,
+              rbReal e10, rbReal e11, rbReal e12,
+              rbReal e20, rbReal e21, rbReal e22 );
+    void SetZero();
+    void SetIdentity();
+    rbMtx3& SetFromAxisAngle( const rbVec3& normalized_axis, rbReal radian );
+    void SetAsCrossProductMatrix( const rbVec3& v );
+    void Orthonormalize();
+    void Scale( rbReal f );
+    rbMtx3 GetTransposed() const;
+    rbMtx3& Transpose();
+    rbMtx3 GetInverse() const;
+    rbMtx3& Invert();
+    rbMtx3 operator +( const rbMtx3& m ) const;
+    rbMtx3& operator +=( const rbMtx3& m );
+    rbMtx3 operator -( const rbMtx3& m ) const;
+    rbMtx3& operator -=( const rbMtx3& m );
+    rbMtx3 operator *( rbReal f ) const;
+    rbMtx3& operator *=( rbReal f );
+    rbMtx3 operator *( const rbMtx3& m ) const;
+    rbMtx3& operator *=( const rbMtx3& m );
+    rbVec3 operator *( const rbVec3& v ) const;
+
+}; // struct rbMtx3
+
+
+//
+// rbVec3 Implementation
+//
+
+#if defined(RIGIDBOX_USE_SIMD)
+
+// [LANG en] x*x' + y*y' + z*z' broadcast to the x, y and z lanes (the padding lanes of +a+ and +b+ are ignored).
+// [LANG ja] x*x' + y*y' + z*z' を x, y, z の各レーンに求めます (+a+, +b+ の padding レーンは無視します)。
+inline __m128 rbSimdDot3( __m128 a, __m128 b )
+{
+#if defined(RIGIDBOX_SIMD_DOT_PRODUCT)
+    return _mm_dp_ps( a, b, 0x7F );
+#else
+    __m128 p = _mm_mul_ps( a, b );
+    __m128 s = _mm_add_ps( p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 0, 2, 1)) );
+    return _mm_add_ps( s, _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 1, 0, 2)) );
+#endif // defined(RIGIDBOX_SIMD_DOT_PRODUCT)
+}
+
+inline rbVec3::rbVec3( __m128 m_ )
+    : m(m_)
+{}
+
+#endif // defined(RIGIDBOX_USE_SIMD)
+
+#if defined(RIGIDBOX_USE_SIMD)
+
+inline rbVec3::rbVec3()
+    : m(_mm_setzero_ps())
+{}
+
+inline rbVec3::rbVec3( rbReal x_, rbReal y_, rbReal z_ )
+    : m(_mm_set_ps(0, z_, y_, x_))
+{}
+
+inline rbVec3::rbVec3( rbReal* a )
+    : m(_mm_set_ps(0, a[2], a[1], a[0]))
+{}
+
+inline rbVec3::rbVec3( const rbVec3& other )
+    : m(other.m)
+{}
+
+inline rbVec3& rbVec3::operator =( const rbVec3& other )
+{
+    m = other.m;
+
+    return *this;
+}
+
+inline void rbVec3::Set( rbReal x_, rbReal y_, rbReal z_ )
+{
+    m = _mm_set_ps( 0, z_, y_, x_ );
+}
+
+inline void rbVec3::SetZero()
+{
+    m = _mm_setzero_ps();
+}
+
+inline void rbVec3::Add( rbReal x_, rbReal y_, rbReal z_ )
+{
+    m = _mm_add_ps( m, _mm_set_ps(0, z_, y_, x_) );
+}
+
+inline rbVec3 rbVec3::operator -() const
+{
+    return rbVec3( _mm_sub_ps(_mm_setzero_ps(), m) );
+}
+
+inline rbVec3 rbVec3::operator +( const rbVec3& v ) const
+{
+    return rbVec3( _mm_add_ps(m, v.m) );
+}
+
+inline rbVec3& rbVec3::operator +=( const rbVec3& v )
+{
+    m = _mm_add_ps( m, v.m );
+    return *this;
+}
+
+inline rbVec3 rbVec3::operator -( const rbVec3& v ) const
+{
+    return rbVec3( _mm_sub_ps(m, v.m) );
+}
+
+inline rbVec3& rbVec3::operator -=( const rbVec3& v )
+{
+    m = _mm_sub_ps( m, v.m );
+    return *this;
+}
+
+inline rbVec3 rbVec3::operator *( rbReal f ) const
+{
+    return rbVec3( _mm_mul_ps(m, _mm_set1_ps(f)) );
+}
+
+inline rbVec3& rbVec3::operator *=( rbReal f )
+{
+    m = _mm_mul_ps( m, _mm_set1_ps(f) );
+    return *this;
+}
+
+inline rbVec3 rbVec3::operator /( rbReal f ) const
+{
+    return rbVec3( _mm_div_ps(m, _mm_set_ps(1, f, f, f)) );
+}
+
+inline rbVec3& rbVec3::operator /=( rbReal f )
+{
+    m = _mm_div_ps( m, _mm_set_ps(1, f, f, f) );
+    return *this;
+}
+
+inline rbReal rbVec3::operator *( const rbVec3& v ) const
+{
+    return _mm_cvtss_f32( rbSimdDot3(m, v.m) );
+}
+
+inline rbVec3 rbVec3::operator %( const rbVec3& v ) const
+{
+    // [LANG en] (a * b.yzx - a.yzx * b) holds the cross product in z, x, y order
+    // [LANG ja] (a * b.yzx - a.yzx * b) の各レーンには外積が z, x, y の順に入る
+    __m128 a_yzx = _mm_shuffle_ps( m, m, _MM_SHUFFLE(3, 0, 2, 1) );
+    __m128 b_yzx = _mm_shuffle_ps( v.m, v.m, _MM_SHUFFLE(3, 0, 2, 1) );
+    __m128 c = _mm_sub_ps( _mm_mul_ps(m, b_yzx), _mm_mul_ps(a_yzx, v.m) );
+    return rbVec3( _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)) );
+}
+
+inline rbReal rbVec3::Length() const
+{
+    return _mm_cvtss_f32( _mm_sqrt_ss(rbSimdDot3(m, m)) );
+}
+
+inline rbReal rbVec3::LengthSq() const
+{
+    return _mm_cvtss_f32( rbSimdDot3(m, m) );
+}
+
+inline rbVec3 rbVec3::GetNormalized() const
+{
+    rbReal l = Length();
+    l = rbReal(1) / l;
+    return rbVec3( _mm_mul_ps(m, _mm_set1_ps(l)) );
+}
+
+inline rbVec3& rbVec3::Normalize()
+{
+    rbReal l = Length();
+    l = rbReal(1) / l;
+
+    m = _mm_mul_ps( m, _mm_set1_ps(l) );
+
+    return *this;
+}
+
+#else
+
+inline rbVec3::rbVec3()
+    : x(0), y(0), z(0)
+{}
+
+inline rbVec3::rbVec3( rbReal x_, rbReal y_, rbReal z_ )
+    : x(x_), y(y_), z(z_)
+{}
+
+inline rbVec3::rbVec3( rbReal* a )
+    : x(a[0]), y(a[1]), z(a[2])
+{}
+
+inline rbVec3::rbVec3( const rbVec3& other )
+    : x(other.x), y(other.y), z(other.z)
+{}
+
+inline rbVec3& rbVec3::operator =( const rbVec3& other )
+{
+    x = other.x;  y = other.y;  z = other.z;
+
+    return *this;
+}
+
+inline void rbVec3::Set( rbReal x_, rbReal y_, rbReal z_ )
+{
+    x = x_;  y = y_;  z = z_;
+}
+
+inline void rbVec3::SetZero()
+{
+    x = 0;  y = 0;  z = 0;
+}
+
+inline void rbVec3::Add( rbReal x_, rbReal y_, rbReal z_ )
+{
+    x += x_;  y += y_;  z += z_;
+}
+
+inline rbVec3 rbVec3::operator -() const
+{
+    return rbVec3( -x, -y, -z );
+}
+
+inline rbVec3 rbVec3::operator +( const rbVec3& v ) const
+{
+    return rbVec3( x+v.x, y+v.y, z+v.z );
+}
+
+inline rbVec3& rbVec3::operator +=( const rbVec3& v )
+{
+    x += v.x;  y += v.y;  z += v.z;
+    return *this;
+}
+
+inline rbVec3 rbVec3::operator -( const rbVec3& v ) const
+{
+    return rbVec3( x-v.x, y-v.y, z-v.z );
+}
+
+inline rbVec3& rbVec3::operator -=( const rbVec3& v )
+{
+    x -= v.x;  y -= v.y;  z -= v.z;
+    return *this;
+}
+
+inline rbVec3 rbVec3::operator *( rbReal f ) const
+{
+    return rbVec3( x*f, y*f, z*f );
+}
+
+inline rbVec3& rbVec3::operator *=( rbReal f )
+{
+    x *= f;  y *= f;  z *= f;
+    return *this;
+}
+
+inline rbVec3 rbVec3::operator /( rbReal f ) const
+{
+    return rbVec3( x/f, y/f, z/f );
+}
+
+inline rbVec3& rbVec3::operator /=( rbReal f )
+{
+    x /= f;  y /= f;  z /= f;
+    return *this;
+}
+
+inline rbReal rbVec3::operator *( const rbVec3& v ) const
+{
+    return x*v.x + y*v.y + z*v.z;
+}
+
+inline rbVec3 rbVec3::operator %( const rbVec3& v ) const
+{
+    return rbVec3( y*v.z - z*v.y,
+                   z*v.x - x*v.z,
+                   x*v.y - y*v.x );
+}
+
+inline rbReal rbVec3::Length() const
+{
+    return rbSqrt( x*x + y*y + z*z );
+}
+
+inline rbReal rbVec3::LengthSq() const
+{
+    return x*x + y*y + z*z;
+}
+
+inline rbVec3 rbVec3::GetNormalized() const
+{
+    rbReal l = Length();
+    l = rbReal(1) / l;
+    return rbVec3( l*x, l*y, l*z );
+}
+
+inline rbVec3& rbVec3::Normalize()
+{
+    rbReal l = Length();
+    l = rbReal(1) / l;
+
+    x *= l;
+    y *= l;
+    z *= l;
+
+    return *this;
+}
+
+#endif // defined(RIGIDBOX_USE_SIMD)
+
+
+//
+// rbMtx3 Implementation
+//
+
+inline rbMtx3::rbMtx3()
+{}
+
+inline rbMtx3::rbMtx3( rbReal e00, rbReal e01, rbReal e02,
+                       rbReal e10, rbReal e11, rbReal e12,
+                       rbReal e20, rbReal e21, rbReal e22 )
+{
+    Elem(0,0) = e00;  Elem(0,1) = e01;  Elem(0,2) = e02;
+    Elem(1,0) = e10;  Elem(1,1) = e11;  Elem(1,2) = e12;
+    Elem(2,0) = e20;  Elem(2,1) = e21;  Elem(2,2) = e22;
+}
+
+inline rbMtx3::rbMtx3( const rbMtx3& other )
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0] = other.c[0];
+    c[1] = other.c[1];
+    c[2] = other.c[2];
+#else
+    r[0] = other.r[0];
+    r[1] = other.r[1];
+    r[2] = other.r[2];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline rbMtx3& rbMtx3::operator =( const rbMtx3& other )
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0] = other.c[0];
+    c[1] = other.c[1];
+    c[2] = other.c[2];
+#else
+    r[0] = other.r[0];
+    r[1] = other.r[1];
+    r[2] = other.r[2];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    return *this;
+}
+
+inline rbReal& rbMtx3::Elem( rbs32 row, rbs32 col )
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    return c[col].e[row];
+#else
+    return r[row].e[col];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline const rbReal& rbMtx3::Elem( rbs32 row, rbs32 col ) const
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    return c[col].e[row];
+#else
+    return r[row].e[col];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline rbVec3 rbMtx3::Row( rbs32 i ) const
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    return rbVec3( Elem(i,0), Elem(i,1), Elem(i,2) );
+#else
+    return r[i];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline rbVec3 rbMtx3::Column( rbs32 i ) const
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    return c[i];
+#else
+    return rbVec3( Elem(0,i), Elem(1,i), Elem(2,i) );
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline void rbMtx3::Set( rbReal e00, rbReal e01, rbReal e02,
+                         rbReal e10, rbReal e11, rbReal e12,
+                         rbReal e20, rbReal e21, rbReal e22 )
+{
+    Elem(0,0) = e00;  Elem(0,1) = e01;  Elem(0,2) = e02;
+    Elem(1,0) = e10;  Elem(1,1) = e11;  Elem(1,2) = e12;
+    Elem(2,0) = e20;  Elem(2,1) = e21;  Elem(2,2) = e22;
+}
+
+inline void rbMtx3::SetZero()
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0].SetZero();
+    c[1].SetZero();
+    c[2].SetZero();
+#else
+    r[0].SetZero();
+    r[1].SetZero();
+    r[2].SetZero();
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline void rbMtx3::SetIdentity()
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0].Set( 1, 0, 0 );
+    c[1].Set( 0, 1, 0 );
+    c[2].Set( 0, 0, 1 );
+#else
+    r[0].Set( 1, 0, 0 );
+    r[1].Set( 0, 1, 0 );
+    r[2].Set( 0, 0, 1 );
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+inline rbMtx3& rbMtx3::SetFromAxisAngle( const rbVec3& axis, rbReal radian )
+{
+    rbReal s = rbSin( radian );
+    rbReal c = rbCos( radian );
+    rbReal C = rbReal(1) - c;
+    rbReal x = axis.x;
+    rbReal y = axis.y;
+    rbReal z = axis.z;
+
+    Elem(0,0) = x*x*C + c;
+    Elem(0,1) = x*y*C - z*s;
+    Elem(0,2) = z*x*C + y*s;
+    Elem(1,0) = x*y*C + z*s;
+    Elem(1,1) = y*y*C + c;
+    Elem(1,2) = y*z*C - x*s;
+    Elem(2,0) = z*x*C - y*s;
+    Elem(2,1) = y*z*C + x*s;
+    Elem(2,2) = z*z*C + c;
+
+    return *this;
+}
+
+inline void rbMtx3::SetAsCrossProductMatrix( const rbVec3& v )
+{
+    Set(    0, -v.z,  v.y,
+          v.z,    0, -v.x,
+         -v.y,  v.x,    0 );
+}
+
+//
+// [LANG en] Orhotnomalization algorithm. Should only be used for the orientation matrix of rigid body (rbRigidBody::State::R).
+// [LANG ja] 正規直交化(※注意：剛体の姿勢行列 rbRigidBody::State::R のみで利用すること)
+//
+// Ref.: Rigid Body Dynamics - Chris Hecker's Website
+//       See the physics article series for Game Developer Magazine.
+//       http://chrishecker.com/Rigid_Body_Dynamics
+//
+inline void rbMtx3::Orthonormalize()
+{
+    rbVec3 X( Column(0).Normalize() );
+    rbVec3 Y( Column(1) );
+    rbVec3 Z( (X % Y).Normalize() );
+    Y = (Z % X).Normalize();
+
+    Set( X.e[0], Y.e[0], Z.e[0],
+         X.e[1], Y.e[1], Z.e[1],
+         X.e[2], Y.e[2], Z.e[2] );
+}
+
+inline void rbMtx3::Scale( rbReal f )
+{
+    for ( rbs32 row = 0; row < 3; ++row )
+        for ( rbs32 col = 0; col < 3; ++col )
+            Elem(row, col) *= f;
+}
+
+inline rbMtx3 rbMtx3::GetTransposed() const
+{
+#if defined(RIGIDBOX_USE_SIMD)
+    __m128 r0 = r[0].m, r1 = r[1].m, r2 = r[2].m, r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+    rbMtx3 result;
+    result.r[0].m = r0;
+    result.r[1].m = r1;
+    result.r[2].m = r2;
+    return result;
+#else
+    return rbMtx3( Elem(0,0), Elem(1,0), Elem(2,0),
+                   Elem(0,1), Elem(1,1), Elem(2,1),
+                   Elem(0,2), Elem(1,2), Elem(2,2) );
+#endif // defined(RIGIDBOX_USE_SIMD)
+}
+
+inline rbMtx3& rbMtx3::Transpose()
+{
+    rbReal tmp;
+    tmp = Elem(0,1); Elem(0,1) = Elem(1,0); Elem(1,0) = tmp;
+    tmp = Elem(0,2); Elem(0,2) = Elem(2,0); Elem(2,0) = tmp;
+    tmp = Elem(1,2); Elem(1,2) = Elem(2,1); Elem(2,1) = tmp;
+
+    return *this;
+}
+
+inline rbMtx3 rbMtx3::GetInverse() const
+{
+#define E( row, col ) Elem((row), (col))
+#define R( row, col ) result.Elem((row), (col))
+#define DET( e00, e01, e10, e11 ) ((e00)*(e11)-(e01)*(e10))
+
+    rbMtx3 result;
+    R(0,0) =  DET( E(1,1),E(1,2), E(2,1),E(2,2) );
+    R(0,1) = -DET( E(0,1),E(0,2), E(2,1),E(2,2) );
+    R(0,2) =  DET( E(0,1),E(0,2), E(1,1),E(1,2) );
+
+    R(1,0) = -DET( E(1,0),E(1,2), E(2,0),E(2,2) );
+    R(1,1) =  DET( E(0,0),E(0,2), E(2,0),E(2,2) );
+    R(1,2) = -DET( E(0,0),E(0,2), E(1,0),E(1,2) );
+
+    R(2,0) =  DET( E(1,0),E(1,1), E(2,0),E(2,1) );
+    R(2,1) = -DET( E(0,0),E(0,1), E(2,0),E(2,1) );
+    R(2,2) =  DET( E(0,0),E(0,1), E(1,0),E(1,1) );
+
+    rbReal det = E(0,0) * R(0,0) + E(0,1) * R(1,0) + E(0,2) * R(2,0);
+    // assert( rmFabs(det) >= RIGIDBOX_TOLERANCE );
+
+    result.Scale( 1 / det );
+
+    return result;
+
+#undef E
+#undef R
+#undef DET
+}
+
+inline rbMtx3& rbMtx3::Invert()
+{
+    *this = GetInverse();
+
+    return *this;
+}
+
+inline rbMtx3 rbMtx3::operator +( const rbMtx3& m ) const
+{
+    return rbMtx3( Elem(0,0)+m.Elem(0,0), Elem(0,1)+m.Elem(0,1), Elem(0,2)+m.Elem(0,2),
+                   Elem(1,0)+m.Elem(1,0), Elem(1,1)+m.Elem(1,1), Elem(1,2)+m.Elem(1,2),
+                   Elem(2,0)+m.Elem(2,0), Elem(2,1)+m.Elem(2,1), Elem(2,2)+m.Elem(2,2) );
+}
+
+inline rbMtx3& rbMtx3::operator +=( const rbMtx3& m )
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0] += m.c[0];
+    c[1] += m.c[1];
+    c[2] += m.c[2];
+#else
+    r[0] += m.r[0];
+    r[1] += m.r[1];
+    r[2] += m.r[2];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+
+    return *this;
+}
+
+inline rbMtx3 rbMtx3::operator -( const rbMtx3& m ) const
+{
+    return rbMtx3( Elem(0,0)-m.Elem(0,0), Elem(0,1)-m.Elem(0,1), Elem(0,2)-m.Elem(0,2),
+                   Elem(1,0)-m.Elem(1,0), Elem(1,1)-m.Elem(1,1), Elem(1,2)-m.Elem(1,2),
+                   Elem(2,0)-m.Elem(2,0), Elem(2,1)-m.Elem(2,1), Elem(2,2)-m.Elem(2,2) );
+}
+
+inline rbMtx3& rbMtx3::operator -=( const rbMtx3& m )
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0] -= m.c[0];
+    c[1] -= m.c[1];
+    c[2] -= m.c[2];
+#else
+    r[0] -= m.r[0];
+    r[1] -= m.r[1];
+    r[2] -= m.r[2];
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+
+    return *this;
+}
+
+inline rbMtx3 rbMtx3::operator *( rbReal f ) const
+{
+    return rbMtx3( Elem(0,0)*f, Elem(0,1)*f, Elem(0,2)*f,
+                   Elem(1,0)*f, Elem(1,1)*f, Elem(1,2)*f,
+                   Elem(2,0)*f, Elem(2,1)*f, Elem(2,2)*f );
+}
+
+inline rbMtx3& rbMtx3::operator *=( rbReal f )
+{
+#if defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    c[0] *= f;
+    c[1] *= f;
+    c[2] *= f;
+#else
+    r[0] *= f;
+    r[1] *= f;
+    r[2] *= f;
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+
+    return *this;
+}
+
+inline rbMtx3 rbMtx3::operator *( const rbMtx3& m ) const
+{
+    rbMtx3 result;
+#if defined(RIGIDBOX_USE_SIMD)
+    // [LANG en] Row i of the product = a(i,0) * m.r[0] + a(i,1) * m.r[1] + a(i,2) * m.r[2]
+    // [LANG ja] 積の第 i 行 = a(i,0) * m.r[0] + a(i,1) * m.r[1] + a(i,2) * m.r[2]
+    for ( rbs32 row = 0; row < 3; ++row )
+    {
+        const __m128 a = r[row].m;
+        __m128 sum = _mm_mul_ps( _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), m.r[0].m );
+        sum = _mm_add_ps( sum, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), m.r[1].m) );
+        sum = _mm_add_ps( sum, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), m.r[2].m) );
+        result.r[row].m = sum;
+    }
+#else
+    for ( rbs32 row = 0; row < 3; ++row )
+        for ( rbs32 col = 0; col < 3; ++col )
+            result.Elem(row, col) =
+                Elem(row, 0) * m.Elem(0, col) +
+                Elem(row, 1) * m.Elem(1, col) +
+                Elem(row, 2) * m.Elem(2, col) ;
+#endif // defined(RIGIDBOX_USE_SIMD)
+
+    return result;
+}
+
+inline rbMtx3& rbMtx3::operator *=( const rbMtx3& m )
+{
+    *this = *this * m;
+    return *this;
+}
+
+inline rbVec3 rbMtx3::operator *( const rbVec3& v ) const
+{
+#if defined(RIGIDBOX_USE_SIMD)
+    // [LANG en] Transposing the three products r[i] * v leaves each row's dot product in lane i
+    // [LANG ja] 三つの積 r[i] * v を転置すると、各行の内積がレーン i に求まる
+    __m128 p0 = _mm_mul_ps( r[0].m, v.m );
+    __m128 p1 = _mm_mul_ps( r[1].m, v.m );
+    __m128 p2 = _mm_mul_ps( r[2].m, v.m );
+    __m128 p3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS( p0, p1, p2, p3 );
+    return rbVec3( _mm_add_ps(_mm_add_ps(p0, p1), p2) );
+#elif defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+    return rbVec3( Row(0) * v, Row(1) * v, Row(2) * v );
+#else
+    return rbVec3( r[0] * v, r[1] * v, r[2] * v );
+#endif // defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+}
+
+
+//
+// Binary operators
+//
+
+inline rbVec3 operator *( rbReal f, const rbVec3& v )
+{
+#if defined(RIGIDBOX_USE_SIMD)
+    return v * f;
+#else
+    return rbVec3( v.x*f, v.y*f, v.z*f );
+#endif // defined(RIGIDBOX_USE_SIMD)
+}
+
+inline rbMtx3 operator *( rbReal f, const rbMtx3& m )
+{
+    return m * f;
+}
+
+
+//
+// rbAABB
+//
+
+// [LANG en] Axis-aligned bounding box (used by the broadphase).
+// [LANG ja] 軸に平行な境界箱 (ブロードフェーズで利用)。
+struct rbAABB
+{
+    rbVec3 lower;
+    rbVec3 upper;
+
+    rbAABB()
+        {}
+
+    rbAABB( const rbVec3& lower_, const rbVec3& upper_ )
+        : lower(lower_), upper(upper_)
+        {}
+
+    bool Overlaps( const rbAABB& other ) const
+        {
+#if defined(RIGIDBOX_USE_SIMD)
+            __m128 overlap = _mm_and_ps( _mm_cmple_ps(lower.m, other.upper.m), _mm_cmpge_ps(upper.m, other.lower.m) );
+            return (_mm_movemask_ps(overlap) & 0x7) == 0x7;
+#else
+            return (lower.x <= other.upper.x) & (upper.x >= other.lower.x) &
+                   (lower.y <= other.upper.y) & (upper.y >= other.lower.y) &
+                   (lower.z <= other.upper.z) & (upper.z >= other.lower.z);
+#endif // defined(RIGIDBOX_USE_SIMD)
+        }
+
+    void Merge( const rbAABB& other )
+        {
+#if defined(RIGIDBOX_USE_SIMD)
+            lower.m = _mm_min_ps( lower.m, other.lower.m );
+            upper.m = _mm_max_ps( upper.m, other.upper.m );
+#else
+            for ( rbs32 i = 0; i < 3; ++i )
+            {
+                lower.e[i] = rbMin( lower.e[i], other.lower.e[i] );
+                upper.e[i] = rbMax( upper.e[i], other.upper.e[i] );
+            }
+#endif // defined(RIGIDBOX_USE_SIMD)
+        }
+
+    rbAABB Translated( const rbVec3& d ) const
+        { return rbAABB( lower + d, upper + d ); }
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
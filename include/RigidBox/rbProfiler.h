@@ -0,0 +1,253 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "rbTypes.h"
+
+/// @define RIGIDBOX_DISABLE_PROFILE
+///
+/// Removes the RIGIDBOX_PROFILE_* instrumentation at compile time. rbFrameStats then only holds
+/// the frame number, BroadPhasePairs and SkippedBodyUpdates, and no trace events are recorded.
+
+// #define RIGIDBOX_DISABLE_PROFILE
+
+// [LANG en] Counters and phase timings of one rbEnvironment::Update.
+// [LANG ja] rbEnvironment::Update 1回分のカウンターと処理段階ごとの時間。
+struct rbFrameStats
+{
+    static const rbu32 Phase_Update       = 0;
+    static const rbu32 Phase_DerivedData  = 1;
+    static const rbu32 Phase_BroadPhase   = 2;
+    static const rbu32 Phase_NarrowPhase  = 3;
+    static const rbu32 Phase_ContactDedup = 4;
+    static const rbu32 Phase_Velocity     = 5;
+    static const rbu32 Phase_Solver       = 6;
+    static const rbu32 Phase_Sleep        = 7;
+    static const rbu32 Phase_CCD          = 8;
+    static const rbu32 Phase_Position     = 9;
+    static const rbu32 Phase_Events       = 10;
+    static const rbu32 PhaseCount         = 11;
+
+    static const char* PhaseName( rbu32 phase );
+
+    // [LANG en] Number of Updates before this one
+    // [LANG ja] これより前の Update の回数
+    rbu64 Frame;
+
+    // [LANG en] Time spent in each phase, summed over the substeps (Phase_Update covers the whole Update)
+    // [LANG ja] 各処理段階に費やした時間 (サブステップの合計。Phase_Update は Update 全体)
+    rbu64 PhaseNanoseconds[PhaseCount];
+
+    // [LANG en] Pairs reported by the broadphase
+    // [LANG ja] ブロードフェーズが報告した組
+    rbu32 BroadPhasePairs;
+
+    // [LANG en] Narrow phase queries (rbCollision::Detect, DetectSpeculative and Overlap) issued for those pairs
+    // [LANG ja] それらの組に対して行った詳細判定 (rbCollision::Detect, DetectSpeculative, Overlap) の回数
+    rbu32 PairsTested;
+
+    // [LANG en] Candidate axes projected by the separating-axis tests during the Update
+    // [LANG ja] Update の間に分離軸テストで射影を計算した候補軸の数
+    rbu32 SATAxesEvaluated;
+
+    // [LANG en] Contacts generated by the narrow phase, and those dropped as duplicates (see Config::NearThreshold)
+    // [LANG ja] 詳細判定が生成した衝突点の数と、そのうち重複として捨てた数 (Config::NearThreshold を参照)
+    rbu32 ContactsFound;
+    rbu32 ContactsDeduped;
+
+    // [LANG en] Contacts that received a non-zero impulse
+    // [LANG ja] 0 でない力積を加えた衝突点の数
+    rbu32 ImpulsesApplied;
+
+    // [LANG en] Bodies sleeping at the end of the Update
+    // [LANG ja] Update の終了時にスリープしている剛体の数
+    rbu32 BodiesAsleep;
+
+    // [LANG en] See rbEnvironment::SkippedBodyUpdateCount
+    // [LANG ja] rbEnvironment::SkippedBodyUpdateCount を参照
+    rbu32 SkippedBodyUpdates;
+
+    void Clear();
+};
+
+// Per-frame statistics and trace recorder of rbEnvironment.
+//
+// [LANG en] The phases of Update are timed by RIGIDBOX_PROFILE_SCOPE and the counters are bumped by RIGIDBOX_PROFILE_COUNT.
+// [LANG en] When a trace capacity is set, every timed scope is also kept as an event, and WriteChromeTrace exports
+// [LANG en] them in the Chrome trace-event format (chrome://tracing, Perfetto).
+// [LANG ja] Update の各処理段階の時間は RIGIDBOX_PROFILE_SCOPE で、カウンターは RIGIDBOX_PROFILE_COUNT で計測します。
+// [LANG ja] トレースの容量を設定すると計測した区間をイベントとしても記録し、WriteChromeTrace で
+// [LANG ja] Chrome の trace-event 形式 (chrome://tracing, Perfetto) に書き出せます。
+class rbProfiler
+{
+public:
+
+    // [LANG en] Called when a timed phase begins (+begin+ == true) and ends, e.g. to read hardware counters around it.
+    // [LANG ja] 計測する処理段階の開始時 (+begin+ == true) と終了時に呼ばれます (ハードウェアカウンターの読み取り等に)。
+    using PhaseCallback = void (*)( rbu32 phase, bool begin, void* user_data );
+
+    rbProfiler();
+
+    const rbFrameStats& Stats() const
+        { return stats; }
+
+    rbFrameStats& Stats()
+        { return stats; }
+
+    // [LANG en] Nanoseconds since the profiler was created
+    // [LANG ja] プロファイラーの生成からの経過時間 (ナノ秒)
+    rbu64 Now() const
+        { return static_cast<rbu64>( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count() ); }
+
+    // [LANG en] Called by rbEnvironment::Update around each frame and substep.
+    // [LANG ja] rbEnvironment::Update がフレームとサブステップごとに呼び出します。
+    void BeginFrame();
+    void EndFrame();
+
+    void SetSubstep( rbs32 substep )
+        { this->substep = substep; }
+
+    // [LANG en] Adds a timed phase to the stats (and to the trace, if enabled), then calls the PhaseCallback.
+    // [LANG ja] 計測した処理段階を統計に加え (トレースが有効ならトレースにも)、PhaseCallback を呼び出します。
+    void AddPhase( rbu32 phase, rbu64 begin, rbu64 end );
+
+    // [LANG en] Keeps at most +capacity+ timed scopes (and as many frame counter samples) for WriteChromeTrace.
+    // [LANG en] Discards the recorded trace. 0 (the default) disables recording.
+    // [LANG ja] WriteChromeTrace のために最大 +capacity+ 個の計測区間 (および同数のフレームのカウンター) を保持します。
+    // [LANG ja] 記録済みのトレースは破棄します。0 (既定値) の場合は記録しません。
+    void SetTraceCapacity( rbu32 capacity );
+
+    rbu32 TraceCapacity() const
+        { return trace_capacity; }
+
+    rbu32 TraceEventCount() const
+        { return static_cast<rbu32>(trace_events.size()); }
+
+    // [LANG en] Number of scopes not recorded because the trace was full
+    // [LANG ja] トレースが一杯だったために記録しなかった区間の数
+    rbu32 TraceOverflowCount() const
+        { return trace_overflow_count; }
+
+    void ClearTrace();
+
+    // [LANG en] nullptr (the default) removes the callback.
+    // [LANG ja] nullptr (既定値) を渡すとコールバックを解除します。
+    void SetPhaseCallback( PhaseCallback callback, void* user_data = nullptr )
+        {
+            phase_callback = callback;
+            phase_callback_user_data = user_data;
+        }
+
+    void BeginPhase( rbu32 phase )
+        {
+            if ( phase_callback != nullptr )
+                phase_callback( phase, true, phase_callback_user_data );
+        }
+
+    // [LANG en] Writes the recorded trace as Chrome trace-event JSON. Returns false if the file cannot be written.
+    // [LANG ja] 記録したトレースを Chrome の trace-event 形式の JSON として書き出します。書き込めない場合は false を返します。
+    bool WriteChromeTrace( const char* path ) const;
+
+    // [LANG en] Free-running count of separating axes evaluated by rbCollision on the calling thread
+    // [LANG ja] 呼び出したスレッドで rbCollision が評価した分離軸の数 (単調増加)
+    static rbu32 SATAxisCount()
+        { return sat_axis_count; }
+
+    static void CountSATAxis()
+        { ++sat_axis_count; }
+
+    // [LANG en] Times the enclosing block as +phase+.
+    // [LANG ja] 囲んでいるブロックの時間を +phase+ として計測します。
+    class Scope
+    {
+    public:
+        Scope( rbProfiler& profiler, rbu32 phase )
+            : profiler(profiler)
+            , phase(phase)
+            , begin(0)
+        {
+            profiler.BeginPhase( phase );
+            begin = profiler.Now();
+        }
+
+        ~Scope()
+            { profiler.AddPhase( phase, begin, profiler.Now() ); }
+
+        Scope( const Scope& ) = delete;
+        Scope& operator =( const Scope& ) = delete;
+
+    private:
+        rbProfiler& profiler;
+        rbu32 phase;
+        rbu64 begin;
+    };
+
+private:
+
+    struct TraceEvent
+    {
+        rbu32 Phase;
+        rbs32 Substep;
+        rbu64 Frame;
+        rbu64 Begin;
+        rbu64 End;
+    };
+
+    struct TraceFrame
+    {
+        rbu64 Begin;
+        rbFrameStats Stats;
+    };
+
+    rbFrameStats stats;
+    std::chrono::steady_clock::time_point epoch;
+    rbu64 frame_count;
+    rbu64 frame_begin;
+    rbu32 frame_sat_axis_begin;
+    rbs32 substep;
+
+    std::vector<TraceEvent> trace_events;
+    std::vector<TraceFrame> trace_frames;
+    rbu32 trace_capacity;
+    rbu32 trace_overflow_count;
+    PhaseCallback phase_callback;
+    void* phase_callback_user_data;
+
+    static thread_local rbu32 sat_axis_count;
+};
+
+#define RIGIDBOX_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RIGIDBOX_PROFILE_CONCAT(a, b) RIGIDBOX_PROFILE_CONCAT_IMPL(a, b)
+
+#if !defined(RIGIDBOX_DISABLE_PROFILE)
+# define RIGIDBOX_PROFILE_SCOPE(profiler, phase) rbProfiler::Scope RIGIDBOX_PROFILE_CONCAT(rb_profile_scope_, __LINE__)( (profiler), rbFrameStats::phase )
+# define RIGIDBOX_PROFILE_COUNT(profiler, counter, n) ((profiler).Stats().counter += static_cast<rbu32>(n))
+# define RIGIDBOX_PROFILE_SAT_AXIS() rbProfiler::CountSATAxis()
+#else
+# define RIGIDBOX_PROFILE_SCOPE(profiler, phase) ((void)0)
+# define RIGIDBOX_PROFILE_COUNT(profiler, counter, n) ((void)0)
+# define RIGIDBOX_PROFILE_SAT_AXIS() ((void)0)
+#endif
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
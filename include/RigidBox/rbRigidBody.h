@@ -1,347 +1,746 @@
-// -*- mode: C++; coding: utf-8; -*-
-#pragma once
-
-#include "rbTypes.h"
-#include "rbMath.h"
-
-class rbRigidBody
-{
-public:
-
-    struct State
-    {
-        // [LANG en] +position+ represents 'center-of-mass position'.
-        // [LANG ja] +position+ は重心の位置を示します。
-        rbVec3 position;
-        rbMtx3 orientation;
-
-        rbVec3 linear_velocity;
-        rbVec3 angular_velocity;
-
-        rbVec3 force;
-        rbVec3 torque;
-
-        rbVec3 angular_momentum;
-        rbMtx3 inv_inertia_world;
-
-        State()
-            : position(rbReal(0), rbReal(0), rbReal(0))
-            , orientation(rbReal(1), 0, 0,
-                          0, rbReal(1), 0,
-                          0, 0, rbReal(1))
-            , linear_velocity(rbReal(0), rbReal(0), rbReal(0))
-            , angular_velocity(rbReal(0), rbReal(0), rbReal(0))
-            , force(rbReal(0), rbReal(0), rbReal(0))
-            , torque(rbReal(0), rbReal(0), rbReal(0))
-            , angular_momentum(rbReal(0), rbReal(0), rbReal(0))
-            , inv_inertia_world(rbReal(1), 0, 0,
-                                0, rbReal(1), 0,
-                                0, 0, rbReal(1))
-            {}
-
-    };
-
-    struct SolverWorkArea
-    {
-        rbVec3 delta_linear_velocity;
-        rbVec3 delta_angular_momentum;
-        rbVec3 delta_angular_velocity;
-
-        SolverWorkArea()
-            : delta_linear_velocity(0, 0, 0)
-            , delta_angular_momentum(0, 0, 0)
-            , delta_angular_velocity(0, 0, 0)
-            {}
-
-        void Clear()
-            {
-                delta_linear_velocity.SetZero();
-                delta_angular_momentum.SetZero();
-                delta_angular_velocity.SetZero();
-            }
-    };
-
-    struct Shape
-    {
-        // [LANG en] each elements correspond to the box's half-extent in x-, y- and z-direction.
-        // [LANG ja] それぞれの要素が直方体の x-, y-, z- 軸方向の half-extent に対応します。
-        rbVec3 half_extent;
-
-        rbReal inv_mass;
-        rbMtx3 inv_inertia;
-
-        rbReal restitution_coefficient;
-        rbReal friction_coefficient;
-
-        Shape()
-            : half_extent(rbReal(1), rbReal(1), rbReal(1))
-            , inv_mass(rbReal(1))
-            , inv_inertia(rbReal(1), 0, 0,
-                          0, rbReal(1), 0,
-                          0, 0, rbReal(1))
-            , restitution_coefficient(rbReal(0.5))
-            , friction_coefficient(rbReal(0.5))
-            {}
-
-        void Set(rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff)
-        {
-            half_extent.Set(hx, hy, hz);
-            restitution_coefficient = restitution_coeff;
-            friction_coefficient = friction_coeff;
-
-            inv_mass = rbReal(1) / mass;
-
-            rbMtx3 inertia(mass * (hy * hy + hz * hz) / rbReal(3), 0, 0,
-                0, mass * (hx * hx + hz * hz) / rbReal(3), 0,
-                0, 0, mass * (hx * hx + hy * hy) / rbReal(3));
-            inv_inertia = inertia.GetInverse();
-        }
-	};
-
-    struct SleepStatus
-    {
-        bool On;
-        rbReal GoSleepThresholdLV;
-        rbReal GoSleepThresholdAV;
-        rbReal WakeUpThresholdLV;
-        rbReal WakeUpThresholdAV;
-        rbReal GoSleepDuration;
-        rbReal SleepingDuration;
-
-        SleepStatus()
-            : On( false )
-            , GoSleepThresholdLV( rbReal(0.03) )
-            , GoSleepThresholdAV( rbReal(0.03) )
-            , WakeUpThresholdLV( rbReal(1.0) )
-            , WakeUpThresholdAV( rbReal(1.0) )
-            , GoSleepDuration( rbReal(0.5) )
-            , SleepingDuration( 0 )
-            {}
-
-        void Clear()
-            {
-                On = false;
-                GoSleepThresholdLV = rbReal(0.03);
-                GoSleepThresholdAV = rbReal(0.03);
-                WakeUpThresholdLV = rbReal(1.0);
-                WakeUpThresholdAV = rbReal(1.0);
-                GoSleepDuration = rbReal(0.5);
-                SleepingDuration = 0;
-            }
-    };
-
-    static const rbu32 Attribute_None            = 0x00000000U;
-    static const rbu32 Attribute_Fixed           = 0x00000001U;
-    static const rbu32 Attribute_AutoSleep       = 0x00000002U;
-
-    rbRigidBody()
-        : state()
-        , shape()
-        , solver_work_area()
-        , sleep_status()
-        , attribute(Attribute_None)
-        {}
-
-    rbVec3 Position()
-        { return state.position; }
-
-    void SetPosition( rbReal x, rbReal y, rbReal z )
-        { state.position.Set( x, y, z ); }
-
-    void SetPosition( const rbVec3& v )
-        { state.position = v; }
-
-    void AddPosition( rbReal dx, rbReal dy, rbReal dz )
-        { state.position.Add(dx, dy, dz); }
-
-    void AddPosition( const rbVec3& dv )
-        { state.position += dv; }
-
-
-    rbMtx3 Orientation()
-        { return state.orientation; }
-
-    rbMtx3 OrientationTranspose()
-        { return state.orientation.GetTransposed(); }
-
-    void SetOrientation( const rbMtx3& m )
-        { state.orientation = m; }
-
-    void SetOrientation( rbReal rad_x, rbReal rad_y, rbReal rad_z );
-    void AddOrientation( rbReal rad_dx, rbReal rad_dy, rbReal rad_dz );
-
-
-    rbVec3 LinearVelocity()
-        { return state.linear_velocity; }
-
-    void SetLinearVelocity( rbReal x, rbReal y, rbReal z )
-        { state.linear_velocity.Set( x, y, z ); }
-
-    void SetLinearVelocity( const rbVec3& v )
-        { state.linear_velocity = v; }
-
-    void AddLinearVelocity( rbReal dx, rbReal dy, rbReal dz )
-        { state.linear_velocity.Add(dx, dy, dz); }
-
-    void AddLinearVelocity( const rbVec3& dv )
-        { state.linear_velocity += dv; }
-
-
-    rbVec3 AngularVelocity()
-        { return state.angular_velocity; }
-
-    void SetAngularVelocity( rbReal x, rbReal y, rbReal z );
-    void SetAngularVelocity( const rbVec3& v );
-    void AddAngularVelocity( rbReal dx, rbReal dy, rbReal dz );
-    void AddAngularVelocity( const rbVec3& dv );
-
-
-    rbVec3 AngularMomentum()
-        { return state.angular_momentum; }
-
-    void SetAngularMomentum( rbReal x, rbReal y, rbReal z )
-        { state.angular_momentum.Set( x, y, z ); }
-
-    void SetAngularMomentum( const rbVec3& v )
-        { state.angular_momentum = v; }
-
-    void AddAngularMomentum( rbReal dx, rbReal dy, rbReal dz )
-        { state.angular_momentum.Add(dx, dy, dz); }
-
-    void AddAngularMomentum( const rbVec3& dv )
-        { state.angular_momentum += dv; }
-
-
-    rbVec3 Force()
-        { return state.force; }
-
-    void SetForce( rbReal x, rbReal y, rbReal z )
-        { state.force.Set( x, y, z ); }
-
-    void SetForce( const rbVec3& v )
-        { state.force = v; }
-
-    void SetForceAt( const rbVec3& v, const rbVec3& at );
-
-    void AddForce( rbReal dx, rbReal dy, rbReal dz )
-        { state.force.Add(dx, dy, dz); }
-
-    void AddForce( const rbVec3& dv )
-        { state.force += dv; }
-
-    void AddForceAt( const rbVec3& dv, const rbVec3& at );
-
-
-    rbVec3 Torque()
-        { return state.torque; }
-
-    void SetTorque( rbReal x, rbReal y, rbReal z )
-        { state.torque.Set( x, y, z ); }
-
-    void SetTorque( const rbVec3& v )
-        { state.torque = v; }
-
-    void AddTorque( rbReal dx, rbReal dy, rbReal dz )
-        { state.torque.Add(dx, dy, dz); }
-
-    void AddTorque( const rbVec3& dv )
-        { state.torque += dv; }
-
-
-    void SetShapeParameter( rbReal mass,
-                            rbReal hx, rbReal hy, rbReal hz,
-                            rbReal restitution_coeff, rbReal friction_coeff );
-
-    rbVec3 HalfExtent()
-        { return shape.half_extent; }
-
-    rbReal Restitution()
-        { return shape.restitution_coefficient; }
-
-    rbReal Friction()
-        { return shape.friction_coefficient; }
-
-    rbReal InvMass()
-        { return shape.inv_mass; }
-
-    rbMtx3 InvInertia()
-        { return shape.inv_inertia; }
-
-    rbMtx3 InvInertiaWorld()
-        { return state.inv_inertia_world; }
-
-    void UpdateInvInertiaWorld();
-
-
-    rbu32 Attribute()
-        { return attribute; }
-    void EnableAttribute( rbu32 attr )
-        { attribute |= attr; }
-    void DisableAttribute( rbu32 attr )
-        { attribute &= ~attr; }
-    bool AttributeEnabled( rbu32 attr )
-        { return (attribute & attr) != 0; }
-
-    bool IsFixed()
-        { return (attribute & Attribute_Fixed) != 0; }
-    bool IsNotFixed()
-        { return (attribute & Attribute_Fixed) == 0; }
-
-    bool Sleeping()
-        { return sleep_status.On == true; }
-    bool Awake()
-        { return sleep_status.On == false; }
-    void SetSleepOn()
-        { sleep_status.On = true; }
-    void SetSleepOff()
-        { sleep_status.On = false; }
-
-
-    void UpdateVelocity( rbReal dt );
-    void ApplyImpulse( const rbVec3& impulse, const rbVec3& relative_position );
-    void CorrectVelocity();
-    void UpdatePosition( rbReal dt );
-    void UpdateSleepStatus( rbReal dt );
-
-    void ClearSolverWorkArea()
-        { solver_work_area.Clear(); }
-
-    void ClearSleepStatus()
-        { sleep_status.Clear(); }
-
-    void ResetStatuses()
-        {
-            ClearSolverWorkArea();
-            ClearSleepStatus();
-        }
-
-private:
-
-    State state;
-    Shape shape;
-    SolverWorkArea solver_work_area;
-    SleepStatus sleep_status;
-    rbu32 attribute;
-};
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include "rbTypes.h"
+#include "rbMath.h"
+#include "rbConvexHull.h"
+#include "rbTriangleMesh.h"
+#include "rbHeightField.h"
+#include "rbCompound.h"
+
+class rbShapeLibrary;
+
+class rbRigidBody
+{
+public:
+
+    // [LANG en] The body is laid out in three blocks by access frequency :
+    // [LANG en] - hot  : State, read and written by every substep (integration, solver). Cache-line aligned.
+    // [LANG en] - warm : solver work area, shape, attributes and sleep status, touched once or twice per substep.
+    // [LANG en] - cold : force/torque accumulators and the kinematic target, set by the application between Updates.
+    // [LANG ja] 剛体のデータはアクセス頻度によって三つのブロックに分けて配置します :
+    // [LANG ja] - hot  : State。サブステップごとに読み書きされます (積分、ソルバー)。キャッシュラインに揃えます。
+    // [LANG ja] - warm : ソルバー作業領域・形状・属性・スリープ状態。サブステップごとに1, 2回参照されます。
+    // [LANG ja] - cold : 力・トルクの累積値とキネマティックな目標。Update の合間にアプリケーションが設定します。
+    struct alignas(RIGIDBOX_CACHE_LINE_SIZE) State
+    {
+        // [LANG en] +position+ represents 'center-of-mass position'.
+        // [LANG ja] +position+ は重心の位置を示します。
+        rbVec3 position;
+        rbMtx3 orientation;
+
+        rbVec3 linear_velocity;
+        rbVec3 angular_velocity;
+
+        rbVec3 angular_momentum;
+        rbMtx3 inv_inertia_world;
+
+        State()
+            : position(rbReal(0), rbReal(0), rbReal(0))
+            , orientation(rbReal(1), 0, 0,
+                          0, rbReal(1), 0,
+                          0, 0, rbReal(1))
+            , linear_velocity(rbReal(0), rbReal(0), rbReal(0))
+            , angular_velocity(rbReal(0), rbReal(0), rbReal(0))
+            , angular_momentum(rbReal(0), rbReal(0), rbReal(0))
+            , inv_inertia_world(rbReal(1), 0, 0,
+                                0, rbReal(1), 0,
+                                0, 0, rbReal(1))
+            {}
+
+    };
+
+    struct Accumulator
+    {
+        rbVec3 force;
+        rbVec3 torque;
+
+        Accumulator()
+            : force(rbReal(0), rbReal(0), rbReal(0))
+            , torque(rbReal(0), rbReal(0), rbReal(0))
+            {}
+    };
+
+    struct SolverWorkArea
+    {
+        rbVec3 delta_linear_velocity;
+        rbVec3 delta_angular_momentum;
+        rbVec3 delta_angular_velocity;
+
+        SolverWorkArea()
+            : delta_linear_velocity(0, 0, 0)
+            , delta_angular_momentum(0, 0, 0)
+            , delta_angular_velocity(0, 0, 0)
+            {}
+
+        void Clear()
+            {
+                delta_linear_velocity.SetZero();
+                delta_angular_momentum.SetZero();
+                delta_angular_velocity.SetZero();
+            }
+    };
+
+    // [LANG en] Shapes are immutable once set up and shared by any number of bodies (see rbShapeLibrary).
+    // [LANG ja] 形状は設定後は変更されず、任意の数の剛体から共有されます (rbShapeLibrary を参照)。
+    struct Shape
+    {
+        rbu32 type;
+
+        // [LANG en] each elements correspond to the box's half-extent in x-, y- and z-direction.
+        // [LANG en] For a convex hull, this is the extent that bounds all of its vertices.
+        // [LANG ja] それぞれの要素が直方体の x-, y-, z- 軸方向の half-extent に対応します。
+        // [LANG ja] 凸包の場合は全頂点を包む大きさを表します。
+        rbVec3 half_extent;
+
+        // [LANG en] Shared, read-only shape data selected by +type+ (unused for boxes). Not owned by the shape.
+        // [LANG ja] +type+ に応じた共有・読み取り専用の形状データ (直方体では未使用)。Shape は所有権を持ちません。
+        union
+        {
+            const rbConvexHull* convex_hull;
+            const rbTriangleMesh* triangle_mesh;
+            const rbHeightField* height_field;
+            const rbCompound* compound;
+        };
+
+        rbReal inv_mass;
+
+        // [LANG en] Inverse inertia tensor = principal_axes * diag(inv_inertia_diagonal) * principal_axes^T.
+        // [LANG en] Boxes are always diagonal in the body frame (principal_axes_identity == true).
+        // [LANG ja] 慣性テンソルの逆行列 = principal_axes * diag(inv_inertia_diagonal) * principal_axes^T。
+        // [LANG ja] 直方体は常に剛体の座標系で対角になります (principal_axes_identity == true)。
+        rbVec3 inv_inertia_diagonal;
+        rbMtx3 principal_axes;
+        bool principal_axes_identity;
+
+        rbReal restitution_coefficient;
+        rbReal friction_coefficient;
+
+        Shape()
+            : type(ShapeType_Box)
+            , half_extent(rbReal(1), rbReal(1), rbReal(1))
+            , convex_hull(nullptr)
+            , inv_mass(rbReal(1))
+            , inv_inertia_diagonal(rbReal(1), rbReal(1), rbReal(1))
+            , principal_axes(rbReal(1), 0, 0,
+                             0, rbReal(1), 0,
+                             0, 0, rbReal(1))
+            , principal_axes_identity(true)
+            , restitution_coefficient(rbReal(0.5))
+            , friction_coefficient(rbReal(0.5))
+            {}
+
+        void Set(rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff);
+
+        // [LANG en] Returns false and leaves the shape unchanged if +hull+ is null or not Valid().
+        // [LANG ja] +hull+ が null または Valid() でなければ false を返し、形状は変更しません。
+        bool Set(rbReal mass, const rbConvexHull* hull, rbReal restitution_coeff, rbReal friction_coeff);
+
+        // [LANG en] Meshes are static : the mass is infinite (inv_mass == 0).
+        // [LANG ja] メッシュは静的な形状なので質量は無限大 (inv_mass == 0) とします。
+        void Set(const rbTriangleMesh* mesh, rbReal restitution_coeff, rbReal friction_coeff);
+        void Set(const rbHeightField* field, rbReal restitution_coeff, rbReal friction_coeff);
+        void Set(const rbCompound* compound_shape, rbReal restitution_coeff, rbReal friction_coeff);
+
+        rbMtx3 InvInertia() const;
+
+    private:
+
+        // [LANG en] Diagonalizes the (symmetric) inertia tensor and stores its inverse
+        // [LANG ja] (対称な) 慣性テンソルを対角化し、その逆を保持する
+        void SetInertia( const rbMtx3& inertia );
+    };
+
+    // [LANG en] Sleep thresholds shared by a class of bodies (see SetSleepThresholds)
+    // [LANG ja] 剛体の種類ごとに共有するスリープの閾値 (SetSleepThresholds を参照)
+    struct SleepThresholds
+    {
+        rbReal GoSleepThresholdLV;
+        rbReal GoSleepThresholdAV;
+        rbReal WakeUpThresholdLV;
+        rbReal WakeUpThresholdAV;
+        rbReal GoSleepDuration;
+
+        SleepThresholds()
+            : GoSleepThresholdLV( rbReal(0.03) )
+            , GoSleepThresholdAV( rbReal(0.03) )
+            , WakeUpThresholdLV( rbReal(1.0) )
+            , WakeUpThresholdAV( rbReal(1.0) )
+            , GoSleepDuration( rbReal(0.5) )
+            {}
+    };
+
+    struct SleepStatus
+    {
+        bool On;
+        rbReal SleepingDuration;
+
+        SleepStatus()
+            : On( false )
+            , SleepingDuration( 0 )
+            {}
+
+        void Clear()
+            {
+                On = false;
+                SleepingDuration = 0;
+            }
+    };
+
+    static const rbu32 Attribute_None            = 0x00000000U;
+    static const rbu32 Attribute_Fixed           = 0x00000001U;
+    static const rbu32 Attribute_AutoSleep       = 0x00000002U;
+    // [LANG en] Continuous collision detection : the body is swept against others to prevent tunneling
+    // [LANG ja] 連続衝突検出 : すり抜けを防ぐため、移動を掃引して他の剛体と判定する
+    static const rbu32 Attribute_CCD             = 0x00000004U;
+    // [LANG en] Trigger volume : only overlaps are detected (reported by rbEnvironment as begin/end events), never contacts
+    // [LANG ja] トリガー領域 : 重なりのみを検出し (rbEnvironment が開始/終了イベントとして報告)、衝突点は生成しない
+    static const rbu32 Attribute_Sensor          = 0x00000008U;
+    // [LANG en] Moved by the application (see SetKinematicTarget) : infinite mass in the solver, no forces, never sleeps
+    // [LANG ja] アプリケーションが動かす剛体 (SetKinematicTarget を参照) : ソルバーでは質量無限大、力を受けず、スリープしない
+    static const rbu32 Attribute_Kinematic       = 0x00000010U;
+
+    // [LANG en] Derived data waiting to be refreshed (see RefreshDerivedData)
+    // [LANG ja] 更新を待っている派生データ (RefreshDerivedData を参照)
+    static const rbu32 Dirty_None                = 0x00000000U;
+    static const rbu32 Dirty_InvInertiaWorld     = 0x00000001U;
+    static const rbu32 Dirty_WorldAABB           = 0x00000002U;
+    static const rbu32 Dirty_SolverWorkArea      = 0x00000004U;
+    static const rbu32 Dirty_Orientation         = Dirty_InvInertiaWorld | Dirty_WorldAABB;
+
+    static const rbu32 ShapeType_Box             = 0;
+    static const rbu32 ShapeType_ConvexHull      = 1;
+    static const rbu32 ShapeType_TriangleMesh    = 2;
+    static const rbu32 ShapeType_HeightField     = 3;
+    static const rbu32 ShapeType_Compound        = 4;
+
+    rbRigidBody()
+        : state()
+        , solver_work_area()
+        , shape(DefaultShape())
+        , sleep_thresholds(DefaultSleepThresholds())
+        , world_aabb(rbVec3(rbReal(0), rbReal(0), rbReal(0)), rbVec3(rbReal(0), rbReal(0), rbReal(0)))
+        , attribute(Attribute_None)
+        , dirty(Dirty_Orientation)
+        , collision_group(1)
+        , collision_mask(~rbu32(0))
+        , support_vertex_cache()
+        , sleep_status()
+        , accumulator()
+        , kinematic_target()
+        , modified(true)
+        {}
+
+    rbVec3 Position()
+        { return state.position; }
+
+    void SetPosition( rbReal x, rbReal y, rbReal z )
+        {
+            state.position.Set( x, y, z );
+            dirty |= Dirty_WorldAABB;
+            modified = true;
+        }
+
+    void SetPosition( const rbVec3& v )
+        {
+            state.position = v;
+            dirty |= Dirty_WorldAABB;
+            modified = true;
+        }
+
+    void AddPosition( rbReal dx, rbReal dy, rbReal dz )
+        {
+            state.position.Add(dx, dy, dz);
+            dirty |= Dirty_WorldAABB;
+            modified = true;
+        }
+
+    void AddPosition( const rbVec3& dv )
+        {
+            state.position += dv;
+            dirty |= Dirty_WorldAABB;
+            modified = true;
+        }
+
+
+    rbMtx3 Orientation()
+        { return state.orientation; }
+
+    rbMtx3 OrientationTranspose()
+        { return state.orientation.GetTransposed(); }
+
+    // [LANG en] InvInertiaWorld follows on the next RefreshDerivedData (or UpdateInvInertiaWorld).
+    // [LANG ja] InvInertiaWorld は次の RefreshDerivedData (または UpdateInvInertiaWorld) で更新されます。
+    void SetOrientation( const rbMtx3& m )
+        {
+            state.orientation = m;
+            dirty |= Dirty_Orientation;
+            modified = true;
+        }
+
+    void SetOrientation( rbReal rad_x, rbReal rad_y, rbReal rad_z );
+    void AddOrientation( rbReal rad_dx, rbReal rad_dy, rbReal rad_dz );
+
+
+    rbVec3 LinearVelocity()
+        { return state.linear_velocity; }
+
+    void SetLinearVelocity( rbReal x, rbReal y, rbReal z )
+        {
+            state.linear_velocity.Set( x, y, z );
+            modified = true;
+        }
+
+    void SetLinearVelocity( const rbVec3& v )
+        {
+            state.linear_velocity = v;
+            modified = true;
+        }
+
+    void AddLinearVelocity( rbReal dx, rbReal dy, rbReal dz )
+        {
+            state.linear_velocity.Add(dx, dy, dz);
+            modified = true;
+        }
+
+    void AddLinearVelocity( const rbVec3& dv )
+        {
+            state.linear_velocity += dv;
+            modified = true;
+        }
+
+
+    rbVec3 AngularVelocity()
+        { return state.angular_velocity; }
+
+    void SetAngularVelocity( rbReal x, rbReal y, rbReal z );
+    void SetAngularVelocity( const rbVec3& v );
+    void AddAngularVelocity( rbReal dx, rbReal dy, rbReal dz );
+    void AddAngularVelocity( const rbVec3& dv );
+
+
+    rbVec3 AngularMomentum()
+        { return state.angular_momentum; }
+
+    void SetAngularMomentum( rbReal x, rbReal y, rbReal z )
+        {
+            state.angular_momentum.Set( x, y, z );
+            modified = true;
+        }
+
+    void SetAngularMomentum( const rbVec3& v )
+        {
+            state.angular_momentum = v;
+            modified = true;
+        }
+
+    void AddAngularMomentum( rbReal dx, rbReal dy, rbReal dz )
+        {
+            state.angular_momentum.Add(dx, dy, dz);
+            modified = true;
+        }
+
+    void AddAngularMomentum( const rbVec3& dv )
+        {
+            state.angular_momentum += dv;
+            modified = true;
+        }
+
+
+    rbVec3 Force()
+        { return accumulator.force; }
+
+    void SetForce( rbReal x, rbReal y, rbReal z )
+        {
+            accumulator.force.Set( x, y, z );
+            modified = true;
+        }
+
+    void SetForce( const rbVec3& v )
+        {
+            accumulator.force = v;
+            modified = true;
+        }
+
+    void SetForceAt( const rbVec3& v, const rbVec3& at );
+
+    void AddForce( rbReal dx, rbReal dy, rbReal dz )
+        {
+            accumulator.force.Add(dx, dy, dz);
+            modified = true;
+        }
+
+    void AddForce( const rbVec3& dv )
+        {
+            accumulator.force += dv;
+            modified = true;
+        }
+
+    void AddForceAt( const rbVec3& dv, const rbVec3& at );
+
+
+    rbVec3 Torque()
+        { return accumulator.torque; }
+
+    void SetTorque( rbReal x, rbReal y, rbReal z )
+        {
+            accumulator.torque.Set( x, y, z );
+            modified = true;
+        }
+
+    void SetTorque( const rbVec3& v )
+        {
+            accumulator.torque = v;
+            modified = true;
+        }
+
+    void AddTorque( rbReal dx, rbReal dy, rbReal dz )
+        {
+            accumulator.torque.Add(dx, dy, dz);
+            modified = true;
+        }
+
+    void AddTorque( const rbVec3& dv )
+        {
+            accumulator.torque += dv;
+            modified = true;
+        }
+
+
+    // [LANG en] SetShapeParameter adds the shape to +library+ (e.g. rbEnvironment::Shapes) and refers to that entry;
+    // [LANG en] bodies given equal parameters share one entry. Keep +library+ alive while the body uses the shape.
+    // [LANG ja] SetShapeParameter は形状を +library+ (rbEnvironment::Shapes など) に追加し、その要素を参照します。
+    // [LANG ja] 同じパラメータの剛体は一つの要素を共有します。剛体が形状を利用する間は +library+ を破棄しないでください。
+    void SetShapeParameter( rbShapeLibrary& library,
+                            rbReal mass,
+                            rbReal hx, rbReal hy, rbReal hz,
+                            rbReal restitution_coeff, rbReal friction_coeff );
+
+    // [LANG en] +hull+ is referenced, not copied. Keep it alive while any body uses it.
+    // [LANG en] Returns false and keeps the current shape if +hull+ is null or not Valid().
+    // [LANG ja] +hull+ はコピーされず参照されます。利用する剛体が存在する間は破棄しないでください。
+    // [LANG ja] +hull+ が null または Valid() でなければ false を返し、現在の形状のままにします。
+    bool SetShapeParameter( rbShapeLibrary& library,
+                            rbReal mass,
+                            const rbConvexHull* hull,
+                            rbReal restitution_coeff, rbReal friction_coeff );
+
+    // [LANG en] +mesh+ is referenced, not copied. The body becomes fixed (Attribute_Fixed is enabled).
+    // [LANG ja] +mesh+ はコピーされず参照されます。剛体は固定物体になります (Attribute_Fixed が有効化されます)。
+    void SetShapeParameter( rbShapeLibrary& library,
+                            const rbTriangleMesh* mesh,
+                            rbReal restitution_coeff, rbReal friction_coeff );
+
+    // [LANG en] +field+ is referenced, not copied. The body becomes fixed (Attribute_Fixed is enabled).
+    // [LANG ja] +field+ はコピーされず参照されます。剛体は固定物体になります (Attribute_Fixed が有効化されます)。
+    void SetShapeParameter( rbShapeLibrary& library,
+                            const rbHeightField* field,
+                            rbReal restitution_coeff, rbReal friction_coeff );
+
+    // [LANG en] +compound+ is referenced, not copied. The mass and inertia are taken from its children.
+    // [LANG ja] +compound+ はコピーされず参照されます。質量と慣性テンソルは子の直方体から計算された値を使います。
+    void SetShapeParameter( rbShapeLibrary& library,
+                            const rbCompound* compound,
+                            rbReal restitution_coeff, rbReal friction_coeff );
+
+    // [LANG en] +shared_shape+ is referenced, not copied (e.g. an entry of rbShapeLibrary). Bodies with a mesh or
+    // [LANG en] heightfield shape become fixed (Attribute_Fixed is enabled).
+    // [LANG ja] +shared_shape+ はコピーされず参照されます (rbShapeLibrary の要素など)。メッシュまたは高さ場の
+    // [LANG ja] 形状を持つ剛体は固定物体になります (Attribute_Fixed が有効化されます)。
+    void SetShape( const Shape* shared_shape );
+
+    const Shape* GetShape()
+        { return shape; }
+
+    rbu32 ShapeType()
+        { return shape->type; }
+
+    const rbConvexHull* ConvexHull()
+        { return shape->type == ShapeType_ConvexHull ? shape->convex_hull : nullptr; }
+
+    const rbTriangleMesh* TriangleMesh()
+        { return shape->type == ShapeType_TriangleMesh ? shape->triangle_mesh : nullptr; }
+
+    const rbHeightField* HeightField()
+        { return shape->type == ShapeType_HeightField ? shape->height_field : nullptr; }
+
+    const rbCompound* Compound()
+        { return shape->type == ShapeType_Compound ? shape->compound : nullptr; }
+
+    // [LANG en] Warm-start slots for the hill-climbing support query of rbConvexHull : [0] for the maximum along an axis,
+    // [LANG en] [1] for the minimum (the opposite direction), so that both ends of a projection start near their last result.
+    // [LANG ja] rbConvexHull の山登り法によるサポート点探索の開始位置 (前回の結果) : [0] は軸方向の最大、[1] は最小
+    // [LANG ja] (逆方向) 用。射影の両端がそれぞれ前回の結果の近くから探索を始められるようにしています。
+    rbu32* SupportVertexCache()
+        { return support_vertex_cache; }
+
+    rbVec3 HalfExtent()
+        { return shape->half_extent; }
+
+    // [LANG en] World-space AABB bounding the shape at the current pose. Cached until the pose or the shape changes.
+    // [LANG ja] 現在の姿勢で形状を包むワールド座標の AABB。姿勢か形状が変わるまでキャッシュされます。
+    const rbAABB& WorldAABB();
+
+    // [LANG en] Same bounds as WorldAABB, computed without reading or writing the cache (for queries, which leave the body as it is).
+    // [LANG ja] WorldAABB と同じ境界を、キャッシュを読み書きせずに計算します (剛体を変更しない問い合わせ用)。
+    rbAABB ComputeWorldAABB() const;
+
+    rbReal Restitution()
+        { return shape->restitution_coefficient; }
+
+    rbReal Friction()
+        { return shape->friction_coefficient; }
+
+    rbReal InvMass()
+        { return shape->inv_mass; }
+
+    rbMtx3 InvInertia()
+        { return shape->InvInertia(); }
+
+    rbMtx3 InvInertiaWorld()
+        { return state.inv_inertia_world; }
+
+    // [LANG en] I^-1 = R * I0^-1 * R^T, evaluated from the diagonal form of the shape's inverse inertia
+    // [LANG ja] I^-1 = R * I0^-1 * R^T (形状の慣性テンソルの逆の対角形式から計算)
+    void UpdateInvInertiaWorld();
+
+
+    rbu32 Attribute()
+        { return attribute; }
+    void EnableAttribute( rbu32 attr )
+        {
+            attribute |= attr;
+            modified = true;
+        }
+    void DisableAttribute( rbu32 attr )
+        {
+            attribute &= ~attr;
+            modified = true;
+        }
+    bool AttributeEnabled( rbu32 attr )
+        { return (attribute & attr) != 0; }
+
+    bool IsFixed()
+        { return (attribute & Attribute_Fixed) != 0; }
+    bool IsNotFixed()
+        { return (attribute & Attribute_Fixed) == 0; }
+
+    bool IsKinematic()
+        { return (attribute & Attribute_Kinematic) != 0; }
+
+    // [LANG en] Pose a body with Attribute_Kinematic should reach at the end of the next rbEnvironment::Update.
+    // [LANG en] Its velocities are derived from the target there, and the target is kept until the next call.
+    // [LANG ja] Attribute_Kinematic を持つ剛体が次の rbEnvironment::Update の終了時に到達すべき姿勢。
+    // [LANG ja] 速度はこの目標から求めます。目標は次に呼び出すまで保持されます。
+    void SetKinematicTarget( const rbVec3& position, const rbMtx3& orientation )
+        {
+            kinematic_target.position = position;
+            kinematic_target.orientation = orientation;
+            kinematic_target.enabled = true;
+            modified = true;
+        }
+
+    // [LANG en] Sets the velocities that carry the body to its kinematic target in +dt+ (see SetKinematicTarget)
+    // [LANG ja] +dt+ で目標の姿勢へ到達する速度を設定します (SetKinematicTarget を参照)
+    void UpdateKinematicVelocity( rbReal dt );
+
+    // [LANG en] Snaps the body onto its kinematic target, removing the drift of the integration
+    // [LANG ja] 積分による誤差を除くため、剛体を目標の姿勢に一致させます
+    void FinishKinematicMotion();
+
+    // [LANG en] Two bodies collide only if each one's group shares a bit with the other's mask
+    // [LANG en] (default : group 1, collides with everything).
+    // [LANG ja] 互いのグループが相手のマスクとビットを共有する場合のみ衝突します
+    // [LANG ja] (既定値 : グループ 1、全てと衝突)。
+    rbu32 CollisionGroup()
+        { return collision_group; }
+    rbu32 CollisionMask()
+        { return collision_mask; }
+    void SetCollisionFilter( rbu32 group, rbu32 mask )
+        {
+            collision_group = group;
+            collision_mask = mask;
+        }
+
+    bool Sleeping()
+        { return sleep_status.On == true; }
+    bool Awake()
+        { return sleep_status.On == false; }
+    void SetSleepOn()
+        {
+            sleep_status.On = true;
+            modified = true;
+        }
+    void SetSleepOff()
+        {
+            sleep_status.On = false;
+            modified = true;
+        }
+
+    // [LANG en] +thresholds+ is referenced, not copied, so that a class of bodies can share (and tune) one instance.
+    // [LANG ja] +thresholds+ はコピーされず参照されるので、同じ種類の剛体で一つの値を共有 (調整) できます。
+    void SetSleepThresholds( const SleepThresholds* thresholds )
+        { sleep_thresholds = thresholds; }
+
+    const SleepThresholds* GetSleepThresholds()
+        { return sleep_thresholds; }
+
+    // [LANG en] Thresholds used by bodies that have not been given their own
+    // [LANG ja] 個別に閾値を設定していない剛体が使用する閾値
+    static const SleepThresholds* DefaultSleepThresholds();
+
+
+    void UpdateVelocity( rbReal dt );
+    void ApplyImpulse( const rbVec3& impulse, const rbVec3& relative_position );
+    void CorrectVelocity();
+    void UpdatePosition( rbReal dt );
+    void UpdateSleepStatus( rbReal dt );
+
+    void ClearSolverWorkArea()
+        {
+            solver_work_area.Clear();
+            dirty &= ~Dirty_SolverWorkArea;
+        }
+
+    // [LANG en] Dirty_* bits of the derived data that are out of date. Set by UpdatePosition, ApplyImpulse and
+    // [LANG en] the pose/shape setters; cleared by the functions that recompute each piece of data.
+    // [LANG ja] 古くなっている派生データの Dirty_* ビット。UpdatePosition, ApplyImpulse, 姿勢/形状の設定で立ち、
+    // [LANG ja] それぞれのデータを計算し直す関数で下ります。
+    rbu32 Dirty()
+        { return dirty; }
+
+    // [LANG en] Clears the solver work area and recomputes InvInertiaWorld if they are out of date.
+    // [LANG en] Returns false if there was nothing to do (resting, fixed or sleeping bodies).
+    // [LANG ja] ソルバーの作業領域と InvInertiaWorld が古くなっていれば、クリア/再計算します。
+    // [LANG ja] 何もする必要がなかった (静止・固定・スリープ中の剛体) 場合は false を返します。
+    bool RefreshDerivedData()
+        {
+            if ( (dirty & (Dirty_SolverWorkArea | Dirty_InvInertiaWorld)) == 0 )
+                return false;
+            if ( dirty & Dirty_SolverWorkArea )
+                ClearSolverWorkArea();
+            if ( dirty & Dirty_InvInertiaWorld )
+                UpdateInvInertiaWorld();
+            return true;
+        }
+
+    void ClearSleepStatus()
+        {
+            sleep_status.Clear();
+            modified = true;
+        }
+
+    void ResetStatuses()
+        {
+            ClearSolverWorkArea();
+            ClearSleepStatus();
+        }
+
+    // [LANG en] Size of the record written by SaveSnapshot : the simulation state (pose, velocities, cached AABB,
+    // [LANG en] attributes, sleep status, accumulators and kinematic target), written component by component so that
+    // [LANG en] equal states give equal bytes (no padding, including the SIMD lane of rbVec3).
+    // [LANG en] The shape, sleep thresholds and collision group/mask are configuration and not included, and neither is
+    // [LANG en] the solver work area (LoadSnapshot clears it).
+    // [LANG ja] SaveSnapshot が書き込む記録の大きさ : シミュレーションの状態 (姿勢・速度・AABB のキャッシュ・
+    // [LANG ja] 属性・スリープ状態・力の累積値・キネマティックな目標) を成分ごとに書き込むので、等しい状態は等しい
+    // [LANG ja] バイト列になります (rbVec3 の SIMD レーンを含め、パディングは含みません)。
+    // [LANG ja] 形状・スリープの閾値・衝突のグループ/マスクは設定とみなし、含めません。ソルバーの作業領域も含めません
+    // [LANG ja] (LoadSnapshot はクリアします)。
+    static rbu32 SnapshotSize();
+
+    // [LANG en] Writes/reads SnapshotSize() bytes (no alignment required).
+    // [LANG ja] SnapshotSize() バイトを書き込み/読み込みます (アラインメントは不要)。
+    void SaveSnapshot( void* record_out ) const;
+    void LoadSnapshot( const void* record );
+
+    // [LANG en] Size of the record written by SaveState : the part of the snapshot that the simulation evolves (pose,
+    // [LANG en] velocities, angular momentum, sleep status, accumulators and kinematic target), in the same scalar form.
+    // [LANG en] The cached AABB, support caches, InvInertiaWorld and dirty bits are left out, so that queries, which may
+    // [LANG en] refresh them, never change the record (see rbEnvironment::StateHash).
+    // [LANG ja] SaveState が書き込む記録の大きさ : スナップショットのうちシミュレーションで変化する部分 (姿勢・速度・
+    // [LANG ja] 角運動量・スリープ状態・力の累積値・キネマティックな目標) を同じスカラーの形式で書き込みます。
+    // [LANG ja] AABB・サポート点のキャッシュ・InvInertiaWorld・Dirty ビットは含まないので、それらを更新しうるクエリで
+    // [LANG ja] 記録が変わることはありません (rbEnvironment::StateHash を参照)。
+    static const rbu32 StateRecordSize = static_cast<rbu32>(
+        sizeof(rbReal) * (3 * 7 + 9 * 2) +  // 7 vectors, 2 matrices
+        sizeof(rbu8) + sizeof(rbReal) +     // sleep_status
+        sizeof(rbu8) );                     // kinematic_target.enabled
+
+    // [LANG en] Writes StateRecordSize bytes (no alignment required).
+    // [LANG ja] StateRecordSize バイトを書き込みます (アラインメントは不要)。
+    void SaveState( void* record_out ) const;
+
+    // [LANG en] True if a setter (or LoadSnapshot) has changed the simulation state since rbEnvironment::Update last
+    // [LANG en] recorded it for rollback. Queries neither set nor clear it.
+    // [LANG ja] rbEnvironment::Update がロールバック用に最後に記録して以降、設定関数 (または LoadSnapshot) が
+    // [LANG ja] シミュレーションの状態を変更していれば true。クエリはこの値を変更しません。
+    bool Modified()
+        { return modified; }
+
+    void ClearModified()
+        { modified = false; }
+
+private:
+
+    // [LANG en] Unit box shared by bodies that have not been given a shape yet
+    // [LANG ja] 形状を設定していない剛体が共有する単位立方体
+    static const Shape* DefaultShape();
+
+    // hot
+    State state;
+
+    // warm
+    SolverWorkArea solver_work_area;
+    const Shape* shape;
+    const SleepThresholds* sleep_thresholds;
+    rbAABB world_aabb;
+    rbu32 attribute;
+    rbu32 dirty;
+    rbu32 collision_group;
+    rbu32 collision_mask;
+    rbu32 support_vertex_cache[2];
+    SleepStatus sleep_status;
+
+    // cold
+    Accumulator accumulator;
+
+    struct KinematicTarget
+    {
+        rbVec3 position;
+        rbMtx3 orientation;
+        bool enabled;
+
+        KinematicTarget()
+            : position(rbReal(0), rbReal(0), rbReal(0))
+            , orientation(rbReal(1), 0, 0,
+                          0, rbReal(1), 0,
+                          0, 0, rbReal(1))
+            , enabled(false)
+            {}
+    };
+
+    KinematicTarget kinematic_target;
+    bool modified;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
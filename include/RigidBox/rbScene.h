@@ -0,0 +1,150 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbTypes.h"
+#include "rbRigidBody.h"
+
+// Scene file for loading large worlds at once.
+//
+// [LANG en] Layout (native byte order, every section starts at a multiple of Alignment) :
+// [LANG en]   Header | ShapeRecord[ShapeCount] | rbRigidBody::SleepThresholds[SleepThresholdsCount]
+// [LANG en]          | BodyConfig[BodyCount] | body records (rbRigidBody::SnapshotSize() bytes each) | rbu32 sweep order[BodyCount]
+// [LANG en] The body records carry the derived data (world AABB and inertia) computed when the scene was saved, and the
+// [LANG en] sweep order is the broadphase order of the bodies (see rbBroadPhase::SetOrder), so neither has to be
+// [LANG en] recomputed after loading. Only box shapes can be stored : hulls, meshes, heightfields and compounds refer
+// [LANG en] to data owned by the application.
+// [LANG ja] レイアウト (ネイティブのバイト順、各区画は Alignment の倍数の位置から始まります) :
+// [LANG ja]   Header | ShapeRecord[ShapeCount] | rbRigidBody::SleepThresholds[SleepThresholdsCount]
+// [LANG ja]          | BodyConfig[BodyCount] | 剛体の記録 (それぞれ rbRigidBody::SnapshotSize() バイト) | rbu32 の並び順[BodyCount]
+// [LANG ja] 剛体の記録は保存時に計算した派生データ (ワールド座標の AABB と慣性テンソル) を含み、並び順は剛体の
+// [LANG ja] ブロードフェーズの並び順 (rbBroadPhase::SetOrder を参照) なので、読み込んだ後にどちらも計算し直す必要は
+// [LANG ja] ありません。保存できる形状は直方体のみです (凸包・メッシュ・高さ場・複合形状はアプリケーションが所有する
+// [LANG ja] データを参照するため)。
+class rbScene
+{
+public:
+
+    static const rbu32 Magic     = 0x43534252U; // "RBSC"
+    static const rbu32 Version   = 1;
+    static const rbu32 Alignment = 64;
+
+    // [LANG en] BodyConfig::SleepThresholds of bodies using rbRigidBody::DefaultSleepThresholds()
+    // [LANG ja] rbRigidBody::DefaultSleepThresholds() を使う剛体の BodyConfig::SleepThresholds
+    static const rbu32 DefaultSleepThresholds = ~rbu32(0);
+
+    struct Header
+    {
+        rbu32 Magic;
+        rbu32 Version;
+
+        // [LANG en] sizeof(rbReal) and rbRigidBody::SnapshotSize() of the build that wrote the scene
+        // [LANG ja] シーンを書き込んだビルドの sizeof(rbReal) と rbRigidBody::SnapshotSize()
+        rbu32 RealSize;
+        rbu32 BodyRecordSize;
+
+        rbu32 BodyCount;
+        rbu32 ShapeCount;
+        rbu32 SleepThresholdsCount;
+        rbu32 Reserved;
+
+        rbu64 ShapeOffset;
+        rbu64 SleepThresholdsOffset;
+        rbu64 BodyConfigOffset;
+        rbu64 BodyRecordOffset;
+        rbu64 SweepOrderOffset;
+        rbu64 FileSize;
+    };
+
+    // [LANG en] Box shape, as computed by rbRigidBody::Shape::Set (stored as is, so loaded bodies behave bit-identically)
+    // [LANG ja] rbRigidBody::Shape::Set が計算した直方体の形状 (読み込んだ剛体がビット単位で同じ動作をするよう、そのまま保存)
+    struct ShapeRecord
+    {
+        rbReal HalfExtent[3];
+        rbReal InvMass;
+        rbReal InvInertiaDiagonal[3];
+        rbReal Restitution;
+        rbReal Friction;
+    };
+
+    struct BodyConfig
+    {
+        rbu32 Shape;
+        rbu32 SleepThresholds;
+        rbu32 CollisionGroup;
+        rbu32 CollisionMask;
+    };
+
+    rbScene();
+
+    rbScene( const rbScene& ) = delete;
+    rbScene& operator =( const rbScene& ) = delete;
+
+    // [LANG en] Writes +bodies+ (e.g. rbEnvironment::RigidBodies()) with their shapes, sleep thresholds, collision filters
+    // [LANG en] and state. Returns false if a body has a shape other than a box or the file cannot be written.
+    // [LANG ja] +bodies+ (rbEnvironment::RigidBodies() 等) を形状・スリープの閾値・衝突フィルター・状態とともに書き込みます。
+    // [LANG ja] 直方体以外の形状を持つ剛体がある場合、またはファイルに書き込めない場合は false を返します。
+    static bool Save( const char* path, const std::vector<rbRigidBody*>& bodies );
+
+    // [LANG en] Maps the file and builds its bodies in one array. Returns false (and leaves the scene empty) if the file
+    // [LANG en] cannot be mapped or does not match this build. The bodies are not registered (see Register).
+    // [LANG ja] ファイルをマップし、その剛体を1つの配列に構築します。マップできない場合、またはこのビルドと合わない場合は
+    // [LANG ja] false を返します (シーンは空になります)。剛体は登録しません (Register を参照)。
+    bool Load( const char* path );
+
+    // [LANG en] Bodies still registered with an environment in use must be unregistered first (see Unregister).
+    // [LANG ja] 使用中の環境に登録されたままの剛体は、先に登録を解除してください (Unregister を参照)。
+    void Clear();
+
+    rbu32 BodyCount() const
+        { return static_cast<rbu32>(bodies.size()); }
+
+    rbRigidBody* Bodies()
+        { return bodies.data(); }
+
+    rbRigidBody& Body( rbu32 index )
+        { return bodies[index]; }
+
+    // [LANG en] Registers all bodies with the baked broadphase order (see rbEnvironment::Register). The environment does
+    // [LANG en] not own them, so it may be destroyed first; call Unregister before clearing or destroying the scene
+    // [LANG en] while the environment is still in use.
+    // [LANG ja] 全ての剛体を保存されたブロードフェーズの並び順とともに登録します (rbEnvironment::Register を参照)。
+    // [LANG ja] 環境は剛体を所有しないので先に破棄しても構いません。環境を使い続ける場合は、シーンをクリアまたは
+    // [LANG ja] 破棄する前に Unregister を呼んでください。
+    bool Register( rbEnvironment& env );
+
+    bool Unregister( rbEnvironment& env );
+
+    // [LANG en] Offsets of the sections for the counts in +header+
+    // [LANG ja] +header+ の個数に対する各区画の位置
+    static void ComputeLayout( Header& header );
+
+private:
+
+    std::vector<rbRigidBody::Shape> shapes;
+    std::vector<rbRigidBody::SleepThresholds> sleep_thresholds;
+    std::vector<rbRigidBody> bodies;
+    std::vector<rbu32> sweep_order;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
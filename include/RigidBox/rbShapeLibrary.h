@@ -0,0 +1,80 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <deque>
+#include <map>
+#include "rbTypes.h"
+#include "rbRigidBody.h"
+
+// Table of rbRigidBody::Shape instances shared by any number of bodies.
+//
+// [LANG en] Each Add* call returns the index of a shape with the given parameters; identical parameters return the
+// [LANG en] index of the existing entry, so a scene of a thousand identical crates stores a single shape. Entries are
+// [LANG en] never moved or removed, so the pointer returned by GetShape() stays valid for the lifetime of the library.
+// [LANG ja] Add* は与えられたパラメータを持つ形状の番号を返します。同じパラメータであれば既存の要素の番号を返すので、
+// [LANG ja] 同じ箱を千個並べたシーンでも形状は一つしか保持しません。要素は移動・削除されないため、GetShape() が
+// [LANG ja] 返すポインタはライブラリが存在する限り有効です。
+class rbShapeLibrary
+{
+public:
+
+    rbShapeLibrary();
+
+    // [LANG en] Returned by AddConvexHull for a hull that is null or not Valid() (nothing is added)
+    // [LANG ja] null または Valid() でない凸包に対して AddConvexHull が返す値 (何も追加しません)
+    static const rbu32 InvalidIndex = ~rbu32(0);
+
+    rbu32 AddBox( rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff );
+    rbu32 AddConvexHull( rbReal mass, const rbConvexHull* hull, rbReal restitution_coeff, rbReal friction_coeff );
+    rbu32 AddTriangleMesh( const rbTriangleMesh* mesh, rbReal restitution_coeff, rbReal friction_coeff );
+    rbu32 AddHeightField( const rbHeightField* field, rbReal restitution_coeff, rbReal friction_coeff );
+    rbu32 AddCompound( const rbCompound* compound, rbReal restitution_coeff, rbReal friction_coeff );
+
+    // [LANG en] Index of an entry equal to +shape+ ; a copy of +shape+ is added if there is none
+    // [LANG ja] +shape+ に等しい要素の番号。なければ +shape+ のコピーを追加します
+    rbu32 Add( const rbRigidBody::Shape& shape );
+
+    const rbRigidBody::Shape* GetShape( rbu32 index ) const
+        { return &shapes[index]; }
+
+    rbu32 Count() const
+        { return static_cast<rbu32>(shapes.size()); }
+
+private:
+
+    // [LANG en] Orders shapes by every member, including the data derived from the referenced hull, mesh, etc.
+    // [LANG en] A pointer alone is not enough : a hull freed and another built at the same address must not match.
+    // [LANG ja] 形状を全メンバーで順序付けする (参照する凸包・メッシュなどから求めたデータを含む)。ポインタだけでは
+    // [LANG ja] 不十分 : 破棄された凸包と同じアドレスに作られた別の凸包が一致してはならない。
+    struct ShapeLess
+    {
+        bool operator()( const rbRigidBody::Shape* a, const rbRigidBody::Shape* b ) const;
+    };
+
+    // [LANG en] std::deque keeps the addresses of existing entries stable on push_back.
+    // [LANG ja] std::deque は push_back しても既存の要素のアドレスが変わりません。
+    std::deque<rbRigidBody::Shape> shapes;
+    std::map<const rbRigidBody::Shape*, rbu32, ShapeLess> index_of;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,130 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "rbTypes.h"
+
+class rbRigidBody;
+
+// Binary snapshot of the simulation state of an rbEnvironment (see rbEnvironment::SaveSnapshot).
+//
+// [LANG en] Layout (native byte order, no alignment requirements) :
+// [LANG en]   Header | body records (rbRigidBody::SnapshotSize() bytes each, in registration order)
+// [LANG en]          | contacts | touching pairs | sensor pairs
+// [LANG en] Bodies are referred to by their registration index, so a snapshot can be restored into any environment
+// [LANG en] holding the same number of bodies with the same configuration (shapes, etc.), e.g. after Data() was
+// [LANG en] written to a file and loaded back with Assign(). The buffer is reused, so saving repeatedly does not allocate.
+// [LANG ja] レイアウト (ネイティブのバイト順、アラインメントの要求なし) :
+// [LANG ja]   Header | 剛体の記録 (それぞれ rbRigidBody::SnapshotSize() バイト、登録順)
+// [LANG ja]          | 衝突点 | 接触している組 | センサーの組
+// [LANG ja] 剛体は登録順の番号で参照するので、同じ数・同じ設定 (形状等) の剛体を持つ環境であれば復元できます
+// [LANG ja] (Data() をファイルに書き出し、Assign() で読み戻した場合など)。バッファは再利用するので、
+// [LANG ja] 繰り返し保存してもメモリ確保は起こりません。
+class rbSnapshot
+{
+public:
+
+    static const rbu32 Magic   = 0x53534252U; // "RBSS"
+    static const rbu32 Version = 1;
+
+    struct Header
+    {
+        rbu32 Magic;
+        rbu32 Version;
+
+        // [LANG en] sizeof(rbReal) and rbRigidBody::SnapshotSize() of the build that wrote the snapshot
+        // [LANG ja] スナップショットを書き込んだビルドの sizeof(rbReal) と rbRigidBody::SnapshotSize()
+        rbu32 RealSize;
+        rbu32 BodyRecordSize;
+
+        rbu32 BodyCount;
+        rbu32 ContactCount;
+        rbu32 TouchingPairCount;
+        rbu32 SensorPairCount;
+        rbu32 NextPairId;
+    };
+
+    struct ContactRecord
+    {
+        rbReal Position[3];
+        rbReal RelativeBodyPosition[2][3];
+        rbReal Normal[3];
+        rbReal PenetrationDepth;
+        rbu32 Body[2];
+    };
+
+    struct TouchingPairRecord
+    {
+        rbReal MaxImpulse;
+        rbReal NormalSum[3];
+        rbu32 Index[2];
+        rbu32 PairId;
+    };
+
+    struct SensorPairRecord
+    {
+        rbu32 Sensor;
+        rbu32 Other;
+    };
+
+    rbSnapshot();
+
+    bool Empty() const
+        { return buffer.empty(); }
+
+    const rbu8* Data() const
+        { return buffer.data(); }
+
+    size_t Size() const
+        { return buffer.size(); }
+
+    // [LANG en] Valid only if !Empty()
+    // [LANG ja] !Empty() の場合のみ有効
+    Header GetHeader() const;
+
+    // [LANG en] Copies a serialized snapshot (e.g. read from a file). Returns false (and leaves the snapshot empty)
+    // [LANG en] if the header does not match this build or the size does not match the header.
+    // [LANG ja] シリアライズされたスナップショット (ファイルから読み込んだもの等) をコピーします。ヘッダーがこのビルドと
+    // [LANG ja] 合わない場合、またはサイズがヘッダーと合わない場合は false を返します (スナップショットは空になります)。
+    bool Assign( const void* data, size_t size );
+
+    void Clear()
+        { buffer.clear(); }
+
+    // [LANG en] Size of a snapshot with the given counts
+    // [LANG ja] 指定した個数を持つスナップショットの大きさ
+    static size_t ComputeSize( const Header& header );
+
+private:
+
+    friend class rbEnvironment;
+
+    std::vector<rbu8> buffer;
+
+    // [LANG en] Scratch table (body address, registration index) sorted by address, used to save contacts and sensor pairs
+    // [LANG ja] 衝突点とセンサーの組の保存に使う (剛体のアドレス, 登録順の番号) の表 (アドレス順)
+    std::vector< std::pair<const rbRigidBody*, rbu32> > body_indices;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
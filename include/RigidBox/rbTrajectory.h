@@ -0,0 +1,243 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "rbMappedFile.h"
+#include "rbTypes.h"
+
+// Trajectory file written by rbTrajectoryRecorder and read by rbTrajectoryPlayer.
+//
+// [LANG en] Layout (native byte order, no alignment requirements) :
+// [LANG en]   FileHeader | chunks | index (one IndexEntry per chunk) | Footer
+// [LANG en] A chunk is a ChunkHeader followed by FrameCount frames of BodyCount pose records (PoseRecordSize bytes each,
+// [LANG en] in registration order) :
+// [LANG en]   - position : 3 x 16 bits, quantized within the bounds of all positions in the chunk
+// [LANG en]   - orientation : 32 bits, "smallest three" quaternion (index of the largest component in the top 2 bits,
+// [LANG en]     the other three as 10-bit values in [-1/sqrt(2), 1/sqrt(2)])
+// [LANG en] so the position error is at most 1/131070 of the chunk extent and the orientation error about 0.1 degrees.
+// [LANG ja] レイアウト (ネイティブのバイト順、アラインメントの要求なし) :
+// [LANG ja]   FileHeader | チャンク | 索引 (チャンクごとに IndexEntry 1つ) | Footer
+// [LANG ja] チャンクは ChunkHeader と、それに続く FrameCount フレーム分の BodyCount 個の姿勢の記録 (それぞれ
+// [LANG ja] PoseRecordSize バイト、登録順) からなります :
+// [LANG ja]   - 位置 : 16 ビット x 3。チャンク内の全位置を囲む範囲で量子化
+// [LANG ja]   - 回転 : 32 ビット。"smallest three" 形式の四元数 (上位 2 ビットに絶対値最大の成分の番号、
+// [LANG ja]     残りの3成分を [-1/sqrt(2), 1/sqrt(2)] の範囲の 10 ビット値として格納)
+// [LANG ja] 位置の誤差はチャンクの範囲の 1/131070 以下、回転の誤差はおよそ 0.1 度です。
+struct rbTrajectoryFile
+{
+    static const rbu32 Magic   = 0x52544252U; // "RBTR"
+    static const rbu32 Version = 1;
+
+    static const rbu32 PoseRecordSize = 10;
+
+    struct FileHeader
+    {
+        rbu32 Magic;
+        rbu32 Version;
+        rbu32 BodyCount;
+        rbu32 FramesPerChunk;
+    };
+
+    struct ChunkHeader
+    {
+        rbu32 FirstFrame;
+        rbu32 FrameCount;
+        float BoundsMin[3];
+        float BoundsMax[3];
+    };
+
+    struct IndexEntry
+    {
+        rbu64 Offset;
+        rbu32 FirstFrame;
+        rbu32 FrameCount;
+    };
+
+    struct Footer
+    {
+        rbu64 IndexOffset;
+        rbu32 ChunkCount;
+        rbu32 FrameCount;
+        rbu32 Reserved;
+        rbu32 Magic;
+    };
+
+    // [LANG en] Pose record codec. +record+ points to PoseRecordSize bytes.
+    // [LANG ja] 姿勢の記録の符号化と復号。+record+ は PoseRecordSize バイトの領域を指します。
+    static void EncodePose( rbu8* record, const rbVec3& position, const rbMtx3& orientation,
+                            const float bounds_min[3], const float bounds_max[3] );
+    static void DecodePose( const rbu8* record, const float bounds_min[3], const float bounds_max[3],
+                            rbVec3& position, rbMtx3& orientation );
+};
+
+// Streams the pose of every body to a trajectory file (see rbTrajectoryFile) without blocking the simulation on I/O.
+//
+// [LANG en] Capture (called at the end of rbEnvironment::Update, see rbEnvironment::SetTrajectoryRecorder) only copies
+// [LANG en] the poses into one of two chunk buffers. When a buffer is full it is handed to a writer thread, which
+// [LANG en] quantizes and writes it while the other buffer is filled. Capture waits only if the writer is still busy
+// [LANG en] with the previous chunk when the next one is full (see StallCount).
+// [LANG ja] Capture (rbEnvironment::Update の最後に呼ばれます。rbEnvironment::SetTrajectoryRecorder を参照) は
+// [LANG ja] 姿勢を2つあるチャンクのバッファの一方にコピーするだけです。バッファが一杯になると書き込み用のスレッドに
+// [LANG ja] 渡し、もう一方のバッファを埋めている間に量子化と書き込みを行います。Capture が待つのは、次のチャンクが
+// [LANG ja] 一杯になった時点でまだ前のチャンクを書き込んでいる場合だけです (StallCount を参照)。
+class rbTrajectoryRecorder
+{
+public:
+
+    rbTrajectoryRecorder();
+
+    // [LANG en] Calls Close.
+    // [LANG ja] Close を呼び出します。
+    ~rbTrajectoryRecorder();
+
+    rbTrajectoryRecorder( const rbTrajectoryRecorder& ) = delete;
+    rbTrajectoryRecorder& operator =( const rbTrajectoryRecorder& ) = delete;
+
+    // [LANG en] Creates the file and starts the writer thread. Every frame must hold +body_count+ bodies.
+    // [LANG en] Returns false if already open or the file cannot be created.
+    // [LANG ja] ファイルを作成し、書き込み用のスレッドを開始します。各フレームの剛体は +body_count+ 個でなければなりません。
+    // [LANG ja] すでに開いている場合、またはファイルを作成できない場合は false を返します。
+    bool Open( const char* path, rbu32 body_count, rbu32 frames_per_chunk = 32 );
+
+    // [LANG en] Writes the remaining frames, the index and the footer, and closes the file.
+    // [LANG en] Returns false if any write failed (the file is then incomplete) or if not open.
+    // [LANG ja] 残りのフレーム、索引、フッターを書き込んでファイルを閉じます。
+    // [LANG ja] 書き込みに失敗していた場合 (ファイルは不完全になります) または開いていない場合は false を返します。
+    bool Close();
+
+    bool IsOpen() const
+        { return file != nullptr; }
+
+    // [LANG en] Appends the current poses as one frame. Returns false (and records nothing) if not open or if the number
+    // [LANG en] of bodies differs from the one given to Open.
+    // [LANG ja] 現在の姿勢を1フレームとして追加します。開いていない場合、または剛体の数が Open に渡した数と異なる場合は
+    // [LANG ja] 何も記録せずに false を返します。
+    bool Capture( const std::vector<rbRigidBody*>& bodies );
+
+    rbu32 FrameCount() const
+        { return frame_count; }
+
+    // [LANG en] Number of times Capture waited for the writer thread
+    // [LANG ja] Capture が書き込み用のスレッドを待った回数
+    rbu32 StallCount() const
+        { return stall_count; }
+
+private:
+
+    // [LANG en] Raw poses of up to FramesPerChunk frames : position (3) and orientation (9, row major) per body
+    // [LANG ja] 最大 FramesPerChunk フレーム分の加工前の姿勢 : 剛体ごとに位置 (3) と回転 (9, 行優先)
+    struct ChunkBuffer
+    {
+        std::vector<rbReal> Poses;
+        rbu32 FirstFrame;
+        rbu32 FrameCount;
+    };
+
+    static const rbu32 RealsPerPose = 12;
+
+    void Submit();
+    void WriterMain();
+    bool WriteChunk( const ChunkBuffer& chunk );
+
+    std::FILE* file;
+    rbu32 body_count;
+    rbu32 frames_per_chunk;
+    rbu32 frame_count;
+    rbu32 stall_count;
+
+    ChunkBuffer buffers[2];
+    rbu32 front;
+
+    // [LANG en] Shared with the writer thread, guarded by +mutex+
+    // [LANG ja] 書き込み用のスレッドと共有 (+mutex+ で保護)
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable condition;
+    const ChunkBuffer* pending;
+    bool closing;
+
+    // [LANG en] Owned by the writer thread until it is joined
+    // [LANG ja] 書き込み用のスレッドが終了するまではそのスレッドが所有
+    std::vector<rbTrajectoryFile::IndexEntry> index;
+    std::vector<rbu8> chunk_bytes;
+    rbu64 file_offset;
+    bool failed;
+};
+
+// Random access to the frames of a trajectory file.
+//
+// [LANG en] The file is memory-mapped, so opening it costs the same regardless of its length, and reading a frame
+// [LANG en] only touches the pages of that frame.
+// [LANG ja] ファイルはメモリにマップするので、開く時間は長さによらず、フレームの読み出しはそのフレームのページにしか触れません。
+class rbTrajectoryPlayer
+{
+public:
+
+    rbTrajectoryPlayer();
+
+    ~rbTrajectoryPlayer();
+
+    rbTrajectoryPlayer( const rbTrajectoryPlayer& ) = delete;
+    rbTrajectoryPlayer& operator =( const rbTrajectoryPlayer& ) = delete;
+
+    // [LANG en] Returns false if the file cannot be mapped or is not a complete trajectory file.
+    // [LANG ja] ファイルをマップできない場合、または完全なトラジェクトリのファイルでない場合は false を返します。
+    bool Open( const char* path );
+
+    void Close();
+
+    bool IsOpen() const
+        { return file.IsOpen(); }
+
+    rbu32 BodyCount() const
+        { return header.BodyCount; }
+
+    rbu32 FrameCount() const
+        { return footer.FrameCount; }
+
+    // [LANG en] Decodes the poses of all bodies of +frame+ into arrays of BodyCount() elements.
+    // [LANG en] Returns false if +frame+ is out of range.
+    // [LANG ja] +frame+ の全剛体の姿勢を BodyCount() 要素の配列に復号します。+frame+ が範囲外の場合は false を返します。
+    bool ReadFrame( rbu32 frame, rbVec3* positions, rbMtx3* orientations ) const;
+
+    // [LANG en] Decodes the pose of one body. Returns false if +frame+ or +body+ is out of range.
+    // [LANG ja] 1つの剛体の姿勢を復号します。+frame+ または +body+ が範囲外の場合は false を返します。
+    bool ReadPose( rbu32 frame, rbu32 body, rbVec3& position, rbMtx3& orientation ) const;
+
+private:
+
+    // [LANG en] Header of the chunk holding +frame+ (nullptr if out of range)
+    // [LANG ja] +frame+ を含むチャンクのヘッダー (範囲外なら nullptr)
+    const rbu8* FindChunk( rbu32 frame, rbTrajectoryFile::ChunkHeader& chunk ) const;
+
+    rbMappedFile file;
+    rbTrajectoryFile::FileHeader header;
+    rbTrajectoryFile::Footer footer;
+    std::vector<rbTrajectoryFile::IndexEntry> index;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,146 @@
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <vector>
+#include "rbTypes.h"
+#include "rbMath.h"
+
+// Static triangle mesh collider with a quantized AABB tree.
+//
+// [LANG en] A mesh is built once and referenced read-only by any number of rbRigidBody instances
+// [LANG en] (even across rbEnvironment instances). Bodies using a mesh are always treated as fixed.
+// [LANG ja] メッシュは一度だけ構築し、任意の数の rbRigidBody から読み取り専用で参照されます
+// [LANG ja] (rbEnvironment をまたいでも共有可能)。メッシュを使う剛体は常に固定物体として扱われます。
+//
+// [LANG en] Triangles are one-sided : wind them counter-clockwise as seen from the side bodies should stay on.
+// [LANG ja] 三角形は片面のみ有効です : 剛体が留まるべき側から見て反時計回りになるように頂点を並べてください。
+class rbTriangleMesh
+{
+public:
+
+    // [LANG en] 16 bytes per node. Bounds are quantized into 16 bits per axis relative to the mesh bounds.
+    // [LANG en] Nodes are stored in depth-first order, so the tree is traversed without a stack :
+    // [LANG en] a rejected internal node is skipped by its subtree size.
+    // [LANG ja] 1ノード 16 バイト。境界はメッシュ全体の AABB を基準に各軸 16 ビットへ量子化されています。
+    // [LANG ja] ノードは深さ優先順に並んでいるため、スタックなしで走査できます :
+    // [LANG ja] 交差しない内部ノードはその部分木のノード数だけ読み飛ばします。
+    struct QuantizedNode
+    {
+        rbu16 quantized_min[3];
+        rbu16 quantized_max[3];
+
+        // [LANG en] leaf : triangle index (>= 0), internal : -(number of nodes in the subtree)
+        // [LANG ja] 葉 : 三角形番号 (>= 0)、内部ノード : -(部分木のノード数)
+        rbs32 escape_index_or_triangle_index;
+
+        bool IsLeaf() const
+            { return escape_index_or_triangle_index >= 0; }
+    };
+
+    rbTriangleMesh();
+
+    // [LANG en] +indices+ holds 3 vertex indices per triangle. Returns false on empty or out-of-range input.
+    // [LANG ja] +indices+ は三角形ごとに3個の頂点番号を持ちます。空または範囲外の入力に対しては false を返します。
+    bool Build( const rbVec3* vertices, rbu32 vertex_count, const rbu32* indices, rbu32 triangle_count );
+
+    void Clear();
+
+    bool Valid() const
+        { return !nodes.empty(); }
+
+    rbu32 VertexCount() const
+        { return static_cast<rbu32>(vertices.size()); }
+
+    rbu32 TriangleCount() const
+        { return static_cast<rbu32>(indices.size() / 3); }
+
+    void Triangle( rbu32 index, rbVec3 v_out[3] ) const
+        {
+            v_out[0] = vertices[indices[3 * index + 0]];
+            v_out[1] = vertices[indices[3 * index + 1]];
+            v_out[2] = vertices[indices[3 * index + 2]];
+        }
+
+    rbu32 NodeCount() const
+        { return static_cast<rbu32>(nodes.size()); }
+
+    const QuantizedNode& Node( rbu32 index ) const
+        { return nodes[index]; }
+
+    rbVec3 BoundMin() const
+        { return bound_min; }
+
+    rbVec3 BoundMax() const
+        { return bound_max; }
+
+    // [LANG en] Symmetric half-extent around the mesh origin that bounds every vertex.
+    // [LANG ja] メッシュ原点を中心として全頂点を包む half-extent。
+    rbVec3 HalfExtent() const;
+
+    // [LANG en] Calls visitor(triangle_index) for every triangle whose node bounds overlap [aabb_min, aabb_max] (mesh-local).
+    // [LANG ja] [aabb_min, aabb_max] (メッシュのローカル座標) と境界が重なる三角形ごとに visitor(triangle_index) を呼びます。
+    template <typename Visitor>
+    void Query( const rbVec3& aabb_min, const rbVec3& aabb_max, Visitor&& visitor ) const
+        {
+            rbu16 qmin[3], qmax[3];
+            Quantize( aabb_min, false, qmin );
+            Quantize( aabb_max, true, qmax );
+
+            const rbs32 node_count = static_cast<rbs32>(nodes.size());
+            rbs32 i = 0;
+            while ( i < node_count )
+            {
+                const QuantizedNode& node = nodes[i];
+                bool overlap =
+                    (qmin[0] <= node.quantized_max[0]) & (qmax[0] >= node.quantized_min[0]) &
+                    (qmin[1] <= node.quantized_max[1]) & (qmax[1] >= node.quantized_min[1]) &
+                    (qmin[2] <= node.quantized_max[2]) & (qmax[2] >= node.quantized_min[2]);
+
+                if ( node.IsLeaf() )
+                {
+                    if ( overlap )
+                        visitor( static_cast<rbu32>(node.escape_index_or_triangle_index) );
+                    ++i;
+                }
+                else
+                {
+                    i += overlap ? 1 : -node.escape_index_or_triangle_index;
+                }
+            }
+        }
+
+private:
+
+    void Quantize( const rbVec3& p, bool round_up, rbu16 q_out[3] ) const;
+    rbs32 BuildNode( std::vector<rbu32>& triangles, rbu32 begin, rbu32 end );
+
+    std::vector<rbVec3> vertices;
+    std::vector<rbu32> indices;
+    std::vector<QuantizedNode> nodes;
+
+    rbVec3 bound_min;
+    rbVec3 bound_max;
+    rbVec3 quantization;
+};
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -1,99 +1,164 @@
-// -*- mode: C++; coding: utf-8; -*-
-#pragma once
-
-#include <cfloat>
-#include <cmath>
-
-
-/// @define RIGIDBOX_USE_DOUBLE_PRECISION
-///
-/// Use double for the type of floating point numbers.
-
-// #define RIGIDBOX_USE_DOUBLE_PRECISION
-
-/// @define RIGIDBOX_USE_COLUMN_MAJOR_MATRIX
-///
-/// Switches the element layout of rbMtx3 from column-major to row-major.
-
-// #define RIGIDBOX_USE_COLUMN_MAJOR_MATRIX
-
-
-#if defined(RIGIDBOX_USE_DOUBLE_PRECISION)
-typedef double rbReal;
-#else
-typedef float  rbReal;
-#endif
-
-#if defined(RIGIDBOX_USE_DOUBLE_PRECISION)
-# define RIGIDBOX_TOLERANCE (1e-15)
-# define RIGIDBOX_REAL_MAX DBL_MAX
-#else
-# define RIGIDBOX_TOLERANCE (1e-6f)
-# define RIGIDBOX_REAL_MAX FLT_MAX
-#endif
-
-#define RIGIDBOX_REAL_PI rbReal(3.141592653589793)
-
-#if defined(RIGIDBOX_USE_DOUBLE_PRECISION)
-
-#define rbAcos(x)  acos(rbReal((x)))
-#define rbAsin(x)  asin(rbReal((x)))
-#define rbAtan(x)  atan(rbReal((x)))
-#define rbAtan2(x) atan2(rbReal((x)))
-#define rbCos(x)   cos(rbReal((x)))
-#define rbSin(x)   sin(rbReal((x)))
-#define rbTan(x)   tan(rbReal((x)))
-#define rbSqrt(x)  sqrt(rbReal((x)))
-#define rbFabs(x)  fabs(rbReal((x)))
-
-#else
-
-#define rbAcos(x)  acosf(rbReal((x)))
-#define rbAsin(x)  asinf(rbReal((x)))
-#define rbAtan(x)  atanf(rbReal((x)))
-#define rbAtan2(x) atan2f(rbReal((x)))
-#define rbCos(x)   cosf(rbReal((x)))
-#define rbSin(x)   sinf(rbReal((x)))
-#define rbTan(x)   tanf(rbReal((x)))
-#define rbSqrt(x)  sqrtf(rbReal((x)))
-#define rbFabs(x)  fabsf(rbReal((x)))
-
-#endif
-
-typedef char           rbs8;
-typedef short          rbs16;
-typedef int            rbs32;
-typedef unsigned char  rbu8;
-typedef unsigned short rbu16;
-typedef unsigned int   rbu32;
-
-struct rbMtx3;
-struct rbVec3;
-
-struct rbContact;
-class rbCollision;
-class rbEnvironment;
-class rbRigidBody;
-class rbSolver;
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+
+
+/// @define RIGIDBOX_USE_DOUBLE_PRECISION
+///
+/// Use double for the type of floating point numbers.
+
+// #define RIGIDBOX_USE_DOUBLE_PRECISION
+
+/// @define RIGIDBOX_USE_COLUMN_MAJOR_MATRIX
+///
+/// Switches the element layout of rbMtx3 from column-major to row-major.
+
+// #define RIGIDBOX_USE_COLUMN_MAJOR_MATRIX
+
+/// @define RIGIDBOX_USE_SIMD
+///
+/// Stores rbVec3 as a 16-byte SSE register (x, y, z and a padding lane) and implements the rbVec3/rbMtx3
+/// operators with SSE intrinsics (SSE4.1 dot products when the compiler targets SSE4.1 or AVX).
+/// Requires single precision and the row-major rbMtx3 layout.
+
+// #define RIGIDBOX_USE_SIMD
+
+#if defined(RIGIDBOX_USE_SIMD) && defined(RIGIDBOX_USE_DOUBLE_PRECISION)
+# error "RIGIDBOX_USE_SIMD requires single precision (RIGIDBOX_USE_DOUBLE_PRECISION must not be defined)."
+#endif
+
+#if defined(RIGIDBOX_USE_SIMD) && defined(RIGIDBOX_USE_COLUMN_MAJOR_MATRIX)
+# error "RIGIDBOX_USE_SIMD requires the row-major rbMtx3 layout (RIGIDBOX_USE_COLUMN_MAJOR_MATRIX must not be defined)."
+#endif
+
+/// @define RIGIDBOX_DETERMINISTIC
+///
+/// Bit-identical simulation across platforms and compilers (lockstep multiplayer, replay verification) :
+/// rbSin, rbCos, rbTan, rbAtan, rbAtan2, rbAsin and rbAcos use the portable implementations of rbDeterministicMath.h
+/// instead of the C library (rbSqrt and rbFabs are exact everywhere and stay as they are). The library and its users
+/// must also be compiled without FMA contraction and without fast-math (see the RIGIDBOX_DETERMINISTIC option of
+/// CMakeLists.txt) and with floating point evaluated in the precision of its type (SSE2 on 32-bit x86). All peers
+/// should also share the precision and RIGIDBOX_USE_SIMD settings, which select different arithmetic code.
+/// Use rbEnvironment::StateHash to compare the states : it covers the x, y, z components and the nine matrix
+/// elements only, never the padding lane that RIGIDBOX_USE_SIMD adds to rbVec3.
+
+// #define RIGIDBOX_DETERMINISTIC
+
+#if defined(RIGIDBOX_DETERMINISTIC) && defined(__FAST_MATH__)
+# error "RIGIDBOX_DETERMINISTIC cannot be used with -ffast-math."
+#endif
+
+#if defined(RIGIDBOX_DETERMINISTIC) && defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD > 0
+# error "RIGIDBOX_DETERMINISTIC requires floating point evaluated in the precision of its type (e.g. -msse2 -mfpmath=sse)."
+#endif
+
+/// @define RIGIDBOX_CACHE_LINE_SIZE
+///
+/// Alignment (in bytes) of the per-body data touched on every substep (see rbRigidBody::State).
+
+#if !defined(RIGIDBOX_CACHE_LINE_SIZE)
+# define RIGIDBOX_CACHE_LINE_SIZE 64
+#endif
+
+
+#if defined(RIGIDBOX_USE_DOUBLE_PRECISION)
+typedef double rbReal;
+#else
+typedef float  rbReal;
+#endif
+
+#if defined(RIGIDBOX_USE_DOUBLE_PRECISION)
+# define RIGIDBOX_TOLERANCE (1e-15)
+# define RIGIDBOX_REAL_MAX DBL_MAX
+#else
+# define RIGIDBOX_TOLERANCE (1e-6f)
+# define RIGIDBOX_REAL_MAX FLT_MAX
+#endif
+
+#define RIGIDBOX_REAL_PI rbReal(3.141592653589793)
+
+#if defined(RIGIDBOX_DETERMINISTIC)
+
+#include "rbDeterministicMath.h"
+
+#define rbAcos(x)  rbReal(rbDeterministicAcos(double(rbReal((x)))))
+#define rbAsin(x)  rbReal(rbDeterministicAsin(double(rbReal((x)))))
+#define rbAtan(x)  rbReal(rbDeterministicAtan(double(rbReal((x)))))
+#define rbAtan2(y, x) rbReal(rbDeterministicAtan2(double(rbReal((y))), double(rbReal((x)))))
+#define rbCos(x)   rbReal(rbDeterministicCos(double(rbReal((x)))))
+#define rbSin(x)   rbReal(rbDeterministicSin(double(rbReal((x)))))
+#define rbTan(x)   rbReal(rbDeterministicTan(double(rbReal((x)))))
+#define rbSqrt(x)  std::sqrt(rbReal((x)))
+#define rbFabs(x)  std::fabs(rbReal((x)))
+
+#elif defined(RIGIDBOX_USE_DOUBLE_PRECISION)
+
+#define rbAcos(x)  acos(rbReal((x)))
+#define rbAsin(x)  asin(rbReal((x)))
+#define rbAtan(x)  atan(rbReal((x)))
+#define rbAtan2(y, x) atan2(rbReal((y)), rbReal((x)))
+#define rbCos(x)   cos(rbReal((x)))
+#define rbSin(x)   sin(rbReal((x)))
+#define rbTan(x)   tan(rbReal((x)))
+#define rbSqrt(x)  sqrt(rbReal((x)))
+#define rbFabs(x)  fabs(rbReal((x)))
+
+#else
+
+#define rbAcos(x)  acosf(rbReal((x)))
+#define rbAsin(x)  asinf(rbReal((x)))
+#define rbAtan(x)  atanf(rbReal((x)))
+#define rbAtan2(y, x) atan2f(rbReal((y)), rbReal((x)))
+#define rbCos(x)   cosf(rbReal((x)))
+#define rbSin(x)   sinf(rbReal((x)))
+#define rbTan(x)   tanf(rbReal((x)))
+#define rbSqrt(x)  sqrtf(rbReal((x)))
+#define rbFabs(x)  fabsf(rbReal((x)))
+
+#endif
+
+typedef char               rbs8;
+typedef short              rbs16;
+typedef int                rbs32;
+typedef long long          rbs64;
+typedef unsigned char      rbu8;
+typedef unsigned short     rbu16;
+typedef unsigned int       rbu32;
+typedef unsigned long long rbu64;
+
+struct rbMtx3;
+struct rbVec3;
+
+struct rbContact;
+class rbCollision;
+class rbConvexHull;
+class rbEnvironment;
+class rbRigidBody;
+class rbScene;
+class rbSolver;
+class rbTrajectoryRecorder;
+class rbTriangleMesh;
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,189 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <algorithm>
+
+#include <RigidBox/rbBroadPhase.h>
+#include <RigidBox/rbRigidBody.h>
+
+rbBroadPhase::rbBroadPhase()
+    : bounds()
+    , filters()
+    , order()
+    , pairs()
+    , pair_filter(nullptr)
+    , pair_filter_user_data(nullptr)
+    , query_bounds()
+    , query_order()
+    , query_wide()
+    , query_reach(0)
+    , query_bounds_valid(false)
+{}
+
+void rbBroadPhase::Update( const std::vector<rbRigidBody*>& bodies, rbReal dt, bool sweep_all )
+{
+    const rbu32 body_count = static_cast<rbu32>(bodies.size());
+
+    ComputeBounds( bodies, dt, sweep_all );
+
+    pairs.clear();
+    for ( rbu32 i = 0; i < body_count; ++i )
+    {
+        const rbu32 index0 = order[i];
+        const rbAABB& aabb0 = bounds[index0];
+        for ( rbu32 j = i + 1; j < body_count && bounds[order[j]].lower.x <= aabb0.upper.x; ++j )
+        {
+            const rbu32 index1 = order[j];
+
+            // [LANG en] No need to check between wall/floor/kinematic bodies, nor between bodies whose groups/masks exclude
+            // [LANG en] each other. Evaluated without short-circuiting, so the whole test costs a single branch.
+            // [LANG ja] 壁/床/キネマティックな剛体同士、およびグループ/マスクで互いに除外される剛体同士の衝突判定は不要。
+            // [LANG ja] 短絡評価を使わずに判定全体を1回の分岐で済ませる。
+            const FilterData& f0 = filters[index0];
+            const FilterData& f1 = filters[index1];
+            const bool rejected =
+                !aabb0.Overlaps(bounds[index1]) |
+                ((f0.group & f1.mask) == 0) | ((f1.group & f0.mask) == 0) |
+                ((f0.fixed & f1.fixed) != 0);
+            if ( rejected )
+                continue;
+
+            Pair pair;
+            pair.Index[0] = std::min( index0, index1 );
+            pair.Index[1] = std::max( index0, index1 );
+
+            if ( pair_filter && !pair_filter(bodies[pair.Index[0]], bodies[pair.Index[1]], pair_filter_user_data) )
+                continue;
+
+            pair.ContactCount = 0;
+            pairs.push_back( pair );
+        }
+    }
+
+    // [LANG en] Keep the registration order of the bodies, so the solver visits contacts in a stable order
+    // [LANG ja] 剛体の登録順を保つ (ソルバーが衝突点を訪れる順序を安定させるため)
+    std::sort( pairs.begin(), pairs.end(),
+        [](const Pair& a, const Pair& b) {
+            return a.Index[0] != b.Index[0] ? a.Index[0] < b.Index[0] : a.Index[1] < b.Index[1];
+        } );
+}
+
+void rbBroadPhase::SetOrder( const rbu32* body_order, rbu32 body_count )
+{
+    order.assign( body_order, body_order + body_count );
+}
+
+void rbBroadPhase::RefitQueryBounds( const std::vector<rbRigidBody*>& bodies )
+{
+    if ( query_bounds_valid )
+        return;
+
+    const rbu32 body_count = static_cast<rbu32>(bodies.size());
+    query_bounds.resize( body_count );
+    rbReal total_width = 0;
+    for ( rbu32 i = 0; i < body_count; ++i )
+    {
+        query_bounds[i] = bodies[i]->ComputeWorldAABB();
+        total_width += query_bounds[i].upper.x - query_bounds[i].lower.x;
+    }
+
+    // [LANG en] A few large bodies (floors, terrain) would stretch the reach of every query :
+    // [LANG en] bodies wider than 8 times the mean width are visited apart instead
+    // [LANG ja] 少数の大きな剛体 (床や地形) が全ての問い合わせの届く範囲を広げてしまうので、
+    // [LANG ja] 平均の 8 倍を超える幅の剛体は別に訪れる
+    const rbReal wide_width = body_count > 0 ? rbReal(8) * total_width / rbReal(body_count) : rbReal(0);
+    query_wide.clear();
+    query_reach = 0;
+    for ( rbu32 i = 0; i < body_count; ++i )
+    {
+        const rbReal width = query_bounds[i].upper.x - query_bounds[i].lower.x;
+        if ( width > wide_width )
+            query_wide.push_back( i );
+        else
+            query_reach = rbMax( query_reach, width );
+    }
+
+    SortByLowerX( query_bounds, query_order );
+    query_bounds_valid = true;
+}
+
+void rbBroadPhase::ComputeBounds( const std::vector<rbRigidBody*>& bodies, rbReal dt, bool sweep_all )
+{
+    const rbu32 body_count = static_cast<rbu32>(bodies.size());
+
+    bounds.resize( body_count );
+    filters.resize( body_count );
+    for ( rbu32 i = 0; i < body_count; ++i )
+    {
+        rbRigidBody* body = bodies[i];
+        bounds[i] = body->WorldAABB();
+        filters[i].group = body->CollisionGroup();
+        filters[i].mask = body->CollisionMask();
+        filters[i].fixed = (body->IsFixed() || body->IsKinematic()) ? 1 : 0;
+
+        // [LANG en] Cover the whole motion of fast bodies so that the narrowphase sees what they may hit this step
+        // [LANG ja] 高速な剛体はこのステップで衝突しうる相手が見つかるように、移動全体を覆う
+        if ( (sweep_all || body->AttributeEnabled(rbRigidBody::Attribute_CCD)) && body->IsNotFixed() )
+        {
+            bounds[i].Merge( bounds[i].Translated(dt * body->LinearVelocity()) );
+
+            const rbReal spin = dt * body->AngularVelocity().Length() * body->HalfExtent().Length();
+            bounds[i].lower -= rbVec3( spin, spin, spin );
+            bounds[i].upper += rbVec3( spin, spin, spin );
+        }
+    }
+
+    SortByLowerX( bounds, order );
+}
+
+void rbBroadPhase::SortByLowerX( const std::vector<rbAABB>& body_bounds, std::vector<rbu32>& body_order )
+{
+    const rbu32 body_count = static_cast<rbu32>(body_bounds.size());
+
+    if ( body_order.size() != body_count )
+    {
+        // [LANG en] The body list changed : sort from scratch. Ties are broken by index, which gives the same order as the
+        // [LANG en] insertion sort below starting from the identity, in O(n log n) instead of O(n^2) for unsorted bodies.
+        // [LANG ja] 剛体のリストが変わった : 最初からソートし直す。同じ値は番号順とするので、下の挿入ソートを恒等順列から
+        // [LANG ja] 始めた場合と同じ並び順になるが、ソートされていない剛体に対して O(n^2) ではなく O(n log n) で済む。
+        body_order.resize( body_count );
+        for ( rbu32 i = 0; i < body_count; ++i )
+            body_order[i] = i;
+        std::sort( body_order.begin(), body_order.end(),
+            [&body_bounds](rbu32 a, rbu32 b) {
+                return body_bounds[a].lower.x != body_bounds[b].lower.x ? body_bounds[a].lower.x < body_bounds[b].lower.x : a < b;
+            } );
+    }
+
+    // [LANG en] Insertion sort : almost linear when the order barely changed since the last update
+    // [LANG ja] 挿入ソート : 前回から並び順がほとんど変わらなければほぼ線形時間
+    for ( rbu32 i = 1; i < body_count; ++i )
+    {
+        const rbu32 index = body_order[i];
+        const rbReal key = body_bounds[index].lower.x;
+        rbu32 j = i;
+        for ( ; j > 0 && body_bounds[body_order[j - 1]].lower.x > key; --j )
+            body_order[j] = body_order[j - 1];
+        body_order[j] = index;
+    }
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
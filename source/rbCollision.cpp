@@ -1,668 +1,1735 @@
-// -*- mode: C++; coding: utf-8; -*-
-#include <RigidBox/rbRigidBody.h>
-#include <RigidBox/rbCollision.h>
-
-#include <algorithm>
-
-static inline rbReal HalfExtentOnAxis( const rbVec3& axis, const rbVec3& h, const rbMtx3& RT )
-{
-    rbVec3 axis_boxlocal = RT * axis;
-    return
-        rbFabs(axis_boxlocal.x) * h.x +
-        rbFabs(axis_boxlocal.y) * h.y +
-        rbFabs(axis_boxlocal.z) * h.z ;
-}
-
-static inline rbReal OverlapAlongAxis( const rbVec3& axis, rbVec3 h[2], rbMtx3 RT[2], const rbVec3& distance )
-{
-    rbReal r0 = HalfExtentOnAxis( axis, h[0], RT[0] );
-    rbReal r1 = HalfExtentOnAxis( axis, h[1], RT[1] );
-    rbReal D  = rbFabs( axis * distance );
-
-    return r0 + r1 - D;
-}
-
-// [LANG en] [NOTE] In the context of GJK algorithm, this function is 'support map function', that returns 'support point' of a box.
-// [LANG ja] [NOTE] この関数は GJK アルゴリズムでいうところのサポート写像で、出力として立方体の支点 (support point) を返すもの。
-// Ref.: Gino van den Bergen, Collision Detection in Interactive 3D Enviroments, 4.3.4 Support Mappings (pp.130-139)
-static inline rbVec3 FurthestVertexAlongAxis( const rbVec3& axis, const rbVec3& h, const rbMtx3& R, const rbMtx3& RT, const rbVec3& P )
-{
-    rbVec3 axis_boxlocal = (RT * axis).Normalize();
-
-    auto Sign = [](rbReal v) -> rbReal { return v < -RIGIDBOX_TOLERANCE ? rbReal(-1) : rbReal(1); };
-
-    rbVec3 FurthestVertexLocal( Sign(axis_boxlocal.x) * h.x, Sign(axis_boxlocal.y) * h.y, Sign(axis_boxlocal.z) * h.z );
-
-    return R * FurthestVertexLocal + P;
-}
-
-static inline rbReal Clamp( rbReal val, rbReal min, rbReal max )
-{
-    if ( val < min )
-        val = min;
-    else if ( val > max )
-        val = max;
-
-    return val;
-}
-
-// Ref.: Christer Ericson, Real-Time Collision Detection (2005)
-// 5.1.9 Closest Points of Two Line Segments
-static inline void ClosestPointOfSegments( const rbVec3 colliding_edge[2][2], rbVec3 point_out[2] )
-{
-    rbVec3 d[2] = {
-        colliding_edge[0][1] - colliding_edge[0][0],
-        colliding_edge[1][1] - colliding_edge[1][0]
-    };
-
-    rbVec3 r = colliding_edge[0][0] - colliding_edge[1][0];
-
-    rbReal a = d[0] * d[0];
-    rbReal e = d[1] * d[1];
-    rbReal c = d[0] * r;
-    rbReal f = d[1] * r;
-    rbReal b = d[0] * d[1];
-
-    // [LANG en] If you want to make this routine more generic, you must confirm given edges don't degenerate into a point (given edges are not zero-length).
-    // [LANG en] But the argument +colliding_edge+ is always given with valid edge data, we don't have to check the condition.
-    // [LANG ja] より汎用的な交差判定ルーチンにしたいのであれば、ここで「辺の両端として渡された2点が一致していないかどうか
-    // [LANG ja] (==点に縮退していないかどうか)」をチェックする必要がある。しかしここで colliding_edge にその可能性はないのでチェックは不要。
-
-    rbReal t[2];
-    rbReal denom = a*e - b*b;
-    if ( denom > RIGIDBOX_TOLERANCE )
-        t[0] = Clamp( (b*f - c*e) / denom, rbReal(0), rbReal(1) );
-    else
-        t[0] = rbReal(0);
-
-    t[1] = (b * t[0] + f) / e;
-
-    if ( t[1] < rbReal(0) )
-    {
-        t[1] = rbReal(0);
-        t[0] = Clamp( -c / a, rbReal(0), rbReal(1) );
-    }
-    else if ( t[1] > rbReal(1) )
-    {
-        t[1] = rbReal(1);
-        t[0] = Clamp( (b - c) / a, rbReal(0), rbReal(1) );
-    }
-
-    point_out[0] = colliding_edge[0][0] + d[0] * t[0];
-    point_out[1] = colliding_edge[1][0] + d[1] * t[1];
-}
-
-
-// Separating axis identifier
-enum class SeparatingAxis : int {
-    Box0XxBox1X = 0,
-    Box0XxBox1Y,
-    Box0XxBox1Z,
-    Box0YxBox1X,
-    Box0YxBox1Y,
-    Box0YxBox1Z,
-    Box0ZxBox1X,
-    Box0ZxBox1Y,
-    Box0ZxBox1Z,
-
-    Box0X,
-    Box0Y,
-    Box0Z,
-    Box1X,
-    Box1Y,
-    Box1Z,
-
-    Count,
-    Unknown,
-    Start = Box0XxBox1X,
-};
-
-static const rbs32 ColumnIndices[9][2] = {
-    { 0, 0 }, // SeparatingAxis::Box0XxBox1X (== 0) -> box0->Orientation().Column(0) % box1->Orientation().Column(0)
-    { 0, 1 }, // SeparatingAxis::Box0XxBox1Y (== 1) -> box0->Orientation().Column(0) % box1->Orientation().Column(1)
-    { 0, 2 }, // SeparatingAxis::Box0XxBox1Z (== 2) -> :
-    { 1, 0 }, // SeparatingAxis::Box0YxBox1X (== 3)
-    { 1, 1 }, // SeparatingAxis::Box0YxBox1Y (== 4)
-    { 1, 2 }, // SeparatingAxis::Box0YxBox1Z (== 5)
-    { 2, 0 }, // SeparatingAxis::Box0ZxBox1X (== 6)
-    { 2, 1 }, // SeparatingAxis::Box0ZxBox1Y (== 7) -> :
-    { 2, 2 }, // SeparatingAxis::Box0ZxBox1Z (== 8) -> box0->Orientation().Column(2) % box1->Orientation().Column(2)
-};
-
-//
-// [LANG en] Box-Box collision detection algorithm
-// [LANG ja] 立方体同士の衝突検出
-//
-// Ref.:
-// - Open Dynamics Engine [box.cpp]
-// - Game Physics Engine Development [collide_fine.cpp]
-//
-
-struct SATPenetration {
-    rbVec3 axis;
-    SeparatingAxis axis_id;
-    // [LANG en] Current candidate value of penetration depth along +best_axis_id+.
-    // [LANG ja] 軸 +best_axis_id+ に沿った貫通深度の候補値
-    rbReal depth;
-};
-
-struct SATEvalStatus {
-    rbVec3 best_axis;
-    SeparatingAxis best_axis_id;
-    SATPenetration penetration[static_cast<int>(SeparatingAxis::Count)];
-
-    void Clear() {
-        best_axis_id = SeparatingAxis::Start;
-        best_axis.SetZero();
-        for (auto& t : penetration) {
-            t.depth = RIGIDBOX_REAL_MAX;
-        }
-    }
-};
-
-struct SATContext {
-    SeparatingAxis current_axis_id;
-    rbVec3 h[2];
-    rbMtx3 RT[2];
-    rbVec3 distance;
-};
-
-static inline bool SeparatedOnAxis(rbVec3&& axis, SATContext& ctx, SATEvalStatus& status)
-{
-    if (axis.LengthSq() >= RIGIDBOX_TOLERANCE)
-    {
-        axis.Normalize();
-        rbReal current_penetration = OverlapAlongAxis(axis, ctx.h, ctx.RT, ctx.distance);
-        status.penetration[static_cast<int>(ctx.current_axis_id)].depth = current_penetration;
-        status.penetration[static_cast<int>(ctx.current_axis_id)].axis_id = ctx.current_axis_id;
-        status.penetration[static_cast<int>(ctx.current_axis_id)].axis = axis;
-
-        if (current_penetration <= RIGIDBOX_TOLERANCE)
-            return true;
-        if (current_penetration < status.penetration[static_cast<int>(status.best_axis_id)].depth)
-        {
-            status.best_axis = axis;
-            status.best_axis_id = ctx.current_axis_id;
-        }
-    }
-    return false;
-}
-
-rbs32 rbCollision::Detect( rbRigidBody* box0, rbRigidBody* box1, rbContact* contact_out )
-{
-    rbVec3 h[2] = { box0->HalfExtent(), box1->HalfExtent() };
-    rbMtx3 R[2] = { box0->Orientation(), box1->Orientation() };
-    rbMtx3 RT[2] = { box0->OrientationTranspose(), box1->OrientationTranspose() };
-    rbVec3 P[2] = { box0->Position(), box1->Position() };
-    rbVec3 distance = P[1] - P[0];
-
-    SATContext ctx = {
-        SeparatingAxis::Unknown,
-        { h[0], h[1] },
-        { RT[0], RT[1] },
-        P[1] - P[0]
-    };
-
-    SATEvalStatus status;
-    status.Clear();
-
-    //
-    // [LANG en] Separating-Axis Test
-    // [LANG ja] 分離軸テスト
-    //
-    bool separated = false;
-
-    // [LANG en] SAT using local axes of Box0
-    // [LANG ja] Box0 のローカル座標系の軸を利用した分離軸テスト
-    ctx.current_axis_id = SeparatingAxis::Box0X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2)), ctx, status);
-    if (separated) return 0;
-
-    // [LANG en] SAT using local axes of Box1
-    // [LANG ja] Box1 のローカル座標系の軸を利用した分離軸テスト
-    ctx.current_axis_id = SeparatingAxis::Box1X;
-    separated = SeparatedOnAxis(rbVec3(R[1].Column(0)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box1Y;
-    separated = SeparatedOnAxis(rbVec3(R[1].Column(1)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box1Z;
-    separated = SeparatedOnAxis(rbVec3(R[1].Column(2)), ctx, status);
-    if (separated) return 0;
-
-    // [LANG en] SAT using cross product from the local axes of each boxes
-    // [LANG ja] Box0 ・ Box1 それぞれのローカル座標系の軸から作成した分離軸でのテスト
-    ctx.current_axis_id = SeparatingAxis::Box0XxBox1X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(0)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(1)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(2)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0YxBox1X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(0)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(1)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(2)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(0)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(1)), ctx, status);
-    if (separated) return 0;
-    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(2)), ctx, status);
-    if (separated) return 0;
-
-    //
-    // [LANG en] No gap is found along any separating axes -> boxes are intersecting
-    // [LANG ja] どの軸上でも隙間が確認できない⇒交差している
-    //
-#if 0
-    std::sort(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
-        [](auto const& lhs, auto const& rhs) {
-            return lhs.depth < rhs.depth;
-        }
-    );
-
-    int best_count = std::count_if(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
-        [&](auto& pen) {
-            return pen.depth == status.penetration[0].depth;
-        }
-    );
-#endif
-    // [LANG en] Create Normal
-    // [LANG ja] 法線の決定
-    contact_out->Normal = status.best_axis;
-
-    switch ( status.best_axis_id )
-    {
-    // [LANG en] a vertex of Box1 is touching the face of Box0
-    // [LANG ja] Box1 の頂点が Box0 の面と交差している場合
-    case SeparatingAxis::Box0X:
-    case SeparatingAxis::Box0Y:
-    case SeparatingAxis::Box0Z:
-    {
-        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
-        // [LANG ja] Box1 -> Box0 と向くように調整
-        if ( ctx.distance.GetNormalized() * contact_out->Normal >= 0 )
-            contact_out->Normal *= -1;
-
-        contact_out->Position = FurthestVertexAlongAxis( contact_out->Normal, h[1], R[1], RT[1], P[1] );
-        contact_out->PenetrationDepth = status.penetration[static_cast<int>(status.best_axis_id)].depth;
-    }
-    break;
-
-    // [LANG en] a vertex of Box0 is touching the face of Box1
-    // [LANG ja] Box0 の頂点が Box1 の面と交差している場合
-    case SeparatingAxis::Box1X:
-    case SeparatingAxis::Box1Y:
-    case SeparatingAxis::Box1Z:
-    {
-        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
-        // [LANG ja] Box1 -> Box0 と向くように調整
-        if ( ctx.distance.GetNormalized() * contact_out->Normal >= 0 )
-            contact_out->Normal *= -1;
-
-        contact_out->Position = FurthestVertexAlongAxis( -contact_out->Normal, h[0], R[0], RT[0], P[0] );
-        contact_out->PenetrationDepth = status.penetration[static_cast<int>(status.best_axis_id)].depth;
-    }
-    break;
-
-    // [LANG en] Both boxes are touching with each other's edge
-    // [LANG ja] Box0 と Box1 の辺同士が交差している場合
-    default:
-    {
-        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
-        // [LANG ja] Box1 -> Box0 と向くように調整
-        if ( ctx.distance.GetNormalized() * contact_out->Normal >= 0 )
-        {
-            contact_out->Normal *= -1;
-        }
-
-        // [LANG en] Estimate touching position
-        // [LANG en] 1. identify touching edges
-        // [LANG en] 2. calculate closest points on these edges
-        // [LANG en] 3. take the midpoint of the points as the touching position
-        // [LANG ja] あとはひたすら接触点の位置の推定
-        // [LANG ja] 1. 接触状態にある辺2本を特定
-        // [LANG ja] 2. 辺対辺の最近接点2個を求める
-        // [LANG ja] 3. 上記の2個の点の中点を接触点の位置とする
-
-        const rbs32 *ColIdx = ColumnIndices[static_cast<int>(status.best_axis_id)];
-
-        const rbVec3 best_axis_boxlocal[2] = {
-            RT[0] * contact_out->Normal,
-            RT[1] * contact_out->Normal
-        };
-
-        rbVec3 midpoint_on_colliding_edge[2] = {
-            rbVec3(0, 0, 0),
-            rbVec3(0, 0, 0)
-        };
-
-        for ( int i = 0; i < 3; ++i )
-        {
-            if ( i != ColIdx[0] )
-                midpoint_on_colliding_edge[0].e[i] =
-                    best_axis_boxlocal[0].e[i] < 0 ? h[0].e[i] : -h[0].e[i];
-
-            if ( i != ColIdx[1] )
-                midpoint_on_colliding_edge[1].e[i] =
-                    best_axis_boxlocal[1].e[i] > 0 ? h[1].e[i] : -h[1].e[i];
-        }
-
-        // [LANG en] convert to the world coordinate system
-        // [LANG ja] ワールド座標系での位置へ変換
-        midpoint_on_colliding_edge[0] = R[0] * midpoint_on_colliding_edge[0] + P[0];
-        midpoint_on_colliding_edge[1] = R[1] * midpoint_on_colliding_edge[1] + P[1];
-
-        // [LANG en] The end points of a colliding edge can be found at positions h (and -h) away from the midpoint.
-        // [LANG ja] 中点がわかればそこから軸方向に幅 h (および -h) だけ伸ばした位置が衝突している辺を表す両端となる
-        const rbVec3 colliding_edge[2][2] = {
-            {
-                midpoint_on_colliding_edge[0] + h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
-                midpoint_on_colliding_edge[0] - h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
-            },
-            {
-                midpoint_on_colliding_edge[1] + h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
-                midpoint_on_colliding_edge[1] - h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
-            },
-        };
-
-        rbVec3 point_out[2];
-        ClosestPointOfSegments( colliding_edge, point_out );
-
-        // [LANG en] Tweak contact_out->Position
-        // [LANG en] - take the average of point_out[0] and point_out[1], and halve +best_penetration+, or
-        // [LANG ja] contact_out->Position の調整
-        // [LANG ja] - point_out[0] と point_out[1] の平均にして best_penetration を 1/2 とする
-        contact_out->Position = rbReal(0.5) * (point_out[0] + point_out[1]);
-        contact_out->PenetrationDepth = status.penetration[static_cast<int>(status.best_axis_id)].depth * rbReal(0.5);
-    }
-    break;
-    }
-
-    // [LANG en] Collect type-independent (vertex-face or edge-edge) data
-    // [LANG ja] 接触のタイプ(頂点対面 or 辺対辺)に依存しない情報はここで整理
-    contact_out->RelativeBodyPosition[0] = contact_out->Position - P[0];
-    contact_out->RelativeBodyPosition[1] = contact_out->Position - P[1];
-    contact_out->Body[0] = box0;
-    contact_out->Body[1] = box1;
-
-    return 1;
-}
-
-// Multiple version
-
-static bool CheckSeparationStatus(SATContext& ctx, rbMtx3 R[2], SATEvalStatus& status)
-{
-    bool separated = false;
-
-    // [LANG en] SAT using local axes of Box0
-    // [LANG ja] Box0 のローカル座標系の軸を利用した分離軸テスト
-    ctx.current_axis_id = SeparatingAxis::Box0X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2)), ctx, status);
-    if (separated) return true;
-
-    // [LANG en] SAT using local axes of Box1
-    // [LANG ja] Box1 のローカル座標系の軸を利用した分離軸テスト
-    ctx.current_axis_id = SeparatingAxis::Box1X;
-    separated = SeparatedOnAxis(rbVec3(R[1].Column(0)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box1Y;
-    separated = SeparatedOnAxis(rbVec3(R[1].Column(1)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box1Z;
-    separated = SeparatedOnAxis(rbVec3(R[1].Column(2)), ctx, status);
-    if (separated) return true;
-
-    // [LANG en] SAT using cross product from the local axes of each boxes
-    // [LANG ja] Box0 ・ Box1 それぞれのローカル座標系の軸から作成した分離軸でのテスト
-    ctx.current_axis_id = SeparatingAxis::Box0XxBox1X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(0)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(1)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(2)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0YxBox1X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(0)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(1)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(2)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1X;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(0)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Y;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(1)), ctx, status);
-    if (separated) return true;
-    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Z;
-    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(2)), ctx, status);
-    if (separated) return true;
-
-    return false;
-}
-
-static void BuildContact(SeparatingAxis axis_id, rbRigidBody* box0, rbRigidBody* box1, SATContext& ctx, SATPenetration& penetration, rbContact* contact_out)
-{
-    contact_out->Normal = penetration.axis; // [TODO] rethink to change here to penetration.axis.GetNormalized()
-
-    switch (axis_id)
-    {
-        // [LANG en] a vertex of Box1 is touching the face of Box0
-        // [LANG ja] Box1 の頂点が Box0 の面と交差している場合
-    case SeparatingAxis::Box0X:
-    case SeparatingAxis::Box0Y:
-    case SeparatingAxis::Box0Z:
-    {
-        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
-        // [LANG ja] Box1 -> Box0 と向くように調整
-        if (ctx.distance.GetNormalized() * contact_out->Normal >= 0)
-            contact_out->Normal *= -1;
-
-        contact_out->Position = FurthestVertexAlongAxis(contact_out->Normal, ctx.h[1], box1->Orientation(), ctx.RT[1], box1->Position());
-        contact_out->PenetrationDepth = penetration.depth;
-    }
-    break;
-
-    // [LANG en] a vertex of Box0 is touching the face of Box1
-    // [LANG ja] Box0 の頂点が Box1 の面と交差している場合
-    case SeparatingAxis::Box1X:
-    case SeparatingAxis::Box1Y:
-    case SeparatingAxis::Box1Z:
-    {
-        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
-        // [LANG ja] Box1 -> Box0 と向くように調整
-        if (ctx.distance.GetNormalized() * contact_out->Normal >= 0)
-            contact_out->Normal *= -1;
-
-        contact_out->Position = FurthestVertexAlongAxis(-contact_out->Normal, ctx.h[0], box0->Orientation(), ctx.RT[0], box0->Position());
-        contact_out->PenetrationDepth = penetration.depth;
-    }
-    break;
-
-    // [LANG en] Both boxes are touching with each other's edge
-    // [LANG ja] Box0 と Box1 の辺同士が交差している場合
-    default:
-    {
-        rbMtx3 R[2] = { box0->Orientation(), box1->Orientation() };
-
-        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
-        // [LANG ja] Box1 -> Box0 と向くように調整
-        if (ctx.distance.GetNormalized() * contact_out->Normal >= 0)
-        {
-            contact_out->Normal *= -1;
-        }
-
-        // [LANG en] Estimate touching position
-        // [LANG en] 1. identify touching edges
-        // [LANG en] 2. calculate closest points on these edges
-        // [LANG en] 3. take the midpoint of the points as the touching position
-        // [LANG ja] あとはひたすら接触点の位置の推定
-        // [LANG ja] 1. 接触状態にある辺2本を特定
-        // [LANG ja] 2. 辺対辺の最近接点2個を求める
-        // [LANG ja] 3. 上記の2個の点の中点を接触点の位置とする
-
-        const rbs32* ColIdx = ColumnIndices[static_cast<int>(axis_id)];
-
-        const rbVec3 best_axis_boxlocal[2] = {
-            ctx.RT[0] * contact_out->Normal,
-            ctx.RT[1] * contact_out->Normal
-        };
-
-        rbVec3 midpoint_on_colliding_edge[2] = {
-            rbVec3(0, 0, 0),
-            rbVec3(0, 0, 0)
-        };
-
-        for (int i = 0; i < 3; ++i)
-        {
-            if (i != ColIdx[0])
-                midpoint_on_colliding_edge[0].e[i] =
-                best_axis_boxlocal[0].e[i] < 0 ? ctx.h[0].e[i] : -ctx.h[0].e[i];
-
-            if (i != ColIdx[1])
-                midpoint_on_colliding_edge[1].e[i] =
-                best_axis_boxlocal[1].e[i] > 0 ? ctx.h[1].e[i] : -ctx.h[1].e[i];
-        }
-
-        // [LANG en] convert to the world coordinate system
-        // [LANG ja] ワールド座標系での位置へ変換
-        midpoint_on_colliding_edge[0] = R[0] * midpoint_on_colliding_edge[0] + box0->Position();
-        midpoint_on_colliding_edge[1] = R[1] * midpoint_on_colliding_edge[1] + box1->Position();
-
-        // [LANG en] The end points of a colliding edge can be found at positions h (and -h) away from the midpoint.
-        // [LANG ja] 中点がわかればそこから軸方向に幅 h (および -h) だけ伸ばした位置が衝突している辺を表す両端となる
-        const rbVec3 colliding_edge[2][2] = {
-            {
-                midpoint_on_colliding_edge[0] + ctx.h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
-                midpoint_on_colliding_edge[0] - ctx.h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
-            },
-            {
-                midpoint_on_colliding_edge[1] + ctx.h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
-                midpoint_on_colliding_edge[1] - ctx.h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
-            },
-        };
-
-        rbVec3 point_out[2];
-        ClosestPointOfSegments(colliding_edge, point_out);
-
-        // [LANG en] Tweak contact_out->Position
-        // [LANG en] - take the average of point_out[0] and point_out[1], and halve +best_penetration+, or
-        // [LANG ja] contact_out->Position の調整
-        // [LANG ja] - point_out[0] と point_out[1] の平均にして best_penetration を 1/2 とする
-        contact_out->Position = rbReal(0.5) * (point_out[0] + point_out[1]);
-        contact_out->PenetrationDepth = penetration.depth * rbReal(0.5);
-    }
-    break;
-    }
-
-    // [LANG en] Collect type-independent (vertex-face or edge-edge) data
-    // [LANG ja] 接触のタイプ(頂点対面 or 辺対辺)に依存しない情報はここで整理
-    contact_out->RelativeBodyPosition[0] = contact_out->Position - box0->Position();
-    contact_out->RelativeBodyPosition[1] = contact_out->Position - box1->Position();
-    contact_out->Body[0] = box0;
-    contact_out->Body[1] = box1;
-
-}
-
-// static
-rbs32 rbCollision::Detect(rbRigidBody* box0, rbRigidBody* box1, std::vector<rbContact>& contacts_out)
-{
-    rbVec3 h[2] = { box0->HalfExtent(), box1->HalfExtent() };
-    rbMtx3 R[2] = { box0->Orientation(), box1->Orientation() };
-    rbMtx3 RT[2] = { box0->OrientationTranspose(), box1->OrientationTranspose() };
-    rbVec3 P[2] = { box0->Position(), box1->Position() };
-
-    SATContext ctx = {
-        SeparatingAxis::Unknown,
-        { h[0], h[1] },
-        { RT[0], RT[1] },
-        P[1] - P[0]
-    };
-
-    SATEvalStatus status;
-    status.Clear();
-
-    //
-    // [LANG en] Separating-Axis Test
-    // [LANG ja] 分離軸テスト
-    //
-
-    if (CheckSeparationStatus(ctx, R, status)) {
-        return 0;
-    }
-
-    //
-    // [LANG en] No gap is found along any separating axes -> boxes are intersecting
-    // [LANG ja] どの軸上でも隙間が確認できない⇒交差している
-    //
-#if 1
-    std::stable_sort(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
-        [](auto const& lhs, auto const& rhs) {
-            return lhs.depth < rhs.depth;
-        }
-    );
-
-    int best_count = std::count_if(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
-        [&](auto& pen) {
-            return pen.depth == status.penetration[0].depth;
-        }
-    );
-#endif
-    rbContact contact_out;
-    for (int i = 0; i < best_count; ++i) {
-        //BuildContact(status.best_axis_id, box0, box1, ctx, status.penetration[static_cast<int>(status.best_axis_id)], &contact_out);
-        BuildContact(status.penetration[i].axis_id, box0, box1, ctx, status.penetration[i], &contact_out);
-        contacts_out.emplace_back(contact_out);
-    }
-
-    return static_cast<rbs32>(contacts_out.size());
-}
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbRigidBody.h>
+#include <RigidBox/rbCollision.h>
+#include <RigidBox/rbConvexHull.h>
+#include <RigidBox/rbTriangleMesh.h>
+#include <RigidBox/rbHeightField.h>
+#include <RigidBox/rbCompound.h>
+#include <RigidBox/rbProfiler.h>
+
+#include <algorithm>
+
+static inline rbReal HalfExtentOnAxis( const rbVec3& axis, const rbVec3& h, const rbMtx3& RT )
+{
+    rbVec3 axis_boxlocal = RT * axis;
+    return
+        rbFabs(axis_boxlocal.x) * h.x +
+        rbFabs(axis_boxlocal.y) * h.y +
+        rbFabs(axis_boxlocal.z) * h.z ;
+}
+
+static inline rbReal OverlapAlongAxis( const rbVec3& axis, rbVec3 h[2], rbMtx3 RT[2], const rbVec3& distance )
+{
+    rbReal r0 = HalfExtentOnAxis( axis, h[0], RT[0] );
+    rbReal r1 = HalfExtentOnAxis( axis, h[1], RT[1] );
+    rbReal D  = rbFabs( axis * distance );
+
+    return r0 + r1 - D;
+}
+
+// [LANG en] [NOTE] In the context of GJK algorithm, this function is 'support map function', that returns 'support point' of a box.
+// [LANG ja] [NOTE] この関数は GJK アルゴリズムでいうところのサポート写像で、出力として立方体の支点 (support point) を返すもの。
+// Ref.: Gino van den Bergen, Collision Detection in Interactive 3D Enviroments, 4.3.4 Support Mappings (pp.130-139)
+static inline rbVec3 FurthestVertexAlongAxis( const rbVec3& axis, const rbVec3& h, const rbMtx3& R, const rbMtx3& RT, const rbVec3& P )
+{
+    rbVec3 axis_boxlocal = (RT * axis).Normalize();
+
+    auto Sign = [](rbReal v) -> rbReal { return v < -RIGIDBOX_TOLERANCE ? rbReal(-1) : rbReal(1); };
+
+    rbVec3 FurthestVertexLocal( Sign(axis_boxlocal.x) * h.x, Sign(axis_boxlocal.y) * h.y, Sign(axis_boxlocal.z) * h.z );
+
+    return R * FurthestVertexLocal + P;
+}
+
+static inline rbReal Clamp( rbReal val, rbReal min, rbReal max )
+{
+    if ( val < min )
+        val = min;
+    else if ( val > max )
+        val = max;
+
+    return val;
+}
+
+// Ref.: Christer Ericson, Real-Time Collision Detection (2005)
+// 5.1.9 Closest Points of Two Line Segments
+static inline void ClosestPointOfSegments( const rbVec3 colliding_edge[2][2], rbVec3 point_out[2] )
+{
+    rbVec3 d[2] = {
+        colliding_edge[0][1] - colliding_edge[0][0],
+        colliding_edge[1][1] - colliding_edge[1][0]
+    };
+
+    rbVec3 r = colliding_edge[0][0] - colliding_edge[1][0];
+
+    rbReal a = d[0] * d[0];
+    rbReal e = d[1] * d[1];
+    rbReal c = d[0] * r;
+    rbReal f = d[1] * r;
+    rbReal b = d[0] * d[1];
+
+    // [LANG en] If you want to make this routine more generic, you must confirm given edges don't degenerate into a point (given edges are not zero-length).
+    // [LANG en] But the argument +colliding_edge+ is always given with valid edge data, we don't have to check the condition.
+    // [LANG ja] より汎用的な交差判定ルーチンにしたいのであれば、ここで「辺の両端として渡された2点が一致していないかどうか
+    // [LANG ja] (==点に縮退していないかどうか)」をチェックする必要がある。しかしここで colliding_edge にその可能性はないのでチェックは不要。
+
+    rbReal t[2];
+    rbReal denom = a*e - b*b;
+    if ( denom > RIGIDBOX_TOLERANCE )
+        t[0] = Clamp( (b*f - c*e) / denom, rbReal(0), rbReal(1) );
+    else
+        t[0] = rbReal(0);
+
+    t[1] = (b * t[0] + f) / e;
+
+    if ( t[1] < rbReal(0) )
+    {
+        t[1] = rbReal(0);
+        t[0] = Clamp( -c / a, rbReal(0), rbReal(1) );
+    }
+    else if ( t[1] > rbReal(1) )
+    {
+        t[1] = rbReal(1);
+        t[0] = Clamp( (b - c) / a, rbReal(0), rbReal(1) );
+    }
+
+    point_out[0] = colliding_edge[0][0] + d[0] * t[0];
+    point_out[1] = colliding_edge[1][0] + d[1] * t[1];
+}
+
+
+// Separating axis identifier
+enum class SeparatingAxis : int {
+    Box0XxBox1X = 0,
+    Box0XxBox1Y,
+    Box0XxBox1Z,
+    Box0YxBox1X,
+    Box0YxBox1Y,
+    Box0YxBox1Z,
+    Box0ZxBox1X,
+    Box0ZxBox1Y,
+    Box0ZxBox1Z,
+
+    Box0X,
+    Box0Y,
+    Box0Z,
+    Box1X,
+    Box1Y,
+    Box1Z,
+
+    Count,
+    Unknown,
+    Start = Box0XxBox1X,
+};
+
+static const rbs32 ColumnIndices[9][2] = {
+    { 0, 0 }, // SeparatingAxis::Box0XxBox1X (== 0) -> box0->Orientation().Column(0) % box1->Orientation().Column(0)
+    { 0, 1 }, // SeparatingAxis::Box0XxBox1Y (== 1) -> box0->Orientation().Column(0) % box1->Orientation().Column(1)
+    { 0, 2 }, // SeparatingAxis::Box0XxBox1Z (== 2) -> :
+    { 1, 0 }, // SeparatingAxis::Box0YxBox1X (== 3)
+    { 1, 1 }, // SeparatingAxis::Box0YxBox1Y (== 4)
+    { 1, 2 }, // SeparatingAxis::Box0YxBox1Z (== 5)
+    { 2, 0 }, // SeparatingAxis::Box0ZxBox1X (== 6)
+    { 2, 1 }, // SeparatingAxis::Box0ZxBox1Y (== 7) -> :
+    { 2, 2 }, // SeparatingAxis::Box0ZxBox1Z (== 8) -> box0->Orientation().Column(2) % box1->Orientation().Column(2)
+};
+
+//
+// [LANG en] Box-Box collision detection algorithm
+// [LANG ja] 立方体同士の衝突検出
+//
+// Ref.:
+// - Open Dynamics Engine [box.cpp]
+// - Game Physics Engine Development [collide_fine.cpp]
+//
+
+struct SATPenetration {
+    rbVec3 axis;
+    SeparatingAxis axis_id;
+    // [LANG en] Current candidate value of penetration depth along +best_axis_id+.
+    // [LANG ja] 軸 +best_axis_id+ に沿った貫通深度の候補値
+    rbReal depth;
+};
+
+struct SATEvalStatus {
+    rbVec3 best_axis;
+    SeparatingAxis best_axis_id;
+    SATPenetration penetration[static_cast<int>(SeparatingAxis::Count)];
+
+    void Clear() {
+        best_axis_id = SeparatingAxis::Start;
+        best_axis.SetZero();
+        for (auto& t : penetration) {
+            t.depth = RIGIDBOX_REAL_MAX;
+        }
+    }
+};
+
+struct SATContext {
+    SeparatingAxis current_axis_id;
+    rbVec3 h[2];
+    rbMtx3 RT[2];
+    rbVec3 distance;
+};
+
+static inline bool SeparatedOnAxis(rbVec3&& axis, SATContext& ctx, SATEvalStatus& status)
+{
+    if (axis.LengthSq() >= RIGIDBOX_TOLERANCE)
+    {
+        RIGIDBOX_PROFILE_SAT_AXIS();
+        axis.Normalize();
+        rbReal current_penetration = OverlapAlongAxis(axis, ctx.h, ctx.RT, ctx.distance);
+        status.penetration[static_cast<int>(ctx.current_axis_id)].depth = current_penetration;
+        status.penetration[static_cast<int>(ctx.current_axis_id)].axis_id = ctx.current_axis_id;
+        status.penetration[static_cast<int>(ctx.current_axis_id)].axis = axis;
+
+        if (current_penetration <= RIGIDBOX_TOLERANCE)
+            return true;
+        if (current_penetration < status.penetration[static_cast<int>(status.best_axis_id)].depth)
+        {
+            status.best_axis = axis;
+            status.best_axis_id = ctx.current_axis_id;
+        }
+    }
+    return false;
+}
+
+static rbs32 DetectBoxBox( rbRigidBody* box0, rbRigidBody* box1, rbContact* contact_out )
+{
+    rbVec3 h[2] = { box0->HalfExtent(), box1->HalfExtent() };
+    rbMtx3 R[2] = { box0->Orientation(), box1->Orientation() };
+    rbMtx3 RT[2] = { box0->OrientationTranspose(), box1->OrientationTranspose() };
+    rbVec3 P[2] = { box0->Position(), box1->Position() };
+    rbVec3 distance = P[1] - P[0];
+
+    SATContext ctx = {
+        SeparatingAxis::Unknown,
+        { h[0], h[1] },
+        { RT[0], RT[1] },
+        P[1] - P[0]
+    };
+
+    SATEvalStatus status;
+    status.Clear();
+
+    //
+    // [LANG en] Separating-Axis Test
+    // [LANG ja] 分離軸テスト
+    //
+    bool separated = false;
+
+    // [LANG en] SAT using local axes of Box0
+    // [LANG ja] Box0 のローカル座標系の軸を利用した分離軸テスト
+    ctx.current_axis_id = SeparatingAxis::Box0X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2)), ctx, status);
+    if (separated) return 0;
+
+    // [LANG en] SAT using local axes of Box1
+    // [LANG ja] Box1 のローカル座標系の軸を利用した分離軸テスト
+    ctx.current_axis_id = SeparatingAxis::Box1X;
+    separated = SeparatedOnAxis(rbVec3(R[1].Column(0)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box1Y;
+    separated = SeparatedOnAxis(rbVec3(R[1].Column(1)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box1Z;
+    separated = SeparatedOnAxis(rbVec3(R[1].Column(2)), ctx, status);
+    if (separated) return 0;
+
+    // [LANG en] SAT using cross product from the local axes of each boxes
+    // [LANG ja] Box0 ・ Box1 それぞれのローカル座標系の軸から作成した分離軸でのテスト
+    ctx.current_axis_id = SeparatingAxis::Box0XxBox1X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(0)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(1)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(2)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0YxBox1X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(0)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(1)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(2)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(0)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(1)), ctx, status);
+    if (separated) return 0;
+    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(2)), ctx, status);
+    if (separated) return 0;
+
+    //
+    // [LANG en] No gap is found along any separating axes -> boxes are intersecting
+    // [LANG ja] どの軸上でも隙間が確認できない⇒交差している
+    //
+#if 0
+    std::sort(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
+        [](auto const& lhs, auto const& rhs) {
+            return lhs.depth < rhs.depth;
+        }
+    );
+
+    int best_count = std::count_if(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
+        [&](auto& pen) {
+            return pen.depth == status.penetration[0].depth;
+        }
+    );
+#endif
+    // [LANG en] Create Normal
+    // [LANG ja] 法線の決定
+    contact_out->Normal = status.best_axis;
+
+    switch ( status.best_axis_id )
+    {
+    // [LANG en] a vertex of Box1 is touching the face of Box0
+    // [LANG ja] Box1 の頂点が Box0 の面と交差している場合
+    case SeparatingAxis::Box0X:
+    case SeparatingAxis::Box0Y:
+    case SeparatingAxis::Box0Z:
+    {
+        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
+        // [LANG ja] Box1 -> Box0 と向くように調整
+        if ( ctx.distance.GetNormalized() * contact_out->Normal >= 0 )
+            contact_out->Normal *= -1;
+
+        contact_out->Position = FurthestVertexAlongAxis( contact_out->Normal, h[1], R[1], RT[1], P[1] );
+        contact_out->PenetrationDepth = status.penetration[static_cast<int>(status.best_axis_id)].depth;
+    }
+    break;
+
+    // [LANG en] a vertex of Box0 is touching the face of Box1
+    // [LANG ja] Box0 の頂点が Box1 の面と交差している場合
+    case SeparatingAxis::Box1X:
+    case SeparatingAxis::Box1Y:
+    case SeparatingAxis::Box1Z:
+    {
+        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
+        // [LANG ja] Box1 -> Box0 と向くように調整
+        if ( ctx.distance.GetNormalized() * contact_out->Normal >= 0 )
+            contact_out->Normal *= -1;
+
+        contact_out->Position = FurthestVertexAlongAxis( -contact_out->Normal, h[0], R[0], RT[0], P[0] );
+        contact_out->PenetrationDepth = status.penetration[static_cast<int>(status.best_axis_id)].depth;
+    }
+    break;
+
+    // [LANG en] Both boxes are touching with each other's edge
+    // [LANG ja] Box0 と Box1 の辺同士が交差している場合
+    default:
+    {
+        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
+        // [LANG ja] Box1 -> Box0 と向くように調整
+        if ( ctx.distance.GetNormalized() * contact_out->Normal >= 0 )
+        {
+            contact_out->Normal *= -1;
+        }
+
+        // [LANG en] Estimate touching position
+        // [LANG en] 1. identify touching edges
+        // [LANG en] 2. calculate closest points on these edges
+        // [LANG en] 3. take the midpoint of the points as the touching position
+        // [LANG ja] あとはひたすら接触点の位置の推定
+        // [LANG ja] 1. 接触状態にある辺2本を特定
+        // [LANG ja] 2. 辺対辺の最近接点2個を求める
+        // [LANG ja] 3. 上記の2個の点の中点を接触点の位置とする
+
+        const rbs32 *ColIdx = ColumnIndices[static_cast<int>(status.best_axis_id)];
+
+        const rbVec3 best_axis_boxlocal[2] = {
+            RT[0] * contact_out->Normal,
+            RT[1] * contact_out->Normal
+        };
+
+        rbVec3 midpoint_on_colliding_edge[2] = {
+            rbVec3(0, 0, 0),
+            rbVec3(0, 0, 0)
+        };
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( i != ColIdx[0] )
+                midpoint_on_colliding_edge[0].e[i] =
+                    best_axis_boxlocal[0].e[i] < 0 ? h[0].e[i] : -h[0].e[i];
+
+            if ( i != ColIdx[1] )
+                midpoint_on_colliding_edge[1].e[i] =
+                    best_axis_boxlocal[1].e[i] > 0 ? h[1].e[i] : -h[1].e[i];
+        }
+
+        // [LANG en] convert to the world coordinate system
+        // [LANG ja] ワールド座標系での位置へ変換
+        midpoint_on_colliding_edge[0] = R[0] * midpoint_on_colliding_edge[0] + P[0];
+        midpoint_on_colliding_edge[1] = R[1] * midpoint_on_colliding_edge[1] + P[1];
+
+        // [LANG en] The end points of a colliding edge can be found at positions h (and -h) away from the midpoint.
+        // [LANG ja] 中点がわかればそこから軸方向に幅 h (および -h) だけ伸ばした位置が衝突している辺を表す両端となる
+        const rbVec3 colliding_edge[2][2] = {
+            {
+                midpoint_on_colliding_edge[0] + h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
+                midpoint_on_colliding_edge[0] - h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
+            },
+            {
+                midpoint_on_colliding_edge[1] + h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
+                midpoint_on_colliding_edge[1] - h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
+            },
+        };
+
+        rbVec3 point_out[2];
+        ClosestPointOfSegments( colliding_edge, point_out );
+
+        // [LANG en] Tweak contact_out->Position
+        // [LANG en] - take the average of point_out[0] and point_out[1], and halve +best_penetration+, or
+        // [LANG ja] contact_out->Position の調整
+        // [LANG ja] - point_out[0] と point_out[1] の平均にして best_penetration を 1/2 とする
+        contact_out->Position = rbReal(0.5) * (point_out[0] + point_out[1]);
+        contact_out->PenetrationDepth = status.penetration[static_cast<int>(status.best_axis_id)].depth * rbReal(0.5);
+    }
+    break;
+    }
+
+    // [LANG en] Collect type-independent (vertex-face or edge-edge) data
+    // [LANG ja] 接触のタイプ(頂点対面 or 辺対辺)に依存しない情報はここで整理
+    contact_out->RelativeBodyPosition[0] = contact_out->Position - P[0];
+    contact_out->RelativeBodyPosition[1] = contact_out->Position - P[1];
+    contact_out->Body[0] = box0;
+    contact_out->Body[1] = box1;
+
+    return 1;
+}
+
+// Multiple version
+
+static bool CheckSeparationStatus(SATContext& ctx, rbMtx3 R[2], SATEvalStatus& status)
+{
+    bool separated = false;
+
+    // [LANG en] SAT using local axes of Box0
+    // [LANG ja] Box0 のローカル座標系の軸を利用した分離軸テスト
+    ctx.current_axis_id = SeparatingAxis::Box0X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2)), ctx, status);
+    if (separated) return true;
+
+    // [LANG en] SAT using local axes of Box1
+    // [LANG ja] Box1 のローカル座標系の軸を利用した分離軸テスト
+    ctx.current_axis_id = SeparatingAxis::Box1X;
+    separated = SeparatedOnAxis(rbVec3(R[1].Column(0)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box1Y;
+    separated = SeparatedOnAxis(rbVec3(R[1].Column(1)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box1Z;
+    separated = SeparatedOnAxis(rbVec3(R[1].Column(2)), ctx, status);
+    if (separated) return true;
+
+    // [LANG en] SAT using cross product from the local axes of each boxes
+    // [LANG ja] Box0 ・ Box1 それぞれのローカル座標系の軸から作成した分離軸でのテスト
+    ctx.current_axis_id = SeparatingAxis::Box0XxBox1X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(0)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(1)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0XxBox1Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(0) % R[1].Column(2)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0YxBox1X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(0)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(1)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0YxBox1Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(1) % R[1].Column(2)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1X;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(0)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Y;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(1)), ctx, status);
+    if (separated) return true;
+    ctx.current_axis_id = SeparatingAxis::Box0ZxBox1Z;
+    separated = SeparatedOnAxis(rbVec3(R[0].Column(2) % R[1].Column(2)), ctx, status);
+    if (separated) return true;
+
+    return false;
+}
+
+static void BuildContact(SeparatingAxis axis_id, rbRigidBody* box0, rbRigidBody* box1, SATContext& ctx, SATPenetration& penetration, rbContact* contact_out)
+{
+    contact_out->Normal = penetration.axis; // [TODO] rethink to change here to penetration.axis.GetNormalized()
+
+    switch (axis_id)
+    {
+        // [LANG en] a vertex of Box1 is touching the face of Box0
+        // [LANG ja] Box1 の頂点が Box0 の面と交差している場合
+    case SeparatingAxis::Box0X:
+    case SeparatingAxis::Box0Y:
+    case SeparatingAxis::Box0Z:
+    {
+        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
+        // [LANG ja] Box1 -> Box0 と向くように調整
+        if (ctx.distance.GetNormalized() * contact_out->Normal >= 0)
+            contact_out->Normal *= -1;
+
+        contact_out->Position = FurthestVertexAlongAxis(contact_out->Normal, ctx.h[1], box1->Orientation(), ctx.RT[1], box1->Position());
+        contact_out->PenetrationDepth = penetration.depth;
+    }
+    break;
+
+    // [LANG en] a vertex of Box0 is touching the face of Box1
+    // [LANG ja] Box0 の頂点が Box1 の面と交差している場合
+    case SeparatingAxis::Box1X:
+    case SeparatingAxis::Box1Y:
+    case SeparatingAxis::Box1Z:
+    {
+        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
+        // [LANG ja] Box1 -> Box0 と向くように調整
+        if (ctx.distance.GetNormalized() * contact_out->Normal >= 0)
+            contact_out->Normal *= -1;
+
+        contact_out->Position = FurthestVertexAlongAxis(-contact_out->Normal, ctx.h[0], box0->Orientation(), ctx.RT[0], box0->Position());
+        contact_out->PenetrationDepth = penetration.depth;
+    }
+    break;
+
+    // [LANG en] Both boxes are touching with each other's edge
+    // [LANG ja] Box0 と Box1 の辺同士が交差している場合
+    default:
+    {
+        rbMtx3 R[2] = { box0->Orientation(), box1->Orientation() };
+
+        // [LANG en] By convention, +Normal+ should point from Box1 to Box0
+        // [LANG ja] Box1 -> Box0 と向くように調整
+        if (ctx.distance.GetNormalized() * contact_out->Normal >= 0)
+        {
+            contact_out->Normal *= -1;
+        }
+
+        // [LANG en] Estimate touching position
+        // [LANG en] 1. identify touching edges
+        // [LANG en] 2. calculate closest points on these edges
+        // [LANG en] 3. take the midpoint of the points as the touching position
+        // [LANG ja] あとはひたすら接触点の位置の推定
+        // [LANG ja] 1. 接触状態にある辺2本を特定
+        // [LANG ja] 2. 辺対辺の最近接点2個を求める
+        // [LANG ja] 3. 上記の2個の点の中点を接触点の位置とする
+
+        const rbs32* ColIdx = ColumnIndices[static_cast<int>(axis_id)];
+
+        const rbVec3 best_axis_boxlocal[2] = {
+            ctx.RT[0] * contact_out->Normal,
+            ctx.RT[1] * contact_out->Normal
+        };
+
+        rbVec3 midpoint_on_colliding_edge[2] = {
+            rbVec3(0, 0, 0),
+            rbVec3(0, 0, 0)
+        };
+
+        for (int i = 0; i < 3; ++i)
+        {
+            if (i != ColIdx[0])
+                midpoint_on_colliding_edge[0].e[i] =
+                best_axis_boxlocal[0].e[i] < 0 ? ctx.h[0].e[i] : -ctx.h[0].e[i];
+
+            if (i != ColIdx[1])
+                midpoint_on_colliding_edge[1].e[i] =
+                best_axis_boxlocal[1].e[i] > 0 ? ctx.h[1].e[i] : -ctx.h[1].e[i];
+        }
+
+        // [LANG en] convert to the world coordinate system
+        // [LANG ja] ワールド座標系での位置へ変換
+        midpoint_on_colliding_edge[0] = R[0] * midpoint_on_colliding_edge[0] + box0->Position();
+        midpoint_on_colliding_edge[1] = R[1] * midpoint_on_colliding_edge[1] + box1->Position();
+
+        // [LANG en] The end points of a colliding edge can be found at positions h (and -h) away from the midpoint.
+        // [LANG ja] 中点がわかればそこから軸方向に幅 h (および -h) だけ伸ばした位置が衝突している辺を表す両端となる
+        const rbVec3 colliding_edge[2][2] = {
+            {
+                midpoint_on_colliding_edge[0] + ctx.h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
+                midpoint_on_colliding_edge[0] - ctx.h[0].e[ColIdx[0]] * R[0].Column(ColIdx[0]),
+            },
+            {
+                midpoint_on_colliding_edge[1] + ctx.h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
+                midpoint_on_colliding_edge[1] - ctx.h[1].e[ColIdx[1]] * R[1].Column(ColIdx[1]),
+            },
+        };
+
+        rbVec3 point_out[2];
+        ClosestPointOfSegments(colliding_edge, point_out);
+
+        // [LANG en] Tweak contact_out->Position
+        // [LANG en] - take the average of point_out[0] and point_out[1], and halve +best_penetration+, or
+        // [LANG ja] contact_out->Position の調整
+        // [LANG ja] - point_out[0] と point_out[1] の平均にして best_penetration を 1/2 とする
+        contact_out->Position = rbReal(0.5) * (point_out[0] + point_out[1]);
+        contact_out->PenetrationDepth = penetration.depth * rbReal(0.5);
+    }
+    break;
+    }
+
+    // [LANG en] Collect type-independent (vertex-face or edge-edge) data
+    // [LANG ja] 接触のタイプ(頂点対面 or 辺対辺)に依存しない情報はここで整理
+    contact_out->RelativeBodyPosition[0] = contact_out->Position - box0->Position();
+    contact_out->RelativeBodyPosition[1] = contact_out->Position - box1->Position();
+    contact_out->Body[0] = box0;
+    contact_out->Body[1] = box1;
+
+}
+
+// static
+
+//
+// [LANG en] Convex-convex test based on support mapping (box, convex hull and triangle)
+// [LANG ja] サポート写像を利用した凸形状同士の判定 (直方体、凸包、三角形)
+//
+
+enum class ConvexKind : int {
+    Box,
+    Hull,
+    Triangle,
+};
+
+struct ConvexProxy
+{
+    ConvexKind kind;
+    const rbConvexHull* hull;
+
+    // [LANG en] Box : half-extent in h. Triangle : vertices, unit normal and unit edges, already given in the working frame (R and P are not used).
+    // [LANG ja] 直方体 : h が half-extent。三角形 : 作業座標系での頂点、単位法線、単位辺ベクトル (R と P は使わない)。
+    rbVec3 h;
+    rbVec3 triangle[3];
+    rbVec3 triangle_normal;
+    rbVec3 triangle_edge[3];
+
+    rbMtx3 R;
+    rbMtx3 RT;
+    rbVec3 P;
+
+    // [LANG en] Warm-start slots of a hull : the body's own, or +local_support_cache+ when the body must not be written
+    // [LANG ja] 凸包の探索開始位置 : 剛体自身のもの、または剛体に書き込んではならない場合は +local_support_cache+
+    rbu32* support_cache;
+    rbu32 local_support_cache[2];
+};
+
+enum class ConvexFeature : int {
+    Face0,
+    Face1,
+    Edge,
+};
+
+struct ConvexSATResult {
+    // [LANG en] Points from body1 to body0, as rbContact::Normal does.
+    // [LANG ja] rbContact::Normal と同様に body1 -> body0 の向き
+    rbVec3 normal;
+    rbReal depth;
+    ConvexFeature feature;
+};
+
+static inline void SetupConvexProxy( rbRigidBody* body, bool update_support_cache, ConvexProxy& proxy )
+{
+    proxy.kind = body->ShapeType() == rbRigidBody::ShapeType_ConvexHull ? ConvexKind::Hull : ConvexKind::Box;
+    proxy.hull = body->ConvexHull();
+    proxy.h = body->HalfExtent();
+    proxy.R = body->Orientation();
+    proxy.RT = body->OrientationTranspose();
+    proxy.P = body->Position();
+    proxy.support_cache = body->SupportVertexCache();
+    if ( !update_support_cache )
+    {
+        proxy.local_support_cache[0] = proxy.support_cache[0];
+        proxy.local_support_cache[1] = proxy.support_cache[1];
+        proxy.support_cache = proxy.local_support_cache;
+    }
+}
+
+static inline void SetupTriangleProxy( const rbVec3 triangle[3], ConvexProxy& proxy )
+{
+    proxy.kind = ConvexKind::Triangle;
+    for ( rbs32 i = 0; i < 3; ++i )
+        proxy.triangle[i] = triangle[i];
+
+    // [LANG en] Degenerated normals/edges are left as zero vectors, so that SeparatedOnConvexAxis skips them.
+    // [LANG ja] 縮退した法線・辺はゼロベクトルのままにしておく (SeparatedOnConvexAxis が読み飛ばす)
+    auto Unit = [](const rbVec3& v) {
+        rbReal length = v.Length();
+        return length > RIGIDBOX_TOLERANCE ? v / length : rbVec3( 0, 0, 0 );
+    };
+    proxy.triangle_normal = Unit( (proxy.triangle[1] - proxy.triangle[0]) % (proxy.triangle[2] - proxy.triangle[0]) );
+    for ( rbs32 i = 0; i < 3; ++i )
+        proxy.triangle_edge[i] = Unit( proxy.triangle[(i + 1) % 3] - proxy.triangle[i] );
+}
+
+// [LANG en] Half-extent of the axis-aligned box that bounds a box of half-extent +h+ rotated by +R+
+// [LANG ja] +R+ で回転させた half-extent +h+ の直方体を包む、軸に平行な直方体の half-extent
+static inline rbVec3 BoundingHalfExtent( const rbMtx3& R, const rbVec3& h )
+{
+    return rbVec3( rbFabs(R.Elem(0,0)) * h.x + rbFabs(R.Elem(0,1)) * h.y + rbFabs(R.Elem(0,2)) * h.z,
+                   rbFabs(R.Elem(1,0)) * h.x + rbFabs(R.Elem(1,1)) * h.y + rbFabs(R.Elem(1,2)) * h.z,
+                   rbFabs(R.Elem(2,0)) * h.x + rbFabs(R.Elem(2,1)) * h.y + rbFabs(R.Elem(2,2)) * h.z );
+}
+
+// [LANG en] +slot+ selects the warm-start cache of a hull (see rbRigidBody::SupportVertexCache) :
+// [LANG en] 0 for queries along an axis, 1 for queries against it, so that the two ends of a projection do not
+// [LANG en] overwrite each other's starting vertex.
+// [LANG ja] +slot+ は凸包の探索開始位置のキャッシュを選ぶ (rbRigidBody::SupportVertexCache を参照) :
+// [LANG ja] 軸の向きの問い合わせは 0、逆向きは 1。射影の両端が互いの開始位置を上書きしないようにするため。
+static inline rbVec3 SupportPoint( const ConvexProxy& proxy, const rbVec3& direction, rbu32 slot = 0 )
+{
+    if ( proxy.kind == ConvexKind::Triangle )
+    {
+        rbReal d[3] = { proxy.triangle[0] * direction, proxy.triangle[1] * direction, proxy.triangle[2] * direction };
+        rbs32 i = d[1] > d[0] ? 1 : 0;
+        return proxy.triangle[d[2] > d[i] ? 2 : i];
+    }
+
+    rbVec3 d = proxy.RT * direction;
+    rbVec3 local;
+    if ( proxy.kind == ConvexKind::Hull )
+        local = proxy.hull->Support( d, proxy.support_cache[slot] );
+    else
+        local.Set( d.x < 0 ? -proxy.h.x : proxy.h.x,
+                   d.y < 0 ? -proxy.h.y : proxy.h.y,
+                   d.z < 0 ? -proxy.h.z : proxy.h.z );
+
+    return proxy.R * local + proxy.P;
+}
+
+static inline rbu32 FaceAxisCount( const ConvexProxy& proxy )
+{
+    switch ( proxy.kind )
+    {
+    case ConvexKind::Hull:     return proxy.hull->FaceCount();
+    case ConvexKind::Triangle: return 1;
+    default:                   return 3;
+    }
+}
+
+static inline rbVec3 FaceAxis( const ConvexProxy& proxy, rbu32 i )
+{
+    switch ( proxy.kind )
+    {
+    case ConvexKind::Hull:     return proxy.R * proxy.hull->FaceNormal(i);
+    case ConvexKind::Triangle: return proxy.triangle_normal;
+    default:                   return proxy.R.Column(i);
+    }
+}
+
+static inline rbu32 EdgeAxisCount( const ConvexProxy& proxy )
+{
+    return proxy.kind == ConvexKind::Hull ? proxy.hull->EdgeDirectionCount() : 3;
+}
+
+static inline rbVec3 EdgeAxis( const ConvexProxy& proxy, rbu32 i )
+{
+    switch ( proxy.kind )
+    {
+    case ConvexKind::Hull:     return proxy.R * proxy.hull->EdgeDirection(i);
+    case ConvexKind::Triangle: return proxy.triangle_edge[i];
+    default:                   return proxy.R.Column(i);
+    }
+}
+
+// [LANG en] +margin+ > 0 accepts axes with a gap smaller than +margin+ (the depth becomes negative : speculative contacts)
+// [LANG ja] +margin+ > 0 の場合は +margin+ 未満の隙間しかない軸を分離軸とみなさない (深さは負になる : 予測的な衝突点)
+static inline bool SeparatedOnConvexAxis( rbVec3 axis, const ConvexProxy p[2], ConvexFeature feature, rbReal margin, ConvexSATResult& best )
+{
+    rbReal length_sq = axis.LengthSq();
+    if ( length_sq < RIGIDBOX_TOLERANCE )
+        return false;
+    axis /= rbSqrt( length_sq );
+    RIGIDBOX_PROFILE_SAT_AXIS();
+
+    rbReal max0 = axis * SupportPoint( p[0],  axis );
+    rbReal min0 = axis * SupportPoint( p[0], -axis, 1 );
+    rbReal max1 = axis * SupportPoint( p[1],  axis );
+    rbReal min1 = axis * SupportPoint( p[1], -axis, 1 );
+
+    // [LANG en] Body0 on the positive side of body1 (Normal == +axis), or on the negative side (Normal == -axis)
+    // [LANG ja] Body0 が body1 の正の側にある (Normal == +axis) か、負の側にある (Normal == -axis) か
+    rbReal depth_positive = max1 - min0;
+    rbReal depth_negative = max0 - min1;
+    rbReal depth = rbMin( depth_positive, depth_negative );
+
+    if ( depth + margin <= RIGIDBOX_TOLERANCE )
+        return true;
+
+    // [LANG en] Prefer face axes to edge axes of almost the same depth, to keep resting contacts stable.
+    // [LANG ja] ほぼ同じ深さであれば辺の軸より面の軸を優先する (静止接触を安定させるため)
+    rbReal threshold = feature == ConvexFeature::Edge ? best.depth - rbReal(0.05) * rbFabs(best.depth) : best.depth;
+    if ( depth < threshold )
+    {
+        best.normal = depth_positive <= depth_negative ? axis : -axis;
+        best.depth = depth;
+        best.feature = feature;
+    }
+
+    return false;
+}
+
+static bool CheckConvexSeparation( const ConvexProxy p[2], rbReal margin, ConvexSATResult& best )
+{
+    best.depth = RIGIDBOX_REAL_MAX;
+    best.feature = ConvexFeature::Face0;
+    best.normal.SetZero();
+
+    for ( rbu32 i = 0, n = FaceAxisCount(p[0]); i < n; ++i )
+        if ( SeparatedOnConvexAxis(FaceAxis(p[0], i), p, ConvexFeature::Face0, margin, best) )
+            return true;
+
+    for ( rbu32 i = 0, n = FaceAxisCount(p[1]); i < n; ++i )
+        if ( SeparatedOnConvexAxis(FaceAxis(p[1], i), p, ConvexFeature::Face1, margin, best) )
+            return true;
+
+    for ( rbu32 i = 0, n0 = EdgeAxisCount(p[0]); i < n0; ++i )
+    {
+        rbVec3 e0 = EdgeAxis( p[0], i );
+        for ( rbu32 j = 0, n1 = EdgeAxisCount(p[1]); j < n1; ++j )
+            if ( SeparatedOnConvexAxis(e0 % EdgeAxis(p[1], j), p, ConvexFeature::Edge, margin, best) )
+                return true;
+    }
+
+    return false;
+}
+
+// [LANG en] Center of the feature (vertex, edge or face) of +proxy+ that lies furthest along +direction+
+// [LANG ja] +proxy+ の中で +direction+ 方向に最も遠い特徴 (頂点・辺・面) の中心
+static rbVec3 SupportFeatureCenter( const ConvexProxy& proxy, const rbVec3& direction, rbu32 slot )
+{
+    const rbReal tolerance = rbReal(0.01) * (proxy.kind == ConvexKind::Triangle ? (proxy.triangle[1] - proxy.triangle[0]).Length() : proxy.h.Length());
+    const rbReal threshold = direction * SupportPoint( proxy, direction, slot ) - tolerance;
+
+    rbVec3 sum( 0, 0, 0 );
+    rbs32 count = 0;
+    auto Visit = [&](const rbVec3& v) {
+        if ( v * direction >= threshold )
+        {
+            sum += v;
+            ++count;
+        }
+    };
+
+    switch ( proxy.kind )
+    {
+    case ConvexKind::Triangle:
+        for ( rbs32 i = 0; i < 3; ++i )
+            Visit( proxy.triangle[i] );
+        break;
+    case ConvexKind::Hull:
+        for ( rbu32 i = 0, n = proxy.hull->VertexCount(); i < n; ++i )
+            Visit( proxy.R * proxy.hull->Vertex(i) + proxy.P );
+        break;
+    default:
+        for ( rbs32 i = 0; i < 8; ++i )
+            Visit( proxy.R * rbVec3( i & 1 ? proxy.h.x : -proxy.h.x, i & 2 ? proxy.h.y : -proxy.h.y, i & 4 ? proxy.h.z : -proxy.h.z ) + proxy.P );
+        break;
+    }
+
+    return sum / rbReal(count);
+}
+
+// [LANG en] Fills Normal, Position and PenetrationDepth in the working frame of the proxies.
+// [LANG ja] Normal, Position, PenetrationDepth をプロキシの作業座標系で設定
+static void BuildConvexContact( const ConvexProxy p[2], const ConvexSATResult& best, rbContact* contact_out )
+{
+    contact_out->Normal = best.normal;
+
+    // [LANG en] Speculative contact across a face : a single point at the center of the closest feature of the other body,
+    // [LANG en] so that a box approaching face-first is stopped without being spun by a corner.
+    // [LANG ja] 面に対する予測的な衝突点 : 相手の最も近い特徴の中心に1点だけ置く
+    // [LANG ja] (面から近づく直方体が角の衝突点によって回転させられることなく止まるように)。
+    if ( best.depth <= 0 && best.feature != ConvexFeature::Edge )
+    {
+        contact_out->Position = best.feature == ConvexFeature::Face0
+            ? SupportFeatureCenter( p[1],  best.normal, 0 )
+            : SupportFeatureCenter( p[0], -best.normal, 1 );
+        contact_out->PenetrationDepth = best.depth;
+        return;
+    }
+
+    switch ( best.feature )
+    {
+    // [LANG en] a vertex of Body1 is touching the face of Body0
+    // [LANG ja] Body1 の頂点が Body0 の面と交差している場合
+    case ConvexFeature::Face0:
+        contact_out->Position = SupportPoint( p[1], best.normal );
+        contact_out->PenetrationDepth = best.depth;
+        break;
+
+    // [LANG en] a vertex of Body0 is touching the face of Body1
+    // [LANG ja] Body0 の頂点が Body1 の面と交差している場合
+    case ConvexFeature::Face1:
+        contact_out->Position = SupportPoint( p[0], -best.normal, 1 );
+        contact_out->PenetrationDepth = best.depth;
+        break;
+
+    // [LANG en] Edge-edge : take the midpoint of the deepest points and halve the depth (same as the box-box case).
+    // [LANG en] A speculative gap (negative depth) is kept as is.
+    // [LANG ja] 辺対辺 : 最も深い点同士の中点を取り、深さを 1/2 とする (直方体同士の場合と同様)。
+    // [LANG ja] 予測的な衝突点の隙間 (負の深さ) はそのまま使う。
+    default:
+        contact_out->Position = rbReal(0.5) * (SupportPoint(p[1], best.normal) + SupportPoint(p[0], -best.normal, 1));
+        contact_out->PenetrationDepth = best.depth > 0 ? best.depth * rbReal(0.5) : best.depth;
+        break;
+    }
+}
+
+// [LANG en] Collect type-independent data (+Position+ must be given in world coordinates)
+// [LANG ja] 形状に依存しない情報の整理 (+Position+ はワールド座標であること)
+static inline void FinishContact( rbRigidBody* body0, rbRigidBody* body1, rbContact* contact_out )
+{
+    contact_out->RelativeBodyPosition[0] = contact_out->Position - body0->Position();
+    contact_out->RelativeBodyPosition[1] = contact_out->Position - body1->Position();
+    contact_out->Body[0] = body0;
+    contact_out->Body[1] = body1;
+}
+
+static inline void SwapContactBodies( rbContact& contact )
+{
+    std::swap( contact.Body[0], contact.Body[1] );
+    std::swap( contact.RelativeBodyPosition[0], contact.RelativeBodyPosition[1] );
+    contact.Normal *= -1;
+}
+
+// [LANG en] Keeps the deepest +capacity+ contacts in +contacts_out+
+// [LANG ja] 深い順に最大 +capacity+ 個の衝突点を +contacts_out+ に残す
+static inline void KeepDeepest( const rbContact& c, rbContact* contacts_out, rbs32 capacity, rbs32& count )
+{
+    if ( count < capacity )
+    {
+        contacts_out[count++] = c;
+        return;
+    }
+
+    rbs32 shallowest = 0;
+    for ( rbs32 i = 1; i < count; ++i )
+        if ( contacts_out[i].PenetrationDepth < contacts_out[shallowest].PenetrationDepth )
+            shallowest = i;
+
+    if ( c.PenetrationDepth > contacts_out[shallowest].PenetrationDepth )
+        contacts_out[shallowest] = c;
+}
+
+// [LANG en] Calls visitor(const ConvexProxy&) for each convex part of +body+ in world coordinates.
+// [LANG en] A compound yields the children whose bounds overlap the world-space box [lo, hi]; other shapes yield themselves.
+// [LANG en] The proxies are valid only during the call (they may refer to the local support cache of +proxy+).
+// [LANG ja] +body+ を構成する凸形状ごとに、ワールド座標のプロキシで visitor(const ConvexProxy&) を呼ぶ。
+// [LANG ja] 複合形状はワールド座標の箱 [lo, hi] と境界が重なる子を、それ以外の形状は自分自身を渡す。
+// [LANG ja] プロキシは呼び出しの間だけ有効 (+proxy+ の探索開始位置を参照することがある)。
+template <typename Visitor>
+static void ForEachConvexPart( rbRigidBody* body, bool update_support_cache, const rbVec3& lo, const rbVec3& hi, Visitor&& visitor )
+{
+    ConvexProxy proxy;
+    SetupConvexProxy( body, update_support_cache, proxy );
+
+    const rbCompound* compound = body->Compound();
+    if ( compound == nullptr )
+    {
+        visitor( proxy );
+        return;
+    }
+
+    const rbVec3 center = proxy.RT * (rbReal(0.5) * (lo + hi) - proxy.P);
+    const rbVec3 extent = BoundingHalfExtent( proxy.RT, rbReal(0.5) * (hi - lo) );
+    compound->Query( center - extent, center + extent,
+        [&](rbu32 child_index) {
+            const rbCompound::Child& child = compound->GetChild( child_index );
+            ConvexProxy part{};
+            part.kind = ConvexKind::Box;
+            part.hull = nullptr;
+            part.h = child.half_extent;
+            part.R = proxy.R * child.orientation;
+            part.RT = part.R.GetTransposed();
+            part.P = proxy.R * child.position + proxy.P;
+            part.support_cache = nullptr;
+            visitor( part );
+        } );
+}
+
+static rbs32 DetectConvexConvex( rbRigidBody* body0, rbRigidBody* body1, rbContact* contacts_out, rbs32 capacity, rbReal margin,
+                                 bool update_support_cache )
+{
+    const rbVec3 m( margin, margin, margin );
+    const rbAABB bounds1 = body1->ComputeWorldAABB();
+
+    rbs32 count = 0;
+    ForEachConvexPart( body0, update_support_cache, bounds1.lower - m, bounds1.upper + m,
+        [&](const ConvexProxy& part0) {
+            const rbVec3 extent0 = BoundingHalfExtent( part0.R, part0.h ) + m;
+            ForEachConvexPart( body1, update_support_cache, part0.P - extent0, part0.P + extent0,
+                [&](const ConvexProxy& part1) {
+                    const ConvexProxy p[2] = { part0, part1 };
+                    ConvexSATResult best;
+                    if ( CheckConvexSeparation(p, margin, best) )
+                        return;
+
+                    rbContact c;
+                    BuildConvexContact( p, best, &c );
+                    FinishContact( body0, body1, &c );
+                    KeepDeepest( c, contacts_out, capacity, count );
+                } );
+        } );
+
+    return count;
+}
+
+// [LANG en] Moves the convex proxy into the local frame of the static body (mesh or heightfield)
+// [LANG ja] 凸形状のプロキシを静的な剛体 (メッシュまたはハイトフィールド) のローカル座標系へ移す
+static inline void ToStaticLocal( rbRigidBody* static_body, ConvexProxy& proxy )
+{
+    const rbMtx3 static_RT = static_body->OrientationTranspose();
+    proxy.R = static_RT * proxy.R;
+    proxy.RT = proxy.R.GetTransposed();
+    proxy.P = static_RT * (proxy.P - static_body->Position());
+}
+
+// [LANG en] Convex proxy p[0] against triangle p[1], both in the local frame of +static_body+.
+// [LANG ja] 凸形状 p[0] と三角形 p[1] の判定 (どちらも +static_body+ のローカル座標系)。
+static void CollideConvexTriangle( ConvexProxy p[2], rbRigidBody* convex_body, rbRigidBody* static_body,
+                                   rbContact* contacts_out, rbs32 capacity, rbs32& count, rbReal margin )
+{
+    ConvexSATResult best;
+    if ( CheckConvexSeparation(p, margin, best) )
+        return;
+
+    // [LANG en] Triangles are one-sided : the SAT above only decides whether they overlap, and the body is
+    // [LANG en] always pushed out along the triangle normal. This avoids catching on internal edges.
+    // [LANG ja] 三角形は片面のみ有効 : 上の分離軸テストは交差の有無の判定のみに使い、剛体は常に三角形の法線方向へ
+    // [LANG ja] 押し出す。これにより隣接する三角形の境界の辺に引っかかるのを防ぐ。
+    best.normal = p[1].triangle_normal;
+    best.depth = best.normal * p[1].triangle[0] - best.normal * SupportPoint( p[0], -best.normal, 1 );
+    best.feature = ConvexFeature::Face1;
+    if ( best.depth + margin <= RIGIDBOX_TOLERANCE || best.normal.LengthSq() < RIGIDBOX_TOLERANCE )
+        return;
+
+    const rbMtx3 static_R = static_body->Orientation();
+    rbContact c;
+    BuildConvexContact( p, best, &c );
+    c.Normal = static_R * c.Normal;
+    c.Position = static_R * c.Position + static_body->Position();
+    FinishContact( convex_body, static_body, &c );
+    KeepDeepest( c, contacts_out, capacity, count );
+}
+
+// [LANG en] +part+ is a convex part of +convex_body+ in world coordinates.
+// [LANG ja] +part+ は +convex_body+ を構成する凸形状 (ワールド座標)。
+static void DetectConvexMesh( const ConvexProxy& part, rbRigidBody* convex_body, rbRigidBody* mesh_body,
+                              rbContact* contacts_out, rbs32 capacity, rbs32& count, rbReal margin )
+{
+    const rbTriangleMesh* mesh = mesh_body->TriangleMesh();
+
+    // [LANG en] Work in the mesh-local frame so that triangles can be used as stored.
+    // [LANG ja] 三角形をそのまま使えるように、メッシュのローカル座標系で計算する
+    ConvexProxy p[2];
+    p[0] = part;
+    ToStaticLocal( mesh_body, p[0] );
+
+    const rbVec3 extent = BoundingHalfExtent( p[0].R, p[0].h ) + rbVec3( margin, margin, margin );
+
+    mesh->Query( p[0].P - extent, p[0].P + extent,
+        [&](rbu32 triangle_index) {
+            rbVec3 triangle[3];
+            mesh->Triangle( triangle_index, triangle );
+            SetupTriangleProxy( triangle, p[1] );
+            CollideConvexTriangle( p, convex_body, mesh_body, contacts_out, capacity, count, margin );
+        } );
+}
+
+static void DetectConvexHeightField( const ConvexProxy& part, rbRigidBody* convex_body, rbRigidBody* field_body,
+                                     rbContact* contacts_out, rbs32 capacity, rbs32& count, rbReal margin )
+{
+    const rbHeightField* field = field_body->HeightField();
+
+    ConvexProxy p[2];
+    p[0] = part;
+    ToStaticLocal( field_body, p[0] );
+
+    // [LANG en] Only the cells under the footprint of the body's AABB are examined.
+    // [LANG ja] 剛体の AABB の真下にあるセルのみを調べる
+    const rbVec3 extent = BoundingHalfExtent( p[0].R, p[0].h ) + rbVec3( margin, margin, margin );
+
+    field->Query( p[0].P - extent, p[0].P + extent,
+        [&](const rbVec3 triangle[3]) {
+            SetupTriangleProxy( triangle, p[1] );
+            CollideConvexTriangle( p, convex_body, field_body, contacts_out, capacity, count, margin );
+        } );
+}
+
+static inline bool IsStaticShape( rbu32 type )
+{
+    return type == rbRigidBody::ShapeType_TriangleMesh || type == rbRigidBody::ShapeType_HeightField;
+}
+
+static rbs32 DetectWithMargin( rbRigidBody* body0, rbRigidBody* body1, rbContact* contacts_out, rbs32 contact_capacity, rbReal margin,
+                               bool update_support_cache )
+{
+    if ( contact_capacity <= 0 )
+        return 0;
+
+    const rbu32 type[2] = { body0->ShapeType(), body1->ShapeType() };
+
+    if ( margin <= 0 && type[0] == rbRigidBody::ShapeType_Box && type[1] == rbRigidBody::ShapeType_Box )
+        return DetectBoxBox( body0, body1, contacts_out );
+
+    const bool is_static[2] = { IsStaticShape(type[0]), IsStaticShape(type[1]) };
+    if ( is_static[0] || is_static[1] )
+    {
+        // [LANG en] Meshes and heightfields are static; no need to check between them
+        // [LANG ja] メッシュとハイトフィールドは静的なので、それら同士の判定は不要
+        if ( is_static[0] && is_static[1] )
+            return 0;
+
+        rbRigidBody* convex_body = is_static[1] ? body0 : body1;
+        rbRigidBody* static_body = is_static[1] ? body1 : body0;
+        const bool height_field = static_body->ShapeType() == rbRigidBody::ShapeType_HeightField;
+
+        const rbVec3 m( margin, margin, margin );
+        const rbAABB static_bounds = static_body->ComputeWorldAABB();
+
+        rbs32 count = 0;
+        ForEachConvexPart( convex_body, update_support_cache, static_bounds.lower - m, static_bounds.upper + m,
+            [&](const ConvexProxy& part) {
+                if ( height_field )
+                    DetectConvexHeightField( part, convex_body, static_body, contacts_out, contact_capacity, count, margin );
+                else
+                    DetectConvexMesh( part, convex_body, static_body, contacts_out, contact_capacity, count, margin );
+            } );
+
+        if ( is_static[0] )
+            for ( rbs32 i = 0; i < count; ++i )
+                SwapContactBodies( contacts_out[i] );
+        return count;
+    }
+
+    return DetectConvexConvex( body0, body1, contacts_out, contact_capacity, margin, update_support_cache );
+}
+
+rbs32 rbCollision::Detect( rbRigidBody* body0, rbRigidBody* body1, rbContact* contacts_out, rbs32 contact_capacity, bool update_support_cache )
+{
+    return DetectWithMargin( body0, body1, contacts_out, contact_capacity, 0, update_support_cache );
+}
+
+rbs32 rbCollision::DetectSpeculative( rbRigidBody* body0, rbRigidBody* body1, rbReal margin, rbContact* contacts_out, rbs32 contact_capacity )
+{
+    return DetectWithMargin( body0, body1, contacts_out, contact_capacity, margin, true );
+}
+
+bool rbCollision::Overlap( rbRigidBody* body0, rbRigidBody* body1 )
+{
+    bool overlap = false;
+    auto Test = [&overlap](const ConvexProxy p[2]) {
+        ConvexSATResult best;
+        if ( !CheckConvexSeparation(p, 0, best) )
+            overlap = true;
+    };
+
+    const bool is_static[2] = { IsStaticShape(body0->ShapeType()), IsStaticShape(body1->ShapeType()) };
+    if ( is_static[0] || is_static[1] )
+    {
+        if ( is_static[0] && is_static[1] )
+            return false;
+
+        rbRigidBody* convex_body = is_static[1] ? body0 : body1;
+        rbRigidBody* static_body = is_static[1] ? body1 : body0;
+        const rbAABB static_bounds = static_body->ComputeWorldAABB();
+
+        ForEachConvexPart( convex_body, true, static_bounds.lower, static_bounds.upper,
+            [&](const ConvexProxy& part) {
+                if ( overlap )
+                    return;
+
+                ConvexProxy p[2];
+                p[0] = part;
+                ToStaticLocal( static_body, p[0] );
+                const rbVec3 extent = BoundingHalfExtent( p[0].R, p[0].h );
+
+                auto Triangle = [&](const rbVec3 triangle[3]) {
+                    if ( overlap )
+                        return;
+                    SetupTriangleProxy( triangle, p[1] );
+                    Test( p );
+                };
+
+                if ( static_body->ShapeType() == rbRigidBody::ShapeType_HeightField )
+                {
+                    static_body->HeightField()->Query( p[0].P - extent, p[0].P + extent, Triangle );
+                }
+                else
+                {
+                    const rbTriangleMesh* mesh = static_body->TriangleMesh();
+                    mesh->Query( p[0].P - extent, p[0].P + extent,
+                        [&](rbu32 triangle_index) {
+                            rbVec3 triangle[3];
+                            mesh->Triangle( triangle_index, triangle );
+                            Triangle( triangle );
+                        } );
+                }
+            } );
+        return overlap;
+    }
+
+    const rbAABB bounds1 = body1->ComputeWorldAABB();
+    ForEachConvexPart( body0, true, bounds1.lower, bounds1.upper,
+        [&](const ConvexProxy& part0) {
+            if ( overlap )
+                return;
+
+            const rbVec3 extent0 = BoundingHalfExtent( part0.R, part0.h );
+            ForEachConvexPart( body1, true, part0.P - extent0, part0.P + extent0,
+                [&](const ConvexProxy& part1) {
+                    if ( overlap )
+                        return;
+
+                    const ConvexProxy p[2] = { part0, part1 };
+                    Test( p );
+                } );
+        } );
+
+    return overlap;
+}
+
+rbs32 rbCollision::Detect(rbRigidBody* box0, rbRigidBody* box1, std::vector<rbContact>& contacts_out)
+{
+    if ( box0->ShapeType() != rbRigidBody::ShapeType_Box || box1->ShapeType() != rbRigidBody::ShapeType_Box )
+    {
+        rbContact c[MaxContactsPerPair];
+        rbs32 count = Detect( box0, box1, c, MaxContactsPerPair );
+        contacts_out.insert( contacts_out.end(), c, c + count );
+        return static_cast<rbs32>(contacts_out.size());
+    }
+
+    rbVec3 h[2] = { box0->HalfExtent(), box1->HalfExtent() };
+    rbMtx3 R[2] = { box0->Orientation(), box1->Orientation() };
+    rbMtx3 RT[2] = { box0->OrientationTranspose(), box1->OrientationTranspose() };
+    rbVec3 P[2] = { box0->Position(), box1->Position() };
+
+    SATContext ctx = {
+        SeparatingAxis::Unknown,
+        { h[0], h[1] },
+        { RT[0], RT[1] },
+        P[1] - P[0]
+    };
+
+    SATEvalStatus status;
+    status.Clear();
+
+    //
+    // [LANG en] Separating-Axis Test
+    // [LANG ja] 分離軸テスト
+    //
+
+    if (CheckSeparationStatus(ctx, R, status)) {
+        return 0;
+    }
+
+    //
+    // [LANG en] No gap is found along any separating axes -> boxes are intersecting
+    // [LANG ja] どの軸上でも隙間が確認できない⇒交差している
+    //
+#if 1
+    std::stable_sort(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
+        [](auto const& lhs, auto const& rhs) {
+            return lhs.depth < rhs.depth;
+        }
+    );
+
+    int best_count = std::count_if(status.penetration, status.penetration + static_cast<int>(SeparatingAxis::Count),
+        [&](auto& pen) {
+            return pen.depth == status.penetration[0].depth;
+        }
+    );
+#endif
+    rbContact contact_out;
+    for (int i = 0; i < best_count; ++i) {
+        //BuildContact(status.best_axis_id, box0, box1, ctx, status.penetration[static_cast<int>(status.best_axis_id)], &contact_out);
+        BuildContact(status.penetration[i].axis_id, box0, box1, ctx, status.penetration[i], &contact_out);
+        contacts_out.emplace_back(contact_out);
+    }
+
+    return static_cast<rbs32>(contacts_out.size());
+}
+
+
+//
+// [LANG en] Time of impact by conservative advancement
+// [LANG ja] 保守的前進法による衝突時刻の計算
+//
+
+// [LANG en] Largest gap between the projections over all SAT axes : a lower bound of the distance between the proxies
+// [LANG en] (positive when separated), or minus the penetration depth when they overlap.
+// [LANG ja] 全ての分離軸における射影の隙間の最大値 : 離れている場合はプロキシ間の距離の下限 (正の値)、
+// [LANG ja] 重なっている場合は貫通深さの符号を反転した値。
+static rbReal ConvexGap( const ConvexProxy p[2] )
+{
+    rbReal gap = -RIGIDBOX_REAL_MAX;
+
+    auto Test = [&p, &gap](rbVec3 axis) {
+        rbReal length_sq = axis.LengthSq();
+        if ( length_sq < RIGIDBOX_TOLERANCE )
+            return;
+        axis /= rbSqrt( length_sq );
+
+        rbReal max0 = axis * SupportPoint( p[0],  axis );
+        rbReal min0 = axis * SupportPoint( p[0], -axis, 1 );
+        rbReal max1 = axis * SupportPoint( p[1],  axis );
+        rbReal min1 = axis * SupportPoint( p[1], -axis, 1 );
+        gap = rbMax( gap, rbMax(min1 - max0, min0 - max1) );
+    };
+
+    for ( rbu32 i = 0, n = FaceAxisCount(p[0]); i < n; ++i )
+        Test( FaceAxis(p[0], i) );
+    for ( rbu32 i = 0, n = FaceAxisCount(p[1]); i < n; ++i )
+        Test( FaceAxis(p[1], i) );
+    for ( rbu32 i = 0, n0 = EdgeAxisCount(p[0]); i < n0; ++i )
+        for ( rbu32 j = 0, n1 = EdgeAxisCount(p[1]); j < n1; ++j )
+            Test( EdgeAxis(p[0], i) % EdgeAxis(p[1], j) );
+
+    return gap;
+}
+
+// [LANG en] Smallest ConvexGap over the convex parts of the two bodies lying in the world-space box +region+.
+// [LANG en] Parts outside +region+ cannot be reached during the sweep, so they are ignored.
+// [LANG ja] ワールド座標の箱 +region+ 内にある両剛体の凸形状の組について、ConvexGap の最小値を求める。
+// [LANG ja] +region+ の外にある形状には掃引中に到達しないため無視する。
+static rbReal SeparationLowerBound( rbRigidBody* body0, rbRigidBody* body1, const rbAABB& region, bool update_support_cache )
+{
+    rbReal gap = RIGIDBOX_REAL_MAX;
+
+    const bool is_static[2] = { IsStaticShape(body0->ShapeType()), IsStaticShape(body1->ShapeType()) };
+    if ( is_static[0] || is_static[1] )
+    {
+        rbRigidBody* convex_body = is_static[1] ? body0 : body1;
+        rbRigidBody* static_body = is_static[1] ? body1 : body0;
+
+        const rbMtx3 static_RT = static_body->OrientationTranspose();
+        const rbVec3 center = static_RT * (rbReal(0.5) * (region.lower + region.upper) - static_body->Position());
+        const rbVec3 extent = BoundingHalfExtent( static_RT, rbReal(0.5) * (region.upper - region.lower) );
+
+        ForEachConvexPart( convex_body, update_support_cache, region.lower, region.upper,
+            [&](const ConvexProxy& part) {
+                ConvexProxy p[2];
+                p[0] = part;
+                ToStaticLocal( static_body, p[0] );
+
+                auto Visit = [&](const rbVec3 triangle[3]) {
+                    SetupTriangleProxy( triangle, p[1] );
+                    gap = rbMin( gap, ConvexGap(p) );
+                };
+
+                if ( const rbHeightField* field = static_body->HeightField() )
+                {
+                    field->Query( center - extent, center + extent, Visit );
+                }
+                else
+                {
+                    const rbTriangleMesh* mesh = static_body->TriangleMesh();
+                    mesh->Query( center - extent, center + extent,
+                        [&](rbu32 triangle_index) {
+                            rbVec3 triangle[3];
+                            mesh->Triangle( triangle_index, triangle );
+                            Visit( triangle );
+                        } );
+                }
+            } );
+
+        return gap;
+    }
+
+    ForEachConvexPart( body0, update_support_cache, region.lower, region.upper,
+        [&](const ConvexProxy& part0) {
+            ForEachConvexPart( body1, update_support_cache, region.lower, region.upper,
+                [&](const ConvexProxy& part1) {
+                    const ConvexProxy p[2] = { part0, part1 };
+                    gap = rbMin( gap, ConvexGap(p) );
+                } );
+        } );
+
+    return gap;
+}
+
+// [LANG en] Conservative advancement of the pair moving with the given velocities (see rbCollision::TimeOfImpact)
+// [LANG ja] 与えられた速度で動く2物体の保守的前進法 (rbCollision::TimeOfImpact を参照)
+// [LANG en] body1 is posed along its motion only if +move_body1+ : a motionless target (see rbCollision::ShapeCast) is left untouched
+// [LANG ja] body1 は +move_body1+ の場合のみ動かす : 動かない対象 (rbCollision::ShapeCast を参照) には一切触れない
+static bool ConservativeAdvancement( rbRigidBody* body0, rbRigidBody* body1, const rbVec3 v[2], const rbVec3 w[2],
+                                     rbReal dt, rbReal target_depth, bool update_support_cache, bool move_body1, rbReal& toi_out )
+{
+    rbRigidBody* body[2] = { body0, body1 };
+    const rbs32 moving_count = move_body1 ? 2 : 1;
+    rbVec3 P[2];
+    rbMtx3 R[2];
+    rbAABB region;
+    rbReal radius_speed = 0;
+
+    for ( rbs32 i = 0; i < 2; ++i )
+    {
+        P[i] = body[i]->Position();
+        R[i] = body[i]->Orientation();
+
+        // [LANG en] No point of the body moves faster than |v| + |w| * r, where r bounds the shape
+        // [LANG ja] 剛体上のどの点も |v| + |w| * r (r は形状を包む半径) より速くは動かない
+        radius_speed += w[i].Length() * body[i]->HalfExtent().Length();
+
+        rbAABB bounds = body[i]->ComputeWorldAABB();
+        bounds.Merge( bounds.Translated(dt * v[i]) );
+        if ( i == 0 )
+            region = bounds;
+        else
+            region.Merge( bounds );
+    }
+
+    // [LANG en] Rotation may sweep the shape outside the translated bounds
+    // [LANG ja] 回転によって形状が並進した AABB の外へ出る場合に備える
+    const rbReal margin = radius_speed * dt;
+    region.lower -= rbVec3( margin, margin, margin );
+    region.upper += rbVec3( margin, margin, margin );
+
+    const rbReal closing_speed = (v[0] - v[1]).Length() + radius_speed;
+    bool hit = false;
+
+    if ( closing_speed > RIGIDBOX_TOLERANCE )
+    {
+        rbReal t = 0;
+        rbReal target_gap = rbReal(-0.25) * target_depth;
+        for ( rbs32 iteration = 0; iteration < rbCollision::MaxTOIIterations; ++iteration )
+        {
+            // [LANG en] Same pose as rbRigidBody::UpdatePosition( t ) would produce
+            // [LANG ja] rbRigidBody::UpdatePosition( t ) と同じ姿勢へ移動
+            for ( rbs32 i = 0; i < moving_count; ++i )
+            {
+                rbMtx3 rot;
+                rot.SetAsCrossProductMatrix( w[i] );
+                rbMtx3 orientation = R[i] + t * rot * R[i];
+                orientation.Orthonormalize();
+                body[i]->SetPosition( P[i] + t * v[i] );
+                body[i]->SetOrientation( orientation );
+            }
+
+            rbReal gap = SeparationLowerBound( body0, body1, region, update_support_cache );
+
+            // [LANG en] Stop slightly inside, so that rbCollision::Detect reports a contact at this pose.
+            // [LANG en] Bodies already overlapping at t == 0 are stopped once they sink a further target_depth / 4.
+            // [LANG ja] rbCollision::Detect が衝突点を報告できるよう、わずかにめり込んだ位置で止める。
+            // [LANG ja] t == 0 ですでに重なっている場合は、さらに target_depth / 4 めり込んだ位置で止める。
+            if ( iteration == 0 )
+                target_gap = rbMin( target_gap, gap - rbReal(0.25) * target_depth );
+
+            if ( gap <= target_gap )
+            {
+                toi_out = t;
+                hit = true;
+                break;
+            }
+
+            // [LANG en] The bodies approach by at most closing_speed * step, so the gap never falls below target_gap - target_depth / 4
+            // [LANG ja] 接近量は最大でも closing_speed * step なので、隙間が target_gap - target_depth / 4 を下回ることはない
+            t += (gap - target_gap + rbReal(0.25) * target_depth) / closing_speed;
+            if ( t > dt )
+                break;
+        }
+    }
+
+    for ( rbs32 i = 0; i < moving_count; ++i )
+    {
+        body[i]->SetPosition( P[i] );
+        body[i]->SetOrientation( R[i] );
+    }
+
+    return hit;
+}
+
+bool rbCollision::TimeOfImpact( rbRigidBody* body0, rbRigidBody* body1, rbReal dt, rbReal target_depth, rbReal& toi_out )
+{
+    rbRigidBody* body[2] = { body0, body1 };
+    rbVec3 v[2], w[2];
+    for ( rbs32 i = 0; i < 2; ++i )
+    {
+        v[i] = body[i]->IsFixed() ? rbVec3( 0, 0, 0 ) : body[i]->LinearVelocity();
+        w[i] = body[i]->IsFixed() ? rbVec3( 0, 0, 0 ) : body[i]->AngularVelocity();
+    }
+
+    return ConservativeAdvancement( body0, body1, v, w, dt, target_depth, true, true, toi_out );
+}
+
+bool rbCollision::ShapeCast( rbRigidBody* body, const rbVec3& displacement, rbRigidBody* target, rbReal target_depth, rbReal& fraction_out,
+                             bool update_support_cache )
+{
+    const rbVec3 v[2] = { displacement, rbVec3( 0, 0, 0 ) };
+    const rbVec3 w[2] = { rbVec3( 0, 0, 0 ), rbVec3( 0, 0, 0 ) };
+
+    return ConservativeAdvancement( body, target, v, w, rbReal(1), target_depth, update_support_cache, false, fraction_out );
+}
+
+//
+// Ray casting
+//
+
+// [LANG en] Slab test of the ray o + t * d against the box [-h, h]. Returns the entering t and the normal of the entered face.
+// [LANG ja] レイ o + t * d と直方体 [-h, h] のスラブ判定。進入時の t と、進入した面の法線を返す。
+static bool RayBox( const rbVec3& o, const rbVec3& d, const rbVec3& h, rbReal max_fraction, rbReal& t_out, rbVec3& normal_out )
+{
+    rbReal t_enter = -RIGIDBOX_REAL_MAX;
+    rbReal t_exit = RIGIDBOX_REAL_MAX;
+    rbs32 enter_axis = -1;
+    rbReal enter_sign = 0;
+
+    for ( rbs32 i = 0; i < 3; ++i )
+    {
+        if ( rbFabs(d.e[i]) < RIGIDBOX_TOLERANCE )
+        {
+            if ( rbFabs(o.e[i]) > h.e[i] )
+                return false;
+            continue;
+        }
+
+        const rbReal inv_d = rbReal(1) / d.e[i];
+        rbReal t0 = (-h.e[i] - o.e[i]) * inv_d;
+        rbReal t1 = ( h.e[i] - o.e[i]) * inv_d;
+        rbReal sign = rbReal(-1);
+        if ( t0 > t1 )
+        {
+            std::swap( t0, t1 );
+            sign = rbReal(1);
+        }
+
+        if ( t0 > t_enter )
+        {
+            t_enter = t0;
+            enter_axis = i;
+            enter_sign = sign;
+        }
+        t_exit = rbMin( t_exit, t1 );
+        if ( t_enter > t_exit )
+            return false;
+    }
+
+    // [LANG en] Starting inside, or the box lies behind / beyond the segment
+    // [LANG ja] 内部から開始している、または線分の後方/先にある
+    if ( enter_axis < 0 || t_enter < 0 || t_enter > max_fraction )
+        return false;
+
+    t_out = t_enter;
+    normal_out.SetZero();
+    normal_out.e[enter_axis] = enter_sign;
+    return true;
+}
+
+// [LANG en] The hull is the intersection of the half-spaces n.x <= support(n) over its face normals (both orientations,
+// [LANG en] as parallel duplicates were removed); clip the ray against each of them.
+// [LANG ja] 凸包は面法線 (平行な重複は除去済みなので両向き) の半空間 n.x <= support(n) の共通部分なので、
+// [LANG ja] レイをそれぞれの半空間で切り取る。
+static bool RayHull( const rbConvexHull* hull, const rbVec3& o, const rbVec3& d, rbReal max_fraction, rbReal& t_out, rbVec3& normal_out )
+{
+    rbReal t_enter = -RIGIDBOX_REAL_MAX;
+    rbReal t_exit = RIGIDBOX_REAL_MAX;
+    rbVec3 enter_normal( 0, 0, 0 );
+    rbu32 support_index = 0;
+
+    for ( rbu32 f = 0; f < hull->FaceCount(); ++f )
+    {
+        for ( rbs32 side = 0; side < 2; ++side )
+        {
+            const rbVec3 n = side == 0 ? hull->FaceNormal( f ) : -hull->FaceNormal( f );
+            const rbReal offset = n * hull->Support( n, support_index );
+            const rbReal distance = n * o - offset;
+            const rbReal denominator = n * d;
+
+            if ( rbFabs(denominator) < RIGIDBOX_TOLERANCE )
+            {
+                if ( distance > 0 )
+                    return false;
+                continue;
+            }
+
+            const rbReal t = -distance / denominator;
+            if ( denominator < 0 )
+            {
+                if ( t > t_enter )
+                {
+                    t_enter = t;
+                    enter_normal = n;
+                }
+            }
+            else
+            {
+                t_exit = rbMin( t_exit, t );
+            }
+
+            if ( t_enter > t_exit )
+                return false;
+        }
+    }
+
+    if ( t_enter < 0 || t_enter > max_fraction )
+        return false;
+
+    t_out = t_enter;
+    normal_out = enter_normal;
+    return true;
+}
+
+// [LANG en] Moller-Trumbore, both sides. The normal is flipped to face the ray.
+// [LANG ja] Moller-Trumbore 法 (両面)。法線はレイに向かう向きに反転する。
+static bool RayTriangle( const rbVec3 v[3], const rbVec3& o, const rbVec3& d, rbReal max_fraction, rbReal& t_out, rbVec3& normal_out )
+{
+    const rbVec3 e1 = v[1] - v[0];
+    const rbVec3 e2 = v[2] - v[0];
+    const rbVec3 p = d % e2;
+    const rbReal determinant = e1 * p;
+    if ( rbFabs(determinant) < RIGIDBOX_TOLERANCE )
+        return false;
+
+    const rbReal inv_determinant = rbReal(1) / determinant;
+    const rbVec3 s = o - v[0];
+    const rbReal u = (s * p) * inv_determinant;
+    if ( u < 0 || u > 1 )
+        return false;
+
+    const rbVec3 q = s % e1;
+    const rbReal w = (d * q) * inv_determinant;
+    if ( w < 0 || u + w > 1 )
+        return false;
+
+    const rbReal t = (e2 * q) * inv_determinant;
+    if ( t < 0 || t > max_fraction )
+        return false;
+
+    rbVec3 normal = e1 % e2;
+    if ( normal * d > 0 )
+        normal = -normal;
+
+    t_out = t;
+    normal_out = normal;
+    normal_out.Normalize();
+    return true;
+}
+
+bool rbCollision::RayCast( rbRigidBody* body, const rbRay& ray, rbReal max_fraction, rbRayHit& hit_out )
+{
+    // [LANG en] Everything below runs in the local frame of the body
+    // [LANG ja] 以下は全て剛体のローカル座標系で行う
+    const rbMtx3 RT = body->OrientationTranspose();
+    const rbVec3 o = RT * (ray.Origin - body->Position());
+    const rbVec3 d = RT * ray.Direction;
+
+    // [LANG en] Bounds of the segment, for the BVH/cell queries
+    // [LANG ja] BVH/セルの問い合わせに使う線分の境界
+    const rbVec3 end = o + max_fraction * d;
+    const rbVec3 segment_min( rbMin(o.x, end.x), rbMin(o.y, end.y), rbMin(o.z, end.z) );
+    const rbVec3 segment_max( rbMax(o.x, end.x), rbMax(o.y, end.y), rbMax(o.z, end.z) );
+
+    rbReal best = max_fraction;
+    rbVec3 normal;
+    bool hit = false;
+
+    auto Triangle = [&](const rbVec3 v[3]) {
+        rbReal t;
+        rbVec3 n;
+        if ( RayTriangle(v, o, d, best, t, n) )
+        {
+            best = t;
+            normal = n;
+            hit = true;
+        }
+    };
+
+    switch ( body->ShapeType() )
+    {
+    case rbRigidBody::ShapeType_Box:
+        hit = RayBox( o, d, body->HalfExtent(), best, best, normal );
+        break;
+
+    case rbRigidBody::ShapeType_ConvexHull:
+        hit = RayHull( body->ConvexHull(), o, d, best, best, normal );
+        break;
+
+    case rbRigidBody::ShapeType_TriangleMesh:
+        {
+            const rbTriangleMesh* mesh = body->TriangleMesh();
+            mesh->Query( segment_min, segment_max,
+                [&](rbu32 triangle_index) {
+                    rbVec3 triangle[3];
+                    mesh->Triangle( triangle_index, triangle );
+                    Triangle( triangle );
+                } );
+        }
+        break;
+
+    case rbRigidBody::ShapeType_HeightField:
+        body->HeightField()->Query( segment_min, segment_max, Triangle );
+        break;
+
+    case rbRigidBody::ShapeType_Compound:
+        {
+            const rbCompound* compound = body->Compound();
+            compound->Query( segment_min, segment_max,
+                [&](rbu32 child_index) {
+                    const rbCompound::Child& child = compound->GetChild( child_index );
+                    const rbMtx3 child_RT = child.orientation.GetTransposed();
+                    rbReal t;
+                    rbVec3 n;
+                    if ( RayBox(child_RT * (o - child.position), child_RT * d, child.half_extent, best, t, n) )
+                    {
+                        best = t;
+                        normal = child.orientation * n;
+                        hit = true;
+                    }
+                } );
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if ( !hit )
+        return false;
+
+    hit_out.Body = body;
+    hit_out.Fraction = best;
+    hit_out.Position = ray.Origin + best * ray.Direction;
+    hit_out.Normal = body->Orientation() * normal;
+    return true;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,166 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbCompound.h>
+
+#include <algorithm>
+
+rbCompound::rbCompound()
+    : children()
+    , nodes()
+    , child_bounds()
+    , mass(0)
+    , center_of_mass(0, 0, 0)
+    , half_extent(0, 0, 0)
+    , inertia(0, 0, 0,
+              0, 0, 0,
+              0, 0, 0)
+{}
+
+void rbCompound::Clear()
+{
+    children.clear();
+    nodes.clear();
+    child_bounds.clear();
+    mass = 0;
+    center_of_mass.SetZero();
+    half_extent.SetZero();
+    inertia.SetZero();
+}
+
+bool rbCompound::Build( const Child* children_in, rbu32 child_count )
+{
+    Clear();
+
+    if ( children_in == nullptr || child_count == 0 )
+        return false;
+
+    for ( rbu32 i = 0; i < child_count; ++i )
+    {
+        const Child& c = children_in[i];
+        if ( c.mass <= 0 || c.half_extent.x <= 0 || c.half_extent.y <= 0 || c.half_extent.z <= 0 )
+            return false;
+    }
+
+    children.assign( children_in, children_in + child_count );
+
+    for ( const Child& c : children )
+    {
+        mass += c.mass;
+        center_of_mass += c.position * c.mass;
+    }
+    center_of_mass /= mass;
+
+    for ( Child& c : children )
+    {
+        c.position -= center_of_mass;
+
+        // [LANG en] Inertia of the child box, rotated into the compound frame and moved by the parallel axis theorem :
+        // [LANG en] I += R * I_box * R^T + m * ((d.d) * E - d d^T)
+        // [LANG ja] 子の直方体の慣性テンソルを複合形状の座標系へ回転させ、平行軸の定理で移動 :
+        // [LANG ja] I += R * I_box * R^T + m * ((d.d) * E - d d^T)
+        const rbVec3& h = c.half_extent;
+        rbMtx3 local(c.mass * (h.y * h.y + h.z * h.z) / rbReal(3), 0, 0,
+                     0, c.mass * (h.x * h.x + h.z * h.z) / rbReal(3), 0,
+                     0, 0, c.mass * (h.x * h.x + h.y * h.y) / rbReal(3));
+        inertia += c.orientation * local * c.orientation.GetTransposed();
+
+        const rbVec3& d = c.position;
+        const rbReal dd = d * d;
+        inertia += rbMtx3(dd - d.x * d.x,    - d.x * d.y,    - d.x * d.z,
+                             - d.y * d.x, dd - d.y * d.y,    - d.y * d.z,
+                             - d.z * d.x,    - d.z * d.y, dd - d.z * d.z) * c.mass;
+    }
+
+    child_bounds.resize( child_count );
+    for ( rbu32 i = 0; i < child_count; ++i )
+    {
+        const Child& c = children[i];
+        const rbMtx3& R = c.orientation;
+        const rbVec3& h = c.half_extent;
+        child_bounds[i].Set( rbFabs(R.Elem(0,0)) * h.x + rbFabs(R.Elem(0,1)) * h.y + rbFabs(R.Elem(0,2)) * h.z,
+                             rbFabs(R.Elem(1,0)) * h.x + rbFabs(R.Elem(1,1)) * h.y + rbFabs(R.Elem(1,2)) * h.z,
+                             rbFabs(R.Elem(2,0)) * h.x + rbFabs(R.Elem(2,1)) * h.y + rbFabs(R.Elem(2,2)) * h.z );
+
+        for ( rbs32 k = 0; k < 3; ++k )
+            half_extent.e[k] = rbMax( half_extent.e[k], rbFabs(c.position.e[k]) + child_bounds[i].e[k] );
+    }
+
+    std::vector<rbu32> order( child_count );
+    for ( rbu32 i = 0; i < child_count; ++i )
+        order[i] = i;
+
+    nodes.reserve( 2 * child_count - 1 );
+    BuildNode( order, 0, child_count );
+
+    return true;
+}
+
+rbs32 rbCompound::BuildNode( std::vector<rbu32>& order, rbu32 begin, rbu32 end )
+{
+    const rbs32 node_index = static_cast<rbs32>(nodes.size());
+    nodes.emplace_back();
+
+    rbVec3 lo( RIGIDBOX_REAL_MAX, RIGIDBOX_REAL_MAX, RIGIDBOX_REAL_MAX );
+    rbVec3 hi = -lo;
+    rbVec3 center_lo = lo, center_hi = hi;
+    for ( rbu32 k = begin; k < end; ++k )
+    {
+        const rbVec3& p = children[order[k]].position;
+        const rbVec3& b = child_bounds[order[k]];
+        for ( rbs32 i = 0; i < 3; ++i )
+        {
+            lo.e[i] = rbMin( lo.e[i], p.e[i] - b.e[i] );
+            hi.e[i] = rbMax( hi.e[i], p.e[i] + b.e[i] );
+            center_lo.e[i] = rbMin( center_lo.e[i], p.e[i] );
+            center_hi.e[i] = rbMax( center_hi.e[i], p.e[i] );
+        }
+    }
+    nodes[node_index].aabb_min = lo;
+    nodes[node_index].aabb_max = hi;
+
+    if ( end - begin == 1 )
+    {
+        nodes[node_index].escape_index_or_child_index = static_cast<rbs32>(order[begin]);
+        return node_index;
+    }
+
+    // [LANG en] Median split along the longest axis of the child centers
+    // [LANG ja] 子の中心位置の AABB の最長軸に沿って中央値で分割
+    rbVec3 extent = center_hi - center_lo;
+    rbs32 axis = 0;
+    if ( extent.y > extent.e[axis] ) axis = 1;
+    if ( extent.z > extent.e[axis] ) axis = 2;
+
+    const rbu32 middle = begin + (end - begin) / 2;
+    std::nth_element( order.begin() + begin, order.begin() + middle, order.begin() + end,
+        [this, axis](rbu32 a, rbu32 b) {
+            return children[a].position.e[axis] < children[b].position.e[axis];
+        } );
+
+    BuildNode( order, begin, middle );
+    BuildNode( order, middle, end );
+
+    nodes[node_index].escape_index_or_child_index = -static_cast<rbs32>(nodes.size() - node_index);
+    return node_index;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,69 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbContactEvent.h>
+
+rbContactEventQueue::rbContactEventQueue()
+    : events()
+    , read_count(0)
+    , write_count(0)
+    , overflow_count(0)
+{}
+
+void rbContactEventQueue::Reserve( rbu32 capacity )
+{
+    rbu32 rounded = 0;
+    if ( capacity > 0 )
+    {
+        rounded = 1;
+        while ( rounded < capacity )
+            rounded <<= 1;
+    }
+
+    events.resize( rounded );
+    read_count = write_count = overflow_count = 0;
+}
+
+bool rbContactEventQueue::Push( const rbContactEvent& event )
+{
+    const rbu32 capacity = Capacity();
+    if ( write_count - read_count >= capacity )
+    {
+        ++overflow_count;
+        return false;
+    }
+
+    events[write_count & (capacity - 1)] = event;
+    ++write_count;
+    return true;
+}
+
+rbu32 rbContactEventQueue::Drain( rbContactEvent* events_out, rbu32 max_count )
+{
+    const rbu32 capacity = Capacity();
+    rbu32 count = 0;
+    for ( ; count < max_count && read_count != write_count; ++count, ++read_count )
+        events_out[count] = events[read_count & (capacity - 1)];
+
+    return count;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,383 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbConvexHull.h>
+
+#include <algorithm>
+
+namespace
+{
+    struct HullFace
+    {
+        rbu32 v[3];
+        rbVec3 normal;
+        rbReal offset;
+        bool alive;
+    };
+
+    struct DirectedEdge
+    {
+        rbu64 key;
+        rbu32 face;
+
+        bool operator <( const DirectedEdge& other ) const
+            { return key < other.key; }
+    };
+
+    inline rbu64 EdgeKey( rbu32 from, rbu32 to )
+    {
+        return (static_cast<rbu64>(from) << 32) | static_cast<rbu64>(to);
+    }
+
+    bool MakeFace( const std::vector<rbVec3>& p, rbu32 a, rbu32 b, rbu32 c, const rbVec3& interior, HullFace& face_out )
+    {
+        rbVec3 n = (p[b] - p[a]) % (p[c] - p[a]);
+        rbReal len = n.Length();
+        if ( len <= RIGIDBOX_TOLERANCE )
+            return false;
+        n /= len;
+
+        // [LANG en] Keep faces counter-clockwise when seen from outside.
+        // [LANG ja] 外側から見て反時計回りになるように向きを揃える
+        if ( n * (interior - p[a]) > 0 )
+        {
+            std::swap( b, c );
+            n = -n;
+        }
+
+        face_out.v[0] = a;  face_out.v[1] = b;  face_out.v[2] = c;
+        face_out.normal = n;
+        face_out.offset = n * p[a];
+        face_out.alive = true;
+        return true;
+    }
+
+    // [LANG en] Adds u * v^T (scaled) to +m+.
+    // [LANG ja] +m+ に u * v^T (スケール付き) を加算
+    inline void AddOuterProduct( rbMtx3& m, const rbVec3& u, const rbVec3& v, rbReal scale )
+    {
+        for ( rbs32 row = 0; row < 3; ++row )
+            for ( rbs32 col = 0; col < 3; ++col )
+                m.Elem(row, col) += scale * u.e[row] * v.e[col];
+    }
+
+    inline bool Parallel( const rbVec3& u, const rbVec3& v )
+    {
+        return rbFabs(u * v) > rbReal(1) - rbReal(1e-4);
+    }
+}
+
+rbConvexHull::rbConvexHull()
+    : vertices()
+    , adjacency_offset()
+    , adjacency()
+    , face_normals()
+    , edge_directions()
+    , center_of_mass(0, 0, 0)
+    , half_extent(0, 0, 0)
+    , volume(0)
+    , unit_inertia(0, 0, 0,
+                   0, 0, 0,
+                   0, 0, 0)
+{}
+
+void rbConvexHull::Clear()
+{
+    vertices.clear();
+    adjacency_offset.clear();
+    adjacency.clear();
+    face_normals.clear();
+    edge_directions.clear();
+    center_of_mass.SetZero();
+    half_extent.SetZero();
+    volume = 0;
+    unit_inertia.SetZero();
+}
+
+bool rbConvexHull::Build( const rbVec3* points, rbu32 point_count )
+{
+    Clear();
+
+    if ( points == nullptr || point_count < 4 )
+        return false;
+
+    std::vector<rbVec3> p( points, points + point_count );
+
+    rbVec3 lo = p[0], hi = p[0];
+    for ( const rbVec3& v : p )
+    {
+        for ( rbs32 i = 0; i < 3; ++i )
+        {
+            lo.e[i] = rbMin( lo.e[i], v.e[i] );
+            hi.e[i] = rbMax( hi.e[i], v.e[i] );
+        }
+    }
+    const rbReal eps = rbMax( (hi - lo).Length() * rbReal(1e-5), RIGIDBOX_TOLERANCE );
+
+    //
+    // [LANG en] Initial tetrahedron
+    // [LANG ja] 初期四面体の選択
+    //
+    rbu32 i0 = 0, i1 = 0, i2 = 0, i3 = 0;
+    rbReal best = 0;
+    for ( rbu32 i = 0; i < point_count; ++i )
+    {
+        rbReal d = (p[i] - p[i0]).LengthSq();
+        if ( d > best ) { best = d; i1 = i; }
+    }
+    if ( best <= eps * eps )
+        return false;
+
+    best = 0;
+    for ( rbu32 i = 0; i < point_count; ++i )
+    {
+        rbReal d = ((p[i1] - p[i0]) % (p[i] - p[i0])).LengthSq();
+        if ( d > best ) { best = d; i2 = i; }
+    }
+    if ( best <= eps * eps )
+        return false;
+
+    rbVec3 n012 = ((p[i1] - p[i0]) % (p[i2] - p[i0])).Normalize();
+    best = 0;
+    for ( rbu32 i = 0; i < point_count; ++i )
+    {
+        rbReal d = rbFabs( n012 * (p[i] - p[i0]) );
+        if ( d > best ) { best = d; i3 = i; }
+    }
+    if ( best <= eps )
+        return false;
+
+    const rbVec3 interior = rbReal(0.25) * (p[i0] + p[i1] + p[i2] + p[i3]);
+
+    std::vector<HullFace> faces;
+    {
+        const rbu32 tetra[4][3] = { { i0, i1, i2 }, { i0, i1, i3 }, { i0, i2, i3 }, { i1, i2, i3 } };
+        for ( const auto& t : tetra )
+        {
+            HullFace f;
+            MakeFace( p, t[0], t[1], t[2], interior, f );
+            faces.push_back( f );
+        }
+    }
+
+    //
+    // [LANG en] Incremental construction : every point outside the current hull replaces the faces it can see.
+    // [LANG ja] 逐次構築 : 現在の凸包の外側にある点ごとに、その点から見える面を置き換えていく
+    //
+    std::vector<rbu32> visible;
+    std::vector<DirectedEdge> visible_edges;
+    std::vector<std::pair<rbu32, rbu32>> horizon;
+    for ( rbu32 i = 0; i < point_count; ++i )
+    {
+        if ( i == i0 || i == i1 || i == i2 || i == i3 )
+            continue;
+
+        visible.clear();
+        for ( rbu32 f = 0; f < faces.size(); ++f )
+        {
+            if ( faces[f].alive && faces[f].normal * p[i] - faces[f].offset > eps )
+                visible.push_back( f );
+        }
+        if ( visible.empty() )
+            continue;
+
+        visible_edges.clear();
+        for ( rbu32 f : visible )
+        {
+            for ( rbs32 e = 0; e < 3; ++e )
+                visible_edges.push_back( { EdgeKey(faces[f].v[e], faces[f].v[(e + 1) % 3]), f } );
+            faces[f].alive = false;
+        }
+        std::sort( visible_edges.begin(), visible_edges.end() );
+
+        // [LANG en] An edge is on the horizon when its twin belongs to a face that remains.
+        // [LANG ja] 逆向きの辺が残る面に属していれば、その辺は地平線(horizon)上にある
+        horizon.clear();
+        for ( const DirectedEdge& e : visible_edges )
+        {
+            rbu32 from = static_cast<rbu32>(e.key >> 32);
+            rbu32 to = static_cast<rbu32>(e.key & 0xFFFFFFFFU);
+            DirectedEdge twin = { EdgeKey(to, from), 0 };
+            if ( !std::binary_search(visible_edges.begin(), visible_edges.end(), twin) )
+                horizon.emplace_back( from, to );
+        }
+
+        for ( const auto& e : horizon )
+        {
+            HullFace f;
+            if ( MakeFace(p, e.first, e.second, i, interior, f) )
+                faces.push_back( f );
+        }
+    }
+
+    faces.erase( std::remove_if(faces.begin(), faces.end(), [](const HullFace& f) { return !f.alive; }), faces.end() );
+
+    //
+    // [LANG en] Compact the vertex array and compute mass properties (sum of tetrahedra spanned from +interior+).
+    // [LANG ja] 頂点配列を詰め直し、質量特性を計算 (+interior+ を頂点とする四面体の総和)
+    //
+    std::vector<rbu32> remap( point_count, ~0U );
+    for ( HullFace& f : faces )
+    {
+        for ( rbu32& v : f.v )
+        {
+            if ( remap[v] == ~0U )
+            {
+                remap[v] = static_cast<rbu32>(vertices.size());
+                vertices.push_back( p[v] - interior );
+            }
+            v = remap[v];
+        }
+    }
+
+    rbReal six_volume = 0;
+    rbVec3 weighted_centroid( 0, 0, 0 );
+    rbMtx3 covariance( 0, 0, 0,
+                       0, 0, 0,
+                       0, 0, 0 );
+    for ( const HullFace& f : faces )
+    {
+        const rbVec3& a = vertices[f.v[0]];
+        const rbVec3& b = vertices[f.v[1]];
+        const rbVec3& c = vertices[f.v[2]];
+        rbReal det = a * (b % c);
+        rbVec3 s = a + b + c;
+
+        six_volume += det;
+        weighted_centroid += det * s;
+
+        // Ref.: J. Blow, A. Binstock, "How to find the inertia tensor (or other mass properties) of a 3D solid body represented by a triangle mesh"
+        rbReal scale = det / rbReal(120);
+        AddOuterProduct( covariance, a, a, scale );
+        AddOuterProduct( covariance, b, b, scale );
+        AddOuterProduct( covariance, c, c, scale );
+        AddOuterProduct( covariance, s, s, scale );
+    }
+
+    volume = six_volume / rbReal(6);
+    if ( volume <= RIGIDBOX_TOLERANCE )
+    {
+        Clear();
+        return false;
+    }
+
+    rbVec3 com = weighted_centroid / (rbReal(4) * six_volume);
+    AddOuterProduct( covariance, com, com, -volume );
+
+    rbReal trace = covariance.Elem(0,0) + covariance.Elem(1,1) + covariance.Elem(2,2);
+    unit_inertia.Set( trace, 0, 0,
+                      0, trace, 0,
+                      0, 0, trace );
+    unit_inertia -= covariance;
+    unit_inertia *= rbReal(1) / volume;
+
+    center_of_mass = interior + com;
+    for ( rbVec3& v : vertices )
+    {
+        v -= com;
+        for ( rbs32 i = 0; i < 3; ++i )
+            half_extent.e[i] = rbMax( half_extent.e[i], rbFabs(v.e[i]) );
+    }
+
+    //
+    // [LANG en] Vertex adjacency and SAT axes
+    // [LANG ja] 頂点の隣接情報と分離軸の候補
+    //
+    std::vector<DirectedEdge> edges;
+    for ( rbu32 f = 0; f < faces.size(); ++f )
+        for ( rbs32 e = 0; e < 3; ++e )
+            edges.push_back( { EdgeKey(faces[f].v[e], faces[f].v[(e + 1) % 3]), f } );
+    std::sort( edges.begin(), edges.end() );
+
+    adjacency_offset.assign( vertices.size() + 1, 0 );
+    for ( const DirectedEdge& e : edges )
+        ++adjacency_offset[(e.key >> 32) + 1];
+    for ( size_t v = 0; v < vertices.size(); ++v )
+        adjacency_offset[v + 1] += adjacency_offset[v];
+    adjacency.resize( edges.size() );
+    for ( size_t k = 0; k < edges.size(); ++k )
+        adjacency[k] = static_cast<rbu32>(edges[k].key & 0xFFFFFFFFU);
+
+    for ( const HullFace& f : faces )
+    {
+        bool duplicated = std::any_of( face_normals.begin(), face_normals.end(),
+            [&f](const rbVec3& n) { return Parallel( n, f.normal ); } );
+        if ( !duplicated )
+            face_normals.push_back( f.normal );
+    }
+
+    for ( const DirectedEdge& e : edges )
+    {
+        rbu32 from = static_cast<rbu32>(e.key >> 32);
+        rbu32 to = static_cast<rbu32>(e.key & 0xFFFFFFFFU);
+        if ( from > to )
+            continue;
+
+        // [LANG en] Diagonals inside a flat polygon are not real edges of the polyhedron.
+        // [LANG ja] 平面ポリゴン内部の対角線は多面体の辺ではないので除外
+        auto twin = std::lower_bound( edges.begin(), edges.end(), DirectedEdge{ EdgeKey(to, from), 0 } );
+        if ( twin != edges.end() && twin->key == EdgeKey(to, from) &&
+             faces[twin->face].normal * faces[e.face].normal > rbReal(1) - rbReal(1e-4) )
+            continue;
+
+        rbVec3 d = (vertices[to] - vertices[from]).Normalize();
+        bool duplicated = std::any_of( edge_directions.begin(), edge_directions.end(),
+            [&d](const rbVec3& u) { return Parallel( u, d ); } );
+        if ( !duplicated )
+            edge_directions.push_back( d );
+    }
+
+    return true;
+}
+
+rbu32 rbConvexHull::SupportIndex( const rbVec3& direction, rbu32 start ) const
+{
+    if ( vertices.empty() )
+        return 0;
+
+    rbu32 current = start < vertices.size() ? start : 0;
+    rbReal current_dot = vertices[current] * direction;
+
+    // [LANG en] Steepest ascent over the vertex graph. A local maximum on a convex polyhedron is also the global one.
+    // [LANG ja] 頂点グラフ上の最急上昇法。凸多面体では局所最大値がそのまま最大値になる。
+    for ( ;; )
+    {
+        rbu32 best = current;
+        rbReal best_dot = current_dot;
+        for ( rbu32 k = adjacency_offset[current]; k < adjacency_offset[current + 1]; ++k )
+        {
+            rbReal d = vertices[adjacency[k]] * direction;
+            if ( d > best_dot )
+            {
+                best_dot = d;
+                best = adjacency[k];
+            }
+        }
+
+        if ( best == current )
+            return current;
+
+        current = best;
+        current_dot = best_dot;
+    }
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -1,192 +1,1272 @@
-// -*- mode: C++; coding: utf-8; -*-
-#include <algorithm>
-#include <functional>
-
-#include <RigidBox/rbCollision.h>
-#include <RigidBox/rbEnvironment.h>
-#include <RigidBox/rbMath.h>
-#include <RigidBox/rbRigidBody.h>
-#include <RigidBox/rbSolver.h>
-
-rbEnvironment::rbEnvironment()
-    : bodies()
-    , contacts()
-    , solver()
-    , config()
-{
-    Config default_config;
-    bodies.reserve( default_config.RigidBodyCapacity );
-    contacts.reserve( default_config.ContactCapacty );
-    this->config = default_config;
-}
-
-rbEnvironment::rbEnvironment( const Config& config )
-    : bodies()
-    , contacts()
-    , solver()
-    , config()
-{
-    bodies.reserve( config.RigidBodyCapacity );
-    contacts.reserve( config.ContactCapacty );
-    this->config = config;
-}
-
-rbEnvironment::~rbEnvironment()
-{
-    if ( !bodies.empty() )
-    {
-        BodyPtrContainer::iterator it_end = bodies.end();
-        for ( BodyPtrContainer::iterator it_current = bodies.begin(); it_current != it_end; ++it_current )
-        {
-            delete *it_current;
-        }
-        bodies.clear();
-    }
-}
-
-
-bool rbEnvironment::Register( rbRigidBody* box )
-{
-    BodyPtrContainer::iterator it = std::find( bodies.begin(), bodies.end(), box );
-
-    if ( it == bodies.end() )
-    {
-        bodies.push_back( box );
-        return true;
-    }
-
-    return false;
-}
-
-bool rbEnvironment::Unregister( rbRigidBody* box )
-{
-    BodyPtrContainer::iterator it = std::find( bodies.begin(), bodies.end(), box );
-
-    if ( it != bodies.end() )
-    {
-        bodies.erase( it );
-        return true;
-    }
-
-    return false;
-}
-
-void rbEnvironment::Update( rbReal dtime, int div )
-{
-    rbReal dt = dtime / div;
-
-    BodyPtrContainer::iterator it_body, it_body0, it_body1, it_bodies_end = bodies.end();
-
-    // [LANG en] Preprocess
-    // [LANG ja] 前処理
-
-    // [LANG en] Cleanup contact point array
-    // [LANG ja] 衝突点配列をゼロクリア
-    ClearContacts();
-
-    for ( rbs32 i = 0; i < div; ++i )
-    {
-        for (rbRigidBody* body : bodies)
-        {
-            // [LANG en] Cleanup temporal space used by collision response routine
-            // [LANG ja] 衝突応答で利用する一時領域をゼロクリア
-            body->ClearSolverWorkArea();
-
-            // [LANG en] The orientation of +it_body+ might be modified in the previous loop. So inertia tensor must be updated here.
-            // [LANG ja] 位置が更新されているため慣性テンソルも更新
-            body->UpdateInvInertiaWorld();
-        }
-
-        // [LANG en] Collision detection
-        // [LANG ja] 衝突検出
-        for ( it_body0 = bodies.begin(); it_body0 != it_bodies_end; ++it_body0 )
-        {
-            for ( it_body1 = it_body0 + 1; it_body1 != it_bodies_end; ++it_body1 )
-            {
-                // [LANG en] No need to check between wall/floor intersection
-                // [LANG ja] 壁/床同士の衝突判定は不要
-                if ( (*it_body0)->IsFixed() && (*it_body1)->IsFixed() )
-                    continue;
-
-                rbContact c;
-                if (rbCollision::Detect(*it_body0, *it_body1, &c) > 0)
-                //std::vector<rbContact> contacts_out;
-                //if (rbCollision::Detect(*it_body0, *it_body1, contacts_out) > 0)
-                {
-                    //rbContact& c = contacts_out[0];
-                    // [LANG en] No need to register if +contacts+ already have the same (or similar) contact point
-                    // [LANG ja] すでに似た衝突点が検出済みである場合は登録しない
-                    auto it = std::find_if(contacts.begin(), contacts.end(),
-                        [this, &c](const rbContact& ci) {
-                            return (c.Position - ci.Position).LengthSq() <= this->config.NearThreshold ? true : false;
-                        });
-                    if ( it == contacts.end() )
-                        contacts.push_back( c );
-                }
-            }
-        }
-
-        // [LANG en] Integration (Force -> Velocity)
-        // [LANG ja] 積分 (力→速度)
-        for (rbRigidBody* body : bodies)
-            body->UpdateVelocity( dt );
-
-        // [LANG en] Collision response
-        // [LANG ja] 衝突応答
-        for (rbContact& contact : contacts)
-            solver.ApplyImpulse( &contact, dt );
-
-        for (rbRigidBody* body : bodies)
-            body->CorrectVelocity();
-
-        // [LANG en] Update sleep status
-        // [LANG ja] スリープ状態の更新
-        for (rbRigidBody* body : bodies)
-        {
-            body->UpdateSleepStatus( dt );
-            if ( body->Sleeping() )
-            {
-                body->SetLinearVelocity( 0, 0, 0 );
-
-                // [LANG en] Angular momentum is also cleared in this method
-                // [LANG ja] Angular Momentum も内部でゼロクリアされる
-                body->SetAngularVelocity( 0, 0, 0 );
-            }
-        }
-
-        // [LANG en] Integration (Velocity -> Position)
-        // [LANG ja] 積分 (速度→位置)
-        for (rbRigidBody* body : bodies)
-            body->UpdatePosition( dt );
-    }
-
-    // [LANG en] Postprocess
-    // [LANG ja] 後処理
-    for (rbRigidBody* body : bodies)
-    {
-        body->SetForce( 0, 0, 0 );
-        body->SetTorque( 0, 0, 0 );
-    }
-}
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include <RigidBox/rbCollision.h>
+#include <RigidBox/rbEnvironment.h>
+#include <RigidBox/rbMath.h>
+#include <RigidBox/rbRigidBody.h>
+#include <RigidBox/rbSolver.h>
+#include <RigidBox/rbTrajectory.h>
+
+const rbu32 rbEnvironment::NoTouchingPair;
+
+rbEnvironment::rbEnvironment()
+    : bodies()
+    , body_arrays()
+    , contacts()
+    , broadphase()
+    , solver()
+    , shape_library()
+    , config()
+    , ccd_advanced_time()
+    , ccd_impacts()
+    , ccd_advanced()
+    , sensor_pairs()
+    , sensor_pairs_current()
+    , sensor_events()
+    , touching_pairs()
+    , touching_pairs_current()
+    , contact_owners()
+    , touching_pairs_previous()
+    , touching_pairs_persisted()
+    , contact_candidates()
+    , candidate_owners()
+    , contact_events()
+    , next_pair_id(0)
+    , profiler()
+    , trajectory_recorder( nullptr )
+    , rollback_frames()
+    , rollback_next(0)
+    , rollback_count(0)
+    , rollback_valid(false)
+    , rollback_baseline()
+    , rollback_awake()
+    , rollback_scratch()
+    , rollback_changed()
+{
+    Config default_config;
+    bodies.reserve( default_config.RigidBodyCapacity );
+    contacts.reserve( default_config.ContactCapacty );
+    this->config = default_config;
+    contact_events.Reserve( default_config.ContactEventCapacity );
+    rollback_frames.resize( default_config.RollbackCapacity );
+}
+
+rbEnvironment::rbEnvironment( const Config& config )
+    : bodies()
+    , body_arrays()
+    , contacts()
+    , broadphase()
+    , solver()
+    , shape_library()
+    , config()
+    , ccd_advanced_time()
+    , ccd_impacts()
+    , ccd_advanced()
+    , sensor_pairs()
+    , sensor_pairs_current()
+    , sensor_events()
+    , touching_pairs()
+    , touching_pairs_current()
+    , contact_owners()
+    , touching_pairs_previous()
+    , touching_pairs_persisted()
+    , contact_candidates()
+    , candidate_owners()
+    , contact_events()
+    , next_pair_id(0)
+    , profiler()
+    , trajectory_recorder( nullptr )
+    , rollback_frames()
+    , rollback_next(0)
+    , rollback_count(0)
+    , rollback_valid(false)
+    , rollback_baseline()
+    , rollback_awake()
+    , rollback_scratch()
+    , rollback_changed()
+{
+    bodies.reserve( config.RigidBodyCapacity );
+    contacts.reserve( config.ContactCapacty );
+    this->config = config;
+    contact_events.Reserve( config.ContactEventCapacity );
+    rollback_frames.resize( config.RollbackCapacity );
+}
+
+rbEnvironment::~rbEnvironment()
+{
+    if ( !bodies.empty() )
+    {
+        // [LANG en] Bodies registered as part of an array belong to the caller (e.g. rbScene)
+        // [LANG ja] 配列の一部として登録された剛体は呼び出し側 (rbScene 等) のもの
+        std::less<const rbRigidBody*> less;
+        BodyPtrContainer::iterator it_end = bodies.end();
+        for ( BodyPtrContainer::iterator it_current = bodies.begin(); it_current != it_end; ++it_current )
+        {
+            rbRigidBody* body = *it_current;
+            const bool in_array = std::any_of( body_arrays.begin(), body_arrays.end(), [&less, body](const BodyArray& array) {
+                return !less(body, array.Bodies) && less(body, array.Bodies + array.Count);
+            } );
+            if ( !in_array )
+                delete body;
+        }
+        bodies.clear();
+    }
+}
+
+
+bool rbEnvironment::Register( rbRigidBody* box )
+{
+    BodyPtrContainer::iterator it = std::find( bodies.begin(), bodies.end(), box );
+
+    if ( it == bodies.end() )
+    {
+        bodies.push_back( box );
+        rollback_valid = false;
+        rollback_count = 0;
+        broadphase.InvalidateQueryBounds();
+        return true;
+    }
+
+    return false;
+}
+
+bool rbEnvironment::Unregister( rbRigidBody* box )
+{
+    BodyPtrContainer::iterator it = std::find( bodies.begin(), bodies.end(), box );
+
+    if ( it != bodies.end() )
+    {
+        bodies.erase( it );
+        rollback_valid = false;
+        rollback_count = 0;
+        broadphase.InvalidateQueryBounds();
+
+        // [LANG en] Forget its sensor overlaps and touching pairs silently, so that no event refers to an unregistered body
+        // [LANG ja] 登録解除した剛体をイベントが参照しないよう、センサーの重なりと接触している組は通知せずに破棄する
+        sensor_pairs.erase( std::remove_if(sensor_pairs.begin(), sensor_pairs.end(),
+                                           [box](const SensorPair& pair) { return pair.Sensor == box || pair.Other == box; }),
+                            sensor_pairs.end() );
+        touching_pairs.erase( std::remove_if(touching_pairs.begin(), touching_pairs.end(),
+                                             [box](const TouchingPair& pair) { return pair.Body[0] == box || pair.Body[1] == box; }),
+                              touching_pairs.end() );
+        return true;
+    }
+
+    return false;
+}
+
+bool rbEnvironment::Register( rbRigidBody* array, rbu32 count, const rbu32* sweep_order )
+{
+    // [LANG en] std::less gives a total order on pointers, so the range test is valid for bodies outside the array
+    // [LANG ja] std::less はポインタの全順序を与えるので、配列の外の剛体に対しても範囲の判定は正しい
+    std::less<const rbRigidBody*> less;
+    for ( rbRigidBody* body : bodies )
+    {
+        if ( !less(body, array) && less(body, array + count) )
+            return false;
+    }
+
+    const bool was_empty = bodies.empty();
+    bodies.reserve( bodies.size() + count );
+    for ( rbu32 i = 0; i < count; ++i )
+        bodies.push_back( &array[i] );
+    if ( count > 0 )
+        body_arrays.push_back( BodyArray{array, count} );
+    rollback_valid = false;
+    rollback_count = 0;
+    broadphase.InvalidateQueryBounds();
+
+    if ( was_empty && sweep_order != nullptr )
+        broadphase.SetOrder( sweep_order, count );
+
+    return true;
+}
+
+bool rbEnvironment::Unregister( rbRigidBody* array, rbu32 count )
+{
+    std::less<const rbRigidBody*> less;
+    auto in_array = [&less, array, count]( const rbRigidBody* body ) {
+        return !less(body, array) && less(body, array + count);
+    };
+
+    if ( rbu32(std::count_if(bodies.begin(), bodies.end(), in_array)) != count )
+        return false;
+
+    bodies.erase( std::remove_if(bodies.begin(), bodies.end(), in_array), bodies.end() );
+    // [LANG en] Forget the registered arrays that lie within [array, array + count)
+    // [LANG ja] [array, array + count) に含まれる登録済みの配列を忘れる
+    body_arrays.erase( std::remove_if(body_arrays.begin(), body_arrays.end(),
+                                      [&less, array, count](const BodyArray& registered) {
+                                          return !less(registered.Bodies, array) &&
+                                                 !less(array + count, registered.Bodies + registered.Count);
+                                      }),
+                       body_arrays.end() );
+    rollback_valid = false;
+    rollback_count = 0;
+    broadphase.InvalidateQueryBounds();
+
+    sensor_pairs.erase( std::remove_if(sensor_pairs.begin(), sensor_pairs.end(),
+                                       [&in_array](const SensorPair& pair) { return in_array(pair.Sensor) || in_array(pair.Other); }),
+                        sensor_pairs.end() );
+    touching_pairs.erase( std::remove_if(touching_pairs.begin(), touching_pairs.end(),
+                                         [&in_array](const TouchingPair& pair) { return in_array(pair.Body[0]) || in_array(pair.Body[1]); }),
+                          touching_pairs.end() );
+    return true;
+}
+
+void rbEnvironment::Update( rbReal dtime, int div )
+{
+    profiler.BeginFrame();
+    {
+        RIGIDBOX_PROFILE_SCOPE( profiler, Phase_Update );
+        if ( !rollback_frames.empty() )
+            BeginRollbackFrame();
+        Step( dtime, div );
+        broadphase.InvalidateQueryBounds();
+        if ( !rollback_frames.empty() )
+            EndRollbackFrame();
+        if ( trajectory_recorder != nullptr )
+            trajectory_recorder->Capture( bodies );
+    }
+    profiler.EndFrame();
+}
+
+void rbEnvironment::Step( rbReal dtime, int div )
+{
+    rbFrameStats& stats = profiler.Stats();
+    rbReal dt = dtime / div;
+
+    // [LANG en] Preprocess
+    // [LANG ja] 前処理
+
+    // [LANG en] Cleanup contact point array
+    // [LANG ja] 衝突点配列をゼロクリア
+    ClearContacts();
+    contact_owners.clear();
+
+    // [LANG en] Kinematic bodies move towards their targets at constant velocity over the whole Update
+    // [LANG ja] キネマティックな剛体は Update 全体を通して一定の速度で目標の姿勢へ移動する
+    const bool track_rollback = rollback_valid && !rollback_frames.empty();
+    rollback_changed.clear();
+    for ( size_t k = 0; k < bodies.size(); ++k )
+    {
+        rbRigidBody* body = bodies[k];
+        body->UpdateKinematicVelocity( dtime );
+
+        // [LANG en] Bodies awake when last recorded, or modified by the application since then (see rbRigidBody::Modified),
+        // [LANG en] may change in this Update
+        // [LANG ja] 前回の記録の時点でスリープしていなかった剛体と、それ以降にアプリケーションが変更した剛体
+        // [LANG ja] (rbRigidBody::Modified を参照) はこの Update で変わりうる
+        if ( track_rollback && (rollback_awake[k] != 0 || body->Modified()) )
+        {
+            rollback_changed.push_back( static_cast<rbu32>(k) );
+            rollback_awake[k] = 1;
+        }
+    }
+
+    for ( rbs32 i = 0; i < div; ++i )
+    {
+        profiler.SetSubstep( i );
+
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_DerivedData );
+            for (rbRigidBody* body : bodies)
+            {
+                // [LANG en] Cleanup temporal space used by collision response routine, and update the inertia tensor of
+                // [LANG en] bodies rotated in the previous loop. Bodies that neither moved nor received impulses are skipped.
+                // [LANG ja] 衝突応答で利用する一時領域をゼロクリアし、前回のループで回転した剛体の慣性テンソルを更新。
+                // [LANG ja] 移動も力積の適用もなかった剛体は飛ばす。
+                if ( !body->RefreshDerivedData() )
+                    ++stats.SkippedBodyUpdates;
+            }
+        }
+
+        // [LANG en] Collision detection
+        // [LANG ja] 衝突検出
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_BroadPhase );
+            broadphase.Update( bodies, dt, config.SpeculativeContacts );
+            stats.BroadPhasePairs += static_cast<rbu32>( broadphase.Pairs().size() );
+        }
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_NarrowPhase );
+            DetectCollision( dt );
+        }
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_ContactDedup );
+            MergeContacts();
+        }
+
+        // [LANG en] Integration (Force -> Velocity)
+        // [LANG ja] 積分 (力→速度)
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_Velocity );
+            for (rbRigidBody* body : bodies)
+                body->UpdateVelocity( dt );
+        }
+
+        // [LANG en] Collision response
+        // [LANG ja] 衝突応答
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_Solver );
+            for ( size_t k = 0; k < contacts.size(); ++k )
+            {
+                const rbReal impulse = solver.ApplyImpulse( &contacts[k], dt );
+                RIGIDBOX_PROFILE_COUNT( profiler, ImpulsesApplied, impulse != 0 ? 1 : 0 );
+                if ( k < contact_owners.size() && contact_owners[k] != NoTouchingPair )
+                {
+                    TouchingPair& touching = touching_pairs_current[contact_owners[k]];
+                    touching.MaxImpulse = rbMax( touching.MaxImpulse, impulse );
+                }
+            }
+
+            for (rbRigidBody* body : bodies)
+                body->CorrectVelocity();
+        }
+
+        // [LANG en] Update sleep status
+        // [LANG ja] スリープ状態の更新
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_Sleep );
+            for (rbRigidBody* body : bodies)
+            {
+                body->UpdateSleepStatus( dt );
+                if ( body->Sleeping() )
+                {
+                    body->SetLinearVelocity( 0, 0, 0 );
+
+                    // [LANG en] Angular momentum is also cleared in this method
+                    // [LANG ja] Angular Momentum も内部でゼロクリアされる
+                    body->SetAngularVelocity( 0, 0, 0 );
+                }
+            }
+        }
+
+        // [LANG en] Continuous collision detection for fast bodies
+        // [LANG ja] 高速な剛体の連続衝突検出
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_CCD );
+            SolveTimeOfImpact( dt );
+        }
+
+        // [LANG en] Integration (Velocity -> Position)
+        // [LANG ja] 積分 (速度→位置)
+        {
+            RIGIDBOX_PROFILE_SCOPE( profiler, Phase_Position );
+            for ( size_t k = 0; k < bodies.size(); ++k )
+                bodies[k]->UpdatePosition( dt - ccd_advanced_time[k] );
+        }
+    }
+    profiler.SetSubstep( -1 );
+
+    // [LANG en] Postprocess
+    // [LANG ja] 後処理
+    {
+        RIGIDBOX_PROFILE_SCOPE( profiler, Phase_Events );
+        UpdateSensorEvents();
+        if ( contact_events.Capacity() > 0 )
+            UpdateContactEvents();
+    }
+
+    for ( size_t k = 0; k < bodies.size(); ++k )
+    {
+        rbRigidBody* body = bodies[k];
+        body->FinishKinematicMotion();
+        body->SetForce( 0, 0, 0 );
+        body->SetTorque( 0, 0, 0 );
+        body->ClearModified();
+        RIGIDBOX_PROFILE_COUNT( profiler, BodiesAsleep, body->Sleeping() ? 1 : 0 );
+
+        // [LANG en] Bodies woken up by this Update
+        // [LANG ja] この Update で起きた剛体
+        if ( track_rollback && rollback_awake[k] == 0 && body->IsNotFixed() && body->Awake() )
+            rollback_changed.push_back( static_cast<rbu32>(k) );
+    }
+}
+
+// [LANG en] Upper bound of how much the gap between two bodies can shrink during +dt+
+// [LANG ja] +dt+ の間に2つの剛体の隙間が縮みうる量の上限
+static rbReal SpeculativeMargin( rbRigidBody* body0, rbRigidBody* body1, rbReal dt )
+{
+    rbRigidBody* body[2] = { body0, body1 };
+    rbVec3 velocity[2];
+    rbReal extra_speed = 0;
+    for ( rbs32 i = 0; i < 2; ++i )
+    {
+        if ( body[i]->IsFixed() )
+        {
+            velocity[i].SetZero();
+            continue;
+        }
+
+        // [LANG en] Forces are integrated after the collision detection, so include the velocity they add within this step
+        // [LANG ja] 力の積分は衝突検出の後に行われるため、このステップで増える速度も含める
+        velocity[i] = body[i]->LinearVelocity();
+        extra_speed += body[i]->AngularVelocity().Length() * body[i]->HalfExtent().Length();
+        extra_speed += dt * body[i]->InvMass() * body[i]->Force().Length();
+    }
+    return ((velocity[0] - velocity[1]).Length() + extra_speed) * dt;
+}
+
+void rbEnvironment::DetectCollision( rbReal dt )
+{
+    contact_candidates.clear();
+    candidate_owners.clear();
+
+    for ( rbBroadPhase::Pair& pair : broadphase.Pairs() )
+    {
+        rbRigidBody* body0 = bodies[pair.Index[0]];
+        rbRigidBody* body1 = bodies[pair.Index[1]];
+
+        // [LANG en] Sensors only need to know whether they overlap, and never reach the solver
+        // [LANG ja] センサーは重なりの有無のみが必要で、ソルバーには渡さない
+        const bool sensor[2] = { body0->AttributeEnabled(rbRigidBody::Attribute_Sensor), body1->AttributeEnabled(rbRigidBody::Attribute_Sensor) };
+        if ( sensor[0] || sensor[1] )
+        {
+            pair.ContactCount = 0;
+            RIGIDBOX_PROFILE_COUNT( profiler, PairsTested, 1 );
+            if ( rbCollision::Overlap(body0, body1) )
+            {
+                if ( sensor[0] )
+                    AddSensorOverlap( body0, body1 );
+                else
+                    AddSensorOverlap( body1, body0 );
+            }
+            continue;
+        }
+
+        rbContact pair_contacts[rbCollision::MaxContactsPerPair];
+        pair.ContactCount = rbCollision::Detect( body0, body1, pair_contacts, rbCollision::MaxContactsPerPair );
+        RIGIDBOX_PROFILE_COUNT( profiler, PairsTested, 1 );
+        if ( pair.ContactCount == 0 && config.SpeculativeContacts )
+        {
+            pair.ContactCount = rbCollision::DetectSpeculative( body0, body1, SpeculativeMargin(body0, body1, dt), pair_contacts, rbCollision::MaxContactsPerPair );
+            RIGIDBOX_PROFILE_COUNT( profiler, PairsTested, 1 );
+        }
+
+        const rbu32 owner = contact_events.Capacity() > 0 ? AddTouchingPair( pair.Index[0], pair.Index[1], pair_contacts, pair.ContactCount ) : NoTouchingPair;
+        for ( rbs32 k = 0; k < pair.ContactCount; ++k )
+        {
+            contact_candidates.push_back( pair_contacts[k] );
+            candidate_owners.push_back( pair_contacts[k].PenetrationDepth >= 0 ? owner : NoTouchingPair );
+        }
+    }
+    RIGIDBOX_PROFILE_COUNT( profiler, ContactsFound, contact_candidates.size() );
+}
+
+void rbEnvironment::MergeContacts()
+{
+    for ( size_t k = 0; k < contact_candidates.size(); ++k )
+    {
+        const rbContact& c = contact_candidates[k];
+        // [LANG en] No need to register if +contacts+ already have the same (or similar) contact point
+        // [LANG ja] すでに似た衝突点が検出済みである場合は登録しない
+        auto it = std::find_if(contacts.begin(), contacts.end(),
+            [this, &c](const rbContact& ci) {
+                return (c.Position - ci.Position).LengthSq() <= this->config.NearThreshold ? true : false;
+            });
+        if ( it == contacts.end() )
+        {
+            contacts.push_back( c );
+            if ( contact_events.Capacity() > 0 )
+                contact_owners.push_back( candidate_owners[k] );
+        }
+        else
+        {
+            RIGIDBOX_PROFILE_COUNT( profiler, ContactsDeduped, 1 );
+        }
+    }
+}
+
+void rbEnvironment::AddSensorOverlap( rbRigidBody* sensor, rbRigidBody* other )
+{
+    // [LANG en] The same pair may overlap in several substeps of one Update
+    // [LANG ja] 1回の Update の複数のサブステップで同じ組が重なる場合がある
+    const SensorPair pair = { sensor, other };
+    if ( std::find(sensor_pairs_current.begin(), sensor_pairs_current.end(), pair) == sensor_pairs_current.end() )
+        sensor_pairs_current.push_back( pair );
+}
+
+void rbEnvironment::UpdateSensorEvents()
+{
+    sensor_events.clear();
+
+    for ( const SensorPair& pair : sensor_pairs_current )
+    {
+        if ( std::find(sensor_pairs.begin(), sensor_pairs.end(), pair) == sensor_pairs.end() )
+        {
+            SensorEvent event = { SensorEvent::Type_Begin, pair.Sensor, pair.Other };
+            sensor_events.push_back( event );
+        }
+    }
+
+    for ( const SensorPair& pair : sensor_pairs )
+    {
+        if ( std::find(sensor_pairs_current.begin(), sensor_pairs_current.end(), pair) == sensor_pairs_current.end() )
+        {
+            SensorEvent event = { SensorEvent::Type_End, pair.Sensor, pair.Other };
+            sensor_events.push_back( event );
+        }
+    }
+
+    sensor_pairs.swap( sensor_pairs_current );
+    sensor_pairs_current.clear();
+}
+
+rbu32 rbEnvironment::AddTouchingPair( rbu32 index0, rbu32 index1, const rbContact* pair_contacts, rbs32 contact_count )
+{
+    TouchingPair touching;
+    touching.Index[0] = index0;
+    touching.Index[1] = index1;
+    touching.Body[0] = bodies[index0];
+    touching.Body[1] = bodies[index1];
+    touching.PairId = 0;
+    touching.MaxImpulse = 0;
+    touching.NormalSum.SetZero();
+
+    // [LANG en] Speculative contacts do not touch yet. Normals are made to point from Body[1] to Body[0] of the pair.
+    // [LANG ja] 予測的な衝突点はまだ接触していない。法線は組の Body[1] -> Body[0] の向きに揃える。
+    bool touched = false;
+    for ( rbs32 k = 0; k < contact_count; ++k )
+    {
+        const rbContact& c = pair_contacts[k];
+        if ( c.PenetrationDepth < 0 )
+            continue;
+        touching.NormalSum += c.Body[0] == touching.Body[0] ? c.Normal : -c.Normal;
+        touched = true;
+    }
+    if ( !touched )
+        return NoTouchingPair;
+
+    touching_pairs_current.push_back( touching );
+    return static_cast<rbu32>(touching_pairs_current.size() - 1);
+}
+
+void rbEnvironment::UpdateContactEvents()
+{
+    // [LANG en] Merge the entries of the same pair found in several substeps. Sorting by body index keeps the event order
+    // [LANG en] independent of where the bodies live in memory.
+    // [LANG ja] 複数のサブステップで見つかった同じ組の要素をまとめる。剛体の番号でソートすることで、
+    // [LANG ja] イベントの順序が剛体のメモリ上の位置に依存しないようにする。
+    std::stable_sort( touching_pairs_current.begin(), touching_pairs_current.end(),
+        [](const TouchingPair& a, const TouchingPair& b) {
+            return a.Index[0] != b.Index[0] ? a.Index[0] < b.Index[0] : a.Index[1] < b.Index[1];
+        } );
+
+    size_t merged_count = 0;
+    for ( size_t i = 0; i < touching_pairs_current.size(); ++i )
+    {
+        const TouchingPair& touching = touching_pairs_current[i];
+        if ( merged_count > 0 && touching_pairs_current[merged_count - 1].Body[0] == touching.Body[0]
+                              && touching_pairs_current[merged_count - 1].Body[1] == touching.Body[1] )
+        {
+            TouchingPair& merged = touching_pairs_current[merged_count - 1];
+            merged.MaxImpulse = rbMax( merged.MaxImpulse, touching.MaxImpulse );
+            merged.NormalSum += touching.NormalSum;
+        }
+        else
+        {
+            touching_pairs_current[merged_count++] = touching;
+        }
+    }
+    touching_pairs_current.resize( merged_count );
+
+    // [LANG en] Lookup table of the previous pairs, sorted by body address
+    // [LANG ja] 前回の組の検索表 (剛体のアドレス順)
+    auto Less = [](rbRigidBody* const a[2], rbRigidBody* const b[2]) {
+        return a[0] != b[0] ? std::less<rbRigidBody*>()( a[0], b[0] ) : std::less<rbRigidBody*>()( a[1], b[1] );
+    };
+    std::vector<rbu32>& previous = touching_pairs_previous;
+    previous.resize( touching_pairs.size() );
+    for ( rbu32 i = 0; i < previous.size(); ++i )
+        previous[i] = i;
+    std::sort( previous.begin(), previous.end(),
+        [&](rbu32 a, rbu32 b) { return Less( touching_pairs[a].Body, touching_pairs[b].Body ); } );
+    std::vector<bool>& persisted = touching_pairs_persisted;
+    persisted.assign( touching_pairs.size(), false );
+
+    for ( TouchingPair& touching : touching_pairs_current )
+    {
+        auto it = std::lower_bound( previous.begin(), previous.end(), touching.Body,
+            [&](rbu32 a, rbRigidBody* const key[2]) { return Less( touching_pairs[a].Body, key ); } );
+
+        rbContactEvent event;
+        if ( it != previous.end() && !Less(touching.Body, touching_pairs[*it].Body) )
+        {
+            touching.PairId = touching_pairs[*it].PairId;
+            persisted[*it] = true;
+            event.Type = rbContactEvent::Type_Persist;
+        }
+        else
+        {
+            touching.PairId = next_pair_id++;
+            event.Type = rbContactEvent::Type_Begin;
+        }
+
+        event.PairId = touching.PairId;
+        event.Body[0] = touching.Body[0];
+        event.Body[1] = touching.Body[1];
+        event.MaxImpulse = touching.MaxImpulse;
+        event.Normal = touching.NormalSum.LengthSq() > RIGIDBOX_TOLERANCE ? touching.NormalSum.GetNormalized() : touching.NormalSum;
+        touching.NormalSum = event.Normal;
+        contact_events.Push( event );
+    }
+
+    for ( size_t i = 0; i < touching_pairs.size(); ++i )
+    {
+        if ( persisted[i] )
+            continue;
+
+        const TouchingPair& touching = touching_pairs[i];
+        rbContactEvent event;
+        event.Type = rbContactEvent::Type_End;
+        event.PairId = touching.PairId;
+        event.Body[0] = touching.Body[0];
+        event.Body[1] = touching.Body[1];
+        event.MaxImpulse = 0;
+        event.Normal = touching.NormalSum;
+        contact_events.Push( event );
+    }
+
+    touching_pairs.swap( touching_pairs_current );
+    touching_pairs_current.clear();
+}
+
+// [LANG en] A CCD body needs a sweep only when it may move more than half its thickness relative to the other body
+// [LANG ja] CCD を有効にした剛体の掃引が必要なのは、相手に対して厚みの半分以上移動しうる場合のみ
+static bool NeedsSweep( rbRigidBody* body, rbRigidBody* other, rbReal dt )
+{
+    if ( !body->AttributeEnabled(rbRigidBody::Attribute_CCD) || body->IsFixed() || body->Sleeping() )
+        return false;
+
+    const rbVec3 h = body->HalfExtent();
+    const rbReal thickness = rbMin( h.x, rbMin(h.y, h.z) );
+    const rbVec3 relative_velocity = body->LinearVelocity() - (other->IsFixed() ? rbVec3( 0, 0, 0 ) : other->LinearVelocity());
+    return relative_velocity.LengthSq() * dt * dt > thickness * thickness;
+}
+
+void rbEnvironment::SolveTimeOfImpact( rbReal dt )
+{
+    ccd_advanced_time.assign( bodies.size(), rbReal(0) );
+    ccd_impacts.clear();
+
+    // [LANG en] Only pairs involving a fast CCD body need a sweep
+    // [LANG ja] 掃引が必要なのは、CCD を有効にした高速な剛体を含む組のみ
+    for ( const rbBroadPhase::Pair& pair : broadphase.Pairs() )
+    {
+        rbRigidBody* body0 = bodies[pair.Index[0]];
+        rbRigidBody* body1 = bodies[pair.Index[1]];
+        if ( body0->AttributeEnabled(rbRigidBody::Attribute_Sensor) || body1->AttributeEnabled(rbRigidBody::Attribute_Sensor) )
+            continue;
+        if ( !NeedsSweep(body0, body1, dt) && !NeedsSweep(body1, body0, dt) )
+            continue;
+
+        CCDImpact impact;
+        if ( rbCollision::TimeOfImpact(body0, body1, dt, config.CCDTargetDepth, impact.toi) )
+        {
+            impact.index[0] = pair.Index[0];
+            impact.index[1] = pair.Index[1];
+            ccd_impacts.push_back( impact );
+        }
+    }
+
+    std::stable_sort( ccd_impacts.begin(), ccd_impacts.end(),
+        [](const CCDImpact& a, const CCDImpact& b) { return a.toi < b.toi; } );
+
+    // [LANG en] Substep each pair alone : advance both bodies to the time of impact, resolve the contact there, and
+    // [LANG en] sweep again over the rest of the step. Whatever time remains is left to the regular integration.
+    // [LANG en] A body takes part in one pair per substep.
+    // [LANG ja] 組ごとに個別のサブステップを行う : 両剛体を衝突時刻まで進めてそこで衝突を解決し、残りの時間で再度掃引する。
+    // [LANG ja] 最後に残った時間は通常の積分に任せる。1サブステップの間に剛体が処理されるのは1組のみ。
+    ccd_advanced.assign( bodies.size(), false );
+    for ( const CCDImpact& impact : ccd_impacts )
+    {
+        if ( ccd_advanced[impact.index[0]] || ccd_advanced[impact.index[1]] )
+            continue;
+        ccd_advanced[impact.index[0]] = ccd_advanced[impact.index[1]] = true;
+
+        rbRigidBody* pair_bodies[2] = { bodies[impact.index[0]], bodies[impact.index[1]] };
+        rbReal toi = impact.toi;
+        rbReal elapsed = 0;
+        for ( rbs32 substep = 0; substep < MaxCCDSubsteps; ++substep )
+        {
+            for ( rbRigidBody* body : pair_bodies )
+            {
+                body->UpdatePosition( toi );
+                body->UpdateInvInertiaWorld();
+                body->ClearSolverWorkArea();
+            }
+            elapsed += toi;
+
+            rbContact pair_contacts[rbCollision::MaxContactsPerPair];
+            rbs32 count = rbCollision::Detect( pair_bodies[0], pair_bodies[1], pair_contacts, rbCollision::MaxContactsPerPair );
+            const rbu32 owner = contact_events.Capacity() > 0 ? AddTouchingPair( impact.index[0], impact.index[1], pair_contacts, count ) : NoTouchingPair;
+            for ( rbs32 k = 0; k < count; ++k )
+            {
+                const rbReal impulse = solver.ApplyImpulse( &pair_contacts[k], dt );
+                if ( owner != NoTouchingPair )
+                    touching_pairs_current[owner].MaxImpulse = rbMax( touching_pairs_current[owner].MaxImpulse, impulse );
+            }
+
+            for ( rbRigidBody* body : pair_bodies )
+                body->CorrectVelocity();
+
+            if ( !rbCollision::TimeOfImpact(pair_bodies[0], pair_bodies[1], dt - elapsed, config.CCDTargetDepth, toi) )
+                break;
+        }
+
+        ccd_advanced_time[impact.index[0]] = elapsed;
+        ccd_advanced_time[impact.index[1]] = elapsed;
+    }
+}
+
+//
+// Scene queries
+//
+
+// [LANG en] Rays of a packet in SoA layout, so that the slab test runs over the lanes at once.
+// [LANG en] Unused lanes get best == -1 and never pass it.
+// [LANG ja] パケットのレイを SoA 形式で保持し、スラブ判定を全レーンまとめて行えるようにする。
+// [LANG ja] 使わないレーンは best == -1 として判定を通らないようにする。
+struct RayPacket
+{
+    rbReal origin[3][rbEnvironment::RayPacketSize];
+    rbReal inv_direction[3][rbEnvironment::RayPacketSize];
+    rbReal best[rbEnvironment::RayPacketSize];
+};
+
+// [LANG en] Slab test of the segment [0, best] of each lane against +aabb+. Returns the mask of the lanes that enter it.
+// [LANG ja] 各レーンの線分 [0, best] と +aabb+ のスラブ判定。交差するレーンのマスクを返す。
+static inline rbu32 RayPacketSlab( const RayPacket& packet, const rbAABB& aabb )
+{
+#if defined(RIGIDBOX_USE_SIMD)
+    static_assert( rbEnvironment::RayPacketSize == 4, "RayPacketSlab processes 4 lanes per SSE register" );
+    __m128 t_min = _mm_setzero_ps();
+    __m128 t_max = _mm_loadu_ps( packet.best );
+    for ( rbs32 a = 0; a < 3; ++a )
+    {
+        const __m128 origin = _mm_loadu_ps( packet.origin[a] );
+        const __m128 inv_direction = _mm_loadu_ps( packet.inv_direction[a] );
+        const __m128 t0 = _mm_mul_ps( _mm_sub_ps(_mm_set1_ps(aabb.lower.e[a]), origin), inv_direction );
+        const __m128 t1 = _mm_mul_ps( _mm_sub_ps(_mm_set1_ps(aabb.upper.e[a]), origin), inv_direction );
+        t_min = _mm_max_ps( t_min, _mm_min_ps(t0, t1) );
+        t_max = _mm_min_ps( t_max, _mm_max_ps(t0, t1) );
+    }
+    return static_cast<rbu32>( _mm_movemask_ps(_mm_cmple_ps(t_min, t_max)) );
+#else
+    rbu32 mask = 0;
+    for ( rbu32 k = 0; k < rbEnvironment::RayPacketSize; ++k )
+    {
+        rbReal t_min = 0;
+        rbReal t_max = packet.best[k];
+        for ( rbs32 a = 0; a < 3; ++a )
+        {
+            const rbReal t0 = (aabb.lower.e[a] - packet.origin[a][k]) * packet.inv_direction[a][k];
+            const rbReal t1 = (aabb.upper.e[a] - packet.origin[a][k]) * packet.inv_direction[a][k];
+            t_min = rbMax( t_min, rbMin(t0, t1) );
+            t_max = rbMin( t_max, rbMax(t0, t1) );
+        }
+        mask |= t_min <= t_max ? (1U << k) : 0U;
+    }
+    return mask;
+#endif
+}
+
+bool rbEnvironment::RayCast( const rbRay& ray, rbRayHit& hit_out )
+{
+    RayCast( &ray, 1, &hit_out );
+    return hit_out.Body != nullptr;
+}
+
+void rbEnvironment::RayCast( const rbRay* rays, rbu32 ray_count, rbRayHit* hits_out )
+{
+    broadphase.RefitQueryBounds( bodies );
+
+    for ( rbu32 first = 0; first < ray_count; first += RayPacketSize )
+    {
+        const rbu32 lane_count = ray_count - first < RayPacketSize ? ray_count - first : RayPacketSize;
+
+        RayPacket packet;
+        rbAABB segments[RayPacketSize];
+        rbAABB packet_bounds;
+        rbReal segment_width = 0;
+        for ( rbu32 k = 0; k < RayPacketSize; ++k )
+        {
+            const rbRay& ray = rays[first + (k < lane_count ? k : 0)];
+            for ( rbs32 a = 0; a < 3; ++a )
+            {
+                packet.origin[a][k] = ray.Origin.e[a];
+                packet.inv_direction[a][k] = rbFabs(ray.Direction.e[a]) > RIGIDBOX_TOLERANCE ? rbReal(1) / ray.Direction.e[a] : RIGIDBOX_REAL_MAX;
+            }
+            packet.best[k] = k < lane_count ? rbReal(1) : rbReal(-1);
+
+            segments[k] = rbAABB( ray.Origin, ray.Origin );
+            segments[k].Merge( segments[k].Translated(ray.Direction) );
+            if ( k == 0 )
+                packet_bounds = segments[k];
+            packet_bounds.Merge( segments[k] );
+
+            if ( k < lane_count )
+            {
+                hits_out[first + k].Body = nullptr;
+                hits_out[first + k].Fraction = rbReal(1);
+                segment_width += segments[k].upper.x - segments[k].lower.x;
+            }
+        }
+
+        // [LANG en] Candidates are collected by a broadphase walk over the given bounds, and each of them is tested
+        // [LANG en] against the own segment of every lane in +lanes+ before the narrowphase
+        // [LANG ja] 与えられた境界でブロードフェーズを走査して候補を集め、各候補を +lanes+ の各レーン自身の線分と
+        // [LANG ja] 判定してからナローフェーズに進む
+        auto Trace = [&]( const rbAABB& walk_bounds, rbu32 lanes ) {
+            broadphase.Query( walk_bounds,
+                [&](rbu32 body_index) {
+                    const rbu32 mask = RayPacketSlab( packet, broadphase.QueryBounds(body_index) ) & lanes;
+                    for ( rbu32 k = 0; k < lane_count; ++k )
+                    {
+                        rbRayHit hit;
+                        if ( (mask & (1U << k)) != 0 && rbCollision::RayCast(bodies[body_index], rays[first + k], packet.best[k], hit) )
+                        {
+                            hits_out[first + k] = hit;
+                            packet.best[k] = hit.Fraction;
+                        }
+                    }
+                } );
+        };
+
+        // [LANG en] A walk scans the bodies whose lower x-bound lies within its x-range widened by the query reach.
+        // [LANG en] Rays spread along x are walked one by one, so that none of them scans the gaps between the others.
+        // [LANG ja] 走査は x 方向の範囲を問い合わせの届く範囲だけ広げた中に下限がある剛体を調べる。
+        // [LANG ja] x 方向に散らばったレイは、互いの間の隙間を調べないように1本ずつ走査する。
+        const rbReal packet_width = packet_bounds.upper.x - packet_bounds.lower.x;
+        if ( packet_width <= segment_width + rbReal(lane_count - 1) * broadphase.QueryReach() )
+        {
+            Trace( packet_bounds, (1U << lane_count) - 1 );
+        }
+        else
+        {
+            for ( rbu32 k = 0; k < lane_count; ++k )
+                Trace( segments[k], 1U << k );
+        }
+    }
+}
+
+rbu32 rbEnvironment::OverlapBox( const rbVec3& center, const rbMtx3& orientation, const rbVec3& half_extent,
+                                 rbRigidBody** bodies_out, rbu32 capacity )
+{
+    // [LANG en] The query box is temporary : its shape is not added to the library
+    // [LANG ja] 問い合わせの直方体は一時的なものなので、形状はライブラリに追加しない
+    rbRigidBody::Shape shape;
+    shape.Set( rbReal(1), half_extent.x, half_extent.y, half_extent.z, 0, 0 );
+    rbRigidBody box;
+    box.SetShape( &shape );
+    box.SetPosition( center );
+    box.SetOrientation( orientation );
+
+    broadphase.RefitQueryBounds( bodies );
+
+    rbu32 count = 0;
+    broadphase.Query( box.WorldAABB(),
+        [&](rbu32 body_index) {
+            rbContact contact;
+            if ( rbCollision::Detect(&box, bodies[body_index], &contact, 1, false) > 0 )
+            {
+                if ( count < capacity )
+                    bodies_out[count] = bodies[body_index];
+                ++count;
+            }
+        } );
+
+    return count;
+}
+
+bool rbEnvironment::SweepBox( const rbVec3& center, const rbMtx3& orientation, const rbVec3& half_extent,
+                              const rbVec3& displacement, rbRayHit& hit_out )
+{
+    // [LANG en] The query box is temporary : its shape is not added to the library
+    // [LANG ja] 問い合わせの直方体は一時的なものなので、形状はライブラリに追加しない
+    rbRigidBody::Shape shape;
+    shape.Set( rbReal(1), half_extent.x, half_extent.y, half_extent.z, 0, 0 );
+    rbRigidBody box;
+    box.SetShape( &shape );
+    box.SetPosition( center );
+    box.SetOrientation( orientation );
+
+    broadphase.RefitQueryBounds( bodies );
+
+    rbAABB swept = box.WorldAABB();
+    swept.Merge( swept.Translated(displacement) );
+
+    hit_out.Body = nullptr;
+    hit_out.Fraction = rbReal(1);
+    broadphase.Query( swept,
+        [&](rbu32 body_index) {
+            rbRigidBody* body = bodies[body_index];
+            rbReal fraction = 0;
+            rbContact contact;
+            if ( rbCollision::Detect(&box, body, &contact, 1, false) == 0 &&
+                 !rbCollision::ShapeCast(&box, displacement, body, config.CCDTargetDepth, fraction, false) )
+                return;
+
+            if ( hit_out.Body == nullptr || fraction < hit_out.Fraction )
+            {
+                hit_out.Body = body;
+                hit_out.Fraction = fraction;
+            }
+        } );
+
+    if ( hit_out.Body == nullptr )
+        return false;
+
+    // [LANG en] Contact normals point from Body[1] to Body[0], i.e. from the hit body towards the box
+    // [LANG ja] 衝突点の法線は Body[1] -> Body[0]、すなわち当たった剛体から直方体へ向かう
+    box.SetPosition( center + hit_out.Fraction * displacement );
+    rbContact contact;
+    if ( rbCollision::Detect(&box, hit_out.Body, &contact, 1, false) > 0 )
+    {
+        hit_out.Position = contact.Position;
+        hit_out.Normal = contact.Body[0] == &box ? contact.Normal : -contact.Normal;
+    }
+    else
+    {
+        hit_out.Position = box.Position();
+        hit_out.Normal = -displacement.GetNormalized();
+    }
+
+    return true;
+}
+
+//
+// Snapshots
+//
+
+static inline void PutVec3( rbReal out[3], const rbVec3& v )
+{
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+static inline rbVec3 GetVec3( const rbReal in[3] )
+{
+    return rbVec3( in[0], in[1], in[2] );
+}
+
+void rbEnvironment::SaveSnapshot( rbSnapshot& snapshot )
+{
+    rbSnapshot::Header header;
+    header.Magic = rbSnapshot::Magic;
+    header.Version = rbSnapshot::Version;
+    header.RealSize = sizeof(rbReal);
+    header.BodyRecordSize = rbRigidBody::SnapshotSize();
+    header.BodyCount = static_cast<rbu32>( bodies.size() );
+    header.ContactCount = static_cast<rbu32>( contacts.size() );
+    header.TouchingPairCount = static_cast<rbu32>( touching_pairs.size() );
+    header.SensorPairCount = static_cast<rbu32>( sensor_pairs.size() );
+    header.NextPairId = next_pair_id;
+
+    snapshot.buffer.resize( rbSnapshot::ComputeSize(header) );
+    rbu8* out = snapshot.buffer.data();
+    std::memcpy( out, &header, sizeof(header) );
+    out += sizeof(header);
+
+    for ( const rbRigidBody* body : bodies )
+    {
+        body->SaveSnapshot( out );
+        out += header.BodyRecordSize;
+    }
+
+    // [LANG en] Contacts and sensor pairs refer to bodies by address : look up their indices in a table sorted by address
+    // [LANG ja] 衝突点とセンサーの組は剛体をアドレスで参照しているので、アドレス順に並べた表で番号を引く
+    auto& indices = snapshot.body_indices;
+    indices.clear();
+    if ( !contacts.empty() || !sensor_pairs.empty() )
+    {
+        for ( rbu32 i = 0; i < header.BodyCount; ++i )
+            indices.push_back( std::make_pair(static_cast<const rbRigidBody*>(bodies[i]), i) );
+        std::sort( indices.begin(), indices.end() );
+    }
+    auto index_of = [&indices]( const rbRigidBody* body ) {
+        auto it = std::lower_bound( indices.begin(), indices.end(), std::make_pair(body, rbu32(0)) );
+        return it != indices.end() && it->first == body ? it->second : ~rbu32(0);
+    };
+
+    for ( const rbContact& c : contacts )
+    {
+        rbSnapshot::ContactRecord record;
+        std::memset( &record, 0, sizeof(record) );
+        PutVec3( record.Position, c.Position );
+        PutVec3( record.RelativeBodyPosition[0], c.RelativeBodyPosition[0] );
+        PutVec3( record.RelativeBodyPosition[1], c.RelativeBodyPosition[1] );
+        PutVec3( record.Normal, c.Normal );
+        record.PenetrationDepth = c.PenetrationDepth;
+        record.Body[0] = index_of( c.Body[0] );
+        record.Body[1] = index_of( c.Body[1] );
+        std::memcpy( out, &record, sizeof(record) );
+        out += sizeof(record);
+    }
+
+    for ( const TouchingPair& pair : touching_pairs )
+    {
+        rbSnapshot::TouchingPairRecord record;
+        std::memset( &record, 0, sizeof(record) );
+        record.MaxImpulse = pair.MaxImpulse;
+        PutVec3( record.NormalSum, pair.NormalSum );
+        record.Index[0] = pair.Index[0];
+        record.Index[1] = pair.Index[1];
+        record.PairId = pair.PairId;
+        std::memcpy( out, &record, sizeof(record) );
+        out += sizeof(record);
+    }
+
+    for ( const SensorPair& pair : sensor_pairs )
+    {
+        rbSnapshot::SensorPairRecord record;
+        record.Sensor = index_of( pair.Sensor );
+        record.Other = index_of( pair.Other );
+        std::memcpy( out, &record, sizeof(record) );
+        out += sizeof(record);
+    }
+}
+
+bool rbEnvironment::RestoreSnapshot( const rbSnapshot& snapshot )
+{
+    if ( snapshot.Empty() )
+        return false;
+
+    const rbSnapshot::Header header = snapshot.GetHeader();
+    if ( header.BodyCount != bodies.size() )
+        return false;
+
+    const rbu32 body_count = header.BodyCount;
+    auto body_at = [this, body_count]( rbu32 index ) {
+        return index < body_count ? bodies[index] : nullptr;
+    };
+
+    const rbu8* in = snapshot.Data() + sizeof(header);
+    for ( rbRigidBody* body : bodies )
+    {
+        body->LoadSnapshot( in );
+        in += header.BodyRecordSize;
+    }
+
+    contacts.resize( header.ContactCount );
+    for ( rbContact& c : contacts )
+    {
+        rbSnapshot::ContactRecord record;
+        std::memcpy( &record, in, sizeof(record) );
+        in += sizeof(record);
+        c.Position = GetVec3( record.Position );
+        c.RelativeBodyPosition[0] = GetVec3( record.RelativeBodyPosition[0] );
+        c.RelativeBodyPosition[1] = GetVec3( record.RelativeBodyPosition[1] );
+        c.Normal = GetVec3( record.Normal );
+        c.PenetrationDepth = record.PenetrationDepth;
+        c.Body[0] = body_at( record.Body[0] );
+        c.Body[1] = body_at( record.Body[1] );
+    }
+    contact_owners.clear();
+
+    touching_pairs.resize( header.TouchingPairCount );
+    for ( TouchingPair& pair : touching_pairs )
+    {
+        rbSnapshot::TouchingPairRecord record;
+        std::memcpy( &record, in, sizeof(record) );
+        in += sizeof(record);
+        pair.Index[0] = record.Index[0];
+        pair.Index[1] = record.Index[1];
+        pair.Body[0] = body_at( record.Index[0] );
+        pair.Body[1] = body_at( record.Index[1] );
+        pair.PairId = record.PairId;
+        pair.MaxImpulse = record.MaxImpulse;
+        pair.NormalSum = GetVec3( record.NormalSum );
+    }
+
+    sensor_pairs.resize( header.SensorPairCount );
+    for ( SensorPair& pair : sensor_pairs )
+    {
+        rbSnapshot::SensorPairRecord record;
+        std::memcpy( &record, in, sizeof(record) );
+        in += sizeof(record);
+        pair.Sensor = body_at( record.Sensor );
+        pair.Other = body_at( record.Other );
+    }
+
+    next_pair_id = header.NextPairId;
+    rollback_valid = false;
+    rollback_count = 0;
+    broadphase.InvalidateQueryBounds();
+    return true;
+}
+
+//
+// Rollback
+//
+
+void rbEnvironment::ResetRollback()
+{
+    const rbu32 record_size = rbRigidBody::SnapshotSize();
+    rollback_baseline.resize( bodies.size() * record_size );
+    rollback_awake.resize( bodies.size() );
+    rollback_scratch.resize( record_size );
+    for ( size_t k = 0; k < bodies.size(); ++k )
+    {
+        bodies[k]->SaveSnapshot( &rollback_baseline[k * record_size] );
+        bodies[k]->ClearModified();
+        rollback_awake[k] = bodies[k]->IsNotFixed() && bodies[k]->Awake() ? 1 : 0;
+    }
+    rollback_next = 0;
+    rollback_count = 0;
+    rollback_valid = true;
+}
+
+void rbEnvironment::BeginRollbackFrame()
+{
+    if ( !rollback_valid )
+        return;
+
+    // [LANG en] The pairs are replaced as a whole by the Update : keep them as they are now
+    // [LANG ja] 組は Update で丸ごと置き換わるので、現在のものをそのまま保持する
+    RollbackFrame& frame = rollback_frames[rollback_next];
+    frame.BodyIndices.clear();
+    frame.BodyRecords.clear();
+    frame.TouchingPairs.assign( touching_pairs.begin(), touching_pairs.end() );
+    frame.SensorPairs.assign( sensor_pairs.begin(), sensor_pairs.end() );
+    frame.NextPairId = next_pair_id;
+}
+
+void rbEnvironment::EndRollbackFrame()
+{
+    // [LANG en] The history starts after an Update, which has cleared rbRigidBody::Modified of every body, so that a
+    // [LANG en] modified sleeping body means the application has changed it since
+    // [LANG ja] 履歴は全剛体の rbRigidBody::Modified を下ろした Update の後から始める。
+    // [LANG ja] そうすれば、スリープ中の剛体が変更済みなら、それ以降にアプリケーションが変更したことになる
+    if ( !rollback_valid )
+    {
+        ResetRollback();
+        return;
+    }
+
+    // [LANG en] Only the bodies noted by Step can differ from their records (the records hold scalar components only,
+    // [LANG en] see rbRigidBody::SaveSnapshot, so equal states compare equal)
+    // [LANG ja] 記録と異なりうるのは Step が書き留めた剛体のみ (記録はスカラーの成分のみからなるので、
+    // [LANG ja] 等しい状態は等しいと比較される。rbRigidBody::SaveSnapshot を参照)
+    const rbu32 record_size = rbRigidBody::SnapshotSize();
+    RollbackFrame& frame = rollback_frames[rollback_next];
+    rbu8* scratch = rollback_scratch.data();
+
+    for ( rbu32 k : rollback_changed )
+    {
+        rbRigidBody* body = bodies[k];
+        rollback_awake[k] = body->IsNotFixed() && body->Awake() ? 1 : 0;
+
+        rbu8* baseline = &rollback_baseline[k * record_size];
+        body->SaveSnapshot( scratch );
+        if ( std::memcmp(scratch, baseline, record_size) == 0 )
+            continue;
+
+        frame.BodyIndices.push_back( k );
+        frame.BodyRecords.insert( frame.BodyRecords.end(), baseline, baseline + record_size );
+        std::memcpy( baseline, scratch, record_size );
+    }
+
+    const rbu32 capacity = static_cast<rbu32>( rollback_frames.size() );
+    rollback_next = (rollback_next + 1) % capacity;
+    rollback_count = std::min( rollback_count + 1, capacity );
+}
+
+bool rbEnvironment::Rollback( rbu32 frame_count )
+{
+    if ( !rollback_valid || frame_count > rollback_count )
+        return false;
+    if ( frame_count == 0 )
+        return true;
+
+    // [LANG en] Undo the frames from the newest one. Each body ends up with the record saved by the oldest frame that changed it.
+    // [LANG ja] 新しいフレームから順に取り消す。各剛体には、その剛体を変更した最も古いフレームが保存した記録が残る。
+    const rbu32 record_size = rbRigidBody::SnapshotSize();
+    const rbu32 capacity = static_cast<rbu32>( rollback_frames.size() );
+    for ( rbu32 i = 0; i < frame_count; ++i )
+    {
+        rollback_next = (rollback_next + capacity - 1) % capacity;
+        const RollbackFrame& frame = rollback_frames[rollback_next];
+        for ( size_t j = 0; j < frame.BodyIndices.size(); ++j )
+        {
+            const rbu32 k = frame.BodyIndices[j];
+            const rbu8* record = &frame.BodyRecords[j * record_size];
+            bodies[k]->LoadSnapshot( record );
+            bodies[k]->ClearModified();
+            std::memcpy( &rollback_baseline[k * record_size], record, record_size );
+            rollback_awake[k] = bodies[k]->IsNotFixed() && bodies[k]->Awake() ? 1 : 0;
+        }
+    }
+    rollback_count -= frame_count;
+
+    const RollbackFrame& oldest = rollback_frames[rollback_next];
+    touching_pairs.assign( oldest.TouchingPairs.begin(), oldest.TouchingPairs.end() );
+    sensor_pairs.assign( oldest.SensorPairs.begin(), oldest.SensorPairs.end() );
+    next_pair_id = oldest.NextPairId;
+    ClearContacts();
+    contact_owners.clear();
+    broadphase.InvalidateQueryBounds();
+    return true;
+}
+
+//
+// State hash
+//
+
+static inline rbu64 HashBytes( rbu64 hash, const void* data, size_t size )
+{
+    const rbu8* bytes = static_cast<const rbu8*>( data );
+    for ( size_t i = 0; i < size; ++i )
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+rbu64 rbEnvironment::StateHash()
+{
+    rbu64 hash = 14695981039346656037ULL;
+
+    // [LANG en] The records hold the simulation state only (no caches, no padding; see rbRigidBody::SaveState), and the
+    // [LANG en] pairs are hashed field by field without their pointers and accumulated impulses and normals
+    // [LANG ja] 記録はシミュレーションの状態のみからなり (キャッシュや padding を含まない。rbRigidBody::SaveState を参照)、
+    // [LANG ja] 組はポインタや力積・法線の累積を除いてメンバーごとにハッシュする
+    rbu8 record[rbRigidBody::StateRecordSize];
+    for ( const rbRigidBody* body : bodies )
+    {
+        body->SaveState( record );
+        hash = HashBytes( hash, record, sizeof(record) );
+    }
+
+    for ( const TouchingPair& pair : touching_pairs )
+    {
+        hash = HashBytes( hash, pair.Index, sizeof(pair.Index) );
+        hash = HashBytes( hash, &pair.PairId, sizeof(pair.PairId) );
+    }
+    return HashBytes( hash, &next_pair_id, sizeof(next_pair_id) );
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,90 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbHeightField.h>
+
+rbHeightField::rbHeightField()
+    : samples()
+    , sample_count_x(0)
+    , sample_count_z(0)
+    , cell_size_x(1)
+    , cell_size_z(1)
+    , height_scale(0)
+    , height_offset(0)
+{}
+
+void rbHeightField::Clear()
+{
+    samples.clear();
+    sample_count_x = 0;
+    sample_count_z = 0;
+    cell_size_x = 1;
+    cell_size_z = 1;
+    height_scale = 0;
+    height_offset = 0;
+}
+
+bool rbHeightField::Build( rbu32 count_x, rbu32 count_z, const rbReal* heights, rbReal size_x, rbReal size_z )
+{
+    Clear();
+
+    if ( heights == nullptr || count_x < 2 || count_z < 2 || size_x <= 0 || size_z <= 0 )
+        return false;
+
+    const size_t count = static_cast<size_t>(count_x) * count_z;
+
+    rbReal lo = heights[0], hi = heights[0];
+    for ( size_t k = 0; k < count; ++k )
+    {
+        lo = rbMin( lo, heights[k] );
+        hi = rbMax( hi, heights[k] );
+    }
+
+    sample_count_x = count_x;
+    sample_count_z = count_z;
+    cell_size_x = size_x;
+    cell_size_z = size_z;
+    height_offset = lo;
+    height_scale = (hi - lo) / rbReal(65535);
+
+    samples.resize( count );
+    const rbReal inv_scale = height_scale > 0 ? rbReal(1) / height_scale : rbReal(0);
+    for ( size_t k = 0; k < count; ++k )
+    {
+        rbReal q = (heights[k] - lo) * inv_scale + rbReal(0.5);
+        samples[k] = static_cast<rbu16>( rbClamp(q, rbReal(0), rbReal(65535)) );
+    }
+
+    return true;
+}
+
+rbVec3 rbHeightField::HalfExtent() const
+{
+    if ( samples.empty() )
+        return rbVec3( 0, 0, 0 );
+
+    rbReal top = height_offset + height_scale * rbReal(65535);
+    return rbVec3( cell_size_x * (sample_count_x - 1),
+                   rbMax( rbFabs(height_offset), rbFabs(top) ),
+                   cell_size_z * (sample_count_z - 1) );
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,110 @@
+// -*- mode: C++; coding: utf-8; -*-
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <RigidBox/rbMappedFile.h>
+
+rbMappedFile::rbMappedFile()
+    : data( nullptr )
+    , size( 0 )
+    , mapping( nullptr )
+{}
+
+rbMappedFile::~rbMappedFile()
+{
+    Close();
+}
+
+bool rbMappedFile::Open( const char* path )
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+        return false;
+    LARGE_INTEGER file_size;
+    if ( !GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 )
+    {
+        CloseHandle( file );
+        return false;
+    }
+    HANDLE file_mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    CloseHandle( file );
+    if ( file_mapping == nullptr )
+        return false;
+    const void* view = MapViewOfFile( file_mapping, FILE_MAP_READ, 0, 0, 0 );
+    if ( view == nullptr )
+    {
+        CloseHandle( file_mapping );
+        return false;
+    }
+    mapping = file_mapping;
+    data = static_cast<const rbu8*>( view );
+    size = static_cast<size_t>( file_size.QuadPart );
+#else
+    const int fd = open( path, O_RDONLY );
+    if ( fd < 0 )
+        return false;
+    struct stat status;
+    if ( fstat(fd, &status) != 0 || status.st_size == 0 )
+    {
+        close( fd );
+        return false;
+    }
+    void* view = mmap( nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( view == MAP_FAILED )
+        return false;
+    data = static_cast<const rbu8*>( view );
+    size = static_cast<size_t>( status.st_size );
+#endif
+
+    return true;
+}
+
+void rbMappedFile::Close()
+{
+    if ( data != nullptr )
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile( data );
+        CloseHandle( static_cast<HANDLE>(mapping) );
+#else
+        munmap( const_cast<rbu8*>(data), size );
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,174 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <cstdio>
+
+#include <RigidBox/rbProfiler.h>
+
+const rbu32 rbFrameStats::PhaseCount;
+
+thread_local rbu32 rbProfiler::sat_axis_count = 0;
+
+const char* rbFrameStats::PhaseName( rbu32 phase )
+{
+    static const char* names[PhaseCount] = {
+        "Update",
+        "DerivedData",
+        "BroadPhase",
+        "NarrowPhase",
+        "ContactDedup",
+        "Velocity",
+        "Solver",
+        "Sleep",
+        "CCD",
+        "Position",
+        "Events",
+    };
+
+    return phase < PhaseCount ? names[phase] : "Unknown";
+}
+
+void rbFrameStats::Clear()
+{
+    Frame = 0;
+    for ( rbu32 i = 0; i < PhaseCount; ++i )
+        PhaseNanoseconds[i] = 0;
+    BroadPhasePairs = 0;
+    PairsTested = 0;
+    SATAxesEvaluated = 0;
+    ContactsFound = 0;
+    ContactsDeduped = 0;
+    ImpulsesApplied = 0;
+    BodiesAsleep = 0;
+    SkippedBodyUpdates = 0;
+}
+
+rbProfiler::rbProfiler()
+    : stats()
+    , epoch(std::chrono::steady_clock::now())
+    , frame_count(0)
+    , frame_begin(0)
+    , frame_sat_axis_begin(0)
+    , substep(-1)
+    , trace_events()
+    , trace_frames()
+    , trace_capacity(0)
+    , trace_overflow_count(0)
+    , phase_callback(nullptr)
+    , phase_callback_user_data(nullptr)
+{
+    stats.Clear();
+}
+
+void rbProfiler::BeginFrame()
+{
+    stats.Clear();
+    stats.Frame = frame_count++;
+    frame_begin = Now();
+    frame_sat_axis_begin = sat_axis_count;
+    substep = -1;
+}
+
+void rbProfiler::EndFrame()
+{
+#if !defined(RIGIDBOX_DISABLE_PROFILE)
+    // [LANG en] The counter is free-running, so the difference is correct even after a wrap-around
+    // [LANG ja] カウンターは単調増加するため、一周した後でも差は正しい
+    stats.SATAxesEvaluated = sat_axis_count - frame_sat_axis_begin;
+#endif
+    substep = -1;
+
+    if ( trace_capacity > 0 )
+    {
+        if ( trace_frames.size() < trace_capacity )
+            trace_frames.push_back( TraceFrame{frame_begin, stats} );
+        else
+            ++trace_overflow_count;
+    }
+}
+
+void rbProfiler::AddPhase( rbu32 phase, rbu64 begin, rbu64 end )
+{
+    stats.PhaseNanoseconds[phase] += end - begin;
+
+    if ( trace_capacity > 0 )
+    {
+        if ( trace_events.size() < trace_capacity )
+            trace_events.push_back( TraceEvent{phase, substep, stats.Frame, begin, end} );
+        else
+            ++trace_overflow_count;
+    }
+
+    if ( phase_callback != nullptr )
+        phase_callback( phase, false, phase_callback_user_data );
+}
+
+void rbProfiler::SetTraceCapacity( rbu32 capacity )
+{
+    trace_capacity = capacity;
+    ClearTrace();
+    trace_events.reserve( capacity );
+    trace_frames.reserve( capacity );
+}
+
+void rbProfiler::ClearTrace()
+{
+    trace_events.clear();
+    trace_frames.clear();
+    trace_overflow_count = 0;
+}
+
+bool rbProfiler::WriteChromeTrace( const char* path ) const
+{
+    FILE* fp = std::fopen( path, "w" );
+    if ( fp == nullptr )
+        return false;
+
+    // [LANG en] Timestamps of the format are in microseconds
+    // [LANG ja] この形式の時刻はマイクロ秒単位
+    std::fprintf( fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+    const char* separator = "";
+    for ( const TraceEvent& event : trace_events )
+    {
+        std::fprintf( fp, "%s{\"name\":\"%s\",\"cat\":\"rbEnvironment\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,"
+                      "\"args\":{\"frame\":%llu,\"substep\":%d}}",
+                      separator, rbFrameStats::PhaseName(event.Phase), event.Begin * 1e-3, (event.End - event.Begin) * 1e-3,
+                      event.Frame, event.Substep );
+        separator = ",\n";
+    }
+    for ( const TraceFrame& frame : trace_frames )
+    {
+        const rbFrameStats& s = frame.Stats;
+        std::fprintf( fp, "%s{\"name\":\"Counters\",\"cat\":\"rbEnvironment\",\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":%.3f,"
+                      "\"args\":{\"BroadPhasePairs\":%u,\"PairsTested\":%u,\"SATAxesEvaluated\":%u,\"ContactsFound\":%u,"
+                      "\"ContactsDeduped\":%u,\"ImpulsesApplied\":%u,\"BodiesAsleep\":%u,\"SkippedBodyUpdates\":%u}}",
+                      separator, frame.Begin * 1e-3,
+                      s.BroadPhasePairs, s.PairsTested, s.SATAxesEvaluated, s.ContactsFound,
+                      s.ContactsDeduped, s.ImpulsesApplied, s.BodiesAsleep, s.SkippedBodyUpdates );
+        separator = ",\n";
+    }
+    std::fprintf( fp, "\n]}\n" );
+
+    const bool succeeded = std::ferror( fp ) == 0;
+    return std::fclose( fp ) == 0 && succeeded;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -1,182 +1,614 @@
-// -*- mode: C++; coding: utf-8; -*-
-#include <RigidBox/rbRigidBody.h>
-
-void rbRigidBody::SetOrientation( rbReal rad_x, rbReal rad_y, rbReal rad_z )
-{
-    // state.orientation =
-    //     rbMtx3().SetFromAxisAngle(rbVec3(0,0,1), rad_z) *
-    //     rbMtx3().SetFromAxisAngle(rbVec3(0,1,0), rad_y) *
-    //     rbMtx3().SetFromAxisAngle(rbVec3(1,0,0), rad_x) ;
-
-    state.orientation.SetFromAxisAngle( rbVec3(0,0,1), rad_z );
-
-    rbMtx3 m;
-    m.SetFromAxisAngle( rbVec3(0,1,0), rad_y );
-    state.orientation *= m;
-
-    m.SetFromAxisAngle( rbVec3(1,0,0), rad_x );
-    state.orientation *= m;
-}
-
-void rbRigidBody::AddOrientation( rbReal rad_dx, rbReal rad_dy, rbReal rad_dz )
-{
-    rbMtx3 m, mAdd;
-
-    mAdd.SetFromAxisAngle( rbVec3(0,0,1), rad_dz );
-
-    m.SetFromAxisAngle( rbVec3(0,1,0), rad_dy );
-    mAdd *= m;
-
-    m.SetFromAxisAngle( rbVec3(1,0,0), rad_dx );
-    mAdd *= m;
-
-    state.orientation = mAdd * state.orientation;
-}
-
-
-void rbRigidBody::SetAngularVelocity( rbReal x, rbReal y, rbReal z )
-{
-    state.angular_velocity.Set( x, y, z );
-    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
-}
-
-void rbRigidBody::SetAngularVelocity( const rbVec3& v )
-{
-    state.angular_velocity = v;
-    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
-}
-
-void rbRigidBody::AddAngularVelocity( rbReal dx, rbReal dy, rbReal dz )
-{
-    state.angular_velocity += rbVec3(dx, dy, dz);
-    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
-}
-
-void rbRigidBody::AddAngularVelocity( const rbVec3& dv )
-{
-    state.angular_velocity += dv;
-    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
-}
-
-
-void rbRigidBody::SetForceAt( const rbVec3& v, const rbVec3& at )
-{
-    rbVec3 relative_position = at - state.position;
-    state.torque = relative_position % v;
-}
-
-void rbRigidBody::AddForceAt( const rbVec3& dv, const rbVec3& at )
-{
-    rbVec3 relative_position = at - state.position;
-    state.torque += relative_position % dv;
-}
-
-
-void rbRigidBody::SetShapeParameter(rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff)
-{
-    shape.Set(mass, hx, hy, hz, restitution_coeff, friction_coeff);
-}
-
-
-void rbRigidBody::UpdateInvInertiaWorld()
-{
-    // I^-1 = R * I0^-1 * R^T
-    state.inv_inertia_world = state.orientation * shape.inv_inertia * state.orientation.GetTransposed();
-}
-
-void rbRigidBody::UpdateVelocity( rbReal dt )
-{
-    if ( IsFixed() ) return;
-
-    state.linear_velocity += shape.inv_mass * dt * state.force;
-
-    state.angular_momentum += dt * state.torque;
-    state.angular_velocity = state.inv_inertia_world * state.angular_momentum;
-}
-
-void rbRigidBody::ApplyImpulse( const rbVec3& impulse, const rbVec3& relative_position )
-{
-    if ( IsFixed() ) return;
-
-    //
-    // Ref.: Physics-Based Animation (2005) p.135, Theorem 6.2 (Applying Impulse to a Rigid Body)
-    //
-    // [LANG en] Take J as an impulse vector :
-    // [LANG ja] 力積を J とおくと：
-    // - Δv = J / m
-    // - Δω = I^-1 * (r × J)
-    //
-
-    solver_work_area.delta_linear_velocity += shape.inv_mass * impulse;
-
-    rbVec3 L = relative_position % impulse;
-    solver_work_area.delta_angular_momentum += L;
-    solver_work_area.delta_angular_velocity += state.inv_inertia_world * L;
-}
-
-void rbRigidBody::CorrectVelocity()
-{
-    if ( IsFixed() ) return;
-
-    state.linear_velocity += solver_work_area.delta_linear_velocity;
-
-    state.angular_momentum += solver_work_area.delta_angular_momentum;
-    state.angular_velocity += solver_work_area.delta_angular_velocity;
-}
-
-void rbRigidBody::UpdatePosition( rbReal dt )
-{
-    if ( IsFixed() ) return;
-
-    state.position += dt * state.linear_velocity;
-
-    rbMtx3 rot;
-    rot.SetAsCrossProductMatrix( state.angular_velocity );
-    state.orientation += dt * rot * state.orientation;
-
-    state.orientation.Orthonormalize();
-}
-
-void rbRigidBody::UpdateSleepStatus( rbReal dt )
-{
-    if ( !AttributeEnabled(Attribute_AutoSleep) )
-        return;
-
-    rbReal thresholdLV = state.linear_velocity.Length();
-    rbReal thresholdAV = state.angular_velocity.Length();
-
-    if ( !sleep_status.On && thresholdLV < sleep_status.GoSleepThresholdLV && thresholdAV < sleep_status.GoSleepThresholdAV )
-    {
-        sleep_status.SleepingDuration += dt;
-        if ( sleep_status.SleepingDuration > sleep_status.GoSleepDuration )
-            sleep_status.On = true;
-    }
-    else if ( sleep_status.On &&
-              (thresholdLV > sleep_status.WakeUpThresholdLV || thresholdAV > sleep_status.WakeUpThresholdAV) )
-    {
-        sleep_status.SleepingDuration = 0;
-        sleep_status.On = false;
-    }
-}
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#include <cstring>
+
+#include <RigidBox/rbRigidBody.h>
+#include <RigidBox/rbShapeLibrary.h>
+
+void rbRigidBody::SetOrientation( rbReal rad_x, rbReal rad_y, rbReal rad_z )
+{
+    // state.orientation =
+    //     rbMtx3().SetFromAxisAngle(rbVec3(0,0,1), rad_z) *
+    //     rbMtx3().SetFromAxisAngle(rbVec3(0,1,0), rad_y) *
+    //     rbMtx3().SetFromAxisAngle(rbVec3(1,0,0), rad_x) ;
+
+    state.orientation.SetFromAxisAngle( rbVec3(0,0,1), rad_z );
+
+    rbMtx3 m;
+    m.SetFromAxisAngle( rbVec3(0,1,0), rad_y );
+    state.orientation *= m;
+
+    m.SetFromAxisAngle( rbVec3(1,0,0), rad_x );
+    state.orientation *= m;
+
+    dirty |= Dirty_Orientation;
+    modified = true;
+}
+
+void rbRigidBody::AddOrientation( rbReal rad_dx, rbReal rad_dy, rbReal rad_dz )
+{
+    rbMtx3 m, mAdd;
+
+    mAdd.SetFromAxisAngle( rbVec3(0,0,1), rad_dz );
+
+    m.SetFromAxisAngle( rbVec3(0,1,0), rad_dy );
+    mAdd *= m;
+
+    m.SetFromAxisAngle( rbVec3(1,0,0), rad_dx );
+    mAdd *= m;
+
+    state.orientation = mAdd * state.orientation;
+
+    dirty |= Dirty_Orientation;
+    modified = true;
+}
+
+
+void rbRigidBody::SetAngularVelocity( rbReal x, rbReal y, rbReal z )
+{
+    state.angular_velocity.Set( x, y, z );
+    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
+    modified = true;
+}
+
+void rbRigidBody::SetAngularVelocity( const rbVec3& v )
+{
+    state.angular_velocity = v;
+    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
+    modified = true;
+}
+
+void rbRigidBody::AddAngularVelocity( rbReal dx, rbReal dy, rbReal dz )
+{
+    state.angular_velocity += rbVec3(dx, dy, dz);
+    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
+    modified = true;
+}
+
+void rbRigidBody::AddAngularVelocity( const rbVec3& dv )
+{
+    state.angular_velocity += dv;
+    state.angular_momentum = state.inv_inertia_world * state.angular_velocity;
+    modified = true;
+}
+
+
+void rbRigidBody::SetForceAt( const rbVec3& v, const rbVec3& at )
+{
+    rbVec3 relative_position = at - state.position;
+    accumulator.torque = relative_position % v;
+    modified = true;
+}
+
+void rbRigidBody::AddForceAt( const rbVec3& dv, const rbVec3& at )
+{
+    rbVec3 relative_position = at - state.position;
+    accumulator.torque += relative_position % dv;
+    modified = true;
+}
+
+
+void rbRigidBody::Shape::Set(rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    type = ShapeType_Box;
+    convex_hull = nullptr;
+    half_extent.Set(hx, hy, hz);
+    restitution_coefficient = restitution_coeff;
+    friction_coefficient = friction_coeff;
+
+    inv_mass = rbReal(1) / mass;
+
+    // [LANG en] A box is diagonal in its own frame : no decomposition required.
+    // [LANG ja] 直方体は自身の座標系で対角なので分解は不要。
+    inv_inertia_diagonal.Set(rbReal(3) / (mass * (hy * hy + hz * hz)),
+                             rbReal(3) / (mass * (hx * hx + hz * hz)),
+                             rbReal(3) / (mass * (hx * hx + hy * hy)));
+    principal_axes.SetIdentity();
+    principal_axes_identity = true;
+}
+
+bool rbRigidBody::Shape::Set(rbReal mass, const rbConvexHull* hull, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    if ( hull == nullptr || !hull->Valid() )
+        return false;
+
+    type = ShapeType_ConvexHull;
+    convex_hull = hull;
+    half_extent = hull->HalfExtent();
+    restitution_coefficient = restitution_coeff;
+    friction_coefficient = friction_coeff;
+
+    inv_mass = rbReal(1) / mass;
+    SetInertia(hull->Inertia(mass));
+    return true;
+}
+
+void rbRigidBody::Shape::Set(const rbTriangleMesh* mesh, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    type = ShapeType_TriangleMesh;
+    triangle_mesh = mesh;
+    half_extent = mesh->HalfExtent();
+    restitution_coefficient = restitution_coeff;
+    friction_coefficient = friction_coeff;
+
+    inv_mass = rbReal(0);
+    inv_inertia_diagonal.SetZero();
+    principal_axes.SetIdentity();
+    principal_axes_identity = true;
+}
+
+void rbRigidBody::Shape::Set(const rbHeightField* field, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    type = ShapeType_HeightField;
+    height_field = field;
+    half_extent = field->HalfExtent();
+    restitution_coefficient = restitution_coeff;
+    friction_coefficient = friction_coeff;
+
+    inv_mass = rbReal(0);
+    inv_inertia_diagonal.SetZero();
+    principal_axes.SetIdentity();
+    principal_axes_identity = true;
+}
+
+void rbRigidBody::Shape::Set(const rbCompound* compound_shape, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    type = ShapeType_Compound;
+    compound = compound_shape;
+    half_extent = compound_shape->HalfExtent();
+    restitution_coefficient = restitution_coeff;
+    friction_coefficient = friction_coeff;
+
+    inv_mass = rbReal(1) / compound_shape->Mass();
+    SetInertia(compound_shape->Inertia());
+}
+
+rbMtx3 rbRigidBody::Shape::InvInertia() const
+{
+    const rbMtx3& P = principal_axes;
+    const rbVec3& d = inv_inertia_diagonal;
+    rbMtx3 inv;
+    for ( rbs32 r = 0; r < 3; ++r )
+    {
+        for ( rbs32 c = 0; c < 3; ++c )
+        {
+            inv.Elem(r,c) = d.x * P.Elem(r,0) * P.Elem(c,0) + d.y * P.Elem(r,1) * P.Elem(c,1) + d.z * P.Elem(r,2) * P.Elem(c,2);
+        }
+    }
+    return inv;
+}
+
+void rbRigidBody::Shape::SetInertia( const rbMtx3& inertia )
+{
+    //
+    // Ref.: Numerical Recipes in C (2nd ed.) 11.1 Jacobi Transformations of a Symmetric Matrix
+    //
+    // [LANG en] Cyclic Jacobi sweeps : each rotation zeroes one off-diagonal element; A converges to diag(I0)
+    // [LANG en] and the accumulated rotations V to the principal axes (I = V * diag(I0) * V^T).
+    // [LANG ja] 巡回 Jacobi 法 : 各回転で非対角要素を一つずつ 0 にしていくと、A は diag(I0) に、回転の積 V は
+    // [LANG ja] 主軸に収束します (I = V * diag(I0) * V^T)。
+    //
+    rbMtx3 A = inertia;
+    rbMtx3 V;
+    V.SetIdentity();
+
+    for ( int sweep = 0; sweep < 32; ++sweep )
+    {
+        rbReal off = A.Elem(0,1) * A.Elem(0,1) + A.Elem(0,2) * A.Elem(0,2) + A.Elem(1,2) * A.Elem(1,2);
+        rbReal diag = A.Elem(0,0) * A.Elem(0,0) + A.Elem(1,1) * A.Elem(1,1) + A.Elem(2,2) * A.Elem(2,2);
+        if ( off <= rbReal(1e-24) * diag )
+            break;
+
+        static const rbs32 pairs[3][2] = { {0, 1}, {0, 2}, {1, 2} };
+        for ( int i = 0; i < 3; ++i )
+        {
+            rbs32 p = pairs[i][0], q = pairs[i][1];
+            rbReal apq = A.Elem(p,q);
+            if ( apq == rbReal(0) )
+                continue;
+
+            rbReal theta = (A.Elem(q,q) - A.Elem(p,p)) / (rbReal(2) * apq);
+            rbReal t = rbReal(1) / (rbFabs(theta) + rbSqrt(theta * theta + rbReal(1)));
+            if ( theta < rbReal(0) ) t = -t;
+            rbReal c = rbReal(1) / rbSqrt(t * t + rbReal(1));
+            rbReal s = t * c;
+
+            rbMtx3 J;
+            J.SetIdentity();
+            J.Elem(p,p) = c;  J.Elem(p,q) = s;
+            J.Elem(q,p) = -s; J.Elem(q,q) = c;
+
+            A = J.GetTransposed() * A * J;
+            V = V * J;
+        }
+    }
+
+    inv_inertia_diagonal.Set(A.Elem(0,0) > rbReal(0) ? rbReal(1) / A.Elem(0,0) : rbReal(0),
+                             A.Elem(1,1) > rbReal(0) ? rbReal(1) / A.Elem(1,1) : rbReal(0),
+                             A.Elem(2,2) > rbReal(0) ? rbReal(1) / A.Elem(2,2) : rbReal(0));
+    principal_axes = V;
+    principal_axes_identity = (inertia.Elem(0,1) == rbReal(0) && inertia.Elem(0,2) == rbReal(0) && inertia.Elem(1,2) == rbReal(0));
+}
+
+
+const rbRigidBody::Shape* rbRigidBody::DefaultShape()
+{
+    static const Shape default_shape;
+    return &default_shape;
+}
+
+const rbRigidBody::SleepThresholds* rbRigidBody::DefaultSleepThresholds()
+{
+    static const SleepThresholds default_thresholds;
+    return &default_thresholds;
+}
+
+// [LANG en] Records hold the scalar components only (row-major for matrices), so that their bytes depend on the values
+// [LANG en] alone : neither the padding lane of rbVec3 (RIGIDBOX_USE_SIMD) nor the alignment padding of State is written.
+// [LANG ja] 記録にはスカラーの成分のみを書き込む (行列は行優先)。バイト列は値だけで決まり、rbVec3 の padding レーン
+// [LANG ja] (RIGIDBOX_USE_SIMD) や State のアラインメントのためのパディングは含まれない。
+static const size_t Vec3RecordSize = sizeof(rbReal) * 3;
+static const size_t Mtx3RecordSize = sizeof(rbReal) * 9;
+
+static inline rbu8* PutBytes( rbu8* out, const void* data, size_t size )
+{
+    std::memcpy( out, data, size );
+    return out + size;
+}
+
+static inline const rbu8* GetBytes( const rbu8* in, void* data, size_t size )
+{
+    std::memcpy( data, in, size );
+    return in + size;
+}
+
+static inline rbu8* PutVec3( rbu8* out, const rbVec3& v )
+{
+    const rbReal e[3] = { v.x, v.y, v.z };
+    return PutBytes( out, e, sizeof(e) );
+}
+
+static inline const rbu8* GetVec3( const rbu8* in, rbVec3& v )
+{
+    rbReal e[3];
+    in = GetBytes( in, e, sizeof(e) );
+    v.Set( e[0], e[1], e[2] );
+    return in;
+}
+
+static inline rbu8* PutMtx3( rbu8* out, const rbMtx3& m )
+{
+    const rbReal e[9] = { m.Elem(0,0), m.Elem(0,1), m.Elem(0,2),
+                          m.Elem(1,0), m.Elem(1,1), m.Elem(1,2),
+                          m.Elem(2,0), m.Elem(2,1), m.Elem(2,2) };
+    return PutBytes( out, e, sizeof(e) );
+}
+
+static inline const rbu8* GetMtx3( const rbu8* in, rbMtx3& m )
+{
+    rbReal e[9];
+    in = GetBytes( in, e, sizeof(e) );
+    m.Set( e[0], e[1], e[2],
+           e[3], e[4], e[5],
+           e[6], e[7], e[8] );
+    return in;
+}
+
+rbu32 rbRigidBody::SnapshotSize()
+{
+    return static_cast<rbu32>(
+        Vec3RecordSize * 4 + Mtx3RecordSize * 2 + // state
+        Vec3RecordSize * 2 +            // world_aabb
+        sizeof(rbu32) * 4 +             // attribute, dirty, support_vertex_cache
+        sizeof(rbu8) + sizeof(rbReal) + // sleep_status
+        Vec3RecordSize * 2 +            // accumulator
+        Vec3RecordSize + Mtx3RecordSize + sizeof(rbu8) ); // kinematic_target
+}
+
+void rbRigidBody::SaveSnapshot( void* record_out ) const
+{
+    rbu8* out = static_cast<rbu8*>( record_out );
+    out = PutVec3( out, state.position );
+    out = PutMtx3( out, state.orientation );
+    out = PutVec3( out, state.linear_velocity );
+    out = PutVec3( out, state.angular_velocity );
+    out = PutVec3( out, state.angular_momentum );
+    out = PutMtx3( out, state.inv_inertia_world );
+
+    // [LANG en] The solver work area is scratch data cleared before its next use (see RefreshDerivedData) : not saved
+    // [LANG ja] ソルバーの作業領域は次に使われる前にクリアされる一時データなので保存しない (RefreshDerivedData を参照)
+    const rbu32 saved_dirty = dirty & ~Dirty_SolverWorkArea;
+    out = PutVec3( out, world_aabb.lower );
+    out = PutVec3( out, world_aabb.upper );
+    out = PutBytes( out, &attribute, sizeof(rbu32) );
+    out = PutBytes( out, &saved_dirty, sizeof(rbu32) );
+    out = PutBytes( out, support_vertex_cache, sizeof(support_vertex_cache) );
+    const rbu8 sleeping = sleep_status.On ? 1 : 0;
+    out = PutBytes( out, &sleeping, sizeof(rbu8) );
+    out = PutBytes( out, &sleep_status.SleepingDuration, sizeof(rbReal) );
+
+    out = PutVec3( out, accumulator.force );
+    out = PutVec3( out, accumulator.torque );
+    out = PutVec3( out, kinematic_target.position );
+    out = PutMtx3( out, kinematic_target.orientation );
+    const rbu8 kinematic_enabled = kinematic_target.enabled ? 1 : 0;
+    PutBytes( out, &kinematic_enabled, sizeof(rbu8) );
+}
+
+void rbRigidBody::LoadSnapshot( const void* record )
+{
+    const rbu8* in = static_cast<const rbu8*>( record );
+    in = GetVec3( in, state.position );
+    in = GetMtx3( in, state.orientation );
+    in = GetVec3( in, state.linear_velocity );
+    in = GetVec3( in, state.angular_velocity );
+    in = GetVec3( in, state.angular_momentum );
+    in = GetMtx3( in, state.inv_inertia_world );
+
+    solver_work_area.Clear();
+    in = GetVec3( in, world_aabb.lower );
+    in = GetVec3( in, world_aabb.upper );
+    in = GetBytes( in, &attribute, sizeof(rbu32) );
+    in = GetBytes( in, &dirty, sizeof(rbu32) );
+    in = GetBytes( in, support_vertex_cache, sizeof(support_vertex_cache) );
+    rbu8 sleeping;
+    in = GetBytes( in, &sleeping, sizeof(rbu8) );
+    sleep_status.On = sleeping != 0;
+    in = GetBytes( in, &sleep_status.SleepingDuration, sizeof(rbReal) );
+
+    in = GetVec3( in, accumulator.force );
+    in = GetVec3( in, accumulator.torque );
+    in = GetVec3( in, kinematic_target.position );
+    in = GetMtx3( in, kinematic_target.orientation );
+    rbu8 kinematic_enabled;
+    GetBytes( in, &kinematic_enabled, sizeof(rbu8) );
+    kinematic_target.enabled = kinematic_enabled != 0;
+    modified = true;
+}
+
+void rbRigidBody::SaveState( void* record_out ) const
+{
+    rbu8* out = static_cast<rbu8*>( record_out );
+    out = PutVec3( out, state.position );
+    out = PutMtx3( out, state.orientation );
+    out = PutVec3( out, state.linear_velocity );
+    out = PutVec3( out, state.angular_velocity );
+    out = PutVec3( out, state.angular_momentum );
+
+    const rbu8 sleeping = sleep_status.On ? 1 : 0;
+    out = PutBytes( out, &sleeping, sizeof(rbu8) );
+    out = PutBytes( out, &sleep_status.SleepingDuration, sizeof(rbReal) );
+
+    out = PutVec3( out, accumulator.force );
+    out = PutVec3( out, accumulator.torque );
+    out = PutVec3( out, kinematic_target.position );
+    out = PutMtx3( out, kinematic_target.orientation );
+    const rbu8 kinematic_enabled = kinematic_target.enabled ? 1 : 0;
+    PutBytes( out, &kinematic_enabled, sizeof(rbu8) );
+}
+
+void rbRigidBody::SetShape( const Shape* shared_shape )
+{
+    shape = shared_shape;
+    support_vertex_cache[0] = support_vertex_cache[1] = 0;
+    dirty |= Dirty_Orientation;
+    modified = true;
+    if ( shape->type == ShapeType_TriangleMesh || shape->type == ShapeType_HeightField )
+        EnableAttribute(Attribute_Fixed);
+}
+
+void rbRigidBody::SetShapeParameter(rbShapeLibrary& library, rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    SetShape( library.GetShape( library.AddBox(mass, hx, hy, hz, restitution_coeff, friction_coeff) ) );
+}
+
+bool rbRigidBody::SetShapeParameter(rbShapeLibrary& library, rbReal mass, const rbConvexHull* hull, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    rbu32 index = library.AddConvexHull( mass, hull, restitution_coeff, friction_coeff );
+    if ( index == rbShapeLibrary::InvalidIndex )
+        return false;
+
+    SetShape( library.GetShape(index) );
+    return true;
+}
+
+void rbRigidBody::SetShapeParameter(rbShapeLibrary& library, const rbTriangleMesh* mesh, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    SetShape( library.GetShape( library.AddTriangleMesh(mesh, restitution_coeff, friction_coeff) ) );
+}
+
+void rbRigidBody::SetShapeParameter(rbShapeLibrary& library, const rbHeightField* field, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    SetShape( library.GetShape( library.AddHeightField(field, restitution_coeff, friction_coeff) ) );
+}
+
+void rbRigidBody::SetShapeParameter(rbShapeLibrary& library, const rbCompound* compound, rbReal restitution_coeff, rbReal friction_coeff)
+{
+    SetShape( library.GetShape( library.AddCompound(compound, restitution_coeff, friction_coeff) ) );
+}
+
+const rbAABB& rbRigidBody::WorldAABB()
+{
+    if ( dirty & Dirty_WorldAABB )
+    {
+        world_aabb = ComputeWorldAABB();
+        dirty &= ~Dirty_WorldAABB;
+    }
+    return world_aabb;
+}
+
+rbAABB rbRigidBody::ComputeWorldAABB() const
+{
+    const rbMtx3& R = state.orientation;
+    const rbVec3& h = shape->half_extent;
+    rbVec3 extent( rbFabs(R.Elem(0,0)) * h.x + rbFabs(R.Elem(0,1)) * h.y + rbFabs(R.Elem(0,2)) * h.z,
+                   rbFabs(R.Elem(1,0)) * h.x + rbFabs(R.Elem(1,1)) * h.y + rbFabs(R.Elem(1,2)) * h.z,
+                   rbFabs(R.Elem(2,0)) * h.x + rbFabs(R.Elem(2,1)) * h.y + rbFabs(R.Elem(2,2)) * h.z );
+    return rbAABB( state.position - extent, state.position + extent );
+}
+
+
+void rbRigidBody::UpdateInvInertiaWorld()
+{
+    //
+    // I^-1 = M * D * M^T, M = R * P (P : principal axes, D : diagonal of I0^-1)
+    //
+    // [LANG en] (M * D * M^T)(r,c) = sum_k d_k * M(r,k) * M(c,k) : 18 multiplies for the symmetric half instead
+    // [LANG en] of two full 3x3 products. Boxes skip the R * P product.
+    // [LANG ja] (M * D * M^T)(r,c) = sum_k d_k * M(r,k) * M(c,k) : 3x3 行列の積を二回行う代わりに、対称な半分を
+    // [LANG ja] 18 回の乗算で求めます。直方体では R * P の積も省略します。
+    //
+    const rbVec3& d = shape->inv_inertia_diagonal;
+    rbMtx3 M = shape->principal_axes_identity ? state.orientation : state.orientation * shape->principal_axes;
+    rbMtx3& inv = state.inv_inertia_world;
+    for ( rbs32 r = 0; r < 3; ++r )
+    {
+        rbVec3 a( d.x * M.Elem(r,0), d.y * M.Elem(r,1), d.z * M.Elem(r,2) );
+        for ( rbs32 c = r; c < 3; ++c )
+        {
+            inv.Elem(r,c) = a.x * M.Elem(c,0) + a.y * M.Elem(c,1) + a.z * M.Elem(c,2);
+            inv.Elem(c,r) = inv.Elem(r,c);
+        }
+    }
+
+    dirty &= ~Dirty_InvInertiaWorld;
+}
+
+void rbRigidBody::UpdateVelocity( rbReal dt )
+{
+    if ( IsFixed() || IsKinematic() ) return;
+
+    state.linear_velocity += shape->inv_mass * dt * accumulator.force;
+
+    state.angular_momentum += dt * accumulator.torque;
+    state.angular_velocity = state.inv_inertia_world * state.angular_momentum;
+}
+
+void rbRigidBody::ApplyImpulse( const rbVec3& impulse, const rbVec3& relative_position )
+{
+    if ( IsFixed() || IsKinematic() ) return;
+
+    //
+    // Ref.: Physics-Based Animation (2005) p.135, Theorem 6.2 (Applying Impulse to a Rigid Body)
+    //
+    // [LANG en] Take J as an impulse vector :
+    // [LANG ja] 力積を J とおくと：
+    // - Δv = J / m
+    // - Δω = I^-1 * (r × J)
+    //
+
+    solver_work_area.delta_linear_velocity += shape->inv_mass * impulse;
+    dirty |= Dirty_SolverWorkArea;
+
+    rbVec3 L = relative_position % impulse;
+    solver_work_area.delta_angular_momentum += L;
+    solver_work_area.delta_angular_velocity += state.inv_inertia_world * L;
+}
+
+void rbRigidBody::CorrectVelocity()
+{
+    if ( IsFixed() || IsKinematic() ) return;
+
+    state.linear_velocity += solver_work_area.delta_linear_velocity;
+
+    state.angular_momentum += solver_work_area.delta_angular_momentum;
+    state.angular_velocity += solver_work_area.delta_angular_velocity;
+}
+
+void rbRigidBody::UpdatePosition( rbReal dt )
+{
+    if ( IsFixed() ) return;
+
+    // [LANG en] Resting (and sleeping) bodies keep their pose and all the data derived from it
+    // [LANG ja] 静止している (スリープ中の) 剛体は姿勢もそこから求めたデータも変わらない
+    const rbVec3& v = state.linear_velocity;
+    const rbVec3& w = state.angular_velocity;
+    if ( v.x == 0 && v.y == 0 && v.z == 0 && w.x == 0 && w.y == 0 && w.z == 0 )
+        return;
+    dirty |= Dirty_Orientation;
+
+    state.position += dt * state.linear_velocity;
+
+    rbMtx3 rot;
+    rot.SetAsCrossProductMatrix( state.angular_velocity );
+    state.orientation += dt * rot * state.orientation;
+
+    state.orientation.Orthonormalize();
+}
+
+void rbRigidBody::UpdateKinematicVelocity( rbReal dt )
+{
+    if ( !IsKinematic() || !kinematic_target.enabled || dt <= 0 )
+        return;
+
+    state.linear_velocity = (kinematic_target.position - state.position) / dt;
+
+    // [LANG en] Axis-angle of the rotation R_target * R^T, from its trace and its antisymmetric part
+    // [LANG ja] 回転 R_target * R^T の軸と角度 (トレースと反対称部分から求める)
+    const rbMtx3 delta = kinematic_target.orientation * state.orientation.GetTransposed();
+    const rbVec3 axis( delta.Elem(2,1) - delta.Elem(1,2),
+                       delta.Elem(0,2) - delta.Elem(2,0),
+                       delta.Elem(1,0) - delta.Elem(0,1) );
+    const rbReal sin_angle = rbReal(0.5) * axis.Length();
+    const rbReal cos_angle = rbReal(0.5) * (delta.Elem(0,0) + delta.Elem(1,1) + delta.Elem(2,2) - 1);
+    const rbReal angle = rbAtan2( sin_angle, cos_angle );
+
+    if ( sin_angle > RIGIDBOX_TOLERANCE )
+        state.angular_velocity = (angle / (2 * sin_angle * dt)) * axis;
+    else
+        state.angular_velocity.SetZero();
+}
+
+void rbRigidBody::FinishKinematicMotion()
+{
+    if ( !IsKinematic() || !kinematic_target.enabled )
+        return;
+
+    state.position = kinematic_target.position;
+    state.orientation = kinematic_target.orientation;
+    dirty |= Dirty_Orientation;
+}
+
+void rbRigidBody::UpdateSleepStatus( rbReal dt )
+{
+    if ( !AttributeEnabled(Attribute_AutoSleep) || IsKinematic() )
+        return;
+
+    rbReal thresholdLV = state.linear_velocity.Length();
+    rbReal thresholdAV = state.angular_velocity.Length();
+
+    const SleepThresholds& thresholds = *sleep_thresholds;
+    if ( !sleep_status.On && thresholdLV < thresholds.GoSleepThresholdLV && thresholdAV < thresholds.GoSleepThresholdAV )
+    {
+        sleep_status.SleepingDuration += dt;
+        if ( sleep_status.SleepingDuration > thresholds.GoSleepDuration )
+            sleep_status.On = true;
+    }
+    else if ( sleep_status.On &&
+              (thresholdLV > thresholds.WakeUpThresholdLV || thresholdAV > thresholds.WakeUpThresholdAV) )
+    {
+        sleep_status.SleepingDuration = 0;
+        sleep_status.On = false;
+    }
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
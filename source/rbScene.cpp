@@ -0,0 +1,261 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#include <RigidBox/rbEnvironment.h>
+#include <RigidBox/rbMappedFile.h>
+#include <RigidBox/rbScene.h>
+
+const rbu32 rbScene::Magic;
+const rbu32 rbScene::Version;
+const rbu32 rbScene::Alignment;
+const rbu32 rbScene::DefaultSleepThresholds;
+
+rbScene::rbScene()
+    : shapes()
+    , sleep_thresholds()
+    , bodies()
+    , sweep_order()
+{}
+
+void rbScene::ComputeLayout( Header& header )
+{
+    auto align = []( rbu64 offset ) { return (offset + Alignment - 1) / Alignment * Alignment; };
+
+    header.ShapeOffset = align( sizeof(Header) );
+    header.SleepThresholdsOffset = align( header.ShapeOffset + rbu64(header.ShapeCount) * sizeof(ShapeRecord) );
+    header.BodyConfigOffset = align( header.SleepThresholdsOffset + rbu64(header.SleepThresholdsCount) * sizeof(rbRigidBody::SleepThresholds) );
+    header.BodyRecordOffset = align( header.BodyConfigOffset + rbu64(header.BodyCount) * sizeof(BodyConfig) );
+    header.SweepOrderOffset = align( header.BodyRecordOffset + rbu64(header.BodyCount) * header.BodyRecordSize );
+    header.FileSize = header.SweepOrderOffset + rbu64(header.BodyCount) * sizeof(rbu32);
+}
+
+bool rbScene::Save( const char* path, const std::vector<rbRigidBody*>& bodies )
+{
+    const rbu32 body_count = static_cast<rbu32>( bodies.size() );
+    const rbu32 record_size = rbRigidBody::SnapshotSize();
+
+    std::vector<ShapeRecord> shape_records;
+    std::vector<rbRigidBody::SleepThresholds> thresholds_records;
+    std::map<const rbRigidBody::Shape*, rbu32> shape_index;
+    std::map<const rbRigidBody::SleepThresholds*, rbu32> thresholds_index;
+    std::vector<BodyConfig> configs( body_count );
+    std::vector<rbReal> lower_x( body_count );
+
+    for ( rbu32 i = 0; i < body_count; ++i )
+    {
+        rbRigidBody* body = bodies[i];
+        const rbRigidBody::Shape* shape = body->GetShape();
+        if ( shape->type != rbRigidBody::ShapeType_Box )
+            return false;
+
+        auto shape_it = shape_index.find( shape );
+        if ( shape_it == shape_index.end() )
+        {
+            const ShapeRecord record = {
+                { shape->half_extent.x, shape->half_extent.y, shape->half_extent.z },
+                shape->inv_mass,
+                { shape->inv_inertia_diagonal.x, shape->inv_inertia_diagonal.y, shape->inv_inertia_diagonal.z },
+                shape->restitution_coefficient,
+                shape->friction_coefficient
+            };
+            shape_it = shape_index.insert( std::make_pair(shape, static_cast<rbu32>(shape_records.size())) ).first;
+            shape_records.push_back( record );
+        }
+
+        rbu32 thresholds = DefaultSleepThresholds;
+        const rbRigidBody::SleepThresholds* body_thresholds = body->GetSleepThresholds();
+        if ( body_thresholds != rbRigidBody::DefaultSleepThresholds() )
+        {
+            auto thresholds_it = thresholds_index.find( body_thresholds );
+            if ( thresholds_it == thresholds_index.end() )
+            {
+                thresholds_it = thresholds_index.insert( std::make_pair(body_thresholds, static_cast<rbu32>(thresholds_records.size())) ).first;
+                thresholds_records.push_back( *body_thresholds );
+            }
+            thresholds = thresholds_it->second;
+        }
+
+        configs[i].Shape = shape_it->second;
+        configs[i].SleepThresholds = thresholds;
+        configs[i].CollisionGroup = body->CollisionGroup();
+        configs[i].CollisionMask = body->CollisionMask();
+
+        // [LANG en] Also brings the cached AABB up to date before the record is taken
+        // [LANG ja] 記録を取る前に AABB のキャッシュも最新にする
+        lower_x[i] = body->WorldAABB().lower.x;
+    }
+
+    Header header;
+    header.Magic = Magic;
+    header.Version = Version;
+    header.RealSize = sizeof(rbReal);
+    header.BodyRecordSize = record_size;
+    header.BodyCount = body_count;
+    header.ShapeCount = static_cast<rbu32>( shape_records.size() );
+    header.SleepThresholdsCount = static_cast<rbu32>( thresholds_records.size() );
+    header.Reserved = 0;
+    ComputeLayout( header );
+
+    std::vector<rbu8> bytes( static_cast<size_t>(header.FileSize), 0 );
+    std::memcpy( bytes.data(), &header, sizeof(header) );
+    if ( !shape_records.empty() )
+        std::memcpy( &bytes[header.ShapeOffset], shape_records.data(), shape_records.size() * sizeof(ShapeRecord) );
+    if ( !thresholds_records.empty() )
+        std::memcpy( &bytes[header.SleepThresholdsOffset], thresholds_records.data(),
+                     thresholds_records.size() * sizeof(rbRigidBody::SleepThresholds) );
+    if ( body_count > 0 )
+    {
+        std::memcpy( &bytes[header.BodyConfigOffset], configs.data(), configs.size() * sizeof(BodyConfig) );
+        for ( rbu32 i = 0; i < body_count; ++i )
+            bodies[i]->SaveSnapshot( &bytes[header.BodyRecordOffset + rbu64(i) * record_size] );
+
+        // [LANG en] Same order as rbBroadPhase builds : by lower x-bound, ties by index
+        // [LANG ja] rbBroadPhase が構築するのと同じ並び順 : x 方向の下限の順、同じ値は番号順
+        std::vector<rbu32> order( body_count );
+        for ( rbu32 i = 0; i < body_count; ++i )
+            order[i] = i;
+        std::sort( order.begin(), order.end(),
+            [&lower_x](rbu32 a, rbu32 b) { return lower_x[a] != lower_x[b] ? lower_x[a] < lower_x[b] : a < b; } );
+        std::memcpy( &bytes[header.SweepOrderOffset], order.data(), order.size() * sizeof(rbu32) );
+    }
+
+    std::FILE* file = std::fopen( path, "wb" );
+    if ( file == nullptr )
+        return false;
+    bool succeeded = std::fwrite( bytes.data(), 1, bytes.size(), file ) == bytes.size();
+    if ( std::fclose(file) != 0 )
+        succeeded = false;
+    return succeeded;
+}
+
+bool rbScene::Load( const char* path )
+{
+    Clear();
+
+    rbMappedFile file;
+    if ( !file.Open(path) || file.Size() < sizeof(Header) )
+        return false;
+    const rbu8* data = file.Data();
+
+    // [LANG en] The layout is fully determined by the counts, so every offset must match the computed one
+    // [LANG ja] レイアウトは個数だけで決まるので、全ての位置が計算したものと一致しなければならない
+    Header header;
+    std::memcpy( &header, data, sizeof(header) );
+    Header expected = header;
+    ComputeLayout( expected );
+    if ( header.Magic != Magic || header.Version != Version ||
+         header.RealSize != sizeof(rbReal) || header.BodyRecordSize != rbRigidBody::SnapshotSize() ||
+         std::memcmp(&header, &expected, sizeof(header)) != 0 || header.FileSize != file.Size() )
+        return false;
+
+    const rbu32 body_count = header.BodyCount;
+    std::vector<BodyConfig> configs( body_count );
+    if ( body_count > 0 )
+    {
+        std::memcpy( configs.data(), data + header.BodyConfigOffset, configs.size() * sizeof(BodyConfig) );
+        sweep_order.resize( body_count );
+        std::memcpy( sweep_order.data(), data + header.SweepOrderOffset, sweep_order.size() * sizeof(rbu32) );
+    }
+
+    bool valid = true;
+    for ( const BodyConfig& config : configs )
+    {
+        valid = valid && config.Shape < header.ShapeCount &&
+            (config.SleepThresholds < header.SleepThresholdsCount || config.SleepThresholds == DefaultSleepThresholds);
+    }
+    std::vector<rbu8> seen( body_count, 0 );
+    for ( rbu32 index : sweep_order )
+    {
+        valid = valid && index < body_count && seen[index] == 0;
+        if ( valid )
+            seen[index] = 1;
+    }
+    if ( !valid )
+    {
+        Clear();
+        return false;
+    }
+
+    shapes.resize( header.ShapeCount );
+    for ( rbu32 i = 0; i < header.ShapeCount; ++i )
+    {
+        ShapeRecord record;
+        std::memcpy( &record, data + header.ShapeOffset + rbu64(i) * sizeof(ShapeRecord), sizeof(record) );
+        rbRigidBody::Shape& shape = shapes[i];
+        shape.type = rbRigidBody::ShapeType_Box;
+        shape.convex_hull = nullptr;
+        shape.half_extent.Set( record.HalfExtent[0], record.HalfExtent[1], record.HalfExtent[2] );
+        shape.inv_mass = record.InvMass;
+        shape.inv_inertia_diagonal.Set( record.InvInertiaDiagonal[0], record.InvInertiaDiagonal[1], record.InvInertiaDiagonal[2] );
+        shape.principal_axes.SetIdentity();
+        shape.principal_axes_identity = true;
+        shape.restitution_coefficient = record.Restitution;
+        shape.friction_coefficient = record.Friction;
+    }
+
+    sleep_thresholds.resize( header.SleepThresholdsCount );
+    if ( !sleep_thresholds.empty() )
+        std::memcpy( sleep_thresholds.data(), data + header.SleepThresholdsOffset,
+                     sleep_thresholds.size() * sizeof(rbRigidBody::SleepThresholds) );
+
+    // [LANG en] One allocation for all bodies. The records restore the state and the derived data as they were saved.
+    // [LANG ja] 全剛体を1回の確保で生成する。記録は状態と派生データを保存時のとおりに復元する。
+    bodies.resize( body_count );
+    const rbu8* record = data + header.BodyRecordOffset;
+    for ( rbu32 i = 0; i < body_count; ++i )
+    {
+        rbRigidBody& body = bodies[i];
+        const BodyConfig& config = configs[i];
+        body.SetShape( &shapes[config.Shape] );
+        body.SetSleepThresholds( config.SleepThresholds == DefaultSleepThresholds ?
+                                 rbRigidBody::DefaultSleepThresholds() : &sleep_thresholds[config.SleepThresholds] );
+        body.SetCollisionFilter( config.CollisionGroup, config.CollisionMask );
+        body.LoadSnapshot( record );
+        record += header.BodyRecordSize;
+    }
+
+    return true;
+}
+
+void rbScene::Clear()
+{
+    bodies.clear();
+    shapes.clear();
+    sleep_thresholds.clear();
+    sweep_order.clear();
+}
+
+bool rbScene::Register( rbEnvironment& env )
+{
+    return env.Register( bodies.data(), BodyCount(), sweep_order.empty() ? nullptr : sweep_order.data() );
+}
+
+bool rbScene::Unregister( rbEnvironment& env )
+{
+    return env.Unregister( bodies.data(), BodyCount() );
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,106 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <algorithm>
+#include <functional>
+
+#include <RigidBox/rbShapeLibrary.h>
+
+rbShapeLibrary::rbShapeLibrary()
+    : shapes()
+    , index_of()
+{}
+
+rbu32 rbShapeLibrary::AddBox( rbReal mass, rbReal hx, rbReal hy, rbReal hz, rbReal restitution_coeff, rbReal friction_coeff )
+{
+    rbRigidBody::Shape shape;
+    shape.Set( mass, hx, hy, hz, restitution_coeff, friction_coeff );
+    return Add( shape );
+}
+
+rbu32 rbShapeLibrary::AddConvexHull( rbReal mass, const rbConvexHull* hull, rbReal restitution_coeff, rbReal friction_coeff )
+{
+    rbRigidBody::Shape shape;
+    if ( !shape.Set(mass, hull, restitution_coeff, friction_coeff) )
+        return InvalidIndex;
+    return Add( shape );
+}
+
+rbu32 rbShapeLibrary::AddTriangleMesh( const rbTriangleMesh* mesh, rbReal restitution_coeff, rbReal friction_coeff )
+{
+    rbRigidBody::Shape shape;
+    shape.Set( mesh, restitution_coeff, friction_coeff );
+    return Add( shape );
+}
+
+rbu32 rbShapeLibrary::AddHeightField( const rbHeightField* field, rbReal restitution_coeff, rbReal friction_coeff )
+{
+    rbRigidBody::Shape shape;
+    shape.Set( field, restitution_coeff, friction_coeff );
+    return Add( shape );
+}
+
+rbu32 rbShapeLibrary::AddCompound( const rbCompound* compound, rbReal restitution_coeff, rbReal friction_coeff )
+{
+    rbRigidBody::Shape shape;
+    shape.Set( compound, restitution_coeff, friction_coeff );
+    return Add( shape );
+}
+
+rbu32 rbShapeLibrary::Add( const rbRigidBody::Shape& shape )
+{
+    std::map<const rbRigidBody::Shape*, rbu32, ShapeLess>::const_iterator it = index_of.find( &shape );
+    if ( it != index_of.end() )
+        return it->second;
+
+    rbu32 index = Count();
+    shapes.push_back( shape );
+    index_of.insert( std::make_pair( &shapes.back(), index ) );
+    return index;
+}
+
+bool rbShapeLibrary::ShapeLess::operator()( const rbRigidBody::Shape* a, const rbRigidBody::Shape* b ) const
+{
+    if ( a->type != b->type ) return a->type < b->type;
+    if ( a->convex_hull != b->convex_hull ) return std::less<const rbConvexHull*>()( a->convex_hull, b->convex_hull );
+    if ( a->principal_axes_identity != b->principal_axes_identity ) return b->principal_axes_identity;
+
+    const rbReal values_a[] = {
+        a->inv_mass, a->restitution_coefficient, a->friction_coefficient,
+        a->half_extent.x, a->half_extent.y, a->half_extent.z,
+        a->inv_inertia_diagonal.x, a->inv_inertia_diagonal.y, a->inv_inertia_diagonal.z,
+        a->principal_axes.Elem(0,0), a->principal_axes.Elem(0,1), a->principal_axes.Elem(0,2),
+        a->principal_axes.Elem(1,0), a->principal_axes.Elem(1,1), a->principal_axes.Elem(1,2),
+        a->principal_axes.Elem(2,0), a->principal_axes.Elem(2,1), a->principal_axes.Elem(2,2),
+    };
+    const rbReal values_b[] = {
+        b->inv_mass, b->restitution_coefficient, b->friction_coefficient,
+        b->half_extent.x, b->half_extent.y, b->half_extent.z,
+        b->inv_inertia_diagonal.x, b->inv_inertia_diagonal.y, b->inv_inertia_diagonal.z,
+        b->principal_axes.Elem(0,0), b->principal_axes.Elem(0,1), b->principal_axes.Elem(0,2),
+        b->principal_axes.Elem(1,0), b->principal_axes.Elem(1,1), b->principal_axes.Elem(1,2),
+        b->principal_axes.Elem(2,0), b->principal_axes.Elem(2,1), b->principal_axes.Elem(2,2),
+    };
+    return std::lexicographical_compare( values_a, values_a + sizeof(values_a) / sizeof(values_a[0]),
+                                         values_b, values_b + sizeof(values_b) / sizeof(values_b[0]) );
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,69 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <cstring>
+
+#include <RigidBox/rbRigidBody.h>
+#include <RigidBox/rbSnapshot.h>
+
+const rbu32 rbSnapshot::Magic;
+const rbu32 rbSnapshot::Version;
+
+rbSnapshot::rbSnapshot()
+    : buffer()
+    , body_indices()
+{}
+
+rbSnapshot::Header rbSnapshot::GetHeader() const
+{
+    Header header;
+    std::memcpy( &header, buffer.data(), sizeof(Header) );
+    return header;
+}
+
+size_t rbSnapshot::ComputeSize( const Header& header )
+{
+    return sizeof(Header) +
+        size_t(header.BodyCount) * header.BodyRecordSize +
+        size_t(header.ContactCount) * sizeof(ContactRecord) +
+        size_t(header.TouchingPairCount) * sizeof(TouchingPairRecord) +
+        size_t(header.SensorPairCount) * sizeof(SensorPairRecord);
+}
+
+bool rbSnapshot::Assign( const void* data, size_t size )
+{
+    buffer.clear();
+    if ( data == nullptr || size < sizeof(Header) )
+        return false;
+
+    Header header;
+    std::memcpy( &header, data, sizeof(Header) );
+    if ( header.Magic != Magic || header.Version != Version ||
+         header.RealSize != sizeof(rbReal) || header.BodyRecordSize != rbRigidBody::SnapshotSize() ||
+         ComputeSize(header) != size )
+        return false;
+
+    const rbu8* bytes = static_cast<const rbu8*>( data );
+    buffer.assign( bytes, bytes + size );
+    return true;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -1,83 +1,122 @@
-// -*- mode: C++; coding: utf-8; -*-
-#include <RigidBox/rbCollision.h>
-#include <RigidBox/rbMath.h>
-#include <RigidBox/rbRigidBody.h>
-#include <RigidBox/rbSolver.h>
-
-void rbSolver::ApplyImpulse( rbContact* c, rbReal dt )
-{
-    rbVec3 relative_velocity =
-         c->Body[0]->LinearVelocity() + (c->Body[0]->AngularVelocity() % c->RelativeBodyPosition[0])
-      - (c->Body[1]->LinearVelocity() + (c->Body[1]->AngularVelocity() % c->RelativeBodyPosition[1]));
-
-    rbReal impulse_magnitude;
-    rbVec3 impulse;
-
-    // [LANG en] Apply impulse generated from collision
-    // [LANG ja] 衝突による速度変化を表すインパルスを剛体に適用
-    {
-        rbReal K[2] = {
-            c->Body[0]->InvMass() + (c->Body[0]->InvInertiaWorld() * ((c->RelativeBodyPosition[0] % c->Normal) % c->RelativeBodyPosition[0])) * c->Normal,
-            c->Body[1]->InvMass() + (c->Body[1]->InvInertiaWorld() * ((c->RelativeBodyPosition[1] % c->Normal) % c->RelativeBodyPosition[1])) * c->Normal,
-        };
-        rbReal e = c->Body[0]->Restitution() * c->Body[1]->Restitution();
-
-        impulse_magnitude = -(1 + e) * (relative_velocity * c->Normal);
-        impulse_magnitude += bias_factor * rbMax(c->PenetrationDepth-rbReal(0), 0) / dt;
-        impulse_magnitude /= K[0] + K[1];
-    }
-
-    impulse = impulse_magnitude * c->Normal;
-    c->Body[0]->ApplyImpulse(  impulse, c->RelativeBodyPosition[0] );
-    c->Body[1]->ApplyImpulse( -impulse, c->RelativeBodyPosition[1] );
-
-    // [LANG en] Calculate slowdown by friction as impulse
-    // [LANG ja] 摩擦による減速もインパルスとして表現し剛体に適用
-    rbVec3 tangent = c->Normal % (c->Normal % relative_velocity);
-    {
-        rbReal tangent_length = tangent.Length();
-        if ( tangent_length > RIGIDBOX_TOLERANCE )
-            tangent /= tangent_length;
-        else
-            tangent.SetZero();
-    }
-
-    {
-        rbReal K[2] = {
-            c->Body[0]->InvMass() + (c->Body[0]->InvInertiaWorld() * ((c->RelativeBodyPosition[0] % tangent) % c->RelativeBodyPosition[0])) * tangent,
-            c->Body[1]->InvMass() + (c->Body[1]->InvInertiaWorld() * ((c->RelativeBodyPosition[1] % tangent) % c->RelativeBodyPosition[1])) * tangent,
-        };
-
-        if ( K[0] + K[1] > RIGIDBOX_TOLERANCE )
-            impulse_magnitude = rbReal(1) / (K[0] + K[1]);
-        else
-            impulse_magnitude = rbReal(0);
-    }
-
-    rbReal coeff = rbMin( rbMax(rbFabs(tangent*relative_velocity), rbReal(0.0)), c->Body[0]->Friction()*c->Body[1]->Friction() );
-    impulse = coeff * impulse_magnitude * tangent;
-    c->Body[0]->ApplyImpulse(  impulse, c->RelativeBodyPosition[0] );
-    c->Body[1]->ApplyImpulse( -impulse, c->RelativeBodyPosition[1] );
-}
-
-// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
-// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
-//
-// This software is provided 'as-is', without any express or implied
-// warranty. In no event will the authors be held liable for any damages
-// arising from the use of this software.
-//
-// Permission is granted to anyone to use this software for any purpose,
-// including commercial applications, and to alter it and redistribute it
-// freely, subject to the following restrictions:
-//
-//     1. The origin of this software must not be misrepresented; you must not
-//     claim that you wrote the original software. If you use this software
-//     in a product, an acknowledgment in the product documentation would be
-//     appreciated but is not required.
-//
-//     2. Altered source versions must be plainly marked as such, and must not be
-//     misrepresented as being the original software.
-//
-//     3. This notice may not be removed or altered from any source
-//     distribution.
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbCollision.h>
+#include <RigidBox/rbMath.h>
+#include <RigidBox/rbRigidBody.h>
+#include <RigidBox/rbSolver.h>
+
+// [LANG en] Inverse of the mass felt along +n+ at +r+. Kinematic bodies have infinite mass in the solver.
+// [LANG ja] +r+ の位置で +n+ 方向に感じる質量の逆数。キネマティックな剛体はソルバーでは質量無限大として扱う。
+static inline rbReal InvEffectiveMass( rbRigidBody* body, const rbVec3& r, const rbVec3& n )
+{
+    if ( body->IsKinematic() )
+        return 0;
+
+    return body->InvMass() + (body->InvInertiaWorld() * ((r % n) % r)) * n;
+}
+
+rbReal rbSolver::ApplyImpulse( rbContact* c, rbReal dt )
+{
+    rbVec3 relative_velocity =
+         c->Body[0]->LinearVelocity() + (c->Body[0]->AngularVelocity() % c->RelativeBodyPosition[0])
+      - (c->Body[1]->LinearVelocity() + (c->Body[1]->AngularVelocity() % c->RelativeBodyPosition[1]));
+
+    rbReal impulse_magnitude;
+    rbVec3 impulse;
+
+    // [LANG en] Speculative contact : the bodies may still close the gap during this step. Only the approaching velocity
+    // [LANG en] beyond gap / dt is removed (no restitution, no friction, no bias), so the contact never pulls the bodies.
+    // [LANG ja] 予測的な衝突点 : このステップの間に隙間を詰めるまでの接近は許す。gap / dt を超える接近速度のみを
+    // [LANG ja] 取り除く (反発・摩擦・バイアスなし)。したがって剛体同士を引き寄せることはない。
+    if ( c->PenetrationDepth < 0 )
+    {
+        rbReal approach = relative_velocity * c->Normal - c->PenetrationDepth / dt;
+        if ( approach >= 0 )
+            return 0;
+
+        // [LANG en] Fixed bodies do not move, so they take no share of the impulse
+        // [LANG ja] 固定物体は動かないので力積を分担しない
+        rbReal K[2] = {
+            c->Body[0]->IsFixed() ? rbReal(0) : InvEffectiveMass( c->Body[0], c->RelativeBodyPosition[0], c->Normal ),
+            c->Body[1]->IsFixed() ? rbReal(0) : InvEffectiveMass( c->Body[1], c->RelativeBodyPosition[1], c->Normal ),
+        };
+        if ( K[0] + K[1] <= RIGIDBOX_TOLERANCE )
+            return 0;
+
+        impulse_magnitude = -approach / (K[0] + K[1]);
+        impulse = impulse_magnitude * c->Normal;
+        c->Body[0]->ApplyImpulse(  impulse, c->RelativeBodyPosition[0] );
+        c->Body[1]->ApplyImpulse( -impulse, c->RelativeBodyPosition[1] );
+        return impulse_magnitude;
+    }
+
+    // [LANG en] Apply impulse generated from collision
+    // [LANG ja] 衝突による速度変化を表すインパルスを剛体に適用
+    {
+        rbReal K[2] = {
+            InvEffectiveMass( c->Body[0], c->RelativeBodyPosition[0], c->Normal ),
+            InvEffectiveMass( c->Body[1], c->RelativeBodyPosition[1], c->Normal ),
+        };
+        rbReal e = c->Body[0]->Restitution() * c->Body[1]->Restitution();
+
+        impulse_magnitude = -(1 + e) * (relative_velocity * c->Normal);
+        impulse_magnitude += bias_factor * rbMax(c->PenetrationDepth-rbReal(0), 0) / dt;
+        impulse_magnitude /= K[0] + K[1];
+    }
+
+    impulse = impulse_magnitude * c->Normal;
+    c->Body[0]->ApplyImpulse(  impulse, c->RelativeBodyPosition[0] );
+    c->Body[1]->ApplyImpulse( -impulse, c->RelativeBodyPosition[1] );
+    const rbReal normal_impulse = impulse_magnitude;
+
+    // [LANG en] Calculate slowdown by friction as impulse
+    // [LANG ja] 摩擦による減速もインパルスとして表現し剛体に適用
+    rbVec3 tangent = c->Normal % (c->Normal % relative_velocity);
+    {
+        rbReal tangent_length = tangent.Length();
+        if ( tangent_length > RIGIDBOX_TOLERANCE )
+            tangent /= tangent_length;
+        else
+            tangent.SetZero();
+    }
+
+    {
+        rbReal K[2] = {
+            InvEffectiveMass( c->Body[0], c->RelativeBodyPosition[0], tangent ),
+            InvEffectiveMass( c->Body[1], c->RelativeBodyPosition[1], tangent ),
+        };
+
+        if ( K[0] + K[1] > RIGIDBOX_TOLERANCE )
+            impulse_magnitude = rbReal(1) / (K[0] + K[1]);
+        else
+            impulse_magnitude = rbReal(0);
+    }
+
+    rbReal coeff = rbMin( rbMax(rbFabs(tangent*relative_velocity), rbReal(0.0)), c->Body[0]->Friction()*c->Body[1]->Friction() );
+    impulse = coeff * impulse_magnitude * tangent;
+    c->Body[0]->ApplyImpulse(  impulse, c->RelativeBodyPosition[0] );
+    c->Body[1]->ApplyImpulse( -impulse, c->RelativeBodyPosition[1] );
+
+    return normal_impulse;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,488 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+#include <RigidBox/rbMappedFile.h>
+#include <RigidBox/rbMath.h>
+#include <RigidBox/rbRigidBody.h>
+#include <RigidBox/rbTrajectory.h>
+
+const rbu32 rbTrajectoryFile::Magic;
+const rbu32 rbTrajectoryFile::Version;
+const rbu32 rbTrajectoryFile::PoseRecordSize;
+const rbu32 rbTrajectoryRecorder::RealsPerPose;
+
+namespace
+{
+    const rbReal Sqrt2 = rbReal(1.41421356237309504880);
+
+    rbu32 Quantize( rbReal value, rbReal scale, rbu32 max_value )
+    {
+        const rbReal q = value * scale + rbReal(0.5);
+        if ( !(q > 0) )
+            return 0;
+        if ( q >= rbReal(max_value) )
+            return max_value;
+        return static_cast<rbu32>( q );
+    }
+}
+
+void rbTrajectoryFile::EncodePose( rbu8* record, const rbVec3& position, const rbMtx3& orientation,
+                                   const float bounds_min[3], const float bounds_max[3] )
+{
+    rbu16 quantized[3];
+    for ( rbs32 k = 0; k < 3; ++k )
+    {
+        const rbReal extent = rbReal(bounds_max[k]) - rbReal(bounds_min[k]);
+        const rbReal scale = extent > 0 ? rbReal(65535) / extent : 0;
+        quantized[k] = static_cast<rbu16>( Quantize(position.e[k] - rbReal(bounds_min[k]), scale, 65535) );
+    }
+
+    // [LANG en] Rotation matrix to quaternion (x, y, z, w), branching on the largest diagonal term for accuracy
+    // [LANG ja] 回転行列から四元数 (x, y, z, w) へ。精度のため対角成分の大小で分岐する
+    const rbMtx3& m = orientation;
+    rbReal q[4];
+    const rbReal trace = m.Elem(0,0) + m.Elem(1,1) + m.Elem(2,2);
+    if ( trace > 0 )
+    {
+        const rbReal s = rbSqrt( trace + 1 ) * 2;
+        q[0] = (m.Elem(2,1) - m.Elem(1,2)) / s;
+        q[1] = (m.Elem(0,2) - m.Elem(2,0)) / s;
+        q[2] = (m.Elem(1,0) - m.Elem(0,1)) / s;
+        q[3] = rbReal(0.25) * s;
+    }
+    else if ( m.Elem(0,0) > m.Elem(1,1) && m.Elem(0,0) > m.Elem(2,2) )
+    {
+        const rbReal s = rbSqrt( 1 + m.Elem(0,0) - m.Elem(1,1) - m.Elem(2,2) ) * 2;
+        q[0] = rbReal(0.25) * s;
+        q[1] = (m.Elem(0,1) + m.Elem(1,0)) / s;
+        q[2] = (m.Elem(0,2) + m.Elem(2,0)) / s;
+        q[3] = (m.Elem(2,1) - m.Elem(1,2)) / s;
+    }
+    else if ( m.Elem(1,1) > m.Elem(2,2) )
+    {
+        const rbReal s = rbSqrt( 1 + m.Elem(1,1) - m.Elem(0,0) - m.Elem(2,2) ) * 2;
+        q[0] = (m.Elem(0,1) + m.Elem(1,0)) / s;
+        q[1] = rbReal(0.25) * s;
+        q[2] = (m.Elem(1,2) + m.Elem(2,1)) / s;
+        q[3] = (m.Elem(0,2) - m.Elem(2,0)) / s;
+    }
+    else
+    {
+        const rbReal s = rbSqrt( 1 + m.Elem(2,2) - m.Elem(0,0) - m.Elem(1,1) ) * 2;
+        q[0] = (m.Elem(0,2) + m.Elem(2,0)) / s;
+        q[1] = (m.Elem(1,2) + m.Elem(2,1)) / s;
+        q[2] = rbReal(0.25) * s;
+        q[3] = (m.Elem(1,0) - m.Elem(0,1)) / s;
+    }
+
+    const rbReal length = rbSqrt( q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3] );
+    rbs32 largest = 0;
+    for ( rbs32 i = 1; i < 4; ++i )
+        if ( rbFabs(q[i]) > rbFabs(q[largest]) )
+            largest = i;
+
+    // [LANG en] q and -q are the same rotation : flip so that the dropped component is positive
+    // [LANG ja] q と -q は同じ回転 : 省略する成分が正になるように符号を反転
+    const rbReal sign = q[largest] < 0 ? -1 / length : 1 / length;
+    rbu32 packed = rbu32(largest) << 30;
+    rbs32 shift = 20;
+    for ( rbs32 i = 0; i < 4; ++i )
+    {
+        if ( i == largest )
+            continue;
+        packed |= Quantize( q[i] * sign * Sqrt2 + 1, rbReal(1023) / 2, 1023 ) << shift;
+        shift -= 10;
+    }
+
+    std::memcpy( record, quantized, sizeof(quantized) );
+    std::memcpy( record + sizeof(quantized), &packed, sizeof(packed) );
+}
+
+void rbTrajectoryFile::DecodePose( const rbu8* record, const float bounds_min[3], const float bounds_max[3],
+                                   rbVec3& position, rbMtx3& orientation )
+{
+    rbu16 quantized[3];
+    rbu32 packed;
+    std::memcpy( quantized, record, sizeof(quantized) );
+    std::memcpy( &packed, record + sizeof(quantized), sizeof(packed) );
+
+    for ( rbs32 k = 0; k < 3; ++k )
+    {
+        const rbReal extent = rbReal(bounds_max[k]) - rbReal(bounds_min[k]);
+        position.e[k] = rbReal(bounds_min[k]) + rbReal(quantized[k]) * (extent / rbReal(65535));
+    }
+
+    const rbs32 largest = static_cast<rbs32>( packed >> 30 );
+    rbReal q[4];
+    rbReal sum = 0;
+    rbs32 shift = 20;
+    for ( rbs32 i = 0; i < 4; ++i )
+    {
+        if ( i == largest )
+            continue;
+        q[i] = ( rbReal((packed >> shift) & 1023) * (rbReal(2) / rbReal(1023)) - 1 ) / Sqrt2;
+        sum += q[i] * q[i];
+        shift -= 10;
+    }
+    q[largest] = rbSqrt( std::max(rbReal(0), 1 - sum) );
+
+    const rbReal x = q[0], y = q[1], z = q[2], w = q[3];
+    orientation.Set( 1 - 2*(y*y + z*z),     2*(x*y - z*w),     2*(x*z + y*w),
+                         2*(x*y + z*w), 1 - 2*(x*x + z*z),     2*(y*z - x*w),
+                         2*(x*z - y*w),     2*(y*z + x*w), 1 - 2*(x*x + y*y) );
+}
+
+rbTrajectoryRecorder::rbTrajectoryRecorder()
+    : file( nullptr )
+    , body_count( 0 )
+    , frames_per_chunk( 0 )
+    , frame_count( 0 )
+    , stall_count( 0 )
+    , front( 0 )
+    , writer()
+    , mutex()
+    , condition()
+    , pending( nullptr )
+    , closing( false )
+    , index()
+    , chunk_bytes()
+    , file_offset( 0 )
+    , failed( false )
+{}
+
+rbTrajectoryRecorder::~rbTrajectoryRecorder()
+{
+    Close();
+}
+
+bool rbTrajectoryRecorder::Open( const char* path, rbu32 body_count, rbu32 frames_per_chunk )
+{
+    if ( file != nullptr || frames_per_chunk == 0 )
+        return false;
+
+    file = std::fopen( path, "wb" );
+    if ( file == nullptr )
+        return false;
+
+    const rbTrajectoryFile::FileHeader header = { rbTrajectoryFile::Magic, rbTrajectoryFile::Version, body_count, frames_per_chunk };
+    if ( std::fwrite(&header, sizeof(header), 1, file) != 1 )
+    {
+        std::fclose( file );
+        file = nullptr;
+        return false;
+    }
+
+    this->body_count = body_count;
+    this->frames_per_chunk = frames_per_chunk;
+    frame_count = 0;
+    stall_count = 0;
+    for ( ChunkBuffer& buffer : buffers )
+    {
+        buffer.Poses.resize( size_t(frames_per_chunk) * body_count * RealsPerPose );
+        buffer.FirstFrame = 0;
+        buffer.FrameCount = 0;
+    }
+    front = 0;
+    pending = nullptr;
+    closing = false;
+    index.clear();
+    file_offset = sizeof(header);
+    failed = false;
+
+    writer = std::thread( &rbTrajectoryRecorder::WriterMain, this );
+    return true;
+}
+
+bool rbTrajectoryRecorder::Close()
+{
+    if ( file == nullptr )
+        return false;
+
+    if ( buffers[front].FrameCount > 0 )
+        Submit();
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        closing = true;
+    }
+    condition.notify_all();
+    writer.join();
+
+    bool succeeded = !failed;
+    if ( succeeded )
+    {
+        const rbTrajectoryFile::Footer footer = {
+            file_offset, static_cast<rbu32>(index.size()), frame_count, 0, rbTrajectoryFile::Magic
+        };
+        if ( !index.empty() && std::fwrite(index.data(), sizeof(index[0]), index.size(), file) != index.size() )
+            succeeded = false;
+        if ( std::fwrite(&footer, sizeof(footer), 1, file) != 1 )
+            succeeded = false;
+    }
+    if ( std::fclose(file) != 0 )
+        succeeded = false;
+    file = nullptr;
+
+    return succeeded;
+}
+
+bool rbTrajectoryRecorder::Capture( const std::vector<rbRigidBody*>& bodies )
+{
+    if ( file == nullptr || bodies.size() != body_count )
+        return false;
+
+    ChunkBuffer& chunk = buffers[front];
+    rbReal* pose = chunk.Poses.data() + size_t(chunk.FrameCount) * body_count * RealsPerPose;
+    for ( rbRigidBody* body : bodies )
+    {
+        const rbVec3 position = body->Position();
+        const rbMtx3 orientation = body->Orientation();
+        for ( rbs32 k = 0; k < 3; ++k )
+            pose[k] = position.e[k];
+        for ( rbs32 row = 0; row < 3; ++row )
+            for ( rbs32 col = 0; col < 3; ++col )
+                pose[3 + 3*row + col] = orientation.Elem( row, col );
+        pose += RealsPerPose;
+    }
+
+    ++chunk.FrameCount;
+    ++frame_count;
+    if ( chunk.FrameCount == frames_per_chunk )
+        Submit();
+
+    return true;
+}
+
+void rbTrajectoryRecorder::Submit()
+{
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        if ( pending != nullptr )
+        {
+            ++stall_count;
+            condition.wait( lock, [this]() { return pending == nullptr; } );
+        }
+        pending = &buffers[front];
+    }
+    condition.notify_all();
+
+    // [LANG en] The other buffer is free : the writer finished it before taking the one just submitted
+    // [LANG ja] もう一方のバッファは空いている : 書き込み用のスレッドは今渡したものを受け取る前にそれを書き終えている
+    front ^= 1;
+    buffers[front].FirstFrame = frame_count;
+    buffers[front].FrameCount = 0;
+}
+
+void rbTrajectoryRecorder::WriterMain()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    for ( ;; )
+    {
+        condition.wait( lock, [this]() { return pending != nullptr || closing; } );
+        if ( pending == nullptr )
+            break;
+
+        const ChunkBuffer* chunk = pending;
+        lock.unlock();
+        if ( !failed && !WriteChunk(*chunk) )
+            failed = true;
+        lock.lock();
+
+        pending = nullptr;
+        condition.notify_all();
+    }
+}
+
+bool rbTrajectoryRecorder::WriteChunk( const ChunkBuffer& chunk )
+{
+    const size_t pose_count = size_t(chunk.FrameCount) * body_count;
+
+    rbTrajectoryFile::ChunkHeader header;
+    header.FirstFrame = chunk.FirstFrame;
+    header.FrameCount = chunk.FrameCount;
+    for ( rbs32 k = 0; k < 3; ++k )
+    {
+        header.BoundsMin[k] = pose_count > 0 ? FLT_MAX : 0;
+        header.BoundsMax[k] = pose_count > 0 ? -FLT_MAX : 0;
+    }
+    for ( size_t i = 0; i < pose_count; ++i )
+    {
+        const rbReal* pose = chunk.Poses.data() + i * RealsPerPose;
+        for ( rbs32 k = 0; k < 3; ++k )
+        {
+            header.BoundsMin[k] = std::min( header.BoundsMin[k], float(pose[k]) );
+            header.BoundsMax[k] = std::max( header.BoundsMax[k], float(pose[k]) );
+        }
+    }
+
+    chunk_bytes.resize( sizeof(header) + pose_count * rbTrajectoryFile::PoseRecordSize );
+    std::memcpy( chunk_bytes.data(), &header, sizeof(header) );
+    rbu8* record = chunk_bytes.data() + sizeof(header);
+    for ( size_t i = 0; i < pose_count; ++i )
+    {
+        const rbReal* pose = chunk.Poses.data() + i * RealsPerPose;
+        const rbVec3 position( pose[0], pose[1], pose[2] );
+        const rbMtx3 orientation( pose[3], pose[4],  pose[5],
+                                  pose[6], pose[7],  pose[8],
+                                  pose[9], pose[10], pose[11] );
+        rbTrajectoryFile::EncodePose( record, position, orientation, header.BoundsMin, header.BoundsMax );
+        record += rbTrajectoryFile::PoseRecordSize;
+    }
+
+    if ( std::fwrite(chunk_bytes.data(), 1, chunk_bytes.size(), file) != chunk_bytes.size() )
+        return false;
+
+    const rbTrajectoryFile::IndexEntry entry = { file_offset, chunk.FirstFrame, chunk.FrameCount };
+    index.push_back( entry );
+    file_offset += chunk_bytes.size();
+    return true;
+}
+
+rbTrajectoryPlayer::rbTrajectoryPlayer()
+    : file()
+    , header()
+    , footer()
+    , index()
+{}
+
+rbTrajectoryPlayer::~rbTrajectoryPlayer()
+{
+    Close();
+}
+
+bool rbTrajectoryPlayer::Open( const char* path )
+{
+    Close();
+
+    if ( !file.Open(path) )
+        return false;
+    const rbu8* data = file.Data();
+    const size_t size = file.Size();
+
+    // [LANG en] Validate the header, the footer and every index entry, so that reading frames needs no checks
+    // [LANG ja] ヘッダー、フッター、索引の全項目を検証しておき、フレームの読み出しでは検査を不要にする
+    bool valid = size >= sizeof(header) + sizeof(footer);
+    if ( valid )
+    {
+        std::memcpy( &header, data, sizeof(header) );
+        std::memcpy( &footer, data + size - sizeof(footer), sizeof(footer) );
+        valid = header.Magic == rbTrajectoryFile::Magic && header.Version == rbTrajectoryFile::Version &&
+            footer.Magic == rbTrajectoryFile::Magic &&
+            footer.IndexOffset >= sizeof(header) &&
+            footer.IndexOffset + rbu64(footer.ChunkCount) * sizeof(rbTrajectoryFile::IndexEntry) + sizeof(footer) == size;
+    }
+    if ( valid )
+    {
+        index.resize( footer.ChunkCount );
+        if ( !index.empty() )
+            std::memcpy( index.data(), data + footer.IndexOffset, index.size() * sizeof(index[0]) );
+
+        rbu64 next_offset = sizeof(header);
+        rbu32 next_frame = 0;
+        for ( const rbTrajectoryFile::IndexEntry& entry : index )
+        {
+            const rbu64 chunk_size = sizeof(rbTrajectoryFile::ChunkHeader) +
+                rbu64(entry.FrameCount) * header.BodyCount * rbTrajectoryFile::PoseRecordSize;
+            rbTrajectoryFile::ChunkHeader chunk;
+            if ( entry.Offset != next_offset || entry.FirstFrame != next_frame || entry.FrameCount == 0 ||
+                 entry.Offset + chunk_size > footer.IndexOffset )
+            {
+                valid = false;
+                break;
+            }
+            std::memcpy( &chunk, data + entry.Offset, sizeof(chunk) );
+            if ( chunk.FirstFrame != entry.FirstFrame || chunk.FrameCount != entry.FrameCount )
+            {
+                valid = false;
+                break;
+            }
+            next_offset += chunk_size;
+            next_frame += entry.FrameCount;
+        }
+        valid = valid && next_offset == footer.IndexOffset && next_frame == footer.FrameCount;
+    }
+
+    if ( !valid )
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void rbTrajectoryPlayer::Close()
+{
+    file.Close();
+    header = rbTrajectoryFile::FileHeader();
+    footer = rbTrajectoryFile::Footer();
+    index.clear();
+}
+
+const rbu8* rbTrajectoryPlayer::FindChunk( rbu32 frame, rbTrajectoryFile::ChunkHeader& chunk ) const
+{
+    if ( !file.IsOpen() || frame >= footer.FrameCount )
+        return nullptr;
+
+    // [LANG en] Last chunk starting at or before +frame+
+    // [LANG ja] +frame+ 以前から始まる最後のチャンク
+    auto it = std::upper_bound( index.begin(), index.end(), frame,
+                                []( rbu32 f, const rbTrajectoryFile::IndexEntry& entry ) { return f < entry.FirstFrame; } );
+    --it;
+    std::memcpy( &chunk, file.Data() + it->Offset, sizeof(chunk) );
+    return file.Data() + it->Offset + sizeof(chunk);
+}
+
+bool rbTrajectoryPlayer::ReadFrame( rbu32 frame, rbVec3* positions, rbMtx3* orientations ) const
+{
+    rbTrajectoryFile::ChunkHeader chunk;
+    const rbu8* records = FindChunk( frame, chunk );
+    if ( records == nullptr )
+        return false;
+
+    const rbu8* record = records + size_t(frame - chunk.FirstFrame) * header.BodyCount * rbTrajectoryFile::PoseRecordSize;
+    for ( rbu32 i = 0; i < header.BodyCount; ++i )
+    {
+        rbTrajectoryFile::DecodePose( record, chunk.BoundsMin, chunk.BoundsMax, positions[i], orientations[i] );
+        record += rbTrajectoryFile::PoseRecordSize;
+    }
+    return true;
+}
+
+bool rbTrajectoryPlayer::ReadPose( rbu32 frame, rbu32 body, rbVec3& position, rbMtx3& orientation ) const
+{
+    if ( body >= header.BodyCount )
+        return false;
+
+    rbTrajectoryFile::ChunkHeader chunk;
+    const rbu8* records = FindChunk( frame, chunk );
+    if ( records == nullptr )
+        return false;
+
+    const size_t record_index = size_t(frame - chunk.FirstFrame) * header.BodyCount + body;
+    rbTrajectoryFile::DecodePose( records + record_index * rbTrajectoryFile::PoseRecordSize,
+                                  chunk.BoundsMin, chunk.BoundsMax, position, orientation );
+    return true;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
@@ -0,0 +1,166 @@
+// -*- mode: C++; coding: utf-8; -*-
+#include <RigidBox/rbTriangleMesh.h>
+
+#include <algorithm>
+
+rbTriangleMesh::rbTriangleMesh()
+    : vertices()
+    , indices()
+    , nodes()
+    , bound_min(0, 0, 0)
+    , bound_max(0, 0, 0)
+    , quantization(1, 1, 1)
+{}
+
+void rbTriangleMesh::Clear()
+{
+    vertices.clear();
+    indices.clear();
+    nodes.clear();
+    bound_min.SetZero();
+    bound_max.SetZero();
+    quantization.Set( 1, 1, 1 );
+}
+
+bool rbTriangleMesh::Build( const rbVec3* vertices_in, rbu32 vertex_count, const rbu32* indices_in, rbu32 triangle_count )
+{
+    Clear();
+
+    if ( vertices_in == nullptr || indices_in == nullptr || vertex_count == 0 || triangle_count == 0 )
+        return false;
+
+    for ( rbu32 i = 0; i < 3 * triangle_count; ++i )
+    {
+        if ( indices_in[i] >= vertex_count )
+            return false;
+    }
+
+    vertices.assign( vertices_in, vertices_in + vertex_count );
+    indices.assign( indices_in, indices_in + 3 * triangle_count );
+
+    bound_min = bound_max = vertices[0];
+    for ( const rbVec3& v : vertices )
+    {
+        for ( rbs32 i = 0; i < 3; ++i )
+        {
+            bound_min.e[i] = rbMin( bound_min.e[i], v.e[i] );
+            bound_max.e[i] = rbMax( bound_max.e[i], v.e[i] );
+        }
+    }
+
+    // [LANG en] A small margin keeps the outermost nodes from being clamped by the quantization.
+    // [LANG ja] 量子化で最外周のノードが切り詰められないように少し余白を取る
+    rbVec3 margin = rbReal(1e-3) * (bound_max - bound_min) + rbVec3( RIGIDBOX_TOLERANCE, RIGIDBOX_TOLERANCE, RIGIDBOX_TOLERANCE );
+    bound_min -= margin;
+    bound_max += margin;
+    for ( rbs32 i = 0; i < 3; ++i )
+        quantization.e[i] = rbReal(65535) / (bound_max.e[i] - bound_min.e[i]);
+
+    std::vector<rbu32> triangles( triangle_count );
+    for ( rbu32 i = 0; i < triangle_count; ++i )
+        triangles[i] = i;
+
+    nodes.reserve( 2 * triangle_count - 1 );
+    BuildNode( triangles, 0, triangle_count );
+
+    return true;
+}
+
+rbVec3 rbTriangleMesh::HalfExtent() const
+{
+    rbVec3 h( 0, 0, 0 );
+    for ( const rbVec3& v : vertices )
+    {
+        for ( rbs32 i = 0; i < 3; ++i )
+            h.e[i] = rbMax( h.e[i], rbFabs(v.e[i]) );
+    }
+    return h;
+}
+
+void rbTriangleMesh::Quantize( const rbVec3& p, bool round_up, rbu16 q_out[3] ) const
+{
+    for ( rbs32 i = 0; i < 3; ++i )
+    {
+        rbReal v = rbClamp( (p.e[i] - bound_min.e[i]) * quantization.e[i], rbReal(0), rbReal(65535) );
+        q_out[i] = static_cast<rbu16>( round_up ? std::ceil(v) : std::floor(v) );
+    }
+}
+
+rbs32 rbTriangleMesh::BuildNode( std::vector<rbu32>& triangles, rbu32 begin, rbu32 end )
+{
+    const rbs32 node_index = static_cast<rbs32>(nodes.size());
+    nodes.emplace_back();
+
+    rbVec3 lo( RIGIDBOX_REAL_MAX, RIGIDBOX_REAL_MAX, RIGIDBOX_REAL_MAX );
+    rbVec3 hi = -lo;
+    rbVec3 centroid_lo = lo, centroid_hi = hi;
+    for ( rbu32 t = begin; t < end; ++t )
+    {
+        rbVec3 v[3];
+        Triangle( triangles[t], v );
+        rbVec3 centroid = (v[0] + v[1] + v[2]) / rbReal(3);
+        for ( rbs32 i = 0; i < 3; ++i )
+        {
+            lo.e[i] = rbMin( lo.e[i], rbMin(v[0].e[i], rbMin(v[1].e[i], v[2].e[i])) );
+            hi.e[i] = rbMax( hi.e[i], rbMax(v[0].e[i], rbMax(v[1].e[i], v[2].e[i])) );
+            centroid_lo.e[i] = rbMin( centroid_lo.e[i], centroid.e[i] );
+            centroid_hi.e[i] = rbMax( centroid_hi.e[i], centroid.e[i] );
+        }
+    }
+
+    {
+        QuantizedNode& node = nodes[node_index];
+        Quantize( lo, false, node.quantized_min );
+        Quantize( hi, true, node.quantized_max );
+    }
+
+    if ( end - begin == 1 )
+    {
+        nodes[node_index].escape_index_or_triangle_index = static_cast<rbs32>(triangles[begin]);
+        return node_index;
+    }
+
+    // [LANG en] Median split along the longest axis of the centroid bounds
+    // [LANG ja] 重心の AABB の最長軸に沿って中央値で分割
+    rbVec3 extent = centroid_hi - centroid_lo;
+    rbs32 axis = 0;
+    if ( extent.y > extent.e[axis] ) axis = 1;
+    if ( extent.z > extent.e[axis] ) axis = 2;
+
+    const rbu32 middle = begin + (end - begin) / 2;
+    std::nth_element( triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+        [this, axis](rbu32 a, rbu32 b) {
+            const rbu32* ia = &indices[3 * a];
+            const rbu32* ib = &indices[3 * b];
+            return vertices[ia[0]].e[axis] + vertices[ia[1]].e[axis] + vertices[ia[2]].e[axis] <
+                   vertices[ib[0]].e[axis] + vertices[ib[1]].e[axis] + vertices[ib[2]].e[axis];
+        } );
+
+    BuildNode( triangles, begin, middle );
+    BuildNode( triangles, middle, end );
+
+    nodes[node_index].escape_index_or_triangle_index = -static_cast<rbs32>(nodes.size() - node_index);
+    return node_index;
+}
+
+// RigidBox : A Small Library for 3D Rigid Body Physics Tutorial
+// Copyright (c) 2011-2020 vaiorabbit <http://twitter.com/vaiorabbit>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//     1. The origin of this software must not be misrepresented; you must not
+//     claim that you wrote the original software. If you use this software
+//     in a product, an acknowledgment in the product documentation would be
+//     appreciated but is not required.
+//
+//     2. Altered source versions must be plainly marked as such, and must not be
+//     misrepresented as being the original software.
+//
+//     3. This notice may not be removed or altered from any source
+//     distribution.
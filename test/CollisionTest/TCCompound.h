@@ -0,0 +1,125 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCCOMPOUND_H_INCLUDED
+#define TCCOMPOUND_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCCompound : public Test::Case
+{
+public:
+    TCCompound( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            {
+                // 同じ立方体 2 個を x = 1, 3 に並べたダンベル形状 : 重心は x = 2
+                rbCompound::Child c[2];
+                c[0].position.Set( 1, 0, 0 );
+                c[1].position.Set( 3, 0, 0 );
+
+                rbCompound pair;
+                TEST_ASSERT( pair.Build(c, 2) );
+                TEST_ASSERT_DOUBLES_EQUAL( pair.Mass(), rbReal(2), rbReal(1e-6) );
+                TEST_ASSERT_DOUBLES_EQUAL( pair.CenterOfMass().x, rbReal(2), rbReal(1e-6) );
+                TEST_ASSERT_DOUBLES_EQUAL( pair.GetChild(0).position.x, rbReal(-1), rbReal(1e-6) );
+
+                // 平行軸の定理 : Ixx = 2 * (2/3), Iyy = Izz = 2 * (2/3 + 1)
+                rbMtx3 I = pair.Inertia();
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(0,0), rbReal(4.0 / 3.0), rbReal(1e-5) );
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(1,1), rbReal(10.0 / 3.0), rbReal(1e-5) );
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(2,2), rbReal(10.0 / 3.0), rbReal(1e-5) );
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(0,1), rbReal(0), rbReal(1e-5) );
+                TEST_ASSERT_DOUBLES_EQUAL( pair.HalfExtent().x, rbReal(2), rbReal(1e-5) );
+
+                // 質量が正でない子は拒否される
+                c[1].mass = 0;
+                rbCompound broken;
+                TEST_ASSERT( !broken.Build(c, 2) );
+                TEST_ASSERT( !broken.Build(c, 0) );
+            }
+
+            // L 字型 : 横長の板 (4x1x1) と、その左端に立つ柱 (1x3x1)
+            rbCompound::Child l_parts[2];
+            l_parts[0].half_extent.Set( 2, rbReal(0.5), rbReal(0.5) );
+            l_parts[0].position.Set( 0, rbReal(0.5), 0 );
+            l_parts[0].mass = 4;
+            l_parts[1].half_extent.Set( rbReal(0.5), rbReal(1.5), rbReal(0.5) );
+            l_parts[1].position.Set( rbReal(-1.5), rbReal(2.5), 0 );
+            l_parts[1].mass = 3;
+
+            rbCompound l_shape;
+            TEST_ASSERT( l_shape.Build(l_parts, 2) );
+            TEST_ASSERT_EQUAL( l_shape.NodeCount(), rbu32(3) );
+
+            {
+                // 柱の付近だけを問い合わせると柱のみが返る
+                const rbVec3 com = l_shape.CenterOfMass();
+                rbu32 hits = 0, last = 0;
+                l_shape.Query( rbVec3(rbReal(-1.8), rbReal(3.5), rbReal(-0.1)) - com, rbVec3(rbReal(-1.2), rbReal(3.8), rbReal(0.1)) - com,
+                               [&](rbu32 i) { ++hits; last = i; } );
+                TEST_ASSERT_EQUAL( hits, rbu32(1) );
+                TEST_ASSERT_EQUAL( last, rbu32(1) );
+            }
+
+            rbShapeLibrary library;
+            rbRigidBody l_body;
+            l_body.SetShapeParameter( library, &l_shape, rbReal(0.5), rbReal(0.5) );
+            TEST_ASSERT( l_body.Compound() == &l_shape );
+            TEST_ASSERT_DOUBLES_EQUAL( 1 / l_body.InvMass(), rbReal(7), rbReal(1e-5) );
+
+            {
+                // 柱の先端にだけ触れる直方体 : 法線は -y (直方体 -> 複合形状)
+                l_body.SetPosition( l_shape.CenterOfMass() );
+
+                rbRigidBody box;
+                box.SetShapeParameter( library, 1, rbReal(0.25), rbReal(0.25), rbReal(0.25), rbReal(0.5), rbReal(0.5) );
+                box.SetPosition( rbReal(-1.5), rbReal(4.24), 0 );
+
+                rbContact c[rbCollision::MaxContactsPerPair];
+                rbs32 result = rbCollision::Detect( &l_body, &box, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result == 1 );
+                TEST_ASSERT_DOUBLES_EQUAL( c[0].Normal.y, rbReal(-1), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( c[0].PenetrationDepth, rbReal(0.01), rbReal(1e-4) );
+                TEST_ASSERT( c[0].Body[0] == &l_body && c[0].Body[1] == &box );
+
+                // 板の右端の上空 (柱がない側) では接触しない
+                box.SetPosition( rbReal(1.5), rbReal(4.24), 0 );
+                result = rbCollision::Detect( &l_body, &box, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result == 0 );
+            }
+
+            {
+                // L 字型を床に落とし、板を下にして静止することを確認
+                rbEnvironment env;
+                rbRigidBody floor;
+                floor.SetShapeParameter( env.Shapes(), 1, 10, rbReal(0.5), 10, rbReal(0.5), rbReal(0.5) );
+                floor.SetPosition( 0, rbReal(-0.5), 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+
+                l_body.SetPosition( l_shape.CenterOfMass() + rbVec3(0, 2, 0) );
+                env.Register( &l_body );
+                env.Register( &floor );
+
+                const rbVec3 G( 0, rbReal(-10), 0 );
+                for ( int i = 0; i < 240; ++i )
+                {
+                    l_body.SetForce( G * 7 );
+                    env.Update( rbReal(1.0 / 60.0), 5 );
+                }
+                TEST_ASSERT_DOUBLES_EQUAL( l_body.Position().y, l_shape.CenterOfMass().y, rbReal(0.1) );
+                TEST_ASSERT( l_body.Orientation().Elem(1,1) > rbReal(0.99) );
+
+                env.Unregister( &l_body );
+                env.Unregister( &floor );
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,134 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCCONVEXHULL_H_INCLUDED
+#define TCCONVEXHULL_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCConvexHull : public Test::Case
+{
+public:
+    TCConvexHull( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            rbs32 result;
+
+            // 立方体の8頂点 + 内部の点 (内部の点は凸包から除かれる)
+            const rbVec3 cube_points[] = {
+                rbVec3( 3, 1, 1 ), rbVec3( 1, 1, 1 ), rbVec3( 3, 3, 1 ), rbVec3( 1, 3, 1 ),
+                rbVec3( 3, 1, 3 ), rbVec3( 1, 1, 3 ), rbVec3( 3, 3, 3 ), rbVec3( 1, 3, 3 ),
+                rbVec3( 2, 2, 2 ), rbVec3( rbReal(2.5), rbReal(1.5), 2 ),
+            };
+
+            rbConvexHull cube;
+
+            {
+                // 構築結果 : 重心は (2,2,2)、頂点は重心基準、面法線と辺方向はそれぞれ3本
+                TEST_ASSERT( cube.Build(cube_points, sizeof(cube_points)/sizeof(cube_points[0])) );
+                TEST_ASSERT_EQUAL( cube.VertexCount(), 8U );
+                TEST_ASSERT_EQUAL( cube.FaceCount(), 3U );
+                TEST_ASSERT_EQUAL( cube.EdgeDirectionCount(), 3U );
+                TEST_ASSERT_DOUBLES_EQUAL( cube.Volume(), rbReal(8), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( cube.CenterOfMass().x, rbReal(2), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( cube.HalfExtent().y, rbReal(1), rbReal(1e-4) );
+
+                // 慣性テンソルは直方体の式 m(h^2+h^2)/3 と一致するはず
+                rbMtx3 I = cube.Inertia( rbReal(3) );
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(0,0), rbReal(2), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(1,1), rbReal(2), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( I.Elem(0,1), rbReal(0), rbReal(1e-4) );
+            }
+
+            {
+                // 山登り法の結果は開始頂点によらず全探索と一致する
+                const rbVec3 dirs[] = { rbVec3(1, 1, 1), rbVec3(-1, rbReal(0.2), rbReal(-0.3)), rbVec3(rbReal(0.1), -1, rbReal(0.9)) };
+                for ( const rbVec3& d : dirs )
+                {
+                    rbReal brute_force = -RIGIDBOX_REAL_MAX;
+                    for ( rbu32 v = 0; v < cube.VertexCount(); ++v )
+                        brute_force = rbMax( brute_force, cube.Vertex(v) * d );
+
+                    for ( rbu32 start = 0; start < cube.VertexCount(); ++start )
+                        TEST_ASSERT_DOUBLES_EQUAL( cube.Vertex(cube.SupportIndex(d, start)) * d, brute_force, rbReal(1e-5) );
+                }
+            }
+
+            {
+                // 同一平面上の点群からは構築できない
+                const rbVec3 flat[] = { rbVec3(0, 0, 0), rbVec3(1, 0, 0), rbVec3(0, 1, 0), rbVec3(1, 1, 0) };
+                rbConvexHull hull;
+                TEST_ASSERT( !hull.Build(flat, 4) );
+
+                // 構築できなかった凸包は形状に設定できない
+                TEST_ASSERT( !hull.Valid() );
+                TEST_ASSERT_EQUAL( hull.SupportIndex(rbVec3(1, 0, 0), 5), 0U );
+                rbRigidBody::Shape shape;
+                TEST_ASSERT( !shape.Set(rbReal(1), &hull, rbReal(1), rbReal(0.5)) );
+                TEST_ASSERT( !shape.Set(rbReal(1), nullptr, rbReal(1), rbReal(0.5)) );
+                TEST_ASSERT_EQUAL( shape.type, rbu32(rbRigidBody::ShapeType_Box) );
+
+                rbShapeLibrary library;
+                TEST_ASSERT_EQUAL( library.AddConvexHull(rbReal(1), &hull, rbReal(1), rbReal(0.5)), rbShapeLibrary::InvalidIndex );
+                TEST_ASSERT_EQUAL( library.Count(), 0U );
+
+                rbRigidBody body;
+                TEST_ASSERT( !body.SetShapeParameter(library, rbReal(1), &hull, rbReal(1), rbReal(0.5)) );
+                TEST_ASSERT( body.ShapeType() == rbRigidBody::ShapeType_Box );
+                TEST_ASSERT( body.ConvexHull() == nullptr );
+            }
+
+            {
+                // 凸包と直方体の面同士が重なるように配置
+                rbContact c;
+                rbShapeLibrary library;
+                rbRigidBody hull_body, box;
+                hull_body.SetShapeParameter( library, rbReal(1), &cube, rbReal(1), rbReal(0.5) );
+                hull_body.SetPosition( rbReal(-1), 0, 0 );
+
+                box.SetPosition( rbReal(1-0.01), 0, 0 );
+
+                result = rbCollision::Detect( &hull_body, &box, &c );
+                TEST_ASSERT( result == 1 );
+                TEST_ASSERT_DOUBLES_EQUAL( c.Normal.x, rbReal(-1), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( c.PenetrationDepth, rbReal(0.01), rbReal(1e-4) );
+
+                // 離れている場合
+                box.SetPosition( rbReal(1.5), 0, 0 );
+                result = rbCollision::Detect( &hull_body, &box, &c );
+                TEST_ASSERT( result == 0 );
+            }
+
+            {
+                // 凸包同士 : 八面体の頂点が立方体の面に刺さるように配置
+                const rbVec3 octa_points[] = {
+                    rbVec3( 1, 0, 0 ), rbVec3( -1, 0, 0 ), rbVec3( 0, 1, 0 ),
+                    rbVec3( 0, -1, 0 ), rbVec3( 0, 0, 1 ), rbVec3( 0, 0, -1 ),
+                };
+                rbConvexHull octa;
+                TEST_ASSERT( octa.Build(octa_points, 6) );
+                TEST_ASSERT_EQUAL( octa.FaceCount(), 4U );
+
+                rbContact c;
+                rbShapeLibrary library;
+                rbRigidBody body0, body1;
+                body0.SetShapeParameter( library, rbReal(1), &cube, rbReal(1), rbReal(0.5) );
+                body1.SetShapeParameter( library, rbReal(1), &octa, rbReal(1), rbReal(0.5) );
+                body0.SetPosition( 0, 0, 0 );
+                body1.SetPosition( 0, rbReal(1.9), 0 );
+
+                result = rbCollision::Detect( &body0, &body1, &c );
+                TEST_ASSERT( result == 1 );
+                TEST_ASSERT_DOUBLES_EQUAL( c.Normal.y, rbReal(-1), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( c.Position.y, rbReal(0.9), rbReal(1e-4) );
+                TEST_ASSERT_DOUBLES_EQUAL( c.PenetrationDepth, rbReal(0.1), rbReal(1e-4) );
+            }
+        }
+};
+
+#endif
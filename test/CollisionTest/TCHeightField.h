@@ -0,0 +1,122 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCHEIGHTFIELD_H_INCLUDED
+#define TCHEIGHTFIELD_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCHeightField : public Test::Case
+{
+public:
+    TCHeightField( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            // 21x21 サンプル、セル幅 1 の地形 (0 <= x, z <= 20)。x の増加に従ってゆるやかに高くなる斜面
+            const rbu32 N = 21;
+            std::vector<rbReal> heights( N * N );
+            for ( rbu32 j = 0; j < N; ++j )
+                for ( rbu32 i = 0; i < N; ++i )
+                    heights[j * N + i] = rbReal(0.1) * rbReal(i);
+
+            rbHeightField field;
+            TEST_ASSERT( !field.Build(1, N, &heights[0], 1, 1) );
+            TEST_ASSERT( field.Build(N, N, &heights[0], 1, 1) );
+            TEST_ASSERT_EQUAL( field.SampleCountX(), N );
+            TEST_ASSERT_EQUAL( field.SampleCountZ(), N );
+
+            // 量子化誤差は scale の 1/2 以内
+            for ( rbu32 i = 0; i < N; ++i )
+                TEST_ASSERT_DOUBLES_EQUAL( field.Height(i, 3), heights[3 * N + i], field.HeightScale() );
+
+            {
+                // 問い合わせ範囲の真下にあるセルのみを訪問する (2x2 セル = 8 三角形)
+                rbu32 hit_count = 0;
+                field.Query( rbVec3(rbReal(4.5), rbReal(-10), rbReal(4.5)), rbVec3(rbReal(5.5), rbReal(10), rbReal(5.5)),
+                             [&hit_count](const rbVec3*) { ++hit_count; } );
+                TEST_ASSERT_EQUAL( hit_count, rbu32(8) );
+
+                // 地形より上にある範囲では何も返さない
+                hit_count = 0;
+                field.Query( rbVec3(rbReal(4.5), rbReal(5), rbReal(4.5)), rbVec3(rbReal(5.5), rbReal(6), rbReal(5.5)),
+                             [&hit_count](const rbVec3*) { ++hit_count; } );
+                TEST_ASSERT_EQUAL( hit_count, rbu32(0) );
+
+                // 地形の外側
+                hit_count = 0;
+                field.Query( rbVec3(rbReal(-5), rbReal(-10), rbReal(-5)), rbVec3(rbReal(-1), rbReal(10), rbReal(-1)),
+                             [&hit_count](const rbVec3*) { ++hit_count; } );
+                TEST_ASSERT_EQUAL( hit_count, rbu32(0) );
+            }
+
+            rbShapeLibrary library;
+            rbRigidBody ground;
+            ground.SetShapeParameter( library, &field, rbReal(0.5), rbReal(0.5) );
+            TEST_ASSERT( ground.IsFixed() );
+            TEST_ASSERT( ground.HeightField() == &field );
+            TEST_ASSERT( ground.TriangleMesh() == nullptr );
+
+            {
+                // 平坦な部分 (x 方向の勾配のみ) : 法線は斜面の法線方向 (地形 -> 直方体)
+                rbContact c[rbCollision::MaxContactsPerPair];
+                rbRigidBody box;
+                box.SetPosition( rbReal(10.5), rbReal(1.9), rbReal(10.5) );
+
+                rbs32 result = rbCollision::Detect( &box, &ground, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result > 0 );
+                const rbVec3 slope_normal = rbVec3( rbReal(-0.1), 1, 0 ).GetNormalized();
+                for ( rbs32 i = 0; i < result; ++i )
+                {
+                    TEST_ASSERT_DOUBLES_EQUAL( c[i].Normal * slope_normal, rbReal(1), rbReal(1e-4) );
+                    TEST_ASSERT( c[i].PenetrationDepth > 0 );
+                    TEST_ASSERT( c[i].Body[0] == &box && c[i].Body[1] == &ground );
+                }
+
+                // 引数の順序を入れ替えると法線も反転する
+                result = rbCollision::Detect( &ground, &box, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result > 0 );
+                TEST_ASSERT_DOUBLES_EQUAL( c[0].Normal * slope_normal, rbReal(-1), rbReal(1e-4) );
+
+                // 離れている場合
+                box.SetPosition( rbReal(10.5), rbReal(3.5), rbReal(10.5) );
+                result = rbCollision::Detect( &box, &ground, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result == 0 );
+            }
+
+            {
+                // 平坦な地形の上に箱を落下させ、静止することを確認
+                std::vector<rbReal> flat( N * N, rbReal(2) );
+                rbHeightField plain;
+                TEST_ASSERT( plain.Build(N, N, &flat[0], 1, 1) );
+                TEST_ASSERT_DOUBLES_EQUAL( plain.Height(7, 7), rbReal(2), rbReal(1e-6) );
+
+                rbEnvironment env;
+                rbRigidBody floor;
+                floor.SetShapeParameter( env.Shapes(), &plain, rbReal(0.5), rbReal(0.5) );
+
+                rbRigidBody box;
+                box.SetPosition( rbReal(10.3), rbReal(5), rbReal(10.3) );
+                env.Register( &box );
+                env.Register( &floor );
+
+                const rbVec3 G( 0, rbReal(-10), 0 );
+                for ( int i = 0; i < 180; ++i )
+                {
+                    box.SetForce( G );
+                    env.Update( rbReal(1.0 / 60.0), 5 );
+                }
+                TEST_ASSERT_DOUBLES_EQUAL( box.Position().y, rbReal(3), rbReal(0.1) );
+
+                env.Unregister( &box );
+                env.Unregister( &floor );
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,112 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCTRIANGLEMESH_H_INCLUDED
+#define TCTRIANGLEMESH_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCTriangleMesh : public Test::Case
+{
+public:
+    TCTriangleMesh( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            // y == 0 の平面上に 20x20 の格子状の床メッシュ (-10 <= x, z <= 10) を作成
+            const rbu32 N = 20;
+            std::vector<rbVec3> vertices;
+            std::vector<rbu32> indices;
+            for ( rbu32 j = 0; j <= N; ++j )
+                for ( rbu32 i = 0; i <= N; ++i )
+                    vertices.push_back( rbVec3(rbReal(i) - rbReal(10), 0, rbReal(j) - rbReal(10)) );
+            for ( rbu32 j = 0; j < N; ++j )
+            {
+                for ( rbu32 i = 0; i < N; ++i )
+                {
+                    rbu32 v0 = j * (N + 1) + i, v1 = v0 + 1, v2 = v0 + (N + 1), v3 = v2 + 1;
+                    rbu32 quad[6] = { v0, v2, v1, v1, v2, v3 };
+                    indices.insert( indices.end(), quad, quad + 6 );
+                }
+            }
+
+            rbTriangleMesh mesh;
+            TEST_ASSERT( mesh.Build(&vertices[0], static_cast<rbu32>(vertices.size()), &indices[0], 2 * N * N) );
+            TEST_ASSERT_EQUAL( mesh.TriangleCount(), 2 * N * N );
+            TEST_ASSERT_EQUAL( mesh.NodeCount(), 2 * mesh.TriangleCount() - 1 );
+            TEST_ASSERT_EQUAL( sizeof(rbTriangleMesh::QuantizedNode), size_t(16) );
+
+            {
+                // 範囲外の頂点番号は拒否される
+                rbTriangleMesh broken;
+                rbu32 bad[3] = { 0, 1, 1000 };
+                TEST_ASSERT( !broken.Build(&vertices[0], static_cast<rbu32>(vertices.size()), bad, 1) );
+            }
+
+            {
+                // 1x1 のセルに収まる問い合わせは、そのセル周辺の少数の三角形だけを返す
+                rbu32 hit_count = 0;
+                mesh.Query( rbVec3(rbReal(0.25), rbReal(-0.1), rbReal(0.25)), rbVec3(rbReal(0.75), rbReal(0.1), rbReal(0.75)),
+                            [&hit_count](rbu32) { ++hit_count; } );
+                TEST_ASSERT( hit_count >= 2 && hit_count <= 8 );
+            }
+
+            rbShapeLibrary library;
+            rbRigidBody floor;
+            floor.SetShapeParameter( library, &mesh, rbReal(0.5), rbReal(0.5) );
+            TEST_ASSERT( floor.IsFixed() );
+
+            {
+                // メッシュにわずかにめり込んだ直方体 : 法線は +y (メッシュ -> 直方体)
+                rbContact c[rbCollision::MaxContactsPerPair];
+                rbRigidBody box;
+                box.SetPosition( rbReal(0.3), rbReal(0.99), rbReal(0.3) );
+
+                rbs32 result = rbCollision::Detect( &box, &floor, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result > 0 );
+                for ( rbs32 i = 0; i < result; ++i )
+                {
+                    TEST_ASSERT_DOUBLES_EQUAL( c[i].Normal.y, rbReal(1), rbReal(1e-4) );
+                    TEST_ASSERT_DOUBLES_EQUAL( c[i].PenetrationDepth, rbReal(0.01), rbReal(1e-4) );
+                    TEST_ASSERT( c[i].Body[0] == &box && c[i].Body[1] == &floor );
+                }
+
+                // 引数の順序を入れ替えると法線も反転する
+                result = rbCollision::Detect( &floor, &box, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result > 0 );
+                TEST_ASSERT_DOUBLES_EQUAL( c[0].Normal.y, rbReal(-1), rbReal(1e-4) );
+
+                // 離れている場合
+                box.SetPosition( rbReal(0.3), rbReal(1.5), rbReal(0.3) );
+                result = rbCollision::Detect( &box, &floor, c, rbCollision::MaxContactsPerPair );
+                TEST_ASSERT( result == 0 );
+            }
+
+            {
+                // 床メッシュの上に箱を落下させ、静止することを確認
+                rbEnvironment env;
+                rbRigidBody box;
+                box.SetPosition( rbReal(0.3), rbReal(3), rbReal(0.3) );
+                env.Register( &box );
+                env.Register( &floor );
+
+                const rbVec3 G( 0, rbReal(-10), 0 );
+                for ( int i = 0; i < 180; ++i )
+                {
+                    box.SetForce( G );
+                    env.Update( rbReal(1.0 / 60.0), 5 );
+                }
+                TEST_ASSERT_DOUBLES_EQUAL( box.Position().y, rbReal(1), rbReal(0.1) );
+
+                env.Unregister( &box );
+                env.Unregister( &floor );
+            }
+        }
+};
+
+#endif
@@ -1,29 +1,57 @@
-// -*- mode: C++; coding: utf-8 -*-
-#include <TestFramework.h>
-
-#include "TCEnv.h"
-
-int
-main( int argc, char** argv )
-{
-    Test::Suite suite( "Env test" );
-
-    Test::Case* tc[] = {
-        new TCEnv( "Env Test" ),
-    };
-
-    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
-        suite.RegisterCase( tc[i] );
-
-    suite.Run();
-
-    if ( Test::ManagerInstance().FailCount() == 0 )
-        std::cout << Test::ManagerInstance().AssertionCount() << " assertions succeeded." << std::endl;
-    else
-        std::cout << Test::ManagerInstance().FailCount() << " of " << Test::ManagerInstance().AssertionCount() << " assertions failed." << std::endl;
-
-    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
-        delete tc[i];
-
-    return 0;
-}
+// -*- mode: C++; coding: utf-8 -*-
+#include <TestFramework.h>
+
+#include "TCEnv.h"
+#include "TCCCD.h"
+#include "TCQuery.h"
+#include "TCFilter.h"
+#include "TCSensor.h"
+#include "TCContactEvent.h"
+#include "TCKinematic.h"
+#include "TCShapeLibrary.h"
+#include "TCDirty.h"
+#include "TCProfiler.h"
+#include "TCSnapshot.h"
+#include "TCRollback.h"
+#include "TCDeterminism.h"
+#include "TCTrajectory.h"
+#include "TCScene.h"
+
+int
+main( int argc, char** argv )
+{
+    Test::Suite suite( "Env test" );
+
+    Test::Case* tc[] = {
+        new TCEnv( "Env Test" ),
+        new TCCCD( "CCD Test" ),
+        new TCQuery( "Query Test" ),
+        new TCFilter( "Filter Test" ),
+        new TCSensor( "Sensor Test" ),
+        new TCContactEvent( "Contact Event Test" ),
+        new TCKinematic( "Kinematic Test" ),
+        new TCShapeLibrary( "Shape Library Test" ),
+        new TCDirty( "Dirty Test" ),
+        new TCProfiler( "Profiler Test" ),
+        new TCSnapshot( "Snapshot Test" ),
+        new TCRollback( "Rollback Test" ),
+        new TCDeterminism( "Determinism Test" ),
+        new TCTrajectory( "Trajectory Test" ),
+        new TCScene( "Scene Test" ),
+    };
+
+    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
+        suite.RegisterCase( tc[i] );
+
+    suite.Run();
+
+    if ( Test::ManagerInstance().FailCount() == 0 )
+        std::cout << Test::ManagerInstance().AssertionCount() << " assertions succeeded." << std::endl;
+    else
+        std::cout << Test::ManagerInstance().FailCount() << " of " << Test::ManagerInstance().AssertionCount() << " assertions failed." << std::endl;
+
+    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
+        delete tc[i];
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCCCD_H_INCLUDED
+#define TCCCD_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCCCD : public Test::Case
+{
+public:
+    TCCCD( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+
+            // ブロードフェーズ : 重なっている組のみを番号順に報告し、固定物体同士は除外する
+            {
+                rbRigidBody box[4];
+                box[0].SetPosition( 0, 0, 0 );
+                box[1].SetPosition( 10, 0, 0 );
+                box[2].SetPosition( rbReal(1.5), 0, 0 );
+                box[3].SetPosition( rbReal(11.5), 0, 0 );
+                box[1].EnableAttribute( rbRigidBody::Attribute_Fixed );
+                box[3].EnableAttribute( rbRigidBody::Attribute_Fixed );
+
+                std::vector<rbRigidBody*> bodies;
+                for ( rbRigidBody& b : box )
+                    bodies.push_back( &b );
+
+                rbBroadPhase broadphase;
+                broadphase.Update( bodies, dtime );
+                TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(1) );
+                TEST_ASSERT_EQUAL( broadphase.Pairs()[0].Index[0], rbu32(0) );
+                TEST_ASSERT_EQUAL( broadphase.Pairs()[0].Index[1], rbu32(2) );
+
+                // 移動後も並び順を引き継いで正しく更新される
+                box[0].SetPosition( rbReal(12), 0, 0 );
+                broadphase.Update( bodies, dtime );
+                TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(2) );
+                TEST_ASSERT_EQUAL( broadphase.Pairs()[0].Index[1], rbu32(1) );
+                TEST_ASSERT_EQUAL( broadphase.Pairs()[1].Index[1], rbu32(3) );
+            }
+
+            // 薄い壁 (厚さ 0.1) に向かって 1 ステップで 5 進む高速な箱を撃ち込む (div == 1)
+            for ( int ccd = 0; ccd < 2; ++ccd )
+            {
+                rbEnvironment env;
+
+                rbRigidBody wall;
+                wall.SetShapeParameter( env.Shapes(), 1, rbReal(0.05), 5, 5, rbReal(0.5), rbReal(0.5) );
+                wall.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                env.Register( &wall );
+
+                rbRigidBody bullet;
+                bullet.SetShapeParameter( env.Shapes(), 1, rbReal(0.1), rbReal(0.1), rbReal(0.1), rbReal(0.5), rbReal(0.5) );
+                bullet.SetPosition( rbReal(-7.3), 0, 0 );
+                bullet.SetLinearVelocity( 300, 0, 0 );
+                if ( ccd )
+                    bullet.EnableAttribute( rbRigidBody::Attribute_CCD );
+                env.Register( &bullet );
+
+                for ( int i = 0; i < 10; ++i )
+                    env.Update( dtime, 1 );
+
+                if ( ccd )
+                {
+                    // 壁 (x == -0.05 の面) の手前で止められる
+                    TEST_ASSERT( bullet.Position().x < rbReal(-0.05) );
+                    TEST_ASSERT( bullet.LinearVelocity().x < rbReal(1) );
+                }
+                else
+                {
+                    // CCD なしでは壁をすり抜ける
+                    TEST_ASSERT( bullet.Position().x > 0 );
+                }
+
+                env.Unregister( &bullet );
+                env.Unregister( &wall );
+            }
+
+            // 低速な剛体同士の衝突では CCD の有無で結果が変わらない
+            {
+                rbReal final_x[2];
+                for ( int ccd = 0; ccd < 2; ++ccd )
+                {
+                    rbEnvironment env;
+                    rbRigidBody box[2];
+                    box[0].SetPosition( rbReal(-3), 0, 0 );
+                    box[0].SetLinearVelocity( 2, 0, 0 );
+                    box[1].SetPosition( rbReal(3), 0, 0 );
+                    box[1].SetLinearVelocity( -2, 0, 0 );
+                    if ( ccd )
+                        box[0].EnableAttribute( rbRigidBody::Attribute_CCD );
+                    env.Register( &box[0] );
+                    env.Register( &box[1] );
+
+                    for ( int i = 0; i < 120; ++i )
+                        env.Update( dtime, 5 );
+                    final_x[ccd] = box[0].Position().x;
+
+                    env.Unregister( &box[0] );
+                    env.Unregister( &box[1] );
+                }
+                TEST_ASSERT_DOUBLES_EQUAL( final_x[0], final_x[1], rbReal(0.05) );
+            }
+        }
+};
+
+#endif
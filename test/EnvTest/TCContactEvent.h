@@ -0,0 +1,134 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCCONTACTEVENT_H_INCLUDED
+#define TCCONTACTEVENT_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCContactEvent : public Test::Case
+{
+public:
+    TCContactEvent( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+
+            // リングバッファ : 容量は2のべき乗に切り上げ、溢れた分は破棄して数える
+            {
+                rbContactEventQueue queue;
+                queue.Reserve( 3 );
+                TEST_ASSERT_EQUAL( queue.Capacity(), rbu32(4) );
+
+                rbContactEvent event = {};
+                for ( rbu32 i = 0; i < 5; ++i )
+                {
+                    event.PairId = i;
+                    queue.Push( event );
+                }
+                TEST_ASSERT_EQUAL( queue.Count(), rbu32(4) );
+                TEST_ASSERT_EQUAL( queue.OverflowCount(), rbu32(1) );
+
+                rbContactEvent drained[4];
+                TEST_ASSERT_EQUAL( queue.Drain(drained, 2), rbu32(2) );
+                TEST_ASSERT_EQUAL( drained[0].PairId, rbu32(0) );
+                TEST_ASSERT_EQUAL( drained[1].PairId, rbu32(1) );
+
+                // 末尾を越えて先頭に戻る
+                event.PairId = 10;
+                queue.Push( event );
+                TEST_ASSERT_EQUAL( queue.Drain(drained, 4), rbu32(3) );
+                TEST_ASSERT_EQUAL( drained[0].PairId, rbu32(2) );
+                TEST_ASSERT_EQUAL( drained[2].PairId, rbu32(10) );
+                TEST_ASSERT_EQUAL( queue.Count(), rbu32(0) );
+            }
+
+            // 床に落ちた箱 : 開始→継続→(持ち上げると)終了
+            {
+                rbEnvironment::Config config;
+                config.ContactEventCapacity = 64;
+                rbEnvironment env( config );
+
+                rbRigidBody floor;
+                floor.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(10), rbReal(0.5), rbReal(10), rbReal(0.5), rbReal(0.5) );
+                floor.SetPosition( 0, rbReal(-0.5), 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                env.Register( &floor );
+
+                rbRigidBody box;
+                box.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5) );
+                box.SetPosition( 0, rbReal(0.6), 0 );
+                env.Register( &box );
+
+                rbs32 begin_count = 0, persist_count = 0, end_count = 0;
+                rbu32 pair_id = ~rbu32(0);
+                rbContactEvent events[64];
+                for ( rbs32 frame = 0; frame < 30; ++frame )
+                {
+                    box.SetForce( 0, rbReal(-9.8), 0 );
+                    env.Update( dtime, 4 );
+
+                    rbu32 count = env.DrainContactEvents( events, 64 );
+                    for ( rbu32 i = 0; i < count; ++i )
+                    {
+                        const rbContactEvent& event = events[i];
+                        TEST_ASSERT( event.Body[0] == &floor && event.Body[1] == &box );
+                        if ( event.Type == rbContactEvent::Type_Begin )
+                        {
+                            ++begin_count;
+                            pair_id = event.PairId;
+                            TEST_ASSERT( event.MaxImpulse > 0 );
+                            TEST_ASSERT( event.Normal.y < rbReal(-0.9) );
+                        }
+                        else if ( event.Type == rbContactEvent::Type_Persist )
+                        {
+                            ++persist_count;
+                            TEST_ASSERT_EQUAL( event.PairId, pair_id );
+                        }
+                        else
+                        {
+                            ++end_count;
+                        }
+                    }
+                }
+                TEST_ASSERT_EQUAL( begin_count, rbs32(1) );
+                TEST_ASSERT( persist_count > 20 );
+                TEST_ASSERT_EQUAL( end_count, rbs32(0) );
+
+                box.SetPosition( 0, rbReal(5), 0 );
+                env.Update( dtime, 4 );
+                TEST_ASSERT_EQUAL( env.DrainContactEvents(events, 64), rbu32(1) );
+                TEST_ASSERT_EQUAL( events[0].Type, rbContactEvent::Type_End );
+                TEST_ASSERT_EQUAL( events[0].PairId, pair_id );
+                TEST_ASSERT_EQUAL( env.ContactEventOverflowCount(), rbu32(0) );
+
+                env.Unregister( &box );
+                env.Unregister( &floor );
+            }
+
+            // 容量 0 では接触イベントを生成しない
+            {
+                rbEnvironment env;
+
+                rbRigidBody box0, box1;
+                box1.SetPosition( rbReal(0.5), 0, 0 );
+                env.Register( &box0 );
+                env.Register( &box1 );
+                env.Update( dtime, 1 );
+
+                rbContactEvent event;
+                TEST_ASSERT( env.ContactCount() > 0 );
+                TEST_ASSERT_EQUAL( env.DrainContactEvents(&event, 1), rbu32(0) );
+
+                env.Unregister( &box1 );
+                env.Unregister( &box0 );
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,182 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCDETERMINISM_H_INCLUDED
+#define TCDETERMINISM_H_INCLUDED
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCDeterminism : public Test::Case
+{
+public:
+    TCDeterminism( const char* name )
+        : Test::Case( name )
+        {}
+
+    static const rbs32 BoxCount = 6;
+
+    struct Scene
+    {
+        rbEnvironment env;
+        rbRigidBody floor, box[BoxCount];
+
+        Scene( const rbEnvironment::Config& config )
+            : env( config )
+            {
+                floor.SetShapeParameter( env.Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+                floor.SetPosition( 0, -0.5f, 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                env.Register( &floor );
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                {
+                    box[i].SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.2f, 0.5f );
+                    box[i].SetPosition( rbReal(i % 2) * 0.3f, 0.5f + rbReal(i) * 1.2f, 0 );
+                    box[i].SetOrientation( rbMtx3().SetFromAxisAngle( rbVec3(0, 1, 0), rbReal(0.3 * i) ) );
+                    env.Register( &box[i] );
+                }
+            }
+
+        ~Scene()
+            {
+                env.Unregister( &floor );
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                    env.Unregister( &box[i] );
+            }
+
+        void Step()
+            {
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                    box[i].SetForce( 0, -9.8f, 0 );
+                env.Update( rbReal(1.0 / 60.0), 2 );
+            }
+    };
+
+    virtual void Run()
+        {
+            // 移植性のある数学関数は C ライブラリの結果とほぼ一致する
+            {
+                double max_error = 0;
+                for ( rbs32 i = -2000; i <= 2000; ++i )
+                {
+                    const double x = i * 0.0137;
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicSin(x) - std::sin(x)) );
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicCos(x) - std::cos(x)) );
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicAtan(x) - std::atan(x)) );
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicAtan2(x, 0.7) - std::atan2(x, 0.7)) );
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicAtan2(0.7, x) - std::atan2(0.7, x)) );
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicAtan2(-0.7, x) - std::atan2(-0.7, x)) );
+                    if ( std::fabs(std::cos(x)) > 0.1 )
+                        max_error = std::fmax( max_error, std::fabs(rbDeterministicTan(x) - std::tan(x)) / (1 + std::fabs(std::tan(x))) );
+                    const double u = i / 2000.0;
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicAsin(u) - std::asin(u)) );
+                    max_error = std::fmax( max_error, std::fabs(rbDeterministicAcos(u) - std::acos(u)) );
+                }
+                TEST_ASSERT( max_error < 1e-14 );
+
+                // 特殊な値
+                const double pi = 3.14159265358979323846;
+                const double inf = std::numeric_limits<double>::infinity();
+                TEST_ASSERT_EQUAL( rbDeterministicSin(0.0), 0.0 );
+                TEST_ASSERT_EQUAL( rbDeterministicCos(0.0), 1.0 );
+                TEST_ASSERT( std::isnan(rbDeterministicSin(inf)) && std::isnan(rbDeterministicCos(-inf)) );
+                TEST_ASSERT( std::isnan(rbDeterministicAsin(1.5)) );
+                TEST_ASSERT_EQUAL( rbDeterministicAtan2(0.0, -1.0), pi );
+                TEST_ASSERT_EQUAL( rbDeterministicAtan2(-0.0, -1.0), -pi );
+                TEST_ASSERT( std::signbit(rbDeterministicAtan2(-0.0, 1.0)) );
+                TEST_ASSERT( std::fabs(rbDeterministicAtan2(1.0, 0.0) - 0.5 * pi) < 1e-15 );
+                TEST_ASSERT( std::fabs(rbDeterministicAtan(inf) - 0.5 * pi) < 1e-15 );
+                TEST_ASSERT( std::fabs(rbDeterministicAcos(-1.0) - pi) < 1e-15 );
+            }
+
+            // 同じ入力からはフレームごとに同じハッシュが得られる
+            {
+                rbEnvironment::Config config;
+                config.RollbackCapacity = 4;
+                Scene scene0( config ), scene1( config );
+                TEST_ASSERT_EQUAL( scene0.env.StateHash(), scene1.env.StateHash() );
+
+                bool same = true;
+                for ( rbs32 frame = 0; frame < 60; ++frame )
+                {
+                    scene0.Step();
+                    scene1.Step();
+                    same = same && scene0.env.StateHash() == scene1.env.StateHash();
+                }
+                TEST_ASSERT( same );
+
+                // 1 ulp の違いでハッシュが変わる
+                const rbVec3 p = scene1.box[2].Position();
+                scene1.box[2].SetPosition( p.x, std::nextafter(p.y, rbReal(10)), p.z );
+                TEST_ASSERT( scene0.env.StateHash() != scene1.env.StateHash() );
+
+                // スナップショットと巻き戻しで元のハッシュに戻る
+                const rbu64 hash = scene0.env.StateHash();
+                scene0.Step();
+                scene0.Step();
+                TEST_ASSERT( scene0.env.StateHash() != hash );
+                TEST_ASSERT( scene0.env.Rollback(2) );
+                TEST_ASSERT_EQUAL( scene0.env.StateHash(), hash );
+
+                rbSnapshot snapshot;
+                scene0.env.SaveSnapshot( snapshot );
+                scene0.Step();
+                TEST_ASSERT( scene0.env.RestoreSnapshot(snapshot) );
+                TEST_ASSERT_EQUAL( scene0.env.StateHash(), hash );
+            }
+
+            // Update の間のクエリ (AABB のキャッシュや Dirty ビットを更新しうる) はハッシュを変えない
+            {
+                rbEnvironment::Config config;
+                Scene scene0( config ), scene1( config );
+                rbMtx3 identity;
+                identity.SetIdentity();
+                bool same = true;
+                for ( rbs32 frame = 0; frame < 60; ++frame )
+                {
+                    scene0.Step();
+                    scene1.Step();
+                    scene1.box[frame % BoxCount].AddPosition( 0, 0, 0 );
+                    const rbu64 hash = scene1.env.StateHash();
+                    rbRayHit hit;
+                    rbRigidBody* found[BoxCount + 1];
+                    scene1.env.RayCast( rbRay(rbVec3(0.2f, 10, 0), rbVec3(0, -20, 0)), hit );
+                    scene1.env.OverlapBox( rbVec3(0, 2, 0), identity, rbVec3(1, 2, 1), found, BoxCount + 1 );
+                    scene1.env.SweepBox( rbVec3(-5, 1, 0), identity, rbVec3(0.5f, 0.5f, 0.5f), rbVec3(10, 0, 0), hit );
+                    same = same && scene1.env.StateHash() == hash && scene0.env.StateHash() == hash;
+                }
+                TEST_ASSERT( same );
+            }
+
+            // 未初期化のメモリの内容 (RIGIDBOX_USE_SIMD の rbVec3 の padding レーンなど) はハッシュに影響しない
+            {
+                rbEnvironment::Config config;
+                std::vector<unsigned char> storage0( sizeof(Scene) + alignof(Scene), 0x00 );
+                std::vector<unsigned char> storage1( sizeof(Scene) + alignof(Scene), 0xA5 );
+                void* memory[2] = { storage0.data(), storage1.data() };
+                Scene* scene[2];
+                for ( rbs32 i = 0; i < 2; ++i )
+                {
+                    size_t space = sizeof(Scene) + alignof(Scene);
+                    scene[i] = new ( std::align(alignof(Scene), sizeof(Scene), memory[i], space) ) Scene( config );
+                }
+
+                bool same = scene[0]->env.StateHash() == scene[1]->env.StateHash();
+                for ( rbs32 frame = 0; frame < 60; ++frame )
+                {
+                    scene[0]->Step();
+                    scene[1]->Step();
+                    same = same && scene[0]->env.StateHash() == scene[1]->env.StateHash();
+                }
+                TEST_ASSERT( same );
+
+                scene[0]->~Scene();
+                scene[1]->~Scene();
+            }
+        }
+};
+
+#endif
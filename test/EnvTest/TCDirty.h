@@ -0,0 +1,78 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCDIRTY_H_INCLUDED
+#define TCDIRTY_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCDirty : public Test::Case
+{
+public:
+    TCDirty( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+
+            // 姿勢の変更で派生データが古くなる
+            {
+                rbShapeLibrary library;
+                rbRigidBody body;
+                body.SetShapeParameter( library, 1, 1, 1, 1, 0.5f, 0.5f );
+                TEST_ASSERT( body.RefreshDerivedData() );
+                body.WorldAABB();
+                TEST_ASSERT_EQUAL( body.Dirty(), rbRigidBody::Dirty_None );
+                TEST_ASSERT( !body.RefreshDerivedData() );
+
+                body.SetPosition( 5, 0, 0 );
+                TEST_ASSERT_EQUAL( body.Dirty(), rbRigidBody::Dirty_WorldAABB );
+                TEST_ASSERT( rbFabs(body.WorldAABB().lower.x - 4) < rbReal(1e-4) );
+                TEST_ASSERT_EQUAL( body.Dirty(), rbRigidBody::Dirty_None );
+
+                // 静止している剛体は積分しても変化しない
+                body.UpdatePosition( dtime );
+                TEST_ASSERT_EQUAL( body.Dirty(), rbRigidBody::Dirty_None );
+
+                body.SetLinearVelocity( 0, 1, 0 );
+                body.UpdatePosition( dtime );
+                TEST_ASSERT_EQUAL( body.Dirty(), rbRigidBody::Dirty_Orientation );
+
+                body.ApplyImpulse( rbVec3(0, 1, 0), rbVec3(0, 0, 0) );
+                TEST_ASSERT( (body.Dirty() & rbRigidBody::Dirty_SolverWorkArea) != 0 );
+                TEST_ASSERT( body.RefreshDerivedData() );
+                TEST_ASSERT_EQUAL( body.Dirty(), rbRigidBody::Dirty_WorldAABB );
+            }
+
+            // 固定物体は Update のたびに更新しない
+            {
+                rbEnvironment env;
+                rbRigidBody floor, box;
+                floor.SetShapeParameter( env.Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+                floor.SetPosition( 0, -0.5f, 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                box.SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+                box.SetPosition( 0, 3, 0 );
+                box.SetForce( 0, -10, 0 );
+
+                env.Register( &floor );
+                env.Register( &box );
+
+                env.Update( dtime, 4 );
+                TEST_ASSERT_EQUAL( env.SkippedBodyUpdateCount(), rbu32(3) );
+
+                box.SetForce( 0, -10, 0 );
+                env.Update( dtime, 4 );
+                TEST_ASSERT_EQUAL( env.SkippedBodyUpdateCount(), rbu32(4) );
+
+                env.Unregister( &floor );
+                env.Unregister( &box );
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,112 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCFILTER_H_INCLUDED
+#define TCFILTER_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCFilter : public Test::Case
+{
+public:
+    TCFilter( const char* name )
+        : Test::Case( name )
+        {}
+
+    struct CallbackCount
+    {
+        rbs32 count;
+        rbRigidBody* rejected;
+    };
+
+    // 指定した剛体を含む組を除外するコールバック
+    static bool RejectBody( rbRigidBody* body0, rbRigidBody* body1, void* user_data )
+        {
+            CallbackCount* callback = static_cast<CallbackCount*>(user_data);
+            ++callback->count;
+            return body0 != callback->rejected && body1 != callback->rejected;
+        }
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+
+            enum
+            {
+                Group_Default = 1 << 0,
+                Group_Debris  = 1 << 1,
+            };
+
+            // 同じ位置に重ねた4つの箱 : 破片同士は衝突しない
+            rbRigidBody box[4];
+            for ( rbRigidBody& b : box )
+                b.SetPosition( 0, 0, 0 );
+            box[2].SetCollisionFilter( Group_Debris, ~rbu32(Group_Debris) );
+            box[3].SetCollisionFilter( Group_Debris, ~rbu32(Group_Debris) );
+
+            std::vector<rbRigidBody*> bodies;
+            for ( rbRigidBody& b : box )
+                bodies.push_back( &b );
+
+            rbBroadPhase broadphase;
+            broadphase.Update( bodies, dtime );
+            TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(5) );
+            for ( const rbBroadPhase::Pair& pair : broadphase.Pairs() )
+                TEST_ASSERT( !(pair.Index[0] == 2 && pair.Index[1] == 3) );
+
+            // 片方のマスクだけが相手を除外していても衝突しない
+            box[1].SetCollisionFilter( Group_Default, Group_Default );
+            broadphase.Update( bodies, dtime );
+            TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(3) );
+
+            // コールバックはグループ/マスクを通過した組に対してのみ呼ばれる
+            CallbackCount callback = { 0, &box[0] };
+            broadphase.SetPairFilter( RejectBody, &callback );
+            broadphase.Update( bodies, dtime );
+            TEST_ASSERT_EQUAL( callback.count, rbs32(3) );
+            TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(0) );
+
+            broadphase.SetPairFilter( nullptr, nullptr );
+            broadphase.Update( bodies, dtime );
+            TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(3) );
+
+            // 環境 : 床と衝突しないグループの箱は床をすり抜けて落ちる
+            {
+                rbEnvironment env;
+
+                rbRigidBody floor;
+                floor.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(10), rbReal(0.5), rbReal(10), rbReal(0.5), rbReal(0.5) );
+                floor.SetPosition( 0, rbReal(-0.5), 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                floor.SetCollisionFilter( Group_Default, Group_Default );
+                env.Register( &floor );
+
+                rbRigidBody falling[2];
+                for ( rbs32 i = 0; i < 2; ++i )
+                {
+                    falling[i].SetShapeParameter( env.Shapes(), rbReal(1), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5) );
+                    falling[i].SetPosition( rbReal(3 * i), rbReal(0.6), 0 );
+                    env.Register( &falling[i] );
+                }
+                falling[1].SetCollisionFilter( Group_Debris, ~rbu32(0) );
+
+                for ( rbs32 frame = 0; frame < 60; ++frame )
+                {
+                    for ( rbRigidBody& b : falling )
+                        b.SetForce( 0, rbReal(-9.8), 0 );
+                    env.Update( dtime, 4 );
+                }
+
+                TEST_ASSERT( falling[0].Position().y > rbReal(0.3) );
+                TEST_ASSERT( falling[1].Position().y < rbReal(-1) );
+
+                env.Unregister( &falling[1] );
+                env.Unregister( &falling[0] );
+                env.Unregister( &floor );
+            }
+        }
+};
+
+#endif
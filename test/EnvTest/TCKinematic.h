@@ -0,0 +1,99 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCKINEMATIC_H_INCLUDED
+#define TCKINEMATIC_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCKinematic : public Test::Case
+{
+public:
+    TCKinematic( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+            const rbReal eps = rbReal(1e-3);
+
+            // 目標の姿勢から速度を求める
+            {
+                rbRigidBody body;
+                body.EnableAttribute( rbRigidBody::Attribute_Kinematic );
+
+                rbMtx3 target;
+                target.SetFromAxisAngle( rbVec3(0, 1, 0), rbToRad(30) );
+                body.SetKinematicTarget( rbVec3(1, 0, 0), target );
+                body.UpdateKinematicVelocity( dtime );
+                TEST_ASSERT( rbFabs(body.LinearVelocity().x - 1 / dtime) < rbReal(0.1) );
+                TEST_ASSERT( rbFabs(body.AngularVelocity().y - rbToRad(30) / dtime) < rbReal(0.1) );
+                TEST_ASSERT( body.AngularVelocity().x * body.AngularVelocity().x + body.AngularVelocity().z * body.AngularVelocity().z < eps );
+
+                // 力積や力は受けない
+                body.SetForce( 0, -10, 0 );
+                body.UpdateVelocity( dtime );
+                body.ApplyImpulse( rbVec3(0, 100, 0), rbVec3(0, 0, 0) );
+                body.CorrectVelocity();
+                TEST_ASSERT( rbFabs(body.LinearVelocity().y) < eps );
+            }
+
+            // キネマティックな剛体と固定物体の組は報告しない
+            {
+                rbRigidBody box[3];
+                box[0].EnableAttribute( rbRigidBody::Attribute_Kinematic );
+                box[1].EnableAttribute( rbRigidBody::Attribute_Fixed );
+                box[2].EnableAttribute( rbRigidBody::Attribute_Kinematic );
+
+                std::vector<rbRigidBody*> bodies;
+                for ( rbRigidBody& b : box )
+                    bodies.push_back( &b );
+
+                rbBroadPhase broadphase;
+                broadphase.Update( bodies, dtime );
+                TEST_ASSERT_EQUAL( broadphase.Pairs().size(), size_t(0) );
+            }
+
+            // エレベーター : 上昇する床に載った箱は一緒に持ち上がる
+            {
+                rbEnvironment env;
+
+                rbRigidBody platform;
+                platform.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(2), rbReal(0.25), rbReal(2), rbReal(0.0), rbReal(0.5) );
+                platform.SetPosition( 0, 0, 0 );
+                platform.EnableAttribute( rbRigidBody::Attribute_Kinematic );
+                env.Register( &platform );
+
+                rbRigidBody box;
+                box.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.0), rbReal(0.5) );
+                box.SetPosition( 0, rbReal(0.75), 0 );
+                env.Register( &box );
+
+                rbMtx3 identity( 1, 0, 0,
+                                 0, 1, 0,
+                                 0, 0, 1 );
+                for ( rbs32 frame = 1; frame <= 60; ++frame )
+                {
+                    platform.SetKinematicTarget( rbVec3(0, frame * dtime, 0), identity );
+                    box.SetForce( 0, rbReal(-9.8), 0 );
+                    env.Update( dtime, 4 );
+                }
+
+                TEST_ASSERT( rbFabs(platform.Position().y - 1) < eps );
+                TEST_ASSERT( rbFabs(box.Position().y - rbReal(1.75)) < rbReal(0.1) );
+
+                // 目標を更新しなければ静止する
+                env.Update( dtime, 4 );
+                TEST_ASSERT( platform.LinearVelocity().Length() < eps );
+                TEST_ASSERT( rbFabs(platform.Position().y - 1) < eps );
+
+                env.Unregister( &box );
+                env.Unregister( &platform );
+            }
+        }
+};
+
+#endif
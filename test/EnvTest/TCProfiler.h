@@ -0,0 +1,125 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCPROFILER_H_INCLUDED
+#define TCPROFILER_H_INCLUDED
+
+#include <cstdio>
+#include <sstream>
+#include <iostream>
+#include <string>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCProfiler : public Test::Case
+{
+public:
+    TCProfiler( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+            const int div = 2;
+
+            rbEnvironment env;
+            rbRigidBody floor, box0, box1;
+            floor.SetShapeParameter( env.Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+            floor.SetPosition( 0, -0.5f, 0 );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+            box0.SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+            box0.SetPosition( 0, 0.49f, 0 );
+            box1.SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+            box1.SetPosition( 0.2f, 1.48f, 0 );
+
+            env.Register( &floor );
+            env.Register( &box0 );
+            env.Register( &box1 );
+
+            // フレームごとの統計
+            {
+                box0.SetForce( 0, -10, 0 );
+                box1.SetForce( 0, -10, 0 );
+                env.Update( dtime, div );
+                const rbFrameStats& stats = env.FrameStats();
+                TEST_ASSERT_EQUAL( stats.Frame, rbu64(0) );
+                TEST_ASSERT_EQUAL( stats.BroadPhasePairs, env.BroadPhasePairCount() );
+                TEST_ASSERT_EQUAL( stats.SkippedBodyUpdates, env.SkippedBodyUpdateCount() );
+                TEST_ASSERT( stats.BroadPhasePairs >= rbu32(2 * div) );
+#if !defined(RIGIDBOX_DISABLE_PROFILE)
+                TEST_ASSERT( stats.PairsTested >= stats.BroadPhasePairs );
+                TEST_ASSERT( stats.SATAxesEvaluated > 0 );
+                TEST_ASSERT( stats.ContactsFound > 0 );
+
+                // 重複として捨てなかった衝突点のみが残る
+                TEST_ASSERT_EQUAL( rbu32(env.ContactCount()), stats.ContactsFound - stats.ContactsDeduped );
+                TEST_ASSERT( stats.ImpulsesApplied > 0 );
+                TEST_ASSERT( stats.BodiesAsleep <= rbu32(env.RigidBodyCount()) );
+
+                // Update 全体の時間は各処理段階の時間を含む
+                rbu64 phase_sum = 0;
+                for ( rbu32 i = 1; i < rbFrameStats::PhaseCount; ++i )
+                    phase_sum += stats.PhaseNanoseconds[i];
+                TEST_ASSERT( stats.PhaseNanoseconds[rbFrameStats::Phase_Update] >= phase_sum );
+#endif
+
+                env.Update( dtime, div );
+                TEST_ASSERT_EQUAL( env.FrameStats().Frame, rbu64(1) );
+            }
+
+            TEST_ASSERT_EQUAL( std::string(rbFrameStats::PhaseName(rbFrameStats::Phase_ContactDedup)), std::string("ContactDedup") );
+            TEST_ASSERT_EQUAL( std::string(rbFrameStats::PhaseName(rbFrameStats::PhaseCount)), std::string("Unknown") );
+
+            // トレースの記録と書き出し
+            {
+                rbProfiler& profiler = env.Profiler();
+                TEST_ASSERT_EQUAL( profiler.TraceEventCount(), rbu32(0) );
+
+                profiler.SetTraceCapacity( 64 );
+                env.Update( dtime, div );
+#if !defined(RIGIDBOX_DISABLE_PROFILE)
+                // Update 全体 + サブステップごとの 9 段階 + 後処理
+                TEST_ASSERT_EQUAL( profiler.TraceEventCount(), rbu32(1 + 9 * div + 1) );
+                TEST_ASSERT_EQUAL( profiler.TraceOverflowCount(), rbu32(0) );
+#endif
+
+                const char* path = "TCProfiler_trace.json";
+                TEST_ASSERT( profiler.WriteChromeTrace(path) );
+                std::string json;
+                if ( FILE* fp = std::fopen(path, "r") )
+                {
+                    char buffer[256];
+                    size_t read_size;
+                    while ( (read_size = std::fread(buffer, 1, sizeof(buffer), fp)) > 0 )
+                        json.append( buffer, read_size );
+                    std::fclose( fp );
+                }
+                std::remove( path );
+                TEST_ASSERT( json.find("\"traceEvents\"") != std::string::npos );
+                TEST_ASSERT( json.find("\"ph\":\"C\"") != std::string::npos );
+#if !defined(RIGIDBOX_DISABLE_PROFILE)
+                TEST_ASSERT( json.find("\"name\":\"NarrowPhase\"") != std::string::npos );
+#endif
+
+                // 書き込めない場合は false
+                TEST_ASSERT( !profiler.WriteChromeTrace("no_such_directory/trace.json") );
+
+                // 容量を超えた区間は数えるだけ
+                profiler.SetTraceCapacity( 4 );
+                env.Update( dtime, div );
+#if !defined(RIGIDBOX_DISABLE_PROFILE)
+                TEST_ASSERT_EQUAL( profiler.TraceEventCount(), rbu32(4) );
+                TEST_ASSERT( profiler.TraceOverflowCount() > 0 );
+#endif
+
+                profiler.SetTraceCapacity( 0 );
+                env.Update( dtime, div );
+                TEST_ASSERT_EQUAL( profiler.TraceEventCount(), rbu32(0) );
+            }
+
+            env.Unregister( &floor );
+            env.Unregister( &box0 );
+            env.Unregister( &box1 );
+        }
+};
+
+#endif
@@ -0,0 +1,230 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCQUERY_H_INCLUDED
+#define TCQUERY_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCQuery : public Test::Case
+{
+public:
+    TCQuery( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal eps = rbReal(1e-3);
+
+            rbEnvironment env;
+
+            rbRigidBody floor;
+            floor.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(10), rbReal(0.5), rbReal(10), rbReal(0.5), rbReal(0.5) );
+            floor.SetPosition( 0, rbReal(-0.5), 0 );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+            env.Register( &floor );
+
+            rbRigidBody box;
+            box.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5) );
+            box.SetPosition( 0, rbReal(2), 0 );
+            env.Register( &box );
+
+            // 平らな高さ場 (高さ 1、原点は (-8, 0, -8))
+            rbReal heights[9] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+            rbHeightField field;
+            field.Build( 3, 3, heights, rbReal(2), rbReal(2) );
+            rbRigidBody ground;
+            ground.SetShapeParameter( env.Shapes(), &field, rbReal(0.5), rbReal(0.5) );
+            ground.SetPosition( rbReal(-8), 0, rbReal(-8) );
+            env.Register( &ground );
+
+            // 単一のレイ : 直方体の上面、床、高さ場、何もない場所
+            rbRay rays[7] = {
+                rbRay( rbVec3(0, 10, 0), rbVec3(0, -20, 0) ),
+                rbRay( rbVec3(5, 10, 0), rbVec3(0, -20, 0) ),
+                rbRay( rbVec3(-7, 10, -7), rbVec3(0, -20, 0) ),
+                rbRay( rbVec3(20, 10, 0), rbVec3(0, -20, 0) ),
+                rbRay( rbVec3(-5, 2, 0), rbVec3(10, 0, 0) ),
+                rbRay( rbVec3(0, 10, 0), rbVec3(0, -5, 0) ),
+                rbRay( rbVec3(0, 2, 0), rbVec3(0, -10, 0) ),
+            };
+
+            rbRayHit hit;
+            TEST_ASSERT( env.RayCast(rays[0], hit) );
+            TEST_ASSERT( hit.Body == &box );
+            TEST_ASSERT( rbFabs(hit.Fraction - rbReal(0.375)) < eps );
+            TEST_ASSERT( rbFabs(hit.Normal.y - 1) < eps );
+
+            TEST_ASSERT( env.RayCast(rays[1], hit) );
+            TEST_ASSERT( hit.Body == &floor );
+            TEST_ASSERT( rbFabs(hit.Position.y) < eps );
+
+            TEST_ASSERT( env.RayCast(rays[2], hit) );
+            TEST_ASSERT( hit.Body == &ground );
+            TEST_ASSERT( rbFabs(hit.Position.y - 1) < eps );
+            TEST_ASSERT( rbFabs(hit.Normal.y - 1) < eps );
+
+            TEST_ASSERT( !env.RayCast(rays[3], hit) );
+            TEST_ASSERT( hit.Body == nullptr );
+
+            // 側面から : 法線は -x
+            TEST_ASSERT( env.RayCast(rays[4], hit) );
+            TEST_ASSERT( hit.Body == &box );
+            TEST_ASSERT( rbFabs(hit.Position.x + rbReal(0.5)) < eps );
+            TEST_ASSERT( rbFabs(hit.Normal.x + 1) < eps );
+
+            // 線分が届かない / 内部から出るレイは直方体を無視して床に当たる
+            TEST_ASSERT( !env.RayCast(rays[5], hit) );
+            TEST_ASSERT( env.RayCast(rays[6], hit) );
+            TEST_ASSERT( hit.Body == &floor );
+
+            // 一括版 (パケットの端数を含む) は単一版と同じ結果を返す
+            rbRayHit hits[7];
+            env.RayCast( rays, 7, hits );
+            for ( rbs32 i = 0; i < 7; ++i )
+            {
+                rbRayHit single;
+                env.RayCast( rays[i], single );
+                TEST_ASSERT( hits[i].Body == single.Body );
+                if ( single.Body )
+                    TEST_ASSERT( rbFabs(hits[i].Fraction - single.Fraction) < eps );
+            }
+
+            // 回転した直方体 : 上端の辺に当たる
+            box.SetOrientation( 0, 0, rbToRad(45) );
+            env.InvalidateQueryBounds();
+            TEST_ASSERT( env.RayCast(rays[0], hit) );
+            TEST_ASSERT( rbFabs(hit.Position.y - (2 + rbSqrt(rbReal(0.5)))) < eps );
+            box.SetOrientation( 0, 0, 0 );
+            env.InvalidateQueryBounds();
+
+            // 直方体との重なり
+            rbMtx3 identity( 1, 0, 0,
+                             0, 1, 0,
+                             0, 0, 1 );
+            rbRigidBody* overlapped[4];
+            TEST_ASSERT_EQUAL( env.OverlapBox(rbVec3(0, 2, 0), identity, rbVec3(rbReal(0.1), rbReal(0.1), rbReal(0.1)), overlapped, 4), rbu32(1) );
+            TEST_ASSERT( overlapped[0] == &box );
+            TEST_ASSERT_EQUAL( env.OverlapBox(rbVec3(0, rbReal(0.8), 0), identity, rbVec3(rbReal(0.1), rbReal(0.1), rbReal(0.1)), overlapped, 4), rbu32(0) );
+            TEST_ASSERT_EQUAL( env.OverlapBox(rbVec3(0, rbReal(0.75), 0), identity, rbVec3(rbReal(0.1), rbReal(0.9), rbReal(0.1)), overlapped, 1), rbu32(2) );
+
+            // 直方体の掃引 : 上から落とすと直方体の上面で止まる
+            TEST_ASSERT( env.SweepBox(rbVec3(0, 6, 0), identity, rbVec3(rbReal(0.5), rbReal(0.5), rbReal(0.5)), rbVec3(0, -10, 0), hit) );
+            TEST_ASSERT( hit.Body == &box );
+            TEST_ASSERT( rbFabs(hit.Fraction - rbReal(0.3)) < rbReal(0.01) );
+            TEST_ASSERT( hit.Normal.y > rbReal(0.9) );
+
+            TEST_ASSERT( !env.SweepBox(rbVec3(5, 6, 0), identity, rbVec3(rbReal(0.5), rbReal(0.5), rbReal(0.5)), rbVec3(0, 0, 5), hit) );
+
+            // 問い合わせは凸包のサポート点探索の開始位置を書き換えない
+            {
+                rbVec3 points[8];
+                for ( int i = 0; i < 8; ++i )
+                    points[i] = rbVec3( (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f );
+                rbConvexHull hull;
+                TEST_ASSERT( hull.Build(points, 8) );
+                rbRigidBody hull_body;
+                TEST_ASSERT( hull_body.SetShapeParameter(env.Shapes(), 1, &hull, rbReal(0.5), rbReal(0.5)) );
+                hull_body.SetPosition( 6, 3, 0 );
+                env.Register( &hull_body );
+
+                const rbu32 cache[2] = { hull_body.SupportVertexCache()[0], hull_body.SupportVertexCache()[1] };
+                TEST_ASSERT_EQUAL( env.OverlapBox(rbVec3(6, 4, 0), identity, rbVec3(rbReal(0.5), rbReal(0.5), rbReal(0.5)), overlapped, 4), rbu32(1) );
+                TEST_ASSERT( overlapped[0] == &hull_body );
+                TEST_ASSERT( env.SweepBox(rbVec3(6, 8, 0), identity, rbVec3(rbReal(0.5), rbReal(0.5), rbReal(0.5)), rbVec3(0, -10, 0), hit) );
+                TEST_ASSERT( hit.Body == &hull_body );
+                TEST_ASSERT( rbFabs(hit.Fraction - rbReal(0.35)) < rbReal(0.01) );
+                TEST_ASSERT_EQUAL( hull_body.SupportVertexCache()[0], cache[0] );
+                TEST_ASSERT_EQUAL( hull_body.SupportVertexCache()[1], cache[1] );
+
+                // rbCollision::Detect は既定では開始位置を更新する
+                rbRigidBody probe;
+                probe.SetPosition( 6, rbReal(4.9), 0 );
+                rbContact contact;
+                TEST_ASSERT( rbCollision::Detect(&probe, &hull_body, &contact) > 0 );
+                TEST_ASSERT( hull_body.SupportVertexCache()[0] != cache[0] || hull_body.SupportVertexCache()[1] != cache[1] );
+
+                env.Unregister( &hull_body );
+            }
+
+            // 散らばったレイの一括版は、全剛体を総当たりした結果と一致する (床のような幅の広い剛体を含む)
+            {
+                const rbs32 RowCount = 40;
+                rbRigidBody row[RowCount];
+                for ( rbs32 i = 0; i < RowCount; ++i )
+                {
+                    row[i].SetShapeParameter( env.Shapes(), 1, rbReal(0.3), rbReal(0.3) + rbReal(i % 3) * rbReal(0.2), rbReal(3), rbReal(0.5), rbReal(0.5) );
+                    row[i].SetPosition( rbReal(i - RowCount / 2) * rbReal(0.65), rbReal(1 + i % 4), 0 );
+                    env.Register( &row[i] );
+                }
+
+                const rbs32 RayCount = 45;
+                rbRay scattered[RayCount];
+                for ( rbs32 i = 0; i < RayCount; ++i )
+                {
+                    // 前半は x 方向に近いレイをまとめたパケット、後半は x 方向に散らばったパケット
+                    const rbReal x = i < 20 ? rbReal(i / 4) * rbReal(1.7) + rbReal(i % 4) * rbReal(0.05) - rbReal(3.93)
+                                            : rbReal((i * 7) % RayCount - RayCount / 2) * rbReal(0.4);
+                    scattered[i] = rbRay( rbVec3(x, 8, rbReal(i % 5) - 2), rbVec3(rbReal(i % 3) - 1, -12, rbReal(i % 2)) );
+                }
+                rbRayHit batch[RayCount];
+                env.RayCast( scattered, RayCount, batch );
+
+                bool same = true;
+                rbs32 row_hits = 0;
+                for ( rbs32 i = 0; i < RayCount; ++i )
+                {
+                    rbRayHit expected;
+                    expected.Body = nullptr;
+                    rbReal best = 1;
+                    rbRigidBody* all[RowCount + 3] = { &floor, &box, &ground };
+                    for ( rbs32 j = 0; j < RowCount; ++j )
+                        all[j + 3] = &row[j];
+                    for ( rbRigidBody* body : all )
+                    {
+                        rbRayHit candidate;
+                        if ( rbCollision::RayCast(body, scattered[i], best, candidate) )
+                        {
+                            expected = candidate;
+                            best = candidate.Fraction;
+                        }
+                    }
+                    rbRayHit single;
+                    env.RayCast( scattered[i], single );
+                    same = same && batch[i].Body == expected.Body && single.Body == expected.Body;
+                    if ( expected.Body )
+                        same = same && rbFabs(batch[i].Fraction - expected.Fraction) < eps;
+                    row_hits += expected.Body >= &row[0] && expected.Body < &row[RowCount] ? 1 : 0;
+                }
+                TEST_ASSERT( same );
+                TEST_ASSERT( row_hits > RayCount / 2 );
+
+                for ( rbs32 i = 0; i < RowCount; ++i )
+                    env.Unregister( &row[i] );
+            }
+
+            // 問い合わせは剛体の AABB のキャッシュ、Dirty ビット、変更の記録を書き換えない
+            {
+                box.SetPosition( 0, rbReal(2), 0 );
+                env.InvalidateQueryBounds();
+                const rbu32 dirty = box.Dirty();
+                const bool modified = box.Modified();
+                TEST_ASSERT( (dirty & rbRigidBody::Dirty_WorldAABB) != 0 );
+                TEST_ASSERT( env.RayCast(rays[0], hit) );
+                TEST_ASSERT_EQUAL( env.OverlapBox(rbVec3(0, 2, 0), identity, rbVec3(rbReal(0.1), rbReal(0.1), rbReal(0.1)), overlapped, 4), rbu32(1) );
+                TEST_ASSERT( env.SweepBox(rbVec3(0, 6, 0), identity, rbVec3(rbReal(0.5), rbReal(0.5), rbReal(0.5)), rbVec3(0, -10, 0), hit) );
+                TEST_ASSERT( hit.Body == &box );
+                TEST_ASSERT_EQUAL( box.Dirty(), dirty );
+                TEST_ASSERT_EQUAL( box.Modified(), modified );
+            }
+
+            env.Unregister( &ground );
+            env.Unregister( &box );
+            env.Unregister( &floor );
+        }
+};
+
+#endif
@@ -0,0 +1,174 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCROLLBACK_H_INCLUDED
+#define TCROLLBACK_H_INCLUDED
+
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCRollback : public Test::Case
+{
+public:
+    TCRollback( const char* name )
+        : Test::Case( name )
+        {}
+
+    static const rbs32 BoxCount = 8;
+
+    rbEnvironment* env;
+    rbRigidBody floor, box[BoxCount];
+
+    // フレームごとに異なる入力 (遅れて届いた入力の再適用を模す)。後半の箱はスリープしたままで、
+    // frame >= 200 の入力でのみ box[BoxCount/2] が起きる
+    void Step( rbs32 frame )
+        {
+            for ( rbs32 i = 0; i < BoxCount; ++i )
+            {
+                rbReal push = 0;
+                if ( i < BoxCount / 2 )
+                    push = rbReal(frame % 4 == i ? 3 : 0);
+                else if ( i == BoxCount / 2 && frame >= 200 )
+                    push = 200;
+                box[i].SetForce( push, -9.8f, 0 );
+            }
+            env->Update( rbReal(1.0 / 60.0), 2 );
+        }
+
+    std::vector<rbu8> Record()
+        {
+            std::vector<rbu8> bytes( (BoxCount + 1) * rbRigidBody::SnapshotSize() );
+            floor.SaveSnapshot( &bytes[0] );
+            for ( rbs32 i = 0; i < BoxCount; ++i )
+                box[i].SaveSnapshot( &bytes[(i + 1) * rbRigidBody::SnapshotSize()] );
+            return bytes;
+        }
+
+    virtual void Run()
+        {
+            rbEnvironment::Config config;
+            config.ContactEventCapacity = 256;
+            config.RollbackCapacity = 8;
+            env = new rbEnvironment( config );
+
+            floor.SetShapeParameter( env->Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+            floor.SetPosition( 0, -0.5f, 0 );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+            env->Register( &floor );
+            for ( rbs32 i = 0; i < BoxCount; ++i )
+            {
+                box[i].SetShapeParameter( env->Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.2f, 0.5f );
+                box[i].SetPosition( rbReal(i % 4) * 2.0f, 0.5f, rbReal(i / 4) * 4.0f );
+                box[i].EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                if ( i >= BoxCount / 2 )
+                    box[i].SetSleepOn();
+                env->Register( &box[i] );
+            }
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(0) );
+            TEST_ASSERT( !env->Rollback(1) );
+
+            // 記録は容量までに制限される
+            std::vector< std::vector<rbu8> > records;
+            records.push_back( Record() );
+            for ( rbs32 frame = 0; frame < 120; ++frame )
+            {
+                Step( frame );
+                records.push_back( Record() );
+            }
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(8) );
+            TEST_ASSERT( !env->Rollback(9) );
+            TEST_ASSERT( box[BoxCount / 2].Sleeping() && box[BoxCount - 1].Sleeping() );
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(8) );
+
+            // 巻き戻した状態は過去の状態とビット単位で一致し、再計算すると同じ結果になる
+            rbContactEvent events[256];
+            env->DrainContactEvents( events, 256 );
+            TEST_ASSERT( env->Rollback(5) );
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(3) );
+            TEST_ASSERT_EQUAL( env->ContactCount(), size_t(0) );
+            TEST_ASSERT( Record() == records[115] );
+            for ( rbs32 frame = 115; frame < 120; ++frame )
+                Step( frame );
+            TEST_ASSERT( Record() == records[120] );
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(8) );
+
+            // 接触していた組も巻き戻るので、再計算で開始イベントは発生しない
+            rbu32 begin_count = 0;
+            const rbu32 event_count = env->DrainContactEvents( events, 256 );
+            for ( rbu32 i = 0; i < event_count; ++i )
+                begin_count += events[i].Type == rbContactEvent::Type_Begin ? 1 : 0;
+            TEST_ASSERT( event_count > 0 );
+            TEST_ASSERT_EQUAL( begin_count, rbu32(0) );
+
+            // 容量いっぱいまで巻き戻せる
+            TEST_ASSERT( env->Rollback(8) );
+            TEST_ASSERT( Record() == records[112] );
+            TEST_ASSERT( !env->Rollback(1) );
+
+            // 異なる入力で進めた後でも元の状態に戻せる
+            for ( rbs32 frame = 0; frame < 4; ++frame )
+                Step( 200 + frame );
+            TEST_ASSERT( Record() != records[116] );
+            TEST_ASSERT( box[BoxCount / 2].Awake() );
+            TEST_ASSERT( env->Rollback(4) );
+            TEST_ASSERT( Record() == records[112] );
+            TEST_ASSERT( box[BoxCount / 2].Sleeping() );
+
+            // 剛体の登録・解除と RestoreSnapshot は履歴を破棄する
+            Step( 112 );
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(1) );
+            rbRigidBody extra;
+            env->Register( &extra );
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(0) );
+            TEST_ASSERT( !env->Rollback(1) );
+            env->Unregister( &extra );
+            Step( 113 );
+            rbSnapshot snapshot;
+            env->SaveSnapshot( snapshot );
+            TEST_ASSERT( env->RestoreSnapshot(snapshot) );
+            TEST_ASSERT_EQUAL( env->RollbackFrameCount(), rbu32(0) );
+
+            // スリープ中の剛体を直接動かした場合も巻き戻せる
+            Step( 114 );
+            const std::vector<rbu8> before_move = Record();
+            TEST_ASSERT( box[BoxCount - 1].Sleeping() );
+            box[BoxCount - 1].SetPosition( 20, 3, 0 );
+            Step( 115 );
+            TEST_ASSERT( box[BoxCount - 1].Sleeping() );
+            TEST_ASSERT( env->Rollback(1) );
+            TEST_ASSERT( Record() == before_move );
+
+            env->Unregister( &floor );
+            for ( rbs32 i = 0; i < BoxCount; ++i )
+                env->Unregister( &box[i] );
+            delete env;
+
+            // 設定関数と Update の間にクエリを行っても、設定した姿勢が履歴に残る (重力なし)
+            rbEnvironment::Config moved_config;
+            moved_config.RollbackCapacity = 8;
+            rbEnvironment moved_env( moved_config );
+            rbRigidBody moved;
+            moved.SetShapeParameter( moved_env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.2f, 0.5f );
+            moved.SetSleepOn();
+            moved_env.Register( &moved );
+            moved_env.Update( rbReal(1.0 / 60.0), 1 );
+            TEST_ASSERT( moved.Sleeping() && !moved.Modified() );
+
+            moved.SetPosition( 5, 0, 0 );
+            TEST_ASSERT( moved.Modified() );
+            rbRayHit hit;
+            TEST_ASSERT( moved_env.RayCast(rbRay(rbVec3(5, 10, 0), rbVec3(0, -20, 0)), hit) );
+            TEST_ASSERT( moved.Modified() );
+            moved_env.Update( rbReal(1.0 / 60.0), 1 );
+            TEST_ASSERT( !moved.Modified() );
+            moved.SetSleepOff();
+            moved.SetLinearVelocity( 1, 0, 0 );
+            moved_env.Update( rbReal(1.0 / 60.0), 1 );
+            TEST_ASSERT( moved.Position().x > 5 );
+            TEST_ASSERT( moved_env.Rollback(1) );
+            TEST_ASSERT( moved.Position().x == 5 );
+            TEST_ASSERT( moved.Sleeping() );
+            moved_env.Unregister( &moved );
+        }
+};
+
+#endif
@@ -0,0 +1,186 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCSCENE_H_INCLUDED
+#define TCSCENE_H_INCLUDED
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCScene : public Test::Case
+{
+public:
+    TCScene( const char* name )
+        : Test::Case( name )
+        {}
+
+    static const rbs32 BoxCount = 12;
+
+    // 剛体の状態をビット列として集める
+    static std::vector<rbu8> Record( const rbEnvironment::BodyPtrContainer& bodies )
+        {
+            std::vector<rbu8> bytes( bodies.size() * rbRigidBody::SnapshotSize() );
+            for ( size_t i = 0; i < bodies.size(); ++i )
+                bodies[i]->SaveSnapshot( &bytes[i * rbRigidBody::SnapshotSize()] );
+            return bytes;
+        }
+
+    static void Step( rbEnvironment& env, rbs32 frames )
+        {
+            for ( rbs32 frame = 0; frame < frames; ++frame )
+            {
+                for ( rbRigidBody* body : env.RigidBodies() )
+                    body->SetForce( 0, -9.8f, 0 );
+                env.Update( rbReal(1.0 / 60.0), 2 );
+            }
+        }
+
+    virtual void Run()
+        {
+            const char* path = "TCScene.rbsc";
+
+            rbRigidBody::SleepThresholds thresholds;
+            thresholds.GoSleepDuration = rbReal(0.25);
+
+            rbEnvironment env;
+            rbRigidBody floor, box[BoxCount];
+            floor.SetShapeParameter( env.Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+            floor.SetPosition( 0, -0.5f, 0 );
+            floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+            env.Register( &floor );
+            for ( rbs32 i = 0; i < BoxCount; ++i )
+            {
+                // 登録順と x 方向の並びを変えておく
+                const rbReal size = (i % 3 == 0) ? 0.5f : 0.3f;
+                box[i].SetShapeParameter( env.Shapes(), 1, size, size, size, 0.2f, 0.5f );
+                box[i].SetPosition( rbReal((i * 7) % BoxCount) * 1.5f - 9.0f, 0.5f + rbReal(i % 4) * 1.1f, 0 );
+                box[i].SetOrientation( 0, rbToRad(rbReal(15 * i)), 0 );
+                box[i].EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                env.Register( &box[i] );
+            }
+            box[1].SetSleepThresholds( &thresholds );
+            box[2].SetSleepThresholds( &thresholds );
+            box[3].SetCollisionFilter( 2, ~rbu32(2) );
+            Step( env, 10 );
+
+            TEST_ASSERT( rbScene::Save(path, env.RigidBodies()) );
+
+            // 形状・閾値・衝突フィルター・状態が復元される
+            rbScene scene;
+            TEST_ASSERT( scene.Load(path) );
+            TEST_ASSERT_EQUAL( scene.BodyCount(), rbu32(BoxCount + 1) );
+
+            bool same_config = true;
+            for ( rbu32 i = 0; i < scene.BodyCount(); ++i )
+            {
+                rbRigidBody* original = env.RigidBodies()[i];
+                rbRigidBody& loaded = scene.Body( i );
+                same_config = same_config &&
+                    loaded.HalfExtent().x == original->HalfExtent().x &&
+                    loaded.HalfExtent().z == original->HalfExtent().z &&
+                    loaded.InvMass() == original->InvMass() &&
+                    loaded.Restitution() == original->Restitution() &&
+                    loaded.Friction() == original->Friction() &&
+                    loaded.CollisionGroup() == original->CollisionGroup() &&
+                    loaded.CollisionMask() == original->CollisionMask();
+            }
+            TEST_ASSERT( same_config );
+            TEST_ASSERT( scene.Body(0).GetSleepThresholds() == rbRigidBody::DefaultSleepThresholds() );
+            TEST_ASSERT( scene.Body(2).GetSleepThresholds() != &thresholds );
+            TEST_ASSERT( scene.Body(2).GetSleepThresholds() == scene.Body(3).GetSleepThresholds() );
+            TEST_ASSERT_EQUAL( scene.Body(2).GetSleepThresholds()->GoSleepDuration, rbReal(0.25) );
+
+            // 読み込んだシーンは元のシーンと同じ結果になる
+            {
+                rbEnvironment loaded_env;
+                TEST_ASSERT( scene.Register(loaded_env) );
+                TEST_ASSERT( !scene.Register(loaded_env) );
+                TEST_ASSERT_EQUAL( loaded_env.RigidBodies().size(), size_t(BoxCount + 1) );
+                TEST_ASSERT( Record(loaded_env.RigidBodies()) == Record(env.RigidBodies()) );
+
+                Step( env, 30 );
+                Step( loaded_env, 30 );
+                TEST_ASSERT( Record(loaded_env.RigidBodies()) == Record(env.RigidBodies()) );
+
+                TEST_ASSERT( scene.Unregister(loaded_env) );
+                TEST_ASSERT( loaded_env.RigidBodies().empty() );
+                TEST_ASSERT( !scene.Unregister(loaded_env) );
+            }
+
+            // 環境はシーンの剛体を所有しないので、シーンより先に破棄できる
+            {
+                rbEnvironment* owner_env = new rbEnvironment;
+                TEST_ASSERT( scene.Register(*owner_env) );
+                rbRigidBody* owned = new rbRigidBody;
+                TEST_ASSERT( owner_env->Register(owned) );
+                delete owner_env;
+                TEST_ASSERT_EQUAL( scene.BodyCount(), rbu32(BoxCount + 1) );
+
+                rbEnvironment reused_env;
+                TEST_ASSERT( scene.Register(reused_env) );
+                TEST_ASSERT( scene.Unregister(reused_env) );
+            }
+
+            // 空のシーンも登録・解除できる
+            {
+                rbScene empty;
+                rbEnvironment empty_env;
+                TEST_ASSERT( empty.Register(empty_env) );
+                TEST_ASSERT( empty.Unregister(empty_env) );
+                TEST_ASSERT( empty_env.RigidBodies().empty() );
+            }
+
+            // 一部でも登録済みなら何もしない
+            {
+                rbEnvironment partial_env;
+                TEST_ASSERT( partial_env.Register(&scene.Body(4)) );
+                TEST_ASSERT( !scene.Register(partial_env) );
+                TEST_ASSERT_EQUAL( partial_env.RigidBodies().size(), size_t(1) );
+                TEST_ASSERT( !scene.Unregister(partial_env) );
+                TEST_ASSERT( partial_env.Unregister(&scene.Body(4)) );
+            }
+
+            // 直方体以外の形状は保存できない
+            {
+                const rbVec3 points[] = {
+                    rbVec3(-1, -1, -1), rbVec3( 1, -1, -1), rbVec3(-1,  1, -1), rbVec3( 1,  1, -1),
+                    rbVec3(-1, -1,  1), rbVec3( 1, -1,  1), rbVec3(-1,  1,  1), rbVec3( 1,  1,  1),
+                };
+                rbConvexHull hull;
+                TEST_ASSERT( hull.Build(points, 8) );
+                rbShapeLibrary library;
+                rbRigidBody hull_body;
+                hull_body.SetShapeParameter( library, 1, &hull, 0.5f, 0.5f );
+                TEST_ASSERT( !rbScene::Save("TCScene-hull.rbsc", rbEnvironment::BodyPtrContainer(1, &hull_body)) );
+            }
+
+            // 壊れたファイルは読み込まない
+            {
+                std::vector<char> bytes;
+                std::FILE* file = std::fopen( path, "rb" );
+                TEST_ASSERT( file != nullptr );
+                char buffer[4096];
+                size_t read = 0;
+                while ( (read = std::fread(buffer, 1, sizeof(buffer), file)) > 0 )
+                    bytes.insert( bytes.end(), buffer, buffer + read );
+                std::fclose( file );
+
+                file = std::fopen( path, "wb" );
+                std::fwrite( bytes.data(), 1, bytes.size() - 1, file );
+                std::fclose( file );
+
+                TEST_ASSERT( !scene.Load(path) );
+                TEST_ASSERT_EQUAL( scene.BodyCount(), rbu32(0) );
+                TEST_ASSERT( !scene.Load("no-such-file.rbsc") );
+            }
+
+            std::remove( path );
+
+            env.Unregister( &floor );
+            for ( rbs32 i = 0; i < BoxCount; ++i )
+                env.Unregister( &box[i] );
+        }
+};
+
+#endif
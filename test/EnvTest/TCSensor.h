@@ -0,0 +1,94 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCSENSOR_H_INCLUDED
+#define TCSENSOR_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCSensor : public Test::Case
+{
+public:
+    TCSensor( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            const rbReal dtime = rbReal(1.0 / 60.0);
+
+            // 重なりのみの判定
+            {
+                rbRigidBody box0, box1;
+                box0.SetPosition( 0, 0, 0 );
+                box1.SetPosition( rbReal(1.9), 0, 0 );
+                TEST_ASSERT( rbCollision::Overlap(&box0, &box1) );
+
+                box1.SetPosition( rbReal(2.1), 0, 0 );
+                TEST_ASSERT( !rbCollision::Overlap(&box0, &box1) );
+
+                // AABB は重なるが、回転した箱の面で分離している
+                box1.SetPosition( 2, 2, 0 );
+                box1.SetOrientation( 0, 0, rbToRad(45) );
+                TEST_ASSERT( !rbCollision::Overlap(&box0, &box1) );
+            }
+
+            // センサーを通過する箱 : 開始/終了イベントが1回ずつ発生し、箱の速度は変わらない
+            {
+                rbEnvironment env;
+
+                rbRigidBody sensor;
+                sensor.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(1), rbReal(1), rbReal(1), rbReal(0.5), rbReal(0.5) );
+                sensor.SetPosition( 0, 0, 0 );
+                sensor.EnableAttribute( rbRigidBody::Attribute_Fixed | rbRigidBody::Attribute_Sensor );
+                env.Register( &sensor );
+
+                rbRigidBody box;
+                box.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(0.25), rbReal(0.25), rbReal(0.25), rbReal(0.5), rbReal(0.5) );
+                box.SetPosition( rbReal(-3), 0, 0 );
+                box.SetLinearVelocity( rbReal(6), 0, 0 );
+                env.Register( &box );
+
+                rbs32 begin_count = 0, end_count = 0, begin_frame = -1, end_frame = -1;
+                for ( rbs32 frame = 0; frame < 60; ++frame )
+                {
+                    env.Update( dtime, 1 );
+                    TEST_ASSERT_EQUAL( env.ContactCount(), size_t(0) );
+                    for ( rbu32 i = 0; i < env.SensorEventCount(); ++i )
+                    {
+                        const rbEnvironment::SensorEvent& event = env.GetSensorEvent( i );
+                        TEST_ASSERT( event.Sensor == &sensor && event.Other == &box );
+                        if ( event.Type == rbEnvironment::SensorEvent::Type_Begin )
+                        {
+                            ++begin_count;
+                            begin_frame = frame;
+                        }
+                        else
+                        {
+                            ++end_count;
+                            end_frame = frame;
+                        }
+                    }
+                }
+
+                TEST_ASSERT_EQUAL( begin_count, rbs32(1) );
+                TEST_ASSERT_EQUAL( end_count, rbs32(1) );
+                TEST_ASSERT( begin_frame < end_frame );
+                TEST_ASSERT( rbFabs(box.LinearVelocity().x - rbReal(6)) < rbReal(1e-4) );
+
+                // 登録解除した剛体の組は終了イベントなしで破棄される
+                box.SetPosition( 0, 0, 0 );
+                env.Update( dtime, 1 );
+                TEST_ASSERT_EQUAL( env.SensorEventCount(), size_t(1) );
+                env.Unregister( &box );
+                env.Update( dtime, 1 );
+                TEST_ASSERT_EQUAL( env.SensorEventCount(), size_t(0) );
+
+                env.Unregister( &sensor );
+            }
+        }
+};
+
+#endif
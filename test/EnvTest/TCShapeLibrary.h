@@ -0,0 +1,187 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCSHAPELIBRARY_H_INCLUDED
+#define TCSHAPELIBRARY_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCShapeLibrary : public Test::Case
+{
+public:
+    TCShapeLibrary( const char* name )
+        : Test::Case( name )
+        {}
+
+    static bool NearlyEqual( const rbMtx3& a, const rbMtx3& b, rbReal eps )
+        {
+            for ( int r = 0; r < 3; ++r )
+                for ( int c = 0; c < 3; ++c )
+                    if ( rbFabs(a.Elem(r,c) - b.Elem(r,c)) > eps )
+                        return false;
+            return true;
+        }
+
+    virtual void Run()
+        {
+            const rbReal eps = rbReal(1e-4);
+
+            // 同じパラメータの形状は一つにまとめられる
+            {
+                rbShapeLibrary library;
+                rbu32 a = library.AddBox( 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+                rbu32 b = library.AddBox( 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+                rbu32 c = library.AddBox( 2, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+                rbu32 d = library.AddBox( 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.25f );
+                TEST_ASSERT_EQUAL( a, b );
+                TEST_ASSERT( a != c );
+                TEST_ASSERT( a != d && c != d );
+                TEST_ASSERT_EQUAL( library.Count(), rbu32(3) );
+
+                // 要素を追加してもアドレスは変わらない
+                const rbRigidBody::Shape* shape = library.GetShape( a );
+                for ( int i = 0; i < 1000; ++i )
+                    library.AddBox( 1, rbReal(1 + i), 1, 1, 0.5f, 0.5f );
+                TEST_ASSERT( library.GetShape( a ) == shape );
+            }
+
+            // SetShapeParameter の形状は渡したライブラリに追加され、同じパラメータの剛体で共有される
+            {
+                rbEnvironment env;
+                rbRigidBody body[2];
+                body[0].SetShapeParameter( env.Shapes(), 3, 0.5f, 1.0f, 1.5f, 0.2f, 0.4f );
+                body[1].SetShapeParameter( env.Shapes(), 3, 0.5f, 1.0f, 1.5f, 0.2f, 0.4f );
+                TEST_ASSERT( body[0].GetShape() == body[1].GetShape() );
+                TEST_ASSERT_EQUAL( env.Shapes().Count(), rbu32(1) );
+                TEST_ASSERT( body[0].GetShape() == env.Shapes().GetShape(0) );
+                TEST_ASSERT( rbFabs(body[0].InvMass() - rbReal(1) / 3) < eps );
+
+                // 登録しても形状は変わらない
+                env.Register( &body[0] );
+                TEST_ASSERT( body[0].GetShape() == env.Shapes().GetShape(0) );
+                env.Unregister( &body[0] );
+                TEST_ASSERT( body[0].GetShape() == env.Shapes().GetShape(0) );
+
+                // 別のライブラリには別の要素が追加される
+                rbShapeLibrary library;
+                rbRigidBody other;
+                other.SetShapeParameter( library, 3, 0.5f, 1.0f, 1.5f, 0.2f, 0.4f );
+                TEST_ASSERT( other.GetShape() == library.GetShape(0) );
+                TEST_ASSERT( other.GetShape() != body[0].GetShape() );
+                TEST_ASSERT_EQUAL( env.Shapes().Count(), rbu32(1) );
+
+                // コピーは同じ形状を参照する
+                rbRigidBody copy( body[1] );
+                TEST_ASSERT( copy.GetShape() == body[1].GetShape() );
+            }
+
+            // 問い合わせの直方体はライブラリに追加されない
+            {
+                rbEnvironment env;
+                rbRigidBody body;
+                body.SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f );
+                env.Register( &body );
+                rbRigidBody* hit = nullptr;
+                rbRayHit sweep_hit;
+                for ( int i = 1; i <= 10; ++i )
+                {
+                    const rbReal h = rbReal(0.1) * rbReal(i);
+                    env.OverlapBox( rbVec3(0, 0, 0), rbMtx3(1, 0, 0, 0, 1, 0, 0, 0, 1), rbVec3(h, h, h), &hit, 1 );
+                    env.SweepBox( rbVec3(0, 5, 0), rbMtx3(1, 0, 0, 0, 1, 0, 0, 0, 1), rbVec3(h, h, h), rbVec3(0, -5, 0), sweep_hit );
+                }
+                TEST_ASSERT_EQUAL( env.Shapes().Count(), rbu32(1) );
+                env.Unregister( &body );
+            }
+
+            // 同じアドレスで作り直した凸包は別の形状になる
+            {
+                rbVec3 points[8];
+                for ( int i = 0; i < 8; ++i )
+                    points[i] = rbVec3( (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f );
+                rbConvexHull hull;
+                TEST_ASSERT( hull.Build( points, 8 ) );
+
+                rbShapeLibrary library;
+                rbu32 a = library.AddConvexHull( 1, &hull, 0.5f, 0.5f );
+                for ( int i = 0; i < 8; ++i )
+                    points[i].x *= 2;
+                TEST_ASSERT( hull.Build( points, 8 ) );
+                rbu32 b = library.AddConvexHull( 1, &hull, 0.5f, 0.5f );
+                TEST_ASSERT( a != b );
+                TEST_ASSERT( rbFabs(library.GetShape(b)->half_extent.x - 2) < eps );
+            }
+
+            // 環境の形状を共有する剛体
+            {
+                rbEnvironment env;
+                rbu32 index = env.Shapes().AddBox( 2, 1, 1, 1, 0.5f, 0.5f );
+                rbRigidBody body;
+                body.SetShape( env.Shapes().GetShape( index ) );
+                TEST_ASSERT( rbFabs(body.InvMass() - rbReal(0.5)) < eps );
+                TEST_ASSERT( rbFabs(body.HalfExtent().x - 1) < eps );
+            }
+
+            // 慣性主軸が剛体の座標系と一致しない凸包
+            {
+                // x 軸方向に長い直方体を z 軸まわりに 30 度回転させた点群
+                rbMtx3 tilt;
+                tilt.SetFromAxisAngle( rbVec3(0, 0, 1), rbToRad(30) );
+                rbVec3 points[8];
+                for ( int i = 0; i < 8; ++i )
+                    points[i] = tilt * rbVec3( (i & 1) ? 2.0f : -2.0f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 1.0f : -1.0f );
+
+                rbConvexHull hull;
+                TEST_ASSERT( hull.Build( points, 8 ) );
+
+                const rbReal mass = 4;
+                rbShapeLibrary library;
+                rbRigidBody body;
+                body.SetShapeParameter( library, mass, &hull, 0.5f, 0.5f );
+                TEST_ASSERT( !body.GetShape()->principal_axes_identity );
+
+                rbMtx3 expected = hull.Inertia( mass ).GetInverse();
+                TEST_ASSERT( NearlyEqual( body.InvInertia(), expected, eps ) );
+
+                // I^-1 = R * I0^-1 * R^T
+                body.SetOrientation( rbToRad(10), rbToRad(20), rbToRad(40) );
+                body.UpdateInvInertiaWorld();
+                rbMtx3 R = body.Orientation();
+                TEST_ASSERT( NearlyEqual( body.InvInertiaWorld(), R * expected * R.GetTransposed(), eps ) );
+            }
+
+            // 直方体の慣性テンソル
+            {
+                rbShapeLibrary library;
+                rbRigidBody body;
+                body.SetShapeParameter( library, 6, 1, 2, 3, 0.5f, 0.5f );
+                body.SetOrientation( rbToRad(45), 0, rbToRad(15) );
+                body.UpdateInvInertiaWorld();
+                rbMtx3 inertia( 6 * (4 + 9) / rbReal(3), 0, 0,
+                                0, 6 * (1 + 9) / rbReal(3), 0,
+                                0, 0, 6 * (1 + 4) / rbReal(3) );
+                rbMtx3 R = body.Orientation();
+                TEST_ASSERT( NearlyEqual( body.InvInertiaWorld(), R * inertia.GetInverse() * R.GetTransposed(), eps ) );
+            }
+
+            // 固定物体は Update で慣性テンソルを再計算しないが、姿勢を設定すれば更新される
+            {
+                rbEnvironment env;
+                rbRigidBody body;
+                body.SetShapeParameter( env.Shapes(), 6, 1, 2, 3, 0.5f, 0.5f );
+                body.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                env.Register( &body );
+
+                body.SetOrientation( 0, rbToRad(60), 0 );
+                env.Update( rbReal(1.0 / 60.0), 1 );
+
+                rbMtx3 R = body.Orientation();
+                rbMtx3 expected = R * body.InvInertia() * R.GetTransposed();
+                TEST_ASSERT( NearlyEqual( body.InvInertiaWorld(), expected, eps ) );
+                env.Unregister( &body );
+            }
+        }
+};
+
+#endif
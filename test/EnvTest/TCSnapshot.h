@@ -0,0 +1,174 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCSNAPSHOT_H_INCLUDED
+#define TCSNAPSHOT_H_INCLUDED
+
+#include <cstring>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCSnapshot : public Test::Case
+{
+public:
+    TCSnapshot( const char* name )
+        : Test::Case( name )
+        {}
+
+    static const rbs32 BoxCount = 6;
+
+    struct Scene
+    {
+        rbEnvironment env;
+        rbRigidBody floor, sensor, box[BoxCount];
+
+        Scene( const rbEnvironment::Config& config )
+            : env( config )
+            {
+                floor.SetShapeParameter( env.Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+                floor.SetPosition( 0, -0.5f, 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                env.Register( &floor );
+
+                sensor.SetShapeParameter( env.Shapes(), 1, 2, 0.5f, 2, 0, 0 );
+                sensor.SetPosition( 0, 1, 0 );
+                sensor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                sensor.EnableAttribute( rbRigidBody::Attribute_Sensor );
+                env.Register( &sensor );
+
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                {
+                    box[i].SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.2f, 0.5f );
+                    box[i].SetPosition( rbReal(i % 2) * 0.3f, 0.5f + rbReal(i) * 1.2f, 0 );
+                    box[i].SetOrientation( 0, rbToRad(rbReal(15 * i)), 0 );
+                    box[i].EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                    env.Register( &box[i] );
+                }
+            }
+
+        ~Scene()
+            {
+                env.Unregister( &floor );
+                env.Unregister( &sensor );
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                    env.Unregister( &box[i] );
+            }
+
+        void Step( rbs32 frames )
+            {
+                for ( rbs32 frame = 0; frame < frames; ++frame )
+                {
+                    for ( rbs32 i = 0; i < BoxCount; ++i )
+                        box[i].SetForce( 0, -9.8f, 0 );
+                    env.Update( rbReal(1.0 / 60.0), 2 );
+                }
+            }
+
+        // 剛体の状態をビット列として集める
+        std::vector<rbu8> Record()
+            {
+                std::vector<rbu8> bytes( BoxCount * rbRigidBody::SnapshotSize() );
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                    box[i].SaveSnapshot( &bytes[i * rbRigidBody::SnapshotSize()] );
+                return bytes;
+            }
+
+        rbu32 DrainEvents( rbContactEvent* events, rbu32 capacity )
+            {
+                return env.DrainContactEvents( events, capacity );
+            }
+    };
+
+    virtual void Run()
+        {
+            rbEnvironment::Config config;
+            config.ContactEventCapacity = 256;
+
+            // 記録にはアラインメントのためのパディングを含まない
+            TEST_ASSERT( rbRigidBody::SnapshotSize() < sizeof(rbRigidBody) );
+
+            // 保存した時点から同じ結果を再現できる
+            {
+                Scene scene( config );
+                scene.Step( 20 );
+
+                rbContactEvent events0[256], events1[256];
+                scene.DrainEvents( events0, 256 );
+
+                rbSnapshot snapshot;
+                TEST_ASSERT( snapshot.Empty() );
+                scene.env.SaveSnapshot( snapshot );
+                TEST_ASSERT( !snapshot.Empty() );
+                TEST_ASSERT_EQUAL( snapshot.GetHeader().BodyCount, rbu32(BoxCount + 2) );
+                TEST_ASSERT_EQUAL( snapshot.GetHeader().ContactCount, rbu32(scene.env.ContactCount()) );
+                TEST_ASSERT( snapshot.GetHeader().TouchingPairCount > 0 );
+                TEST_ASSERT( snapshot.GetHeader().SensorPairCount > 0 );
+                TEST_ASSERT_EQUAL( snapshot.Size(), rbSnapshot::ComputeSize(snapshot.GetHeader()) );
+
+                scene.Step( 30 );
+                const std::vector<rbu8> expected = scene.Record();
+                const rbu32 expected_event_count = scene.DrainEvents( events0, 256 );
+                const size_t expected_sensor_events = scene.env.SensorEventCount();
+
+                TEST_ASSERT( scene.env.RestoreSnapshot(snapshot) );
+                scene.Step( 30 );
+                TEST_ASSERT( scene.Record() == expected );
+                TEST_ASSERT_EQUAL( scene.DrainEvents(events1, 256), expected_event_count );
+                TEST_ASSERT_EQUAL( scene.env.SensorEventCount(), expected_sensor_events );
+
+                bool same_events = true;
+                for ( rbu32 i = 0; i < expected_event_count; ++i )
+                    same_events = same_events && events0[i].Type == events1[i].Type && events0[i].PairId == events1[i].PairId &&
+                        events0[i].Body[0] == events1[i].Body[0] && events0[i].Body[1] == events1[i].Body[1];
+                TEST_ASSERT( same_events );
+
+                // 衝突点は登録順の番号を通じて剛体を参照し直す
+                scene.env.RestoreSnapshot( snapshot );
+                bool valid_bodies = true;
+                for ( size_t i = 0; i < scene.env.ContactCount(); ++i )
+                    valid_bodies = valid_bodies && scene.env.Contact( rbu32(i) )->Body[0] != nullptr && scene.env.Contact( rbu32(i) )->Body[1] != nullptr;
+                TEST_ASSERT( valid_bodies );
+            }
+
+            // バイト列を別の環境へ読み込む
+            {
+                Scene scene0( config ), scene1( config );
+                scene0.Step( 25 );
+                rbSnapshot snapshot;
+                scene0.env.SaveSnapshot( snapshot );
+                const std::vector<rbu8> bytes( snapshot.Data(), snapshot.Data() + snapshot.Size() );
+
+                rbSnapshot loaded;
+                TEST_ASSERT( loaded.Assign(bytes.data(), bytes.size()) );
+                TEST_ASSERT( scene1.env.RestoreSnapshot(loaded) );
+                scene0.Step( 10 );
+                scene1.Step( 10 );
+                TEST_ASSERT( scene0.Record() == scene1.Record() );
+
+                // 壊れたデータ・大きさの合わないデータは受け付けない
+                std::vector<rbu8> broken = bytes;
+                broken[0] ^= 0xFF;
+                TEST_ASSERT( !loaded.Assign(broken.data(), broken.size()) );
+                TEST_ASSERT( loaded.Empty() );
+                TEST_ASSERT( !loaded.Assign(bytes.data(), bytes.size() - 1) );
+                TEST_ASSERT( !loaded.Assign(bytes.data(), 4) );
+                TEST_ASSERT( !scene1.env.RestoreSnapshot(loaded) );
+            }
+
+            // 剛体の数が違う環境には復元しない
+            {
+                Scene scene( config );
+                rbSnapshot snapshot;
+                scene.env.SaveSnapshot( snapshot );
+
+                rbEnvironment other;
+                rbRigidBody body;
+                other.Register( &body );
+                TEST_ASSERT( !other.RestoreSnapshot(snapshot) );
+                other.Unregister( &body );
+            }
+        }
+};
+
+#endif
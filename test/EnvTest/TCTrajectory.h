@@ -0,0 +1,163 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCTRAJECTORY_H_INCLUDED
+#define TCTRAJECTORY_H_INCLUDED
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCTrajectory : public Test::Case
+{
+public:
+    TCTrajectory( const char* name )
+        : Test::Case( name )
+        {}
+
+    static const rbs32 BoxCount = 6;
+    static const rbu32 BodyCount = BoxCount + 1;
+
+    // 位置は 16 ビット (チャンクの範囲 10m 程度に対して 1mm 未満)、回転は 10 ビット x 3 で量子化される
+    static bool NearlyEqual( const rbVec3& a, const rbVec3& b )
+        {
+            return rbFabs(a.x - b.x) < 1.0e-3f && rbFabs(a.y - b.y) < 1.0e-3f && rbFabs(a.z - b.z) < 1.0e-3f;
+        }
+
+    static bool NearlyEqual( const rbMtx3& a, const rbMtx3& b )
+        {
+            for ( rbs32 row = 0; row < 3; ++row )
+                for ( rbs32 col = 0; col < 3; ++col )
+                    if ( rbFabs(a.Elem(row, col) - b.Elem(row, col)) > 1.0e-2f )
+                        return false;
+            return true;
+        }
+
+    virtual void Run()
+        {
+            const char* path = "TCTrajectory.rbtr";
+            const rbs32 frames = 100;
+
+            std::vector<rbVec3> expected_positions;
+            std::vector<rbMtx3> expected_orientations;
+
+            // Update の最後に記録される
+            {
+                rbEnvironment env;
+                rbRigidBody floor, box[BoxCount];
+                floor.SetShapeParameter( env.Shapes(), 100, 10, 0.5f, 10, 0.5f, 0.5f );
+                floor.SetPosition( 0, -0.5f, 0 );
+                floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                env.Register( &floor );
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                {
+                    box[i].SetShapeParameter( env.Shapes(), 1, 0.5f, 0.5f, 0.5f, 0.2f, 0.5f );
+                    box[i].SetPosition( rbReal(i % 2) * 0.3f, 0.5f + rbReal(i) * 1.2f, 0 );
+                    box[i].SetOrientation( rbToRad(rbReal(10 * i)), rbToRad(rbReal(25 * i)), 0 );
+                    env.Register( &box[i] );
+                }
+
+                rbTrajectoryRecorder recorder;
+                TEST_ASSERT( !recorder.IsOpen() );
+                TEST_ASSERT( !recorder.Capture(env.RigidBodies()) );
+                TEST_ASSERT( !recorder.Close() );
+
+                // 作成できないファイル
+                TEST_ASSERT( !recorder.Open("no-such-directory/TCTrajectory.rbtr", BodyCount) );
+
+                TEST_ASSERT( recorder.Open(path, BodyCount, 16) );
+                TEST_ASSERT( recorder.IsOpen() );
+                TEST_ASSERT( !recorder.Open(path, BodyCount, 16) );
+                env.SetTrajectoryRecorder( &recorder );
+
+                for ( rbs32 frame = 0; frame < frames; ++frame )
+                {
+                    for ( rbs32 i = 0; i < BoxCount; ++i )
+                        box[i].SetForce( 0, -9.8f, 0 );
+                    env.Update( rbReal(1.0 / 60.0), 2 );
+
+                    for ( rbRigidBody* body : env.RigidBodies() )
+                    {
+                        expected_positions.push_back( body->Position() );
+                        expected_orientations.push_back( body->Orientation() );
+                    }
+                }
+
+                // 剛体の数が合わないフレームは記録しない
+                std::vector<rbRigidBody*> fewer( env.RigidBodies() );
+                fewer.pop_back();
+                TEST_ASSERT( !recorder.Capture(fewer) );
+
+                TEST_ASSERT_EQUAL( recorder.FrameCount(), rbu32(frames) );
+                env.SetTrajectoryRecorder( nullptr );
+                TEST_ASSERT( recorder.Close() );
+                TEST_ASSERT( !recorder.IsOpen() );
+
+                env.Unregister( &floor );
+                for ( rbs32 i = 0; i < BoxCount; ++i )
+                    env.Unregister( &box[i] );
+            }
+
+            // 任意のフレームを読み出せる
+            {
+                rbTrajectoryPlayer player;
+                TEST_ASSERT( !player.IsOpen() );
+                TEST_ASSERT( player.Open(path) );
+                TEST_ASSERT_EQUAL( player.BodyCount(), BodyCount );
+                TEST_ASSERT_EQUAL( player.FrameCount(), rbu32(frames) );
+
+                bool all_near = true;
+                rbVec3 positions[BodyCount];
+                rbMtx3 orientations[BodyCount];
+                for ( rbs32 frame = frames - 1; frame >= 0; --frame )
+                {
+                    TEST_ASSERT( player.ReadFrame(rbu32(frame), positions, orientations) );
+                    for ( rbu32 i = 0; i < BodyCount; ++i )
+                    {
+                        const size_t k = size_t(frame) * BodyCount + i;
+                        all_near = all_near && NearlyEqual( positions[i], expected_positions[k] );
+                        all_near = all_near && NearlyEqual( orientations[i], expected_orientations[k] );
+                    }
+                }
+                TEST_ASSERT( all_near );
+
+                // 最後のチャンクは端数 (100 = 16 x 6 + 4)
+                rbVec3 position;
+                rbMtx3 orientation;
+                TEST_ASSERT( player.ReadPose(97, 3, position, orientation) );
+                TEST_ASSERT( NearlyEqual(position, expected_positions[97 * BodyCount + 3]) );
+                TEST_ASSERT( NearlyEqual(orientation, expected_orientations[97 * BodyCount + 3]) );
+
+                TEST_ASSERT( !player.ReadFrame(rbu32(frames), positions, orientations) );
+                TEST_ASSERT( !player.ReadPose(0, BodyCount, position, orientation) );
+
+                player.Close();
+                TEST_ASSERT( !player.IsOpen() );
+                TEST_ASSERT( !player.ReadPose(0, 0, position, orientation) );
+            }
+
+            // 途中で切れたファイルは開けない
+            {
+                std::vector<char> bytes;
+                std::FILE* file = std::fopen( path, "rb" );
+                TEST_ASSERT( file != nullptr );
+                char buffer[4096];
+                size_t read = 0;
+                while ( (read = std::fread(buffer, 1, sizeof(buffer), file)) > 0 )
+                    bytes.insert( bytes.end(), buffer, buffer + read );
+                std::fclose( file );
+
+                file = std::fopen( path, "wb" );
+                std::fwrite( bytes.data(), 1, bytes.size() - 1, file );
+                std::fclose( file );
+
+                rbTrajectoryPlayer player;
+                TEST_ASSERT( !player.Open(path) );
+                TEST_ASSERT( !player.Open("no-such-file.rbtr") );
+            }
+
+            std::remove( path );
+        }
+};
+
+#endif
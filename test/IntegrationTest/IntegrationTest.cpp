@@ -1,29 +1,31 @@
-// -*- mode: C++; coding: utf-8 -*-
-#include <TestFramework.h>
-
-#include "TCIntegration.h"
-
-int
-main( int argc, char** argv )
-{
-    Test::Suite suite( "Integration test" );
-
-    Test::Case* tc[] = {
-        new TCIntegration( "Integration Test" ),
-    };
-
-    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
-        suite.RegisterCase( tc[i] );
-
-    suite.Run();
-
-    if ( Test::ManagerInstance().FailCount() == 0 )
-        std::cout << Test::ManagerInstance().AssertionCount() << " assertions succeeded." << std::endl;
-    else
-        std::cout << Test::ManagerInstance().FailCount() << " of " << Test::ManagerInstance().AssertionCount() << " assertions failed." << std::endl;
-
-    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
-        delete tc[i];
-
-    return 0;
-}
+// -*- mode: C++; coding: utf-8 -*-
+#include <TestFramework.h>
+
+#include "TCIntegration.h"
+#include "TCBodyLayout.h"
+
+int
+main( int argc, char** argv )
+{
+    Test::Suite suite( "Integration test" );
+
+    Test::Case* tc[] = {
+        new TCIntegration( "Integration Test" ),
+        new TCBodyLayout( "Body Layout Test" ),
+    };
+
+    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
+        suite.RegisterCase( tc[i] );
+
+    suite.Run();
+
+    if ( Test::ManagerInstance().FailCount() == 0 )
+        std::cout << Test::ManagerInstance().AssertionCount() << " assertions succeeded." << std::endl;
+    else
+        std::cout << Test::ManagerInstance().FailCount() << " of " << Test::ManagerInstance().AssertionCount() << " assertions failed." << std::endl;
+
+    for ( int i = 0; i < sizeof(tc)/sizeof(tc[0]); ++i )
+        delete tc[i];
+
+    return 0;
+}
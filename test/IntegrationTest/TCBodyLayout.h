@@ -0,0 +1,64 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCBODYLAYOUT_H_INCLUDED
+#define TCBODYLAYOUT_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCBodyLayout : public Test::Case
+{
+
+public:
+    TCBodyLayout( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            // サブステップごとに参照するデータはキャッシュラインに揃える
+            {
+                TEST_ASSERT_EQUAL( alignof(rbRigidBody::State), size_t(RIGIDBOX_CACHE_LINE_SIZE) );
+                // 詰め物はキャッシュラインの境界までの分だけ
+                const size_t payload = 4 * sizeof(rbVec3) + 2 * sizeof(rbMtx3);
+                TEST_ASSERT( sizeof(rbRigidBody::State) < payload + RIGIDBOX_CACHE_LINE_SIZE );
+
+                std::vector<rbRigidBody> bodies( 3 );
+                for ( size_t i = 0; i < bodies.size(); ++i )
+                    TEST_ASSERT_EQUAL( reinterpret_cast<std::uintptr_t>(&bodies[i]) % RIGIDBOX_CACHE_LINE_SIZE, std::uintptr_t(0) );
+            }
+
+            // スリープの閾値は剛体の種類ごとに共有できる
+            {
+                const rbReal dt = rbReal(1.0 / 60.0);
+
+                rbRigidBody::SleepThresholds patient;
+                patient.GoSleepDuration = rbReal(2.0);
+
+                rbRigidBody box[2];
+                box[0].EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                box[1].EnableAttribute( rbRigidBody::Attribute_AutoSleep );
+                box[1].SetSleepThresholds( &patient );
+                TEST_ASSERT( box[0].GetSleepThresholds() == rbRigidBody::DefaultSleepThresholds() );
+
+                for ( int i = 0; i < 60; ++i )
+                {
+                    box[0].UpdateSleepStatus( dt );
+                    box[1].UpdateSleepStatus( dt );
+                }
+                TEST_ASSERT( box[0].Sleeping() );
+                TEST_ASSERT( box[1].Awake() );
+
+                // 閾値を変更すると、それを共有する剛体すべてに反映される
+                patient.GoSleepDuration = rbReal(0.5);
+                box[1].UpdateSleepStatus( dt );
+                TEST_ASSERT( box[1].Sleeping() );
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,101 @@
+// -*- mode: C++; coding: utf-8; -*-
+#ifndef TCSPECULATIVE_H_INCLUDED
+#define TCSPECULATIVE_H_INCLUDED
+
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <RigidBox/RigidBox.h>
+#include <TestFramework.h>
+
+class TCSpeculative : public Test::Case
+{
+public:
+    TCSpeculative( const char* name )
+        : Test::Case( name )
+        {}
+
+    virtual void Run()
+        {
+            rbs32 result;
+            const rbReal dt = rbReal(1.0 / 60.0);
+            rbSolver solver( rbReal(0.2) );
+
+            {
+                // 0.5 の隙間を空けて立方体を積む : マージン内でのみ負の深さの衝突点を報告
+                rbContact c;
+                rbRigidBody box0, box1;
+                box0.SetPosition( 0, 0, 0 );
+                box1.SetPosition( 0, rbReal(2.5), 0 );
+
+                result = rbCollision::Detect( &box0, &box1, &c );
+                TEST_ASSERT( result == 0 );
+
+                result = rbCollision::DetectSpeculative( &box0, &box1, rbReal(0.25), &c );
+                TEST_ASSERT( result == 0 );
+
+                result = rbCollision::DetectSpeculative( &box0, &box1, rbReal(1.0), &c );
+                TEST_ASSERT( result == 1 );
+                TEST_ASSERT( rbFabs(c.PenetrationDepth + rbReal(0.5)) < rbReal(1e-3) );
+                TEST_ASSERT( rbFabs(rbFabs(c.Normal.y) - 1) < rbReal(1e-3) );
+            }
+
+            {
+                // 隙間を詰めきれない接近速度には力積を加えない
+                rbContact c;
+                rbRigidBody box0, box1;
+                box0.SetPosition( 0, 0, 0 );
+                box0.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                box1.SetPosition( 0, rbReal(2.5), 0 );
+                box1.SetLinearVelocity( 0, rbReal(-10), 0 );
+
+                result = rbCollision::DetectSpeculative( &box0, &box1, rbReal(1.0), &c );
+                TEST_ASSERT( result == 1 );
+
+                solver.ApplyImpulse( &c, dt );
+                box1.CorrectVelocity();
+                TEST_ASSERT( rbFabs(box1.LinearVelocity().y + rbReal(10)) < rbReal(1e-3) );
+
+                // 隙間を超える接近速度は gap / dt まで抑える
+                box1.SetLinearVelocity( 0, rbReal(-60), 0 );
+                solver.ApplyImpulse( &c, dt );
+                box1.CorrectVelocity();
+                TEST_ASSERT( rbFabs(box1.LinearVelocity().y + rbReal(0.5) / dt) < rbReal(1e-2) );
+            }
+
+            {
+                // 薄い床へ高速で落下 : 予測的な衝突点がなければすり抜け、あれば床の上で止まる
+                for ( int speculative = 0; speculative < 2; ++speculative )
+                {
+                    rbEnvironment::Config config;
+                    config.SpeculativeContacts = (speculative != 0);
+                    rbEnvironment env( config );
+
+                    rbRigidBody floor;
+                    floor.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(10), rbReal(0.05), rbReal(10), rbReal(0.5), rbReal(0.5) );
+                    floor.SetPosition( 0, rbReal(-0.05), 0 );
+                    floor.EnableAttribute( rbRigidBody::Attribute_Fixed );
+                    env.Register( &floor );
+
+                    rbRigidBody box;
+                    box.SetShapeParameter( env.Shapes(), rbReal(1), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5), rbReal(0.5) );
+                    box.SetPosition( 0, rbReal(2), 0 );
+                    box.SetLinearVelocity( 0, rbReal(-80), 0 );
+                    env.Register( &box );
+
+                    env.Update( dt, 1 );
+                    env.Update( dt, 1 );
+
+                    if ( speculative )
+                        TEST_ASSERT( box.Position().y > rbReal(0.45) );
+                    else
+                        TEST_ASSERT( box.Position().y < rbReal(0) );
+
+                    env.Unregister( &box );
+                    env.Unregister( &floor );
+                }
+            }
+        }
+};
+
+#endif